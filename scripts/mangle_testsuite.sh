@@ -74,6 +74,25 @@ tail -n +2 jazel > azel.dat
 ../../scripts/make_pixelmaps.sh 2qz_north_res4s.pol azel.dat 0
 rm azel.dat jazel
 
+echo "Checking that the pixels of scheme h are equal in area ..."
+#every pixel at resolution 6, and the resolution 14 pixels in small circles
+#about a pole, corners of the base pixels and a point inside one, must have
+#an area within 0.5% of 4 pi / (12 4^(res-1)); none may be empty
+#USAGE: hpix_area <polygon file> <number of pixels at res> [<number of polygons>]
+hpix_area() {
+    awk -v n=$2 -v k=$3 '/^polygon/ {for(i=1;i<=NF;i++) if($i=="str):") a=$(i-1); r=a*n/(4*3.14159265358979); if(!m++ || r<min) min=r; if(r>max) max=r}
+    END {print m, "pixels, area / nominal from", min, "to", max; if((k!="" && m!=k) || min<0.995 || max>1.005) exit 1}' $1
+}
+../../bin/pixelize -q -Ph0,6 ../../masks/allsky/allsky.pol hpix6.pol || exit
+hpix_area hpix6.pol 12288 12288 || exit
+printf "0 90 0.05\n0 0 0.05\n45 41.8103149 0.05\n22.5 -60 0.05\n" > jcircles.dat
+../../bin/snap -q -ic1 jcircles.dat jcircles.pol || exit
+../../bin/pixelize -q -Ph0,14 jcircles.pol jpix.pol || exit
+../../bin/balkanize -q jpix.pol jbalk.pol || exit
+../../bin/pixelmap -q -Ph0,14 jbalk.pol hpix14.pol || exit
+hpix_area hpix14.pol 805306368 || exit
+rm jcircles.dat jcircles.pol jpix.pol jbalk.pol
+
 if which matlab >/dev/null 2>&1 ; then
     ../../bin/poly2poly -ol30 trimmed_mask.pol trimmed_mask.list
     ../../scripts/graphmask.sh trimmed_mask.list trimmed_mask.eps
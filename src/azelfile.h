@@ -0,0 +1,71 @@
+/*------------------------------------------------------------------------------
+  Binary and FITS az, el files.
+------------------------------------------------------------------------------*/
+#ifndef AZELFILE_H
+#define AZELFILE_H
+
+#include <stdio.h>
+#include "fits.h"
+#include "vertices.h"
+
+/*
+  A binary az, el file is a 24-byte header followed by one fixed length
+  record per position, with no padding, in the native byte order:
+
+  header:  char magic[8]	"mangleaz"
+	   int version		AZEL_VERSION; also detects foreign byte order
+	   int columns		AZEL_ID | AZEL_WEIGHT | AZEL_POLYID,
+				the optional columns
+	   char unit		angular unit of az, el, one of UNITS
+	   char pad[7]		zero
+  record:  double az, el
+	   long long id		if columns & AZEL_ID
+	   double weight	if columns & AZEL_WEIGHT
+	   long long polyid	if columns & AZEL_POLYID
+
+  The id is that of the position, as in a catalog, and is carried
+  through by the programs that read it; polyid writes the id of a
+  polygon containing the position in polyid, which is not read back.
+
+  A FITS az, el file is a FITS binary table with double columns AZ, EL,
+  and optionally long long columns ID and POLYID and a double column WEIGHT,
+  with TUNITs deg, rad, arcmin, arcsec, or hour for az in hms.
+  On input, columns RA, DEC, and any integer or real type are accepted too,
+  with TSCALn and TZEROn applied, so unsigned integers work; an integer
+  ID column with TSCALn 1 and an integer TZEROn is read exactly.
+  A row with an undefined value (TNULLn, or NaN) is an error.
+
+  Files are read and written sequentially, so they can be pipes;
+  FITS output to a pipe is held in a temporary file until wrazel_end,
+  since the number of rows goes in the header.
+*/
+#define AZEL_MAGIC	"mangleaz"
+#define AZEL_VERSION	1
+#define AZEL_HEADSIZE	24
+
+/* optional columns */
+#define AZEL_ID		1
+#define AZEL_WEIGHT	2
+#define AZEL_POLYID	4
+
+typedef struct {
+    char *name;			/* filename */
+    FILE *file;			/* file stream */
+    char fmt;			/* b binary, f FITS */
+    int columns;		/* optional columns present */
+    char unit;			/* angular unit of az, el */
+    long long nrec;		/* number of records read or written */
+    /* FITS only */
+    fitstable table;		/* layout of binary table */
+    int icol[4];		/* input: table columns of az, el, id, weight */
+    long headpos;		/* output: position of table header in file */
+    FILE *spool;		/* output to a pipe: records held here until wrazel_end */
+} azelfile;
+
+int	rdazel_head(azelfile *);
+int	rdazel(azelfile *, azel *, long long *, real_t *);
+int	wrazel_head(azelfile *);
+int	wrazel(azelfile *, azel *, long long, real_t, long long);
+int	wrazel_end(azelfile *);
+
+#endif	/* AZELFILE_H */
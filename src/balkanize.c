@@ -79,7 +79,7 @@ int main(int argc, char *argv[])
     if (mtol != 0.) {
 	scale(&mtol, munit, 's');
 	munit = 's';
-	msg("multiple intersections closer than %Lg%c will be treated as coincident\n", mtol, munit);
+	msg("multiple intersections closer than %" RL "g%c will be treated as coincident\n", mtol, munit);
 	scale(&mtol, munit, 'r');
 	munit = 'r';
     }
@@ -164,28 +164,14 @@ int balkanize(int npoly, polygon *poly[/*npoly*/], int npolys, polygon *polys[/*
 #define WARNMAX                 8
   char *snapped_polys = 0x0;
   int discard, dm, dn, dnp, failed, i, ier, inull, isnap, ip, iprune, j, k, m, n, nadj, np, selfsnap;
-  int *start;
-  int *total;
-  int begin, end, p, max_pixel;
-  long double tol;
+  int begin, end, p;
+  pixeldir dir;
+  real_t tol;
 
   poly_sort(npoly, poly, 'p');
 
-  /* allocate memory for pixel info arrays start and total */
-  max_pixel=poly[npoly-1]->pixel+1;
-  start = (int *) malloc(sizeof(int) * max_pixel);
-  if (!start) {
-    fprintf(stderr, "balkanize: failed to allocate memory for %d integers\n", max_pixel);
-    return(-1);
-  }
-  total = (int *) malloc(sizeof(int) * max_pixel);
-  if (!total) {
-    fprintf(stderr, "balkanize: failed to allocate memory for %d integers\n", max_pixel);
-    return(-1);
-  }
-
-  /* build lists of starting indices of each pixel and total number of polygons in each pixel*/
-  ier=pixel_list(npoly, poly, max_pixel, start, total);
+  /* build directory of starting indices of each pixel and total number of polygons in each pixel*/
+  ier=pixel_dir(npoly, poly, &dir);
   if (ier == -1) {
     fprintf(stderr, "balkanize: error building pixel index lists\n");
     return(-1);
@@ -240,11 +226,11 @@ int balkanize(int npoly, polygon *poly[/*npoly*/], int npolys, polygon *polys[/*
   dnp = 0;
   ip = 0;
   /* go through each pixel and fragment each polygon against the other polygons in its pixel */
-  for(p=0;p<max_pixel;p++){
-    begin=start[p];
-    end=start[p]+total[p];
+  for(p=0;p<dir.npix;p++){
+    begin=dir.start[p];
+    end=dir.start[p]+dir.total[p];
     //  if(end>begin){
-    // msg("balkanize: in pixel %d out of %d\n", p,max_pixel);
+    // msg("balkanize: in pixel %lld\n", dir.pixel[p]);
     // }
     /* too many polygons */
     if (n >= npolys) break;
@@ -316,7 +302,7 @@ int balkanize(int npoly, polygon *poly[/*npoly*/], int npolys, polygon *polys[/*
 	  if (n > npolys) {
 	    fprintf(stderr, "(1) balkanize: total number of polygons (= %d) exceeded maximum %d\n", npoly + n, npoly + npolys);
 	    fprintf(stderr, "if you need more space, enlarge NPOLYSMAX in defines.h, and recompile\n");
-	    fprintf(stderr, "currently, dn = %d, np = %d, dnp = %d, poly[%d]->id = %lld, poly[%d]->pixel = %d\n", dn, np, dnp, i, poly[i]->id, i, poly[i]->pixel);
+	    fprintf(stderr, "currently, dn = %d, np = %d, dnp = %d, poly[%d]->id = %lld, poly[%d]->pixel = %lld\n", dn, np, dnp, i, poly[i]->id, i, poly[i]->pixel);
 	    n = npolys;
 #ifdef  CARRY_ON_REGARDLESS
 	    break;
@@ -349,8 +335,7 @@ int balkanize(int npoly, polygon *poly[/*npoly*/], int npolys, polygon *polys[/*
 
   }
 
-  free(start);
-  free(total);
+  free_pixel_dir(&dir);
 
   msg("added %d polygons to make %d\n", dnp, np);
 
@@ -19,7 +19,7 @@
   Return value: number of disjoint connected polygons,
 		or -1 if error occurred.
 */
-int balkanize(int npoly, polygon *poly[/*npoly*/], int npolys, polygon *polys[/*npolys*/], long double mtol, format *fmt, long double axtol, long double btol, long double thtol, long double ytol)
+int balkanize(int npoly, polygon *poly[/*npoly*/], int npolys, polygon *polys[/*npolys*/], real_t mtol, format *fmt, real_t axtol, real_t btol, real_t thtol, real_t ytol)
 {
 /* part_poly should lasso one-boundary polygons only if they have too many caps */
 #define ALL_ONEBOUNDARY		1
@@ -32,28 +32,14 @@ int balkanize(int npoly, polygon *poly[/*npoly*/], int npolys, polygon *polys[/*
 #define WARNMAX			8
     char *snapped_polys = 0x0;
     int discard, dm, dn, dnp, failed, i, ier, inull, isnap, ip, iprune, j, k, m, n, nadj, np, selfsnap;
-    int *start;
-    int *total;
-    int begin, end, p, max_pixel;
-    long double tol;
+    int begin, end, p;
+    pixeldir dir;
+    real_t tol;
 
     poly_sort(npoly, poly, 'p');
 
-    /* allocate memory for pixel info arrays start and total */ 
-    max_pixel=poly[npoly-1]->pixel+1; 
-    start = (int *) malloc(sizeof(int) * max_pixel);
-    if (!start) {
-      fprintf(stderr, "balkanize: failed to allocate memory for %d integers\n", max_pixel);
-      return(-1);
-    }
-    total = (int *) malloc(sizeof(int) * max_pixel);
-    if (!total) {
-      fprintf(stderr, "balkanize: failed to allocate memory for %d integers\n", max_pixel);
-      return(-1);
-    }
-
-    /* build lists of starting indices of each pixel and total number of polygons in each pixel*/
-    ier=pixel_list(npoly, poly, max_pixel, start, total);
+    /* build directory of starting indices of each pixel and total number of polygons in each pixel*/
+    ier=pixel_dir(npoly, poly, &dir);
     if (ier == -1) {
       fprintf(stderr, "balkanize: error building pixel index lists\n");
       return(-1);
@@ -108,10 +94,10 @@ int balkanize(int npoly, polygon *poly[/*npoly*/], int npolys, polygon *polys[/*
     dnp = 0;
     ip = 0;
     /* go through each pixel and fragment each polygon against the other polygons in its pixel */
-    for(p=0;p<max_pixel;p++){
+    for(p=0;p<dir.npix;p++){
       
-      begin=start[p];
-      end=start[p]+total[p];
+      begin=dir.start[p];
+      end=dir.start[p]+dir.total[p];
 
       /* too many polygons */
       if (n >= npolys) break;
@@ -183,7 +169,7 @@ int balkanize(int npoly, polygon *poly[/*npoly*/], int npolys, polygon *polys[/*
 	    if (n > npolys) {
 	      fprintf(stderr, "(1) balkanize: total number of polygons (= %d) exceeded maximum %d\n", npoly + n, npoly + npolys);
 	      fprintf(stderr, "if you need more space, enlarge NPOLYSMAX in defines.h, and recompile\n");
-              fprintf(stderr, "currently, dn = %d, np = %d, dnp = %d, poly[%d]->id = %lld, poly[%d]->pixel = %d\n", dn, np, dnp, i, poly[i]->id, i, poly[i]->pixel);
+              fprintf(stderr, "currently, dn = %d, np = %d, dnp = %d, poly[%d]->id = %lld, poly[%d]->pixel = %lld\n", dn, np, dnp, i, poly[i]->id, i, poly[i]->pixel);
 	      n = npolys;
 #ifdef	CARRY_ON_REGARDLESS
 	      break;
@@ -216,8 +202,7 @@ int balkanize(int npoly, polygon *poly[/*npoly*/], int npolys, polygon *polys[/*
       
     }
 
-    free(start);
-    free(total);
+    free_pixel_dir(&dir);
 
     msg("added %d polygons to make %d\n", dnp, np);
     
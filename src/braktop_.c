@@ -6,22 +6,22 @@
 /*------------------------------------------------------------------------------
   c interface to fortran subroutines in braktop.s.f
 */
-void braktop(long double aa, int *ia, long double a[], int n, int l)
+void braktop(real_t aa, int *ia, real_t a[], int n, int l)
 {
     braktop_(&aa, ia, a, &n, &l);
 }
 
-void brakbot(long double aa, int *ia, long double a[], int n, int l)
+void brakbot(real_t aa, int *ia, real_t a[], int n, int l)
 {
     brakbot_(&aa, ia, a, &n, &l);
 }
 
-void braktpa(long double aa, int *ia, long double a[], int n, int l)
+void braktpa(real_t aa, int *ia, real_t a[], int n, int l)
 {
     braktpa_(&aa, ia, a, &n, &l);
 }
 
-void brakbta(long double aa, int *ia, long double a[], int n, int l)
+void brakbta(real_t aa, int *ia, real_t a[], int n, int l)
 {
     brakbta_(&aa, ia, a, &n, &l);
 }
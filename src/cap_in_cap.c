@@ -0,0 +1,38 @@
+/*------------------------------------------------------------------------------
+  Placing one cap with respect to another.
+------------------------------------------------------------------------------*/
+#include "manglefn.h"
+
+/* angle within which the placement is too close to tell */
+#define CAP_TOL		1.e-10
+
+/*------------------------------------------------------------------------------
+  Where a cap lies with respect to another cap, from the angles alone,
+  so that most polygons can be placed in or out of a pixel, or a pixel
+  in or out of a polygon, without intersecting them.
+
+   Input: c, cmc = cap, 0 <= cmc <= 2, as the bounding cap of a polygon.
+	  rp, cm = other cap, as one of the caps of a pixel.
+   Return value: 1 if cap c is inside cap rp,
+		-1 if it is outside,
+		0 if it straddles the boundary, or is too close to tell.
+*/
+int cap_in_cap(vec c, real_t cmc, vec rp, real_t cm)
+{
+    real_t d, th, thc;
+
+    /* angle between the centers, and angular radii */
+    d = 2. * asinl(sqrtl((c[0]-rp[0])*(c[0]-rp[0]) + (c[1]-rp[1])*(c[1]-rp[1]) + (c[2]-rp[2])*(c[2]-rp[2])) / 2.);
+    thc = 2. * asinl(sqrtl(cmc / 2.));
+    if (cm >= 2.) return(1);
+    if (cm <= -2.) return(-1);
+    th = 2. * asinl(sqrtl(fabsl(cm) / 2.));
+    if (cm >= 0.) {
+	if (d + thc < th - CAP_TOL) return(1);
+	if (d - thc > th + CAP_TOL) return(-1);
+    } else {
+	if (d - thc > th + CAP_TOL) return(1);
+	if (d + thc < th - CAP_TOL) return(-1);
+    }
+    return(0);
+}
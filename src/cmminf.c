@@ -6,10 +6,10 @@
 /*------------------------------------------------------------------------------
   Find smallest cap of polygon.
 */
-void cmminf(polygon *poly, int *ipmin, long double *cmmin)
+void cmminf(polygon *poly, int *ipmin, real_t *cmmin)
 {
     int ip;
-    long double cmi;
+    real_t cmi;
 
     *cmmin = 2.;
     for (ip = 0; ip < poly->np; ip++) {
@@ -6,7 +6,8 @@
 
 /*------------------------------------------------------------------------------
   Copy format structure from fmt1 to fmt2, except fmt->nweights (this is used
-  as a sort of flag in rdmask as to whether rd_hpix has been called or not).
+  as a sort of flag in rdmask as to whether rd_hpix has been called or not)
+  and fmt->nside, which goes with it.
 */
 void copy_format(format *fmt1, format *fmt2)
 {
@@ -30,6 +31,8 @@ void copy_format(format *fmt1, format *fmt2)
     fmt2->outframe = fmt1->outframe;
     fmt2->inunit = fmt1->inunit;
     fmt2->outunit = fmt1->outunit;
+    fmt2->inazel = fmt1->inazel;
+    fmt2->outazel = fmt1->outazel;
     fmt2->outprecision = fmt1->outprecision;
     fmt2->outphase = fmt1->outphase;
     fmt2->azn = fmt1->azn;
@@ -24,6 +24,7 @@ void copy_poly(polygon *poly1, polygon *poly)
     poly->id = poly1->id;
     poly->pixel = poly1->pixel;
     poly->weight = poly1->weight;
+    poly->areaok = 0;
 }
 
 /*------------------------------------------------------------------------------
@@ -48,6 +49,7 @@ void copy_polyn(polygon *poly1, int np, polygon *poly)
     poly->id = poly1->id;
     poly->pixel = poly1->pixel;
     poly->weight = poly1->weight;
+    poly->areaok = 0;
 }
 
 /*------------------------------------------------------------------------------
@@ -80,6 +82,7 @@ void poly_poly(polygon *poly1, polygon *poly2, polygon *poly)
     poly->id = poly1->id;
     poly->pixel = poly1->pixel;
     poly->weight = poly1->weight;
+    poly->areaok = 0;
 }
 
 /*------------------------------------------------------------------------------
@@ -114,6 +117,7 @@ void poly_polyn(polygon *poly1, polygon *poly2, int n, int scm, polygon *poly)
     poly->id = poly1->id;
     poly->pixel = poly1->pixel;
     poly->weight = poly1->weight;
+    poly->areaok = 0;
 }
 
 /*------------------------------------------------------------------------------
@@ -152,4 +156,5 @@ void group_poly(polygon *poly, int gp[/*poly->np*/], int gpg, polygon *gpoly)
     gpoly->id = poly->id;
     gpoly->pixel = poly->pixel;
     gpoly->weight = poly->weight;
+    gpoly->areaok = 0;
 }
@@ -8,12 +8,13 @@
 #ifdef TIME
 #include <time.h>
 #endif
+#include "azelfile.h"
 #include "inputfile.h"
 #include "manglefn.h"
 #include "defaults.h"
 
 /* getopt options */
-const char *optstr = "dqs:e:u:p:i:";
+const char *optstr = "dqs:e:u:p:i:FI:";
 
 /* allocate polygons as a global array */
 polygon *poly_global[NPOLYSMAX];
@@ -125,7 +126,7 @@ long ddcount(char *azel_in_filename, char *th_in_filename, char *out_filename, f
     /* maximum number of az-el points: will expand as necessary */
     static int nazelmax = 0;
     static int *dd = 0x0, *id = 0x0, *iord = 0x0;
-    static long double *cm = 0x0, *th = 0x0;
+    static real_t *cm = 0x0, *th = 0x0;
     static azel *v = 0x0;
     static vec *rp = 0x0;
 
@@ -138,7 +139,9 @@ long ddcount(char *azel_in_filename, char *th_in_filename, char *out_filename, f
     int i, iazel, idi, ird, ith, j, jazel, manyid, nazel, nid, noid, nth;
     int *id_p;
     long np;
-    long double az, cmm, el, s, t;
+    real_t az, cmm, el, s, t;
+    azel vi;
+    azelfile azelin;
     char *out_fn;
     FILE *outfile;
 
@@ -166,94 +169,116 @@ long ddcount(char *azel_in_filename, char *th_in_filename, char *out_filename, f
     /* read angular radii th from th_in_filename */
     nth = 0;
     while (1) {
-	/* read line */
-	ird = rdline(&file);
-	/* serious error */
-	if (ird == -1) return(-1);
-	/* EOF */
-	if (ird == 0) break;
-	/* read angular radius from line */
-	ird = rdangle(file.line, &next, inunit, &t);
-	/* error */
-	if (ird < 1) {
-	    /* retry if nothing read, otherwise break */
-	    if (nth > 0) break;
-	/* ok */
-	} else if (ird == 1) {
-	    if (nth >= nthmax) {
-		if (nthmax == 0) {
-		    nthmax = 64;
-		} else {
-		    nthmax *= 2;
-		}
-		/* (re)allocate memory for th array */
-		th = (long double *) realloc(th, sizeof(long double) * nthmax);
-		if (!th) {
-		    fprintf(stderr, "ddcount: failed to allocate memory for %d long doubles\n", nthmax);
-		    return(-1);
+	if (fmt->inazel != 't') {
+	    /* read binary record */
+	    ird = rdazel(&azelin, &vi, 0x0, 0x0);
+	    /* serious error */
+	    if (ird == -1) return(-1);
+	    /* EOF */
+	    if (ird == 0) break;
+	    az = vi.az;
+	    el = vi.el;
+	} else {
+	    /* read line */
+	    ird = rdline(&file);
+	    /* serious error */
+	    if (ird == -1) return(-1);
+	    /* EOF */
+	    if (ird == 0) break;
+	    /* read angular radius from line */
+	    ird = rdangle(file.line, &next, inunit, &t);
+	    /* error */
+	    if (ird < 1) {
+		/* retry if nothing read, otherwise break */
+		if (nth > 0) break;
+	    /* ok */
+	    } else if (ird == 1) {
+		if (nth >= nthmax) {
+		    if (nthmax == 0) {
+			nthmax = 64;
+		    } else {
+			nthmax *= 2;
+		    }
+		    /* (re)allocate memory for th array */
+		    th = (real_t *) realloc(th, sizeof(real_t) * nthmax);
+		    if (!th) {
+			fprintf(stderr, "ddcount: failed to allocate memory for %d long doubles\n", nthmax);
+			return(-1);
+		    }
 		}
+		/* store th */
+		th[nth] = t;
+		nth++;
 	    }
-	    /* store th */
-	    th[nth] = t;
-	    nth++;
 	}
-    }
 
-    if (file.file != stdin) {
-	/* close th_in_filename */
-	fclose(file.file);
-	/* advise */
-	msg("%d angular radii read from %s\n", nth, file.name);
-    }
+	if (file.file != stdin) {
+	    /* close th_in_filename */
+	    fclose(file.file);
+	    /* advise */
+	    msg("%d angular radii read from %s\n", nth, file.name);
+	}
 
-    if (nth == 0) return(nth);
+	if (nth == 0) return(nth);
 
-    /* open azel_in_filename for reading */
-    if (!azel_in_filename || strcmp(azel_in_filename, "-") == 0) {
-	file.file = stdin;
-	file.name = input;
-    } else {
-	file.file = fopen(azel_in_filename, "r");
-	if (!file.file) {
-	    fprintf(stderr, "cannot open %s for reading\n", azel_in_filename);
-	    return(-1);
+	/* open azel_in_filename for reading */
+	if (!azel_in_filename || strcmp(azel_in_filename, "-") == 0) {
+	    file.file = stdin;
+	    file.name = input;
+	} else {
+	    file.file = fopen(azel_in_filename, "r");
+	    if (!file.file) {
+		fprintf(stderr, "cannot open %s for reading\n", azel_in_filename);
+		return(-1);
+	    }
+	    file.name = azel_in_filename;
+	}
+	file.line_number = 0;
+
+	/* binary input: the header gives the angular units */
+	if (fmt->inazel != 't') {
+	    azelin.name = file.name;
+	    azelin.file = file.file;
+	    azelin.fmt = fmt->inazel;
+	    azelin.unit = fmt->inunit;
+	    ird = rdazel_head(&azelin);
+	    if (ird == -1) return(-1);
+	    if (ird == 1) fmt->inunit = azelin.unit;
 	}
-	file.name = azel_in_filename;
-    }
-    file.line_number = 0;
-
-    /* advise input angular units */
-    msg("will take units of input az, el angles in %s to be ", file.name);
-    switch (fmt->inunit) {
-#include "angunit.h"
-    }
-    msg("\n");
 
-    /* read angular positions az, el from azel_in_filename */
-    nazel = 0;
-    while (1) {
-	/* read line */
-	ird = rdline(&file);
-	/* serious error */
-	if (ird == -1) return(-1);
-	/* EOF */
-	if (ird == 0) break;
-
-	/* read <az> */
-	word = file.line;
-	ird = rdangle(word, &next, fmt->inunit, &az);
-	/* skip header */
-	if (ird != 1 && nazel == 0) continue;
-	/* otherwise exit on unrecognized characters */
-	if (ird != 1) break;
-
-	/* read <el> */
-	word = next;
-	ird = rdangle(word, &next, fmt->inunit, &el);
-	/* skip header */
-	if (ird != 1 && nazel == 0) continue;
-	/* otherwise exit on unrecognized characters */
-	if (ird != 1) break;
+	/* advise input angular units */
+	msg("will take units of input az, el angles in %s to be ", file.name);
+	switch (fmt->inunit) {
+    #include "angunit.h"
+	}
+	msg("\n");
+
+	/* read angular positions az, el from azel_in_filename */
+	nazel = 0;
+	while (1) {
+	    /* read line */
+	    ird = rdline(&file);
+	    /* serious error */
+	    if (ird == -1) return(-1);
+	    /* EOF */
+	    if (ird == 0) break;
+
+	    /* read <az> */
+	    word = file.line;
+	    ird = rdangle(word, &next, fmt->inunit, &az);
+	    /* skip header */
+	    if (ird != 1 && nazel == 0) continue;
+	    /* otherwise exit on unrecognized characters */
+	    if (ird != 1) break;
+
+	    /* read <el> */
+	    word = next;
+	    ird = rdangle(word, &next, fmt->inunit, &el);
+	    /* skip header */
+	    if (ird != 1 && nazel == 0) continue;
+	    /* otherwise exit on unrecognized characters */
+	    if (ird != 1) break;
+	}
 
 	/* (re)allocate memory for array of az-el points */
 	if (nazel >= nazelmax) {
@@ -296,11 +321,12 @@ long ddcount(char *azel_in_filename, char *th_in_filename, char *out_filename, f
 	    fprintf(stderr, "cannot open %s for writing\n", out_filename);
 	    return(-1);
 	}
+	wrbuf(outfile);
 	out_fn = out_filename;
     }
 
     /* (re)allocate memory */
-    cm = (long double *) realloc(dd, sizeof(long double) * nth);
+    cm = (real_t *) realloc(dd, sizeof(real_t) * nth);
     if (!cm) {
 	fprintf(stderr, "ddcount: failed to allocate memory for %d long doubles\n", nth);
 	return(-1);
@@ -425,7 +451,7 @@ long ddcount(char *azel_in_filename, char *th_in_filename, char *out_filename, f
 		fprintf(outfile, "\t%d", dd[ith]);
 	    }
 	    fprintf(outfile, "\n");
-	    fflush(outfile);
+	    if (flush_lines) fflush(outfile);
 	    nid++;
 //printf("\n");
 	}
@@ -433,14 +459,14 @@ long ddcount(char *azel_in_filename, char *th_in_filename, char *out_filename, f
 
 #ifdef TIME
     time = clock() - time;
-    printf("done in %Lg sec\n", (float)time / (float)CLOCKS_PER_SEC);
+    printf("done in %" RL "g sec\n", (float)time / (float)CLOCKS_PER_SEC);
 #else
     msg("\n");
 #endif
 
     /* advise */
     if (outfile != stdout) {
-	fclose(outfile);
+	wrclose(outfile);
 	msg("%d distinct pairs in %d th-bins x %d polygons written to %s\n", np, nth, nid, out_fn);
     }
 
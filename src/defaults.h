@@ -7,15 +7,25 @@
 
 /* maximum harmonic */
 static int lmax = LMAX;
+/* number of harmonic numbers l computed at a time (0 = all) */
+static UNUSED int lblock = 0;
 /* smoothing parameters */
-static long double lsmooth = LSMOOTH, esmooth = ESMOOTH;
+static real_t lsmooth = LSMOOTH, esmooth = ESMOOTH;
+/* tolerance of interpolation in elevation of map */
+static UNUSED real_t eltol = ELTOL;
 
 /* name of file containing harmonics */
 static char *Wlm_filename = 0x0;
 
+/* name of directory in which harmonize keeps the harmonics of each polygon */
+static UNUSED char *harmonic_cache = 0x0;
+
 /* name of survey */
 static char *survey = 0x0;
 
+/* name of file containing table of polygon ids and weights */
+static UNUSED char *idweight_filename = 0x0;
+
 /* option in -f<fopt> command line switch */
 static char *fopt = 0x0;
 
@@ -57,6 +67,8 @@ static format fmt = {
 	0,		/* angular frame of output az, el data */
 	INUNIT,		/* default unit of input az, el data */
 	OUTUNIT,	/* default unit of output az, el data */
+	INAZEL,		/* default format of input az, el data */
+	OUTAZEL,	/* default format of output az, el data */
 	-1,		/* digits after decimal point in output angles (-1 = automatic) */
 	OUTPHASE,	/* '-' or '+' to make output azimuth in interval (-pi, pi] or [0, 2 pi) */
 	AZN,		/* default			       */
@@ -64,6 +76,7 @@ static format fmt = {
 	AZP,		/* 		between angular frames */
 	TRUNIT,		/* unit of transformation angles */
 	0,              /* default number of weights in healpix_weight input file */
+	0,              /* default healpix_weight input file has all pixels */
 	DMETHOD,        /* default method to split up polygons into separate files */
 };
 
@@ -80,31 +93,31 @@ int verbose = 1;
 int infiles = 0;
 
 /* tolerances */
-long double axtol = AXTOL;		/* snap angle for axis */
+real_t axtol = AXTOL;		/* snap angle for axis */
 char axunit = AXUNIT;		/* unit of snap angle for axis */
-long double btol = BTOL;		/* snap angle for latitude */
+real_t btol = BTOL;		/* snap angle for latitude */
 char bunit = BUNIT;		/* unit of snap angle for latitude */
-long double thtol = THTOL;		/* snap angle for edge */
+real_t thtol = THTOL;		/* snap angle for edge */
 char thunit = THUNIT;		/* unit of snap angle for edge */
-long double ytol = YTOL;		/* edge to length tolerance */
-long double mtol = MTOL;		/* tolerance angle for multiple intersections */
+real_t ytol = YTOL;		/* edge to length tolerance */
+real_t mtol = MTOL;		/* tolerance angle for multiple intersections */
 char munit = MUNIT;		/* unit of tolerance angle for multiple intersections */
-long double grow_angle = GROW_ANGLE;		/* angle defining borders to grow around polygons with the grow function */
+real_t grow_angle = GROW_ANGLE;		/* angle defining borders to grow around polygons with the grow function */
 char gunit = GUNIT;		/* unit of grow angle */
 
 /* whether min, max weight are turned on */
 int is_weight_min = 0;
 int is_weight_max = 0;
 /* min, max weight to keep */
-long double weight_min;
-long double weight_max;
+real_t weight_min;
+real_t weight_max;
 
 /* whether min, max area are turned on */
 int is_area_min = 0;
 int is_area_max = 0;
 /* min, max area to keep */
-long double area_min;
-long double area_max;
+real_t area_min;
+real_t area_max;
 
 /* whether min, max id are turned on */
 int is_id_min = 0;
@@ -117,8 +130,8 @@ long long id_max;
 int is_pixel_min = 0;
 int is_pixel_max = 0;
 /* min, max pixel to keep */
-int pixel_min;
-int pixel_max;
+long long pixel_min;
+long long pixel_max;
 
 /* whether to take intersection of polygons in input files */
 int intersect = 0;
@@ -168,6 +181,8 @@ char *frames[] = {
 int res_max=RES_MAX;                  /*maximum resolution allowed for pixelization*/
 int polys_per_pixel=POLYS_PER_PIXEL;  /*level of pixelization: number of polygons allowed per pixel*/
                                       /*set polys_per_pixel=0 to pixelize everything to max resolution*/
+int caps_per_pixel=CAPS_PER_PIXEL;    /*also refine any pixel whose polygons have more than this many caps in total*/
+                                      /*set caps_per_pixel=0 to refine on polygon count alone*/
 char scheme=SCHEME;                   /*default pixelization scheme*/
 int unpixelize=0;                     /*switch for whether unify should unpixelize or not*/
 int pixelized=0;                      /*counter for pixelized input files */
@@ -184,9 +199,15 @@ char bmethod=BMETHOD;
 
 int polyid_weight=0;                     /*0= polyid prints id numbers, 1= polyid prints weights*/
 
+int flush_lines=0;                     /*1= flush output after every line, for interactive use*/
+
 int sliceordice=0;                     /*switch for whether rasterize should return the rasterizer polygons 
 					 with weights averaged over their area (i.e. "dicing" - this is the 
 					 default, with sliceordice=0), or the input mask polygons sliced so 
 					 that each polygon is only in one rasterizer polygon, like in pixelize 
 					 (i.e. "slicing" - set sliceordice=1)*/
+
+int healpix_nside=0;                   /*if > 0, rasterize generates its own HEALPix rasterizer polygons
+					 at this nside, rather than reading them from polygon_infile1,
+					 and harmonize approximates harmonics from the mask rasterized at this nside*/
 int real=REAL;
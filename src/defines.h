@@ -6,6 +6,27 @@
 
 #define	MAXINT		(((unsigned int)-1) / 2)
 
+/*
+  Storage class for static scratch space in library routines,
+  so that each thread gets its own copy, and the routines may be called
+  concurrently from several threads (OpenMP or otherwise).
+*/
+#if defined(__GNUC__) || defined(_OPENMP)
+#define THREADLOCAL	__thread
+#else
+#define THREADLOCAL
+#endif
+
+/*
+  Attribute of option defaults in defaults.h that only some programs use,
+  so that programs which include defaults.h without them compile quietly.
+*/
+#if defined(__GNUC__)
+#define UNUSED		__attribute__((unused))
+#else
+#define UNUSED
+#endif
+
 /* maximum number of polygons */
 /*
   This is the only hard limit built into mangle.
@@ -40,14 +61,27 @@
 #define LSMOOTH		0.
 /* default smoothing exponent (2. = gaussian) */
 #define ESMOOTH		2.
+/* default tolerance of interpolation in elevation of map (0. = exact) */
+#define ELTOL		0.
 /* default snap angles for axis, latitude, and edge */
+/* (the real*8 version cannot resolve angles as fine as the real*10 one) */
+#ifdef REAL8
+#define AXTOL		1.0e-5
+#define BTOL		1.0e-5
+#define THTOL		1.0e-5
+#else
 #define AXTOL		2.0e-9
 #define BTOL		2.0e-9
 #define THTOL		2.0e-9
+#endif
 /* default value of ytol */
 #define YTOL		.01
 /* default snap angle for multiple intersections */
+#ifdef REAL8
+#define MTOL		1.0e-5
+#else
 #define MTOL		1.0e-11
+#endif
 /* default angle for growing the border around a polygon */
 #define GROW_ANGLE     	5.
 /* default input units of snap angles */
@@ -71,6 +105,12 @@
 #define INUNIT		'd'
 /* default output unit of az, el data is degrees */
 #define OUTUNIT		'd'
+/* formats of az, el data: text, binary, FITS */
+#define AZELFMTS	"tbf"
+/* default format of input az, el data is text */
+#define INAZEL		't'
+/* default format of output az, el data is text */
+#define OUTAZEL		't'
 /* default output phase: '-' or '+' to make output azimuth in interval (-pi, pi] or [0, 2 pi) */
 #define	OUTPHASE	'+'
 /* identity transformation between angular frames */
@@ -108,11 +148,17 @@
 #define	DPOLYGON	14
 
 /*list of allowed pixelization schemes*/
-#define SCHEMES		"sd"
+#define SCHEMES		"sdh"
 /*pixelization defaults*/
 #define SCHEME          's'
 #define POLYS_PER_PIXEL  40
 #define RES_MAX          10
+/* maximum total number of caps allowed in each pixel (0 = no limit) */
+#define CAPS_PER_PIXEL   0
+/* highest resolution whose pixel numbers (and those of their children) fit in a long long */
+#define RES_LIMIT        28
+/* maximum resolution of HEALPix-like scheme h: nside = 2^(res-1) = 8192, the largest pix2vec_nest allows */
+#define HEALPIX_RES_LIMIT 14
 
 /*list of balkanize methods */
 #define BMETHODS        "lanx" /*last, add, min, max */
@@ -124,7 +170,11 @@
 /*default balkanize method */
 #define DMETHOD         'i'
 
-/*this is the real*10 version of mangle, so set value of real to 10*/
+/*value of real: 10 for the real*10 version of mangle, 8 for the real*8 version*/
+#ifdef REAL8
+#define REAL 8
+#else
 #define REAL 10
+#endif
 
 #endif	/* DEFINES_H */
@@ -2,11 +2,12 @@
  A J S Hamilton 2001
 ------------------------------------------------------------------------------*/
 #include <stdlib.h>
+#include "real.h"
 
 /*------------------------------------------------------------------------------
-  Random long double in interval [0., 1.)
+  Random real_t in interval [0., 1.)
 */
-long double drandom(void)
+real_t drandom(void)
 {
-    return((long double)random() / ((long double)RAND_MAX + 1.));
+    return((real_t)random() / ((real_t)RAND_MAX + 1.));
 }
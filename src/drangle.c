@@ -9,6 +9,7 @@
 #ifdef TIME
 #include <time.h>
 #endif
+#include "azelfile.h"
 #include "inputfile.h"
 #include "manglefn.h"
 #include "defaults.h"
@@ -18,7 +19,7 @@
 #define OUTUNIT		'r'
 
 /* getopt options */
-const char *optstr = "dqm:hs:e:u:p:i:";
+const char *optstr = "dqm:hs:e:u:p:i:FI:";
 
 /* allocate polygons as a global array */
 polygon *poly_global[NPOLYSMAX];
@@ -148,8 +149,8 @@ int drangle(char *azel_in_filename, char *th_in_filename, char *out_filename, fo
     /* maximum number of angular angular radii: will expand as necessary */
     static int nthmax = 0;
     static int ndrmax = 0;
-    static long double *th = 0x0, *cm = 0x0, *drsum = 0x0;
-    static long double *dr = 0x0;
+    static real_t *th = 0x0, *cm = 0x0, *drsum = 0x0;
+    static real_t *dr = 0x0;
 
 #ifdef TIME
     clock_t time;
@@ -158,8 +159,9 @@ int drangle(char *azel_in_filename, char *th_in_filename, char *out_filename, fo
     char *word, *next;
     char az_str[AZEL_STR_LEN], el_str[AZEL_STR_LEN], th_str[AZEL_STR_LEN], dr_str[AZEL_STR_LEN];
     int ier, ird, ith, len, lenth, np, nt, nth;
-    long double rp[3], s, t;
+    real_t rp[3], s, t;
     azel v;
+    azelfile azelin;
     char *out_fn;
     FILE *outfile;
 
@@ -212,7 +214,7 @@ int drangle(char *azel_in_filename, char *th_in_filename, char *out_filename, fo
 			nthmax *= 2;
 		    }
 		    /* (re)allocate memory for th array */
-		    th = (long double *) realloc(th, sizeof(long double) * nthmax);
+		    th = (real_t *) realloc(th, sizeof(real_t) * nthmax);
 		    if (!th) {
 			fprintf(stderr, "drangle: failed to allocate memory for %d long doubles\n", nthmax);
 			return(-1);
@@ -234,19 +236,19 @@ int drangle(char *azel_in_filename, char *th_in_filename, char *out_filename, fo
 	if (nth == 0) return(nth);
 
 	/* (re)allocate memory for th array */
-	th = (long double *) realloc(th, sizeof(long double) * nth);
+	th = (real_t *) realloc(th, sizeof(real_t) * nth);
 	if (!th) {
 	    fprintf(stderr, "drangle: failed to allocate memory for %d long doubles\n", nth);
 	    return(-1);
 	}
 	/* (re)allocate memory for cm array */
-	cm = (long double *) realloc(cm, sizeof(long double) * nth);
+	cm = (real_t *) realloc(cm, sizeof(real_t) * nth);
 	if (!cm) {
 	    fprintf(stderr, "drangle: failed to allocate memory for %d long doubles\n", nth);
 	    return(-1);
 	}
 	/* (re)allocate memory for drsum array */
-	drsum = (long double *) realloc(drsum, sizeof(long double) * nth);
+	drsum = (real_t *) realloc(drsum, sizeof(real_t) * nth);
 	if (!drsum) {
 	    fprintf(stderr, "drangle: failed to allocate memory for %d long doubles\n", nth);
 	    return(-1);
@@ -268,6 +270,21 @@ int drangle(char *azel_in_filename, char *th_in_filename, char *out_filename, fo
     }
     file.line_number = 0;
 
+    /* binary input: the header gives the angular units */
+    if (fmt->inazel != 't') {
+	if (!th_in_filename) {
+	    fprintf(stderr, "drangle: binary az, el input needs the angular radii th in a separate file\n");
+	    return(-1);
+	}
+	azelin.name = file.name;
+	azelin.file = file.file;
+	azelin.fmt = fmt->inazel;
+	azelin.unit = fmt->inunit;
+	ird = rdazel_head(&azelin);
+	if (ird == -1) return(-1);
+	if (ird == 1) fmt->inunit = azelin.unit;
+    }
+
     /* open out_filename for writing */
     if (!out_filename || strcmp(out_filename, "-") == 0) {
 	outfile = stdout;
@@ -278,6 +295,7 @@ int drangle(char *azel_in_filename, char *th_in_filename, char *out_filename, fo
 	    fprintf(stderr, "cannot open %s for writing\n", out_filename);
 	    return(-1);
 	}
+	wrbuf(outfile);
 	out_fn = out_filename;
     }
 
@@ -360,28 +378,37 @@ int drangle(char *azel_in_filename, char *th_in_filename, char *out_filename, fo
     np = 0;
     nt = 0;
     while (1) {
-	/* read line */
-	ird = rdline(&file);
-	/* serious error */
-	if (ird == -1) return(-1);
-	/* EOF */
-	if (ird == 0) break;
-
-	/* read <az> */
-	word = file.line;
-	ird = rdangle(word, &next, fmt->inunit, &v.az);
-	/* skip header */
-	if (ird != 1 && np == 0) continue;
-	/* otherwise exit on unrecognized characters */
-	if (ird != 1) break;
-
-	/* read <el> */
-	word = next;
-	ird = rdangle(word, &next, fmt->inunit, &v.el);
-	/* skip header */
-	if (ird != 1 && np == 0) continue;
-	/* otherwise exit on unrecognized characters */
-	if (ird != 1) break;
+	if (fmt->inazel != 't') {
+	    /* read binary record */
+	    ird = rdazel(&azelin, &v, 0x0, 0x0);
+	    /* serious error */
+	    if (ird == -1) return(-1);
+	    /* EOF */
+	    if (ird == 0) break;
+	} else {
+	    /* read line */
+	    ird = rdline(&file);
+	    /* serious error */
+	    if (ird == -1) return(-1);
+	    /* EOF */
+	    if (ird == 0) break;
+
+	    /* read <az> */
+	    word = file.line;
+	    ird = rdangle(word, &next, fmt->inunit, &v.az);
+	    /* skip header */
+	    if (ird != 1 && np == 0) continue;
+	    /* otherwise exit on unrecognized characters */
+	    if (ird != 1) break;
+
+	    /* read <el> */
+	    word = next;
+	    ird = rdangle(word, &next, fmt->inunit, &v.el);
+	    /* skip header */
+	    if (ird != 1 && np == 0) continue;
+	    /* otherwise exit on unrecognized characters */
+	    if (ird != 1) break;
+	}
 
 	/* convert az and el from input units to radians */
 	scale_azel(&v, fmt->inunit, 'r');
@@ -401,13 +428,13 @@ int drangle(char *azel_in_filename, char *th_in_filename, char *out_filename, fo
 		    } else {
 			nthmax *= 2;
 		    }
-		    th = (long double *) realloc(th, sizeof(long double) * nthmax);
+		    th = (real_t *) realloc(th, sizeof(real_t) * nthmax);
 		    if (!th) {
 			fprintf(stderr, "drangle: failed to allocate memory for %d long doubles\n", nthmax);
 			return(-1);
 		    }
 		    /* (re)allocate memory for cm array */
-		    cm = (long double *) realloc(cm, sizeof(long double) * nthmax);
+		    cm = (real_t *) realloc(cm, sizeof(real_t) * nthmax);
 		    if (!cm) {
 			fprintf(stderr, "drangle: failed to allocate memory for %d long doubles\n", nthmax);
 			return(-1);
@@ -426,7 +453,7 @@ int drangle(char *azel_in_filename, char *th_in_filename, char *out_filename, fo
 	/* allocate memory for dr */
 	if (nth > ndrmax) {
 	    ndrmax = nth;
-	    dr = (long double *) realloc(dr, sizeof(long double) * ndrmax);
+	    dr = (real_t *) realloc(dr, sizeof(real_t) * ndrmax);
 	    if (!dr) {
 		fprintf(stderr, "drangle: failed to allocate memory for %d long doubles\n", ndrmax);
 		return(-1);
@@ -471,7 +498,7 @@ int drangle(char *azel_in_filename, char *th_in_filename, char *out_filename, fo
 		fprintf(outfile, " %s", dr_str);
 	    }
 	    fprintf(outfile, "\n");
-	    fflush(outfile);
+	    if (flush_lines) fflush(outfile);
 	}
 
         /* increment counters of results */
@@ -494,7 +521,7 @@ int drangle(char *azel_in_filename, char *th_in_filename, char *out_filename, fo
 	    scale(&th[ith], 'r', inunit);
 	    wrangle(th[ith], inunit, fmt->outprecision, AZEL_STR_LEN, th_str);
 	    scale(&drsum[ith], 'r', outunit);
-	    wrangle(drsum[ith] / (long double)np, outunit, fmt->outprecision, AZEL_STR_LEN, dr_str);
+	    wrangle(drsum[ith] / (real_t)np, outunit, fmt->outprecision, AZEL_STR_LEN, dr_str);
 	    fprintf(outfile, "%s %s\n", th_str, dr_str);
 	}
 	fflush(outfile);
@@ -502,7 +529,7 @@ int drangle(char *azel_in_filename, char *th_in_filename, char *out_filename, fo
 	fprintf(outfile, "%*s", 2 * len + 1, "Average:");
 	for (ith = 0; ith < nth; ith++) {
 	    scale(&drsum[ith], 'r', outunit);
-	    wrangle(drsum[ith] / (long double)np, outunit, fmt->outprecision, AZEL_STR_LEN, dr_str);
+	    wrangle(drsum[ith] / (real_t)np, outunit, fmt->outprecision, AZEL_STR_LEN, dr_str);
 	    fprintf(outfile, " %s", dr_str);
 	}
 	fprintf(outfile, "\n");
@@ -516,12 +543,12 @@ int drangle(char *azel_in_filename, char *th_in_filename, char *out_filename, fo
 
 #ifdef TIME
     time = clock() - time;
-    printf("done in %Lg sec\n", (float)time / (float)CLOCKS_PER_SEC);
+    printf("done in %" RL "g sec\n", (float)time / (float)CLOCKS_PER_SEC);
 #endif
 
     /* advise */
     if (outfile != stdout) {
-	fclose(outfile);
+	wrclose(outfile);
 	if (summary) {
 	    msg("drangle: header + %d lines written to %s\n", nth, out_fn);
 	} else {
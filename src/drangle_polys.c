@@ -9,8 +9,8 @@
 
 #define TWOPI		(2. * PI)
 
-static int *iord = 0x0;
-static long double *cmmin = 0x0, *cmmax = 0x0;
+static THREADLOCAL int *iord = 0x0;
+static THREADLOCAL real_t *cmmin = 0x0, *cmmax = 0x0;
 
 /*------------------------------------------------------------------------------
   Minimum and maximum values of cm = 1-cosl(th) between each of npoly polygons
@@ -23,25 +23,25 @@ static long double *cmmin = 0x0, *cmmax = 0x0;
   Return value: number of polygons done;
 		-1 if error.
 */
-int cmlim_polys(int npoly, polygon *poly[/*npoly*/], long double mtol, long double rp[3])
+int cmlim_polys(int npoly, polygon *poly[/*npoly*/], real_t mtol, real_t rp[3])
 {
     int ier, ipoly;
-    long double tol;
+    real_t tol;
 
     /* allocate memory for cmmin, cmmax, iord */
     if (!cmmin) {
-	cmmin = (long double *) malloc(sizeof(long double) * npoly);
+	cmmin = (real_t *) malloc(sizeof(real_t) * npoly);
     } else {
-	cmmin = (long double *) realloc(cmmin, sizeof(long double) * npoly);
+	cmmin = (real_t *) realloc(cmmin, sizeof(real_t) * npoly);
     }
     if (!cmmin) {
 	fprintf(stderr, "cmlim_polys: failed to allocate memory for %d long doubles\n", npoly);
 	return(-1);
     }
     if (!cmmax) {
-	cmmax = (long double *) malloc(sizeof(long double) * npoly);
+	cmmax = (real_t *) malloc(sizeof(real_t) * npoly);
     } else {
-	cmmax = (long double *) realloc(cmmax, sizeof(long double) * npoly);
+	cmmax = (real_t *) realloc(cmmax, sizeof(real_t) * npoly);
     }
     if (!cmmax) {
 	fprintf(stderr, "cmlim_polys: failed to allocate memory for %d long doubles\n", npoly);
@@ -85,10 +85,10 @@ int cmlim_polys(int npoly, polygon *poly[/*npoly*/], long double mtol, long doub
   Return value: number of angular radii done;
 		-1 if error.
 */
-int drangle_polys(int npoly, polygon *poly[/*npoly*/], long double mtol, long double rp[3], int nth, long double cm[/*nth*/], long double dr[/*nth*/])
+int drangle_polys(int npoly, polygon *poly[/*npoly*/], real_t mtol, real_t rp[3], int nth, real_t cm[/*nth*/], real_t dr[/*nth*/])
 {
     int ier, ip, ipoly, ith;
-    long double angle, tol;
+    real_t angle, tol;
 
     /* angle within mask at each angular radius */
     for (ith = 0; ith < nth; ith++) {
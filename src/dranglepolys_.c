@@ -14,7 +14,7 @@ extern polygon *polys[];
       real*8 rp(3)
       call cmlimpolys(mtol, rp)
 */
-void cmlimpolys_(long double *mtol, vec rp)
+void cmlimpolys_(real_t *mtol, vec rp)
 {
     int ndone;
 
@@ -30,7 +30,7 @@ void cmlimpolys_(long double *mtol, vec rp)
       real*8 cm(nth),dr(nth)
       call dranglepolys(mtol, rp, nth, cm, dr)
 */
-void dranglepolys_(long double *mtol, vec rp, int *nth, long double cm[/**nth*/], long double dr[/**nth*/])
+void dranglepolys_(real_t *mtol, vec rp, int *nth, real_t cm[/**nth*/], real_t dr[/**nth*/])
 {
     int ndone;
 
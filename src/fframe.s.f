@@ -2,24 +2,26 @@ c-----------------------------------------------------------------------
 c  A J S Hamilton 2001
 c-----------------------------------------------------------------------
       subroutine fframe(framei,azi,eli,framef,azf,elf)
+#include "real.par"
       integer framei,framef
-      real*10 azi,eli,azf,elf
+      real(KR) azi,eli,azf,elf
 c
 c        parameters
-      real*10 BEPOCH,JEPOCH
-      parameter (BEPOCH=1950._10,JEPOCH=2000._10)
+      real(KR) BEPOCH,JEPOCH
+      parameter (BEPOCH=1950._KR,JEPOCH=2000._KR)
       include 'frames.par'
       include 'radian.par'
 c        externals
-      real*10 felp,SLA_epj2d
+      real(KR) felp,SLA_epj2d
 c        data variables
       logical init
 c        saved local variables
-      real*10 azg,elg,elp,l2z
+      real(KR) azg,elg,elp,l2z
       save azg,elg,elp,l2z
+!$omp threadprivate(init,azg,elg,elp,l2z)
 c        local (automatic) variables
       integer iaz
-      real*10 date,dd,dec2k,dr,ra2k
+      real(KR) date,dd,dec2k,dr,ra2k
 c *
 c * Transform azimuth (phi) and elevation (90-theta) in degrees
 c * from one frame to another frame.
@@ -176,9 +178,9 @@ c         elf=elf*RADIAN
       endif
 c--------put azf in interval [0,360)
 
-      iaz=azf/360._10
-      if (azf.lt.0._10) iaz=iaz-1
-      azf=azf-iaz*360._10
+      iaz=azf/360._KR
+      if (azf.lt.0._KR) iaz=iaz-1
+      azf=azf-iaz*360._KR
 
       return
       end
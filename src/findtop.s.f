@@ -2,8 +2,9 @@ c-----------------------------------------------------------------------
 c  A J S Hamilton 2001
 c-----------------------------------------------------------------------
       subroutine findtop(a,na,iord,nb)
+#include "real.par"
       integer na,nb,iord(nb)
-      real*10 a(na)
+      real(KR) a(na)
 c
 c        local (automatic) variables
       integer i,ia,ib,it,n,ja
@@ -22,8 +23,9 @@ c *
 c
 c-----------------------------------------------------------------------
       subroutine findbot(a,na,iord,nb)
+#include "real.par"
       integer na,nb,iord(nb)
-      real*10 a(na)
+      real(KR) a(na)
 c
 c        local (automatic) variables
       integer i,ia,ib,it,n,ja
@@ -42,8 +44,9 @@ c *
 c
 c-----------------------------------------------------------------------
       subroutine findtpa(a,na,iord,nb)
+#include "real.par"
       integer na,nb,iord(nb)
-      real*10 a(na)
+      real(KR) a(na)
 c
 c        intrinsics
       intrinsic abs
@@ -65,8 +68,9 @@ c *
 c
 c-----------------------------------------------------------------------
       subroutine findbta(a,na,iord,nb)
+#include "real.par"
       integer na,nb,iord(nb)
-      real*10 a(na)
+      real(KR) a(na)
 c
 c        intrinsics
       intrinsic abs
@@ -0,0 +1,557 @@
+/*------------------------------------------------------------------------------
+  Minimal reading and writing of FITS binary tables,
+  enough for tables of numbers without a cfitsio dependency.
+  Files are read and written sequentially, so they can be pipes.
+------------------------------------------------------------------------------*/
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fits.h"
+
+/* maximum number of header cards written, 2 blocks */
+#define MAXCARD		(2 * FITS_BLOCK / FITS_CARD)
+
+/*------------------------------------------------------------------------------
+  Format a header card.
+
+   Input: key = keyword.
+	  value = value, already quoted if a string;
+		  or null for a card without a value, such as END.
+	  comment = comment, or null.
+  Output: card = 80 characters, blank padded, and null terminated.
+*/
+void fits_card(char *card, char *key, char *value, char *comment)
+{
+    int n;
+
+    if (!value) {
+	n = snprintf(card, FITS_CARD + 1, "%-8.8s", key);
+    } else if (value[0] == '\'') {
+	/* strings start in column 11 */
+	n = snprintf(card, FITS_CARD + 1, "%-8.8s= %-20s%s%s", key, value, (comment)? " / " : "", (comment)? comment : "");
+    } else {
+	/* numbers and logicals end in column 30 */
+	n = snprintf(card, FITS_CARD + 1, "%-8.8s= %20s%s%s", key, value, (comment)? " / " : "", (comment)? comment : "");
+    }
+    if (n > FITS_CARD) n = FITS_CARD;
+    for (; n < FITS_CARD; n++) card[n] = ' ';
+    card[FITS_CARD] = '\0';
+}
+
+/*------------------------------------------------------------------------------
+  Write header cards, then END, padded with blanks to a whole block.
+*/
+static int wrfits_cards(FILE *file, int ncard, char card[][FITS_CARD + 1])
+{
+    char end[FITS_CARD + 1];
+    int i, n;
+
+    for (i = 0; i < ncard; i++) {
+	if (fwrite(card[i], 1, FITS_CARD, file) != FITS_CARD) return(-1);
+    }
+    fits_card(end, "END", 0x0, 0x0);
+    if (fwrite(end, 1, FITS_CARD, file) != FITS_CARD) return(-1);
+    n = ((ncard + 1) * FITS_CARD) % FITS_BLOCK;
+    if (n > 0) {
+	for (; n < FITS_BLOCK; n++) {
+	    if (putc(' ', file) == EOF) return(-1);
+	}
+    }
+    return(0);
+}
+
+/*------------------------------------------------------------------------------
+  Write an empty primary header, which must precede the binary table.
+
+  Return value: 0 = ok;
+		-1 = error.
+*/
+int wrfits_primary(FILE *file)
+{
+    char card[4][FITS_CARD + 1];
+
+    fits_card(card[0], "SIMPLE", "T", "file conforms to FITS standard");
+    fits_card(card[1], "BITPIX", "8", 0x0);
+    fits_card(card[2], "NAXIS", "0", "no primary data");
+    fits_card(card[3], "EXTEND", "T", "binary table follows");
+    return(wrfits_cards(file, 4, card));
+}
+
+/*------------------------------------------------------------------------------
+  Write the header of a binary table of scalar columns.
+  The header has the same length whatever nrows is, so it can be rewritten
+  in place once the number of rows is known.
+
+   Input: nrows = number of rows.
+	  ncol = number of columns.
+	  ttype, tform, tunit = names, formats and units of columns;
+		  tunit may be null, as may any of its elements.
+	  ncard = number of extra header cards, as formatted by fits_card.
+	  card = extra header cards.
+  Return value: 0 = ok;
+		-1 = error.
+*/
+int wrfits_table(FILE *file, long long nrows, int ncol, char *ttype[], char *tform[], char *tunit[], int ncard, char extra[][FITS_CARD + 1])
+{
+    char card[MAXCARD][FITS_CARD + 1];
+    char key[16], value[FITS_STRLEN + 3];
+    int i, n, rowlen;
+
+    if (8 + 3 * ncol + ncard >= MAXCARD) {
+	fprintf(stderr, "wrfits_table: too many header cards\n");
+	return(-1);
+    }
+
+    /* length of row */
+    rowlen = 0;
+    for (i = 0; i < ncol; i++) {
+	switch (tform[i][strlen(tform[i]) - 1]) {
+	case 'B':	rowlen += 1;	break;
+	case 'I':	rowlen += 2;	break;
+	case 'J':
+	case 'E':	rowlen += 4;	break;
+	default:	rowlen += 8;	break;
+	}
+    }
+
+    n = 0;
+    fits_card(card[n++], "XTENSION", "'BINTABLE'", "binary table extension");
+    fits_card(card[n++], "BITPIX", "8", 0x0);
+    fits_card(card[n++], "NAXIS", "2", 0x0);
+    sprintf(value, "%d", rowlen);
+    fits_card(card[n++], "NAXIS1", value, "bytes per row");
+    sprintf(value, "%lld", nrows);
+    fits_card(card[n++], "NAXIS2", value, "number of rows");
+    fits_card(card[n++], "PCOUNT", "0", 0x0);
+    fits_card(card[n++], "GCOUNT", "1", 0x0);
+    sprintf(value, "%d", ncol);
+    fits_card(card[n++], "TFIELDS", value, "number of columns");
+    for (i = 0; i < ncol; i++) {
+	sprintf(key, "TTYPE%d", i + 1);
+	sprintf(value, "'%-8.*s'", FITS_STRLEN - 2, ttype[i]);
+	fits_card(card[n++], key, value, 0x0);
+	sprintf(key, "TFORM%d", i + 1);
+	sprintf(value, "'%-8.*s'", FITS_STRLEN - 2, tform[i]);
+	fits_card(card[n++], key, value, 0x0);
+	if (tunit && tunit[i]) {
+	    sprintf(key, "TUNIT%d", i + 1);
+	    sprintf(value, "'%-8.*s'", FITS_STRLEN - 2, tunit[i]);
+	    fits_card(card[n++], key, value, 0x0);
+	}
+    }
+    for (i = 0; i < ncard; i++) strcpy(card[n++], extra[i]);
+
+    return(wrfits_cards(file, n, card));
+}
+
+/*------------------------------------------------------------------------------
+  Pad the data of a binary table with zeros to a whole block.
+
+   Input: nbytes = number of bytes of data written.
+  Return value: 0 = ok;
+		-1 = error.
+*/
+int wrfits_end(FILE *file, long long nbytes)
+{
+    int n;
+
+    n = nbytes % FITS_BLOCK;
+    if (n > 0) {
+	for (; n < FITS_BLOCK; n++) {
+	    if (putc('\0', file) == EOF) return(-1);
+	}
+    }
+    return(0);
+}
+
+/*------------------------------------------------------------------------------
+  Skip nbytes of file, by reading, so that pipes work.
+*/
+static int skip(FILE *file, long long nbytes)
+{
+    char buf[FITS_BLOCK];
+    size_t n;
+
+    while (nbytes > 0) {
+	n = (nbytes > FITS_BLOCK)? FITS_BLOCK : nbytes;
+	if (fread(buf, 1, n, file) != n) return(-1);
+	nbytes -= n;
+    }
+    return(0);
+}
+
+/*------------------------------------------------------------------------------
+  Split header card into keyword and value.
+  String values are unquoted and stripped of trailing blanks.
+*/
+static void parse_card(char *card, char *key, char *value)
+{
+    char *ch;
+    int i, n;
+
+    for (i = 0; i < 8 && card[i] != ' '; i++) key[i] = card[i];
+    key[i] = '\0';
+
+    value[0] = '\0';
+    if (card[8] != '=' || card[9] != ' ') return;
+    ch = &card[10];
+    while (ch < card + FITS_CARD && *ch == ' ') ch++;
+    n = 0;
+    if (*ch == '\'') {
+	for (ch++; ch < card + FITS_CARD && n < FITS_STRLEN - 1; ch++) {
+	    if (*ch == '\'') {
+		/* '' is a quote within the string */
+		if (ch + 1 < card + FITS_CARD && ch[1] == '\'') {
+		    ch++;
+		} else {
+		    break;
+		}
+	    }
+	    value[n++] = *ch;
+	}
+	while (n > 0 && value[n - 1] == ' ') n--;
+    } else {
+	for (; ch < card + FITS_CARD && *ch != ' ' && *ch != '/' && n < FITS_STRLEN - 1; ch++) {
+	    value[n++] = *ch;
+	}
+    }
+    value[n] = '\0';
+}
+
+/*------------------------------------------------------------------------------
+  Parse the value of a TZEROn card, exactly if it is an integer.
+*/
+static void parse_zero(char *value, fitscol *col)
+{
+    char *ch;
+
+    col->zero = strtod(value, &ch);
+    errno = 0;
+    col->izero = strtoll(value, &ch, 10);
+    col->zint = (errno == 0 && ch != value && *ch == '\0');
+    if (!col->zint && col->zero == (double)(long long)col->zero
+	&& col->zero > (double)LLONG_MIN && col->zero < (double)LLONG_MAX) {
+	/* integer written as real, eg 32768.0 */
+	col->izero = (long long)col->zero;
+	col->zint = 1;
+    }
+}
+
+static int rd_table(FILE *file, char *name, fitstable *table)
+{
+    char card[FITS_CARD], key[9], value[FITS_STRLEN];
+    char *ch;
+    int bintable, bitpix, i, icard, ihdu, naxis, ncol, rowlen, width;
+    long long axis, gcount, nbytes, pcount;
+
+    for (ihdu = 0; ; ihdu++) {
+	bintable = 0;
+	bitpix = 8;
+	naxis = 0;
+	nbytes = 1;
+	pcount = 0;
+	gcount = 1;
+	ncol = 0;
+	rowlen = 0;
+	table->nrows = 0;
+
+	/* read header, to END */
+	for (icard = 0; ; icard++) {
+	    i = fread(card, 1, FITS_CARD, file);
+	    if (i == 0 && ihdu == 0 && icard == 0) return(0);
+	    if (i != FITS_CARD) {
+		fprintf(stderr, "rdfits_table: unexpected end of %s\n", name);
+		return(-1);
+	    }
+	    parse_card(card, key, value);
+	    if (icard == 0) {
+		if ((ihdu == 0 && strcmp(key, "SIMPLE") != 0) || (ihdu > 0 && strcmp(key, "XTENSION") != 0)) {
+		    fprintf(stderr, "rdfits_table: %s is not a FITS file\n", name);
+		    return(-1);
+		}
+		if (ihdu > 0 && strcmp(value, "BINTABLE") == 0) bintable = 1;
+	    }
+	    if (strcmp(key, "END") == 0) break;
+	    if (strcmp(key, "BITPIX") == 0) {
+		bitpix = atoi(value);
+	    } else if (strcmp(key, "NAXIS") == 0) {
+		naxis = atoi(value);
+	    } else if (strncmp(key, "NAXIS", 5) == 0) {
+		axis = atoll(&key[5]);
+		if (axis >= 1 && axis <= naxis) {
+		    nbytes *= atoll(value);
+		    if (axis == 1) rowlen = atoi(value);
+		    if (axis == 2) table->nrows = atoll(value);
+		}
+	    } else if (strcmp(key, "PCOUNT") == 0) {
+		pcount = atoll(value);
+	    } else if (strcmp(key, "GCOUNT") == 0) {
+		gcount = atoll(value);
+	    } else if (bintable && strcmp(key, "TFIELDS") == 0) {
+		free_fits_table(table);
+		ncol = atoi(value);
+		if (ncol <= 0) continue;
+		table->col = (fitscol *) calloc(ncol, sizeof(fitscol));
+		if (!table->col) {
+		    fprintf(stderr, "rdfits_table: failed to allocate memory for %d columns\n", ncol);
+		    return(-1);
+		}
+		for (i = 0; i < ncol; i++) {
+		    table->col[i].scale = 1.;
+		    table->col[i].zint = 1;
+		}
+	    } else if (bintable && table->col
+		&& (strncmp(key, "TTYPE", 5) == 0 || strncmp(key, "TFORM", 5) == 0 || strncmp(key, "TUNIT", 5) == 0
+		|| strncmp(key, "TSCAL", 5) == 0 || strncmp(key, "TZERO", 5) == 0 || strncmp(key, "TNULL", 5) == 0)) {
+		i = atoi(&key[5]) - 1;
+		if (i < 0 || i >= ncol) continue;
+		if (key[1] == 'T') {
+		    strcpy(table->col[i].name, value);
+		} else if (key[1] == 'U') {
+		    strcpy(table->col[i].unit, value);
+		} else if (key[1] == 'S') {
+		    table->col[i].scale = atof(value);
+		} else if (key[1] == 'Z') {
+		    parse_zero(value, &table->col[i]);
+		} else if (key[1] == 'N') {
+		    table->col[i].null = atoll(value);
+		    table->col[i].hasnull = 1;
+		} else {
+		    table->col[i].repeat = strtol(value, &ch, 10);
+		    if (ch == value) table->col[i].repeat = 1;
+		    table->col[i].form = *ch;
+		}
+	    }
+	}
+	/* the header is padded to a whole block */
+	if (skip(file, (FITS_BLOCK - ((icard + 1) * FITS_CARD) % FITS_BLOCK) % FITS_BLOCK) == -1) {
+	    fprintf(stderr, "rdfits_table: unexpected end of %s\n", name);
+	    return(-1);
+	}
+
+	if (bintable) break;
+
+	/* skip data of this HDU */
+	if (naxis == 0) nbytes = 0;
+	nbytes = (bitpix < 0 ? -bitpix : bitpix) / 8 * gcount * (pcount + nbytes);
+	nbytes = (nbytes + FITS_BLOCK - 1) / FITS_BLOCK * FITS_BLOCK;
+	if (skip(file, nbytes) == -1) {
+	    fprintf(stderr, "rdfits_table: no binary table in %s\n", name);
+	    return(-1);
+	}
+    }
+
+    /* offsets of columns */
+    table->ncol = ncol;
+    table->rowlen = rowlen;
+    width = 0;
+    for (i = 0; i < ncol; i++) {
+	table->col[i].offset = width;
+	switch (table->col[i].form) {
+	case 'L':
+	case 'B':
+	case 'A':	width += table->col[i].repeat;		break;
+	case 'X':	width += (table->col[i].repeat + 7) / 8;	break;
+	case 'I':	width += 2 * table->col[i].repeat;	break;
+	case 'J':
+	case 'E':	width += 4 * table->col[i].repeat;	break;
+	case 'K':
+	case 'D':
+	case 'C':
+	case 'P':	width += 8 * table->col[i].repeat;	break;
+	case 'M':
+	case 'Q':	width += 16 * table->col[i].repeat;	break;
+	default:
+	    fprintf(stderr, "rdfits_table: column %d of %s has unknown format %c\n", i + 1, name, table->col[i].form);
+	    return(-1);
+	}
+    }
+    if (width != rowlen) {
+	fprintf(stderr, "rdfits_table: columns of %s add up to %d bytes, but rows are %d bytes\n", name, width, rowlen);
+	return(-1);
+    }
+
+    return(1);
+}
+
+/*------------------------------------------------------------------------------
+  Read the first binary table of a FITS file, skipping the primary array
+  and any other extensions before it.  On return, file is positioned at
+  the first row of the table.
+
+   Input: file = FITS file.
+	  name = name of file, for messages.
+  Output: table = layout of table; table->col is allocated here,
+		  and should be freed with free_fits_table.
+  Return value: 1 = ok;
+		0 = empty file;
+		-1 = error.
+*/
+int rdfits_table(FILE *file, char *name, fitstable *table)
+{
+    int ier;
+
+    table->col = 0x0;
+    ier = rd_table(file, name, table);
+    if (ier == -1) free_fits_table(table);
+    return(ier);
+}
+
+/*------------------------------------------------------------------------------
+  Free the columns of a table read by rdfits_table.
+  Safe to call more than once.
+*/
+void free_fits_table(fitstable *table)
+{
+    if (table->col) free(table->col);
+    table->col = 0x0;
+    table->ncol = 0;
+}
+
+/*------------------------------------------------------------------------------
+  Find a numeric scalar column of a binary table by name, case insensitively.
+
+   Input: table = binary table.
+	  names = null-terminated list of acceptable names.
+  Return value: index of column,
+		or -1 if there is none.
+*/
+int fits_column(fitstable *table, char *names[])
+{
+    int i, j, k;
+
+    for (j = 0; names[j]; j++) {
+	for (i = 0; i < table->ncol; i++) {
+	    if (table->col[i].repeat != 1 || !strchr("BIJKED", table->col[i].form)) continue;
+	    for (k = 0; names[j][k] && table->col[i].name[k]; k++) {
+		if ((names[j][k] | 0x20) != (table->col[i].name[k] | 0x20)) break;
+	    }
+	    if (!names[j][k] && !table->col[i].name[k]) return(i);
+	}
+    }
+    return(-1);
+}
+
+/*------------------------------------------------------------------------------
+  Big-endian conversions.
+*/
+void fits_putk(unsigned char *p, long long k)
+{
+    unsigned long long u;
+    int i;
+
+    u = k;
+    for (i = 7; i >= 0; i--) {
+	p[i] = u & 0xff;
+	u >>= 8;
+    }
+}
+
+void fits_putd(unsigned char *p, double x)
+{
+    long long k;
+
+    memcpy(&k, &x, 8);
+    fits_putk(p, k);
+}
+
+/* integer of width n bytes, sign extended */
+static long long getint(unsigned char *p, int n)
+{
+    unsigned long long u;
+    int i;
+
+    u = (p[0] & 0x80)? ~0ULL : 0;
+    for (i = 0; i < n; i++) u = (u << 8) | p[i];
+    return((long long)u);
+}
+
+/* stored value of an integer column */
+static long long getraw(unsigned char *p, char form)
+{
+    switch (form) {
+    case 'B':	return(p[0]);
+    case 'I':	return(getint(p, 2));
+    case 'J':	return(getint(p, 4));
+    default:	return(getint(p, 8));
+    }
+}
+
+/*------------------------------------------------------------------------------
+  Get the value of a numeric column of a row, applying TSCALn and TZEROn.
+
+   Input: p = start of column in row.
+	  col = column.
+  Output: *d = value.
+  Return value: 0 = ok;
+		1 = value is undefined (TNULLn, or NaN).
+*/
+int fits_getd(unsigned char *p, fitscol *col, double *d)
+{
+    float f;
+    long long k;
+    int j;
+
+    switch (col->form) {
+    case 'D':
+	k = getint(p, 8);
+	memcpy(d, &k, 8);
+	break;
+    case 'E':
+	j = getint(p, 4);
+	memcpy(&f, &j, 4);
+	*d = f;
+	break;
+    default:
+	k = getraw(p, col->form);
+	if (col->hasnull && k == col->null) return(1);
+	*d = k;
+	break;
+    }
+    if (*d != *d) return(1);
+    *d = col->zero + col->scale * *d;
+    return(0);
+}
+
+/*------------------------------------------------------------------------------
+  Get the value of an integer column of a row exactly, applying TZEROn.
+  Integer columns whose TSCALn is not 1, or whose TZEROn is not an integer,
+  and real columns, are read through fits_getd.
+
+   Input: p = start of column in row.
+	  col = column.
+  Output: *k = value.
+  Return value: 0 = ok;
+		1 = value is undefined (TNULLn, or NaN);
+		-1 = value is not an integer that fits in a long long.
+*/
+int fits_getk(unsigned char *p, fitscol *col, long long *k)
+{
+    double d;
+    unsigned long long u;
+    int ier;
+
+    if (strchr("BIJK", col->form) && col->scale == 1. && col->zint) {
+	*k = getraw(p, col->form);
+	if (col->hasnull && *k == col->null) return(1);
+	if ((col->izero > 0 && *k > LLONG_MAX - col->izero)
+	    || (col->izero < 0 && *k < LLONG_MIN - col->izero)) return(-1);
+	*k += col->izero;
+	return(0);
+    }
+    /* unsigned 64 bit integers */
+    if (col->form == 'K' && col->scale == 1. && col->zero == 9223372036854775808.) {
+	u = (unsigned long long)getraw(p, col->form) + (1ULL << 63);
+	if (col->hasnull && getraw(p, col->form) == col->null) return(1);
+	if (u > (unsigned long long)LLONG_MAX) return(-1);
+	*k = (long long)u;
+	return(0);
+    }
+    ier = fits_getd(p, col, &d);
+    if (ier) return(ier);
+    if (d != (double)(long long)d || d <= (double)LLONG_MIN || d >= (double)LLONG_MAX) return(-1);
+    *k = (long long)d;
+    return(0);
+}
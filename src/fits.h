@@ -0,0 +1,48 @@
+/*------------------------------------------------------------------------------
+  Minimal FITS binary tables.
+------------------------------------------------------------------------------*/
+#ifndef FITS_H
+#define FITS_H
+
+#include <stdio.h>
+
+/* FITS files come in blocks of 2880 bytes, of 36 80-character header cards */
+#define FITS_BLOCK	2880
+#define FITS_CARD	80
+/* maximum length of a string value */
+#define FITS_STRLEN	72
+
+typedef struct {		/* column of FITS binary table */
+    char name[FITS_STRLEN];	/* TTYPEn */
+    char unit[FITS_STRLEN];	/* TUNITn */
+    char form;			/* data type letter of TFORMn */
+    int repeat;			/* repeat count of TFORMn */
+    int offset;			/* byte offset of column in row */
+    double scale;		/* TSCALn, default 1 */
+    double zero;		/* TZEROn, default 0 */
+    long long izero;		/* TZEROn, if zint */
+    int zint;			/* whether TZEROn is an integer that fits in izero */
+    int hasnull;		/* whether TNULLn is given */
+    long long null;		/* TNULLn, undefined value of an integer column */
+} fitscol;
+
+typedef struct {		/* FITS binary table */
+    long long nrows;		/* NAXIS2 */
+    int rowlen;			/* NAXIS1 */
+    int ncol;			/* TFIELDS */
+    fitscol *col;		/* array col[ncol] of columns */
+} fitstable;
+
+void	fits_card(char *, char *, char *, char *);
+int	wrfits_primary(FILE *);
+int	wrfits_table(FILE *, long long, int, char *[], char *[], char *[], int, char [][FITS_CARD + 1]);
+int	wrfits_end(FILE *, long long);
+int	rdfits_table(FILE *, char *, fitstable *);
+void	free_fits_table(fitstable *);
+int	fits_column(fitstable *, char *[]);
+void	fits_putd(unsigned char *, double);
+void	fits_putk(unsigned char *, long long);
+int	fits_getd(unsigned char *, fitscol *, double *);
+int	fits_getk(unsigned char *, fitscol *, long long *);
+
+#endif	/* FITS_H */
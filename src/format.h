@@ -5,6 +5,7 @@
 #define FORMAT_H
 
 #include <stdio.h>
+#include "real.h"
 
 /*
   Structure defining format of data.
@@ -26,22 +27,25 @@ typedef struct {
     long long id;		/* id number of current polygon */
     char newid;		/* whether to use old or new id number */
     long long idstart;          /* new id number to use for first polygon in file*/
-    int pixel;          /* pixel that current polygon is in */ 
-    long double weight;	/* weight of current polygon */
+    long long pixel;    /* pixel that current polygon is in */ 
+    real_t weight;	/* weight of current polygon */
     char inunitp;	/* angular units of input polygon data */
     char outunitp;	/* angular units of output polygon data */
     int inframe;	/* angular frame of input az, el data */
     int outframe;	/* angular frame of output az, el data */
     char inunit;	/* angular units of input az, el data */
     char outunit;	/* angular units of output az, el data */
+    char inazel;	/* format of input az, el data: t text, b binary */
+    char outazel;	/* format of output az, el data: t text, b binary */
     int outprecision;	/* digits after decimal point in output angles */
     char outphase;	/* '-' or '+' to make output azimuth in interval (-pi, pi] or [0, 2 pi) */
-    long double azn;		/* azimuth of new pole wrt original frame */
-    long double eln;		/* elevation of new pole wrt original frame
+    real_t azn;		/* azimuth of new pole wrt original frame */
+    real_t eln;		/* elevation of new pole wrt original frame
 			 = elevation of original pole wrt new frame */
-    long double azp;		/* azimuth of original pole wrt new frame */
+    real_t azp;		/* azimuth of original pole wrt new frame */
     char trunit;	/* angular units of transformation angles */
     int nweights;       /* the total number of weights/polygons, for use with healpix_weight input files and rasterize */ 
+    int nside;          /* HEALPix nside of sparse healpix_weight input file, 0 if it has all pixels */
     char dmethod;         /* for distributed polygon output file, define id to use for splitting into separate files */
 } format;
 
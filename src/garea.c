@@ -3,12 +3,70 @@
 ------------------------------------------------------------------------------*/
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <float.h>
 #include "logical.h"
 #include "manglefn.h"
 
 /* number of extra caps to allocate to polygon, to allow for expansion */
 #define DNP		4
 
+/* number of significant bytes in a real_t (x87 extended has 6 bytes of padding) */
+#if !defined(REAL8) && LDBL_MANT_DIG == 64
+#define REAL_BYTES	10
+#else
+#define REAL_BYTES	sizeof(real_t)
+#endif
+
+/*------------------------------------------------------------------------------
+  Mix a real_t, bit for bit, into fingerprint h.
+*/
+static unsigned long long key_mix(unsigned long long h, real_t x)
+{
+    unsigned char b[sizeof(real_t)];
+    unsigned long long w;
+    size_t i, n;
+
+    memcpy(b, &x, sizeof(real_t));
+    for (i = 0; i < REAL_BYTES; i += n) {
+	n = (REAL_BYTES - i < sizeof(w))? REAL_BYTES - i : sizeof(w);
+	w = 0;
+	memcpy(&w, b + i, n);
+	h ^= w + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+	h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+	h ^= h >> 31;
+    }
+    return(h);
+}
+
+/*------------------------------------------------------------------------------
+  Fingerprint of the caps of a polygon and of a tolerance,
+  as a key to results computed from the polygon and kept elsewhere.
+  Return value: fingerprint, never 0.
+*/
+unsigned long long poly_key(polygon *poly, real_t tol)
+{
+    int i, ip;
+    unsigned long long h;
+
+    h = (unsigned long long)poly->np;
+    h = key_mix(h, tol);
+    for (ip = 0; ip < poly->np; ip++) {
+	for (i = 0; i < 3; i++) h = key_mix(h, poly->rp[ip][i]);
+	h = key_mix(h, poly->cm[ip]);
+    }
+    return((h == 0)? 1 : h);
+}
+
+/*------------------------------------------------------------------------------
+  Whether two real_t are the same, bit for bit.
+*/
+static int same_real(real_t x, real_t y)
+{
+    return(memcmp(&x, &y, REAL_BYTES) == 0);
+}
+
 /*------------------------------------------------------------------------------
   Area of polygon.
 
@@ -22,16 +80,27 @@
   Return value:  0 if ok;
 		 1 if fatal error;
 		-1 if failed to allocate memory.
+
+  If poly holds an area kept by poly_area for the same *tol,
+  that area is returned without recomputation.
+  garea itself never writes to poly.
 */
-int garea(polygon *poly, long double *tol, int verb, long double *area)
+int garea(polygon *poly, real_t *tol, int verb, real_t *area)
 {
-    static polygon *dpoly = 0x0;
+    static THREADLOCAL polygon *dpoly = 0x0;
     logical ldegen;
     int ier, ipmin, ipoly, np;
-    long double cmmin, darea;
+    real_t cmmin, darea;
     /* work arrays */
     int *iord;
-    long double *phi;
+    real_t *phi;
+
+    /* area already kept for these caps at this tolerance */
+    if (poly->areaok && same_real(poly->areatolin, *tol)) {
+	*area = poly->area;
+	*tol = poly->areatol;
+	return(0);
+    }
 
     /* smallest cap of polygon */
     cmminf(poly, &ipmin, &cmmin);
@@ -45,7 +114,7 @@ int garea(polygon *poly, long double *tol, int verb, long double *area)
 	fprintf(stderr, "garea: failed to allocate memory for %d ints\n", np * 2);
 	return(-1);
     }
-    phi = (long double *) malloc(sizeof(long double) * np * 2);
+    phi = (real_t *) malloc(sizeof(real_t) * np * 2);
     if (!phi) {
 	fprintf(stderr, "garea: failed to allocate memory for %d long doubles\n", np * 2);
 	return(-1);
@@ -96,8 +165,34 @@ int garea(polygon *poly, long double *tol, int verb, long double *area)
 
     /* fatal error */
     if (ldegen){
-      fprintf(stderr,"garea: fatal error in polygon %lld, pixel %d\n", poly->id,poly->pixel);
+      fprintf(stderr,"garea: fatal error in polygon %lld, pixel %lld\n", poly->id,poly->pixel);
       return(1);
     }
+
+    return(0);
+}
+
+/*------------------------------------------------------------------------------
+  Area of polygon, kept in the polygon.
+
+  Same as garea, but the area is also kept in poly, so later calls
+  to garea or poly_area with the same *tol return it at once.
+  Only the owner of poly should call this; editing the caps of poly
+  afterwards must clear poly->areaok.
+*/
+int poly_area(polygon *poly, real_t *tol, int verb, real_t *area)
+{
+    int ier;
+    real_t tolin;
+
+    tolin = *tol;
+    ier = garea(poly, tol, verb, area);
+    if (ier) return(ier);
+
+    poly->area = *area;
+    poly->areatolin = tolin;
+    poly->areatol = *tol;
+    poly->areaok = 1;
+
     return(0);
 }
@@ -18,11 +18,11 @@
   Return value:  0 if ok;
 		-1 if failed to allocate memory.
 */
-int gcmlim(polygon *poly, long double *tol, vec rp, long double *cmmin, long double *cmmax)
+int gcmlim(polygon *poly, real_t *tol, vec rp, real_t *cmmin, real_t *cmmax)
 {
     /* work arrays */
     int *iord;
-    long double *phi;
+    real_t *phi;
 
     /* allocate memory for work arrays */
     iord = (int *) malloc(sizeof(int) * poly->np * 2);
@@ -30,7 +30,7 @@ int gcmlim(polygon *poly, long double *tol, vec rp, long double *cmmin, long dou
 	fprintf(stderr, "gcmlim: failed to allocate memory for %d ints\n", poly->np * 2);
 	return(-1);
     }
-    phi = (long double *) malloc(sizeof(long double) * poly->np * 2);
+    phi = (real_t *) malloc(sizeof(real_t) * poly->np * 2);
     if (!phi) {
 	fprintf(stderr, "gcmlim: failed to allocate memory for %d long doubles\n", poly->np * 2);
 	return(-1);
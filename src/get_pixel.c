@@ -15,16 +15,17 @@
    returns pointer to polygon containing pixel, or 0x0 if an error occurs
 */
 
-polygon *get_pixel(int pix, char scheme){
-  int m,n,res,base_pix,i,ier,pix_c[4];
-  long double azmax, azmin, elmax, elmin;
-  long double lammin, lammax, etamin, etamax;
-  long double angle[4], lammin_c[4], lammax_c[4], etamin_c[4], etamax_c[4];
+polygon *get_pixel(long long pix, char scheme){
+  int res,i,ier;
+  long long m,n,base_pix,pix_c[4];
+  real_t azmax, azmin, elmax, elmin;
+  real_t lammin, lammax, etamin, etamax;
+  real_t angle[4], lammin_c[4], lammax_c[4], etamin_c[4], etamax_c[4];
   azel v[4],v_r[4];
   polygon *pixel;
   
   if(pix<0){
-    fprintf(stderr, "error in get_pixel: %d not a valid pixel number.\n", pix);
+    fprintf(stderr, "error in get_pixel: %lld not a valid pixel number.\n", pix);
     return(0x0);
   }
 
@@ -39,8 +40,8 @@ polygon *get_pixel(int pix, char scheme){
   
     base_pix=pix-pixel_start(res,scheme);
    
-    m=base_pix % (int)(powl(2,res));
-    n=(base_pix-m)/powl(2,res);
+    m=base_pix & ((1LL<<res)-1);
+    n=base_pix >> res;
     azmin=TWOPI/powl(2,res)*m;
     azmax=TWOPI/powl(2,res)*(m+1);
     elmin=asinl(1-2.0/powl(2,res)*(n+1));
@@ -68,6 +69,26 @@ polygon *get_pixel(int pix, char scheme){
     return(pixel);
     
   }
+  else if(scheme=='h'){
+    // this is a HEALPix-like NESTED scheme, with nside=2^(res-1).  Pixel 0 is the whole sky,
+    // pixels 1-12 are the 12 base pixels (resolution 1), and NESTED pixel hpix
+    // of resolution res is pixel pixel_start(res)+hpix = 4^res-3+hpix.
+    // The pixel polygons nest exactly and have equal areas, but are not the HEALPix
+    // pixels beyond the lowest resolutions; see healpix_nest_caps.
+
+    pixel=new_poly(5+2*(res-1));
+    if (!pixel) {
+      fprintf(stderr, "error in get_pixel: failed to allocate memory for polygon of %d caps\n", 5+2*(res-1));
+      return(0x0);
+    }
+    pixel->np=(res==0)? 0 : healpix_nest_caps(res, (int)(pix-pixel_start(res,scheme)), pixel->rp, pixel->cm);
+    pixel->areaok=0;
+    pixel->id=0;
+    pixel->pixel=pix;
+    pixel->weight=1.;
+
+    return(pixel);
+  }
   else if(scheme=='d'){
     //this is the SDSSPix pixelization scheme; see http://lahmu.phyast.pitt.edu/~scranton/SDSSPix/
     //for more details
@@ -225,18 +246,83 @@ polygon *get_pixel(int pix, char scheme){
    returns 0 on success, 1 if an error occurs
 */
 
-int get_child_pixels(int pix_p, int pix_c[], char scheme){
-  int mp,np,res,base_pix,i;
+/* cache of pixel polygons, indexed by pixel number modulo PIXEL_CACHE */
+#define PIXEL_CACHE	4096
+typedef struct {
+  long long pix;
+  char scheme;
+  polygon *poly;
+} cached_pixel;
+static THREADLOCAL cached_pixel pixel_cache[PIXEL_CACHE];
+
+/* Function pixel_poly returns the polygon of a pixel, as get_pixel does, but from a cache,
+   so that pixel boundaries are computed once rather than every time they are needed.
+   A pixel of scheme h whose parent is in the cache is built by adding 2 caps to the
+   parent, rather than from scratch.
+   The polygon belongs to the cache: it must not be modified or freed, and is valid
+   only until the next call to pixel_poly.
+   inputs:
+   pix: pixel number
+   scheme: pixelization scheme
+   returns pointer to polygon of pixel, or 0x0 if an error occurs
+*/
+
+polygon *pixel_poly(long long pix, char scheme){
+  int np, res;
+  long long parent;
+  cached_pixel *c, *p;
+  polygon *pixel;
+
+  c=&pixel_cache[pix & (PIXEL_CACHE-1)];
+  if(c->poly && c->pix==pix && c->scheme==scheme) return(c->poly);
+
+  pixel=0x0;
+  if(scheme=='h' && pix>=pixel_start(2,scheme)){
+    // the parent of q=pix+3 is q/4
+    parent=((pix+3)>>2)-3;
+    p=&pixel_cache[parent & (PIXEL_CACHE-1)];
+    if(p->poly && p->pix==parent && p->scheme==scheme){
+      res=get_res(pix,scheme);
+      np=p->poly->np;
+      pixel=new_poly(np+2);
+      if (!pixel) {
+	fprintf(stderr, "error in pixel_poly: failed to allocate memory for polygon of %d caps\n", np+2);
+	return(0x0);
+      }
+      copy_poly(p->poly,pixel);
+      healpix_child_caps(res, (int)(pix-pixel_start(res,scheme)), &pixel->rp[np], &pixel->cm[np]);
+      pixel->np=np+2;
+      pixel->areaok=0;
+      pixel->pixel=pix;
+    }
+  }
+  if(!pixel) pixel=get_pixel(pix,scheme);
+  if(!pixel) return(0x0);
+
+  if(c->poly) free_poly(c->poly);
+  c->pix=pix;
+  c->scheme=scheme;
+  c->poly=pixel;
+  return(pixel);
+}
+
+int get_child_pixels(long long pix_p, long long pix_c[], char scheme){
+  int res,i;
+  long long mp,np,base_pix;
   unsigned long pix_c0, pix_c1, pix_c2, pix_c3;
 
   if(pix_p<0){
-    fprintf(stderr, "error in get_child_pixels: %d is not a valid pixel number\n",pix_p);
+    fprintf(stderr, "error in get_child_pixels: %lld is not a valid pixel number\n",pix_p);
     return(1);
   }
 
   res=get_res(pix_p, scheme);
   //printf("get_res(pix_p = %d) = %d\n", pix_p, res);
   if(res==-1) return (1);
+  if(res>=RES_LIMIT){
+    fprintf(stderr, "error in get_child_pixels: children of pixel %lld would exceed maximum resolution %d\n", pix_p, RES_LIMIT);
+    return(1);
+  }
 
   if(scheme=='s'){
     // this scheme divides up the sphere by rectangles in az and el, and is numbered 
@@ -245,8 +331,8 @@ int get_child_pixels(int pix_p, int pix_c[], char scheme){
     // 1/16 of the sky (resolution 2), etc.
     
     base_pix=pix_p-pixel_start(res,scheme);
-    mp=base_pix % (int)(powl(2,res));
-    np=(base_pix-mp)/powl(2,res);
+    mp=base_pix & ((1LL<<res)-1);
+    np=base_pix >> res;
     
     //child pixels will have nc=2*np or 2*np+1, mc=2*mp or 2*mp+1, res_c=res+1
     //for first child pixel (nc=2*np, mc=2*mp), the base pixel number is given by
@@ -254,12 +340,27 @@ int get_child_pixels(int pix_p, int pix_c[], char scheme){
     //combine this with base_pix_p=2^res*np+mp and extra resolution term 4^res 
     //to get formula for the number for the first child pixel number below
     
-    pix_c[0]=pix_p+powl(4,res)+powl(2,res)*3*np+mp;
+    pix_c[0]=pix_p+(1LL<<(2*res))+(np<<res)*3+mp;
     pix_c[1]=pix_c[0]+1;
-    pix_c[2]=pix_c[0]+powl(2,res+1);
+    pix_c[2]=pix_c[0]+(1LL<<(res+1));
     pix_c[3]=pix_c[2]+1;
     return(0);
   }
+  else if(scheme=='h'){
+    // HEALPix-like NESTED: pixel 0 has the 12 base pixels 1-12 as children.
+    // Otherwise, in terms of q=pix+3=4^res+hpix, the children are 4q to 4q+3,
+    // so the children of pix are 4*pix+9 to 4*pix+12.
+    if(res>=HEALPIX_RES_LIMIT){
+      fprintf(stderr, "error in get_child_pixels: children of pixel %lld would exceed maximum resolution %d of scheme h\n", pix_p, HEALPIX_RES_LIMIT);
+      return(1);
+    }
+    if(pix_p==0){
+      for(i=0;i<12;i++) pix_c[i]=i+1;
+      return(0);
+    }
+    for(i=0;i<4;i++) pix_c[i]=((pix_p+3)<<2)+i-3;
+    return(0);
+  }
   else if(scheme=='d'){
     assign_parameters();
     if (pix_p==0){
@@ -285,10 +386,10 @@ int get_child_pixels(int pix_p, int pix_c[], char scheme){
     }
     else {
       subpix((int)powl(2,res-2), (unsigned long)(pix_p-pixel_start(res, scheme)), &pix_c0, &pix_c1, &pix_c2, &pix_c3);
-      pix_c[0] = (int)pix_c0 + pixel_start(res+1, scheme);
-      pix_c[1] = (int)pix_c1 + pixel_start(res+1, scheme);
-      pix_c[2] = (int)pix_c2 + pixel_start(res+1, scheme);
-      pix_c[3] = (int)pix_c3 + pixel_start(res+1, scheme);
+      pix_c[0] = (long long)pix_c0 + pixel_start(res+1, scheme);
+      pix_c[1] = (long long)pix_c1 + pixel_start(res+1, scheme);
+      pix_c[2] = (long long)pix_c2 + pixel_start(res+1, scheme);
+      pix_c[3] = (long long)pix_c3 + pixel_start(res+1, scheme);
       return(0);
     }
   }
@@ -306,37 +407,33 @@ int get_child_pixels(int pix_p, int pix_c[], char scheme){
    returns the resolution of the pixel, or -1 if an error occurs
 */
 
-int get_res(int pix, char scheme){
+int get_res(long long pix, char scheme){
   int res;
   
   if(pix<0){
-    fprintf(stderr, "error in get_res: %d not a valid pixel number.\n", pix);
+    fprintf(stderr, "error in get_res: %lld not a valid pixel number.\n", pix);
     return(-1);
   }
 
   if(scheme=='s'){
-    for(res=0;pix>=powl(4,res);res++){
-      pix-=(int)powl(4,res);
+    for(res=0;pix>=(1LL<<(2*res));res++){
+      pix-=1LL<<(2*res);
     }
     return(res);
   }
-  /* else if(scheme=='h'){
-    if(pix==0){
-      res=0;
-      return(res);
-    }
-    else if(pix>0){
-      for(res=2;pix>(int)(12*(powl(4,res)-4)/12);res++){
-      }
-    return((int)(res-1));  
+  else if(scheme=='h'){
+    // q=pix+3 lies in [4^res, 4^(res+1)) for res>=1
+    if(pix==0) return(0);
+    for(res=1;pix+3>=(1LL<<(2*(res+1)));res++){
     }
-    } */
+    return(res);
+  }
   else if(scheme=='d'){
     if(pix==0) return(0);
     else if(pix>=1 && pix <=117) return(1);
     else pix-=117;
-    for(res=2;pix>(int)powl(4,res-2)*468;res++){
-      pix-=(int)powl(4,res-2)*468;
+    for(res=2;pix>(1LL<<(2*(res-2)))*468;res++){
+      pix-=(1LL<<(2*(res-2)))*468;
     }
     // sdss_res increases by factors of 2 instead of increments of 1
     // sdss_res = (int)powl(2,res-1);
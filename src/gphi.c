@@ -21,11 +21,11 @@
   Return value:  0 if ok;
 		-1 if failed to allocate memory.
 */
-int gphi(polygon *poly, long double *tol, vec rp, long double cm, long double *angle)
+int gphi(polygon *poly, real_t *tol, vec rp, real_t cm, real_t *angle)
 {
     /* work arrays */
     int *iord;
-    long double *phi;
+    real_t *phi;
 
     /* allocate memory for work arrays */
     iord = (int *) malloc(sizeof(int) * poly->np * 2);
@@ -33,7 +33,7 @@ int gphi(polygon *poly, long double *tol, vec rp, long double cm, long double *a
 	fprintf(stderr, "gphi: failed to allocate memory for %d ints\n", poly->np * 2);
 	return(-1);
     }
-    phi = (long double *) malloc(sizeof(long double) * poly->np * 2);
+    phi = (real_t *) malloc(sizeof(real_t) * poly->np * 2);
     if (!phi) {
 	fprintf(stderr, "gphi: failed to allocate memory for %d long doubles\n", poly->np * 2);
 	return(-1);
@@ -3,14 +3,15 @@ c 
 c-----------------------------------------------------------------------
       subroutine gphim(angle,rp,cm,np,rpi,cmi,cmimin,cmimax,tol,
      *  phi,iord)
+#include "real.par"
       integer np,iord(2*np)
-      real*10 angle,rp(3,np),cm(np),rpi(3),cmi,cmimin,cmimax,tol,
+      real(KR) angle,rp(3,np),cm(np),rpi(3),cmi,cmimin,cmimax,tol,
      *  phi(2,np)
 c
 c        parameters
       include 'pi.par'
-      real*10 TWOPI
-      parameter (TWOPI=2._10*PI)
+      real(KR) TWOPI
+      parameter (TWOPI=2._KR*PI)
 c        intrinsics
       intrinsic abs
 c *
@@ -20,18 +21,18 @@ c * cmimin and cmimax are gotten from prior call to gcmlim.
 c *
       if (cmi.le.abs(cmimin)) then
 c        region excludes circle
-        if (cmimin.ge.0._10) then
-          angle=0._10
+        if (cmimin.ge.0._KR) then
+          angle=0._KR
 c        region encloses circle
-        elseif (cmimin.lt.0._10) then
+        elseif (cmimin.lt.0._KR) then
           angle=TWOPI
         endif
       elseif (cmi.ge.abs(cmimax)) then
 c        circle encloses region
-        if (cmimax.ge.0._10) then
-          angle=0._10
+        if (cmimax.ge.0._KR) then
+          angle=0._KR
 c        circle and region enclose each other
-        elseif (cmimax.lt.0._10) then
+        elseif (cmimax.lt.0._KR) then
           angle=TWOPI
         endif
       else
@@ -18,9 +18,9 @@ polygon *polys_global[NPOLYSMAX];
 /* local functions */
 void	usage(void);
 #ifdef  GCC
-int     grow(int npoly, polygon *[npoly], int npolys, polygon *[npolys], long double grow_angle);
+int     grow(int npoly, polygon *[npoly], int npolys, polygon *[npolys], real_t grow_angle);
 #else
-int     grow(int npoly, polygon *[/*npoly*/], int npolys, polygon *[/*npolys*/], long double grow_angle);
+int     grow(int npoly, polygon *[/*npoly*/], int npolys, polygon *[/*npolys*/], real_t grow_angle);
 #endif
 
 
@@ -45,7 +45,7 @@ int main(int argc, char *argv[])
     if (mtol != 0.) {
 	scale(&mtol, munit, 's');
 	munit = 's';
-	msg("multiple intersections closer than %Lg%c will be treated as coincident\n", mtol, munit);
+	msg("multiple intersections closer than %" RL "g%c will be treated as coincident\n", mtol, munit);
 	scale(&mtol, munit, 'r');
 	munit = 'r';
     }
@@ -67,7 +67,7 @@ int main(int argc, char *argv[])
     /*process grow angle */
     scale(&grow_angle, gunit, 's');
     gunit = 's';
-    msg("Borders of %Lg%c will be grown around the input polygons.\n", grow_angle, gunit);
+    msg("Borders of %" RL "g%c will be grown around the input polygons.\n", grow_angle, gunit);
     scale(&grow_angle, gunit, 'r');
     gunit = 'r';
     
@@ -134,10 +134,10 @@ void usage(void)
   Return value: number of polygons weighted,
 		or -1 if error occurred.
 */
-int grow(int npoly, polygon *poly[/*npoly*/], int npolys, polygon *polys[/*npolys*/], long double grow_angle)
+int grow(int npoly, polygon *poly[/*npoly*/], int npolys, polygon *polys[/*npolys*/], real_t grow_angle)
 {
   int ipoly,iret,n,np;
-  long double tol;
+  real_t tol;
   
   n=npoly;
   for (ipoly = 0; ipoly < npoly; ipoly++) {
@@ -159,9 +159,9 @@ int grow(int npoly, polygon *poly[/*npoly*/], int npolys, polygon *polys[/*npoly
   return(n);
 }
 
-int grow_poly(polygon **poly, int npolys, polygon *polys[/*npolys*/], long double grow_angle, long double mtol, int *np){
+int grow_poly(polygon **poly, int npolys, polygon *polys[/*npolys*/], real_t grow_angle, real_t mtol, int *np){
   int i, ip, jp, iret, ier, dn;
-  long double s, cmi, cm_new,theta, theta_new, tol;
+  real_t s, cmi, cm_new,theta, theta_new, tol;
   polygon *poly1= 0x0;
   
 /* part_poly should lasso all one-boundary polygons */
@@ -236,6 +236,7 @@ int grow_poly(polygon **poly, int npolys, polygon *polys[/*npolys*/], long doubl
       
       poly1->cm[ip]=cm_new;
     }
+    poly1->areaok=0;
     tol=mtol;
     iret=prune_poly(poly1,tol);
   }
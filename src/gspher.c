@@ -25,14 +25,14 @@
 		 1 if fatal error;
 		-1 if could not allocate temporary memory.
 */
-int gspher(polygon *poly, int lmax, long double *tol, long double *area, long double bound[2], long double vert[2], harmonic w[/*NW*/])
+int gspher(polygon *poly, int lmax, real_t *tol, real_t *area, real_t bound[2], real_t vert[2], harmonic w[/*NW*/])
 {
     logical ldegen;
-    int i, ibv, ier, im, iphi, iw, lmax1, nw, verb;
-    long double darea;
+    int i, ibv, ier, im, iphi, iw, lmin, lmax1, nw, verb;
+    real_t darea;
     /* work arrays */
     int *iord;
-    long double *v, *phw;
+    real_t *v, *phw;
 
     /* determine area without 2 pi ambiguity, and a good value for tol */
     verb = 1;
@@ -58,18 +58,19 @@ int gspher(polygon *poly, int lmax, long double *tol, long double *area, long do
 	fprintf(stderr, "gspher: failed to allocate memory for %d ints\n", poly->np * 2);
 	return(-1);
     }
-    phw = (long double *) malloc(sizeof(long double) * poly->np * 2);
+    phw = (real_t *) malloc(sizeof(real_t) * poly->np * 2);
     if (!phw) {
 	fprintf(stderr, "gspher: failed to allocate memory for %d long doubles\n", poly->np * 2);
 	return(-1);
     }
-    v = (long double *) malloc(sizeof(long double) * (lmax + 1));
+    v = (real_t *) malloc(sizeof(real_t) * (lmax + 1));
     if (!v) {
 	fprintf(stderr, "gspher: failed to allocate memory for %d long doubles\n", lmax + 1);
 	return(-1);
     }
 
     /* parameters */
+    lmin = 0;
     lmax1 = lmax + 1;
     im = IM;
     nw = NW;
@@ -77,7 +78,7 @@ int gspher(polygon *poly, int lmax, long double *tol, long double *area, long do
     iphi = 0;
 
     /* the fortran routine */
-    gspher_(&darea, bound, vert, w, &lmax1, &im, &nw, poly->rp, poly->cm, &poly->np, &poly->np, &ibv, &iphi, tol, phw, iord, v, &ldegen);
+    gspher_(&darea, bound, vert, w, &lmin, &lmax1, &im, &nw, poly->rp, poly->cm, &poly->np, &poly->np, &ibv, &iphi, tol, phw, iord, v, &ldegen);
 
     /* monopole harmonic without 2 pi/sqrtl(4 pi) ambiguity */
     w[0][0] = *area / sqrtl(4. * PI);
@@ -111,23 +112,24 @@ int gspher(polygon *poly, int lmax, long double *tol, long double *area, long do
   Return value:  0 if ok;
 		-1 if could not allocate temporary memory.
 */
-int gsphera(long double azmin, long double azmax, long double elmin, long double elmax, int lmax, long double *area, long double bound[2], long double vert[2], harmonic w[/*NW*/])
+int gsphera(real_t azmin, real_t azmax, real_t elmin, real_t elmax, int lmax, real_t *area, real_t bound[2], real_t vert[2], harmonic w[/*NW*/])
 {
     /* array used for acceleration */
-    static long double *dw = 0x0;
+    static THREADLOCAL real_t *dw = 0x0;
 
-    int ibv, im, lmax1, nw;
+    int ibv, im, lmin, lmax1, nw;
     /* work array */
-    long double *v;
+    real_t *v;
 
     /* allocate memory for work arrays */
-    v = (long double *) malloc(sizeof(long double) * (lmax + 1));
+    v = (real_t *) malloc(sizeof(real_t) * (lmax + 1));
     if (!v) {
 	fprintf(stderr, "gsphera: failed to allocate memory for %d long doubles\n", lmax + 1);
 	return(-1);
     }
 
     /* parameters */
+    lmin = 0;
     lmax1 = lmax + 1;
     im = IM;
     nw = NW;
@@ -135,7 +137,7 @@ int gsphera(long double azmin, long double azmax, long double elmin, long double
 
     /* dw contains array that is pre-computed, then used by all rects with same elmin, elmax */
     if (!dw) {
-	dw = (long double *) malloc(sizeof(long double) * NW);
+	dw = (real_t *) malloc(sizeof(real_t) * NW);
 	if (!dw) {
 	    fprintf(stderr, "gsphera: failed to allocate memory for %d long doubles\n", NW);
 	    return(-1);
@@ -143,7 +145,7 @@ int gsphera(long double azmin, long double azmax, long double elmin, long double
     }
 
     /* fortran routine */
-    gsphera_(area, bound, vert, w, &lmax1, &im, &nw, &ibv, &azmin, &azmax, &elmin, &elmax, v, dw);
+    gsphera_(area, bound, vert, w, &lmin, &lmax1, &im, &nw, &ibv, &azmin, &azmax, &elmin, &elmax, v, dw);
 
     /* free work array */
     free(v);
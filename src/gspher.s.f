@@ -1,32 +1,34 @@
 c-----------------------------------------------------------------------
 c  A J S Hamilton 2001
 c-----------------------------------------------------------------------
-      subroutine gspher(area,bound,vert,w,lmax1,im,nw,rp,cm,np,npc,ibv,
-     *  iphi,tol,phw,iord,v,ldegen)
-      integer lmax1,im,nw,np,npc,ibv,iphi
+      subroutine gspher(area,bound,vert,w,lmin,lmax1,im,nw,rp,cm,np,
+     *  npc,ibv,iphi,tol,phw,iord,v,ldegen)
+#include "real.par"
+      integer lmin,lmax1,im,nw,np,npc,ibv,iphi
       logical ldegen
-      real*10 area,bound(2),vert(2),w(im,nw),rp(3,np),cm(np),tol
+      real(KR) area,bound(2),vert(2),w(im,(lmin*(lmin+1))/2+1:nw),
+     *  rp(3,np),cm(np),tol
 c        work arrays (could be automatic if compiler supports it)
       integer iord(2*np)
-      real*10 phw(2,np),v(lmax1)
+      real(KR) phw(2,np),v(lmax1)
 c
 c        parameters
       include 'pi.par'
-      real*10 TWOPI
-      parameter (TWOPI=2._10*PI)
+      real(KR) TWOPI
+      parameter (TWOPI=2._KR*PI)
 c        intrinsics
       intrinsic abs
 c        externals
       integer garpi,gsegij,gzeroar
 c        data variables
-      real*10 big
-      real*10 dphmin
+      real(KR) big
+      real(KR) dphmin
 c        local (automatic) variables
       integer i,iarea,ik,iseg,j,jm,jml,jmu,jp,jpl,jpu,k,km,kp,l,
      *  nbd,nbd0m,nbd0p,ni,nmult,retry,scmi
 C     logical warn
       logical whole
-      real*10 bik,ci,cmi,cmik,cmk,cti,ctk,ctpsi,
+      real(KR) bik,ci,cmi,cmik,cmk,cti,ctk,ctpsi,
      *  d,darea,dbound(2),dph,dvert(2),
      *  ph,phi,phii,phm,php,psi,psip,ri,rii,si,sk,sqrt4pi,t,tolin,
      *  xi(3),yi(3)
@@ -131,7 +133,10 @@ c *     expansion of <WW>, whose coefficients involve bound and vert,
 c *     probably breaks down already at tiny values of the separation
 c *     angle th.
 c *
-c  Input: lmax1 = lmax+1 where lmax is maximum desired l of transform.
+c  Input: lmin = minimum desired l of transform;
+c              if lmin > 0, the monopole w(1,1) is absent,
+c              and area is not checked against it.
+c         lmax1 = lmax+1 where lmax is maximum desired l of transform.
 c         im = 1 means compute only real part of harmonics;
 c              2 means compute both real and imaginary parts.
 c              Note harmonics are real if region possesses reflection
@@ -160,8 +165,9 @@ c                where psi is exterior angle (=pi-interior angle)
 c                at vertex, or as explained above if ibv>0.
 c         ldegen = .true. signals an error: the code dealt incorrectly
 c                  with a multiply intersecting boundary.
-c Input/Output: w(i,lm) = spherical transform, dimensioned w(im,nw)
-c            w(i,lm), i=1,im, lm=l*(l+1)/2+m+1, l=0,lmax, m=0,l;
+c Input/Output: w(i,lm) = spherical transform,
+c            dimensioned w(im,lmin*(lmin+1)/2+1:nw)
+c            w(i,lm), i=1,im, lm=l*(l+1)/2+m+1, l=lmin,lmax, m=0,l;
 c            w(1,lm) is real part, w(2,lm) is imaginary part (if im=2).
 c            Note w(l,-m)=(-)**m*[Complex conjugate of w(l,m)], just as
 c                 Y(l,-m)=(-)**m*[Complex conjugate of Y(l,m)].
@@ -170,9 +176,9 @@ c Work arrays: phw and iord should be dimensioned at least 2*np.
 c              v should be dimensioned at least lmax1.
 c
 c        set azimuthal angle of non-intersection to big
-      data big /1.e6_10/
+      data big /1.e6_KR/
 c        possible multiple intersection when dph < dphmin
-      data dphmin /1.e-8_10/
+      data dphmin /1.e-8_KR/
 c
 c        input tolerance to multiple intersections
       tolin=tol
@@ -183,14 +189,14 @@ c        initialise error flag to no error
       ldegen=.false.
 C     warn=.false.
 c        zero stuff
-      area=0._10
-      bound(1)=0._10
-      bound(2)=0._10
-      vert(1)=0._10
-      vert(2)=0._10
-      do j=1,nw
+      area=0._KR
+      bound(1)=0._KR
+      bound(2)=0._KR
+      vert(1)=0._KR
+      vert(2)=0._KR
+      do j=(lmin*(lmin+1))/2+1,nw
         do i=1,im
-          w(i,j)=0._10
+          w(i,j)=0._KR
         enddo
       enddo
 c        check for zero area because one circle is null
@@ -203,35 +209,35 @@ c        number of non-intersecting circles bounding area
       nbd0m=0
       nbd0p=0
 c        error check on evaluation of vertex terms
-      ikchk=0._10
+      ikchk=0._KR
 c        area=sqrt(4pi)*monopole
-      sqrt4pi=sqrt(4._10*PI)
+      sqrt4pi=sqrt(4._KR*PI)
 c        harmonics defined so point iphi is at zero azimuthal angle
-      rii=0._10
+      rii=0._KR
       if (iphi.ge.1) rii=sqrt(rp(1,iphi)**2+rp(2,iphi)**2)
-      phii=0._10
-      if (rii.gt.0._10) phii=atan2(rp(2,iphi),rp(1,iphi))
+      phii=0._KR
+      if (rii.gt.0._KR) phii=atan2(rp(2,iphi),rp(1,iphi))
 c--------identify boundary segments around each circle i in turn
       do 280 i=1,np
 c        cm(i).ge.2 means include whole sphere, which is no constraint
-        if (cm(i).ge.2._10) goto 280
+        if (cm(i).ge.2._KR) goto 280
 c        there is a constraint, so area is not whole sphere
         whole=.false.
 c        scmi * cmi = 1-cos th(i)
-        if (cm(i).ge.0._10) then
+        if (cm(i).ge.0._KR) then
           scmi=1
         else
           scmi=-1
         endif
         cmi=abs(cm(i))
 c        ci = cos th(i)
-        ci=1._10-cmi
+        ci=1._KR-cmi
 c        si = sin th(i)
-        si=sqrt(cmi*(2._10-cmi))
+        si=sqrt(cmi*(2._KR-cmi))
 c........ri, phi, rp(3,i) are cylindrical coordinates of rp(i)
         ri=sqrt(rp(1,i)**2+rp(2,i)**2)
-        if (ri.eq.0._10.or.i.eq.iphi) then
-          phi=0._10
+        if (ri.eq.0._KR.or.i.eq.iphi) then
+          phi=0._KR
         else
           phi=atan2(rp(2,i),rp(1,i))-phii
         endif
@@ -240,20 +246,20 @@ c The direction of yi is important here,
 c unlike some other subroutines (gphi, garea, gphbv, gvlim, gvphi)
 c where yi can point in any abitrary direction.
 c        set yi in direction z x rp(i)
-        if (ri.gt.0._10) then
+        if (ri.gt.0._KR) then
           yi(1)=-rp(2,i)/ri
           yi(2)=rp(1,i)/ri
-          yi(3)=0._10
+          yi(3)=0._KR
 c        if rp(i) is along z-axis, set yi in direction z x rp(iphi)
-        elseif (rii.gt.0._10) then
+        elseif (rii.gt.0._KR) then
           yi(1)=-rp(2,iphi)/rii
           yi(2)=rp(1,iphi)/rii
-          yi(3)=0._10
+          yi(3)=0._KR
 c        if rp(iphi) is also along z-axis, set yi along y-axis
-        elseif (ri.eq.0._10.and.rii.eq.0._10) then
-          yi(1)=0._10
-          yi(2)=1._10
-          yi(3)=0._10
+        elseif (ri.eq.0._KR.and.rii.eq.0._KR) then
+          yi(1)=0._KR
+          yi(2)=1._KR
+          yi(3)=0._KR
         endif
 c        xi in direction yi x rp(i)
         xi(1)=yi(2)*rp(3,i)-yi(3)*rp(2,i)
@@ -266,14 +272,14 @@ c        i circle lies outside polygon
 c        area of polygon is zero
         if (ni.eq.-2) then
 c        area can be non-zero from psi at multiple intersections
-          area=0._10
-          bound(1)=0._10
-          bound(2)=0._10
-          vert(1)=0._10
-          vert(2)=0._10
-          do l=1,nw
+          area=0._KR
+          bound(1)=0._KR
+          bound(2)=0._KR
+          vert(1)=0._KR
+          vert(2)=0._KR
+          do l=(lmin*(lmin+1))/2+1,nw
             do k=1,im
-              w(k,l)=0._10
+              w(k,l)=0._KR
             enddo
           enddo
           goto 410
@@ -287,13 +293,13 @@ c........i circle has no intersections
           endif
           dph=TWOPI
           if (scmi.lt.0) dph=-dph
-          ph=0._10
+          ph=0._KR
 c        increment area
           darea=cmi*dph
           area=area+darea
 c        bound(1) term is length of boundary
           dbound(1)=si*abs(dph)
-          dbound(2)=(1._10/si-2._10*si)*abs(dph)
+          dbound(2)=(1._KR/si-2._KR*si)*abs(dph)
 c        standard
           if (ibv.eq.0
 c        cross
@@ -314,7 +320,7 @@ C         print *,'dbound =',dbound(1),dbound(2),
 C    *      ' bound =',bound(1),bound(2)
 c        increment spherical transform
           if (ibv.ge.2) dph=-dph
-          call wlm(w,lmax1,im,nw,ri,phi,0,rp(3,i),ci,si,ph,dph,v)
+          call wlm(w,lmin,lmax1,im,nw,ri,phi,0,rp(3,i),ci,si,ph,dph,v)
 c........i circle has intersections
         elseif (ni.gt.0) then
 c        find ordering of intersection angles around i circle
@@ -349,7 +355,7 @@ c        contribution to area from the boundary segment
             area=area+darea
 c        bound(1) term is length of boundary
             dbound(1)=si*abs(dph)
-            dbound(2)=(1._10/si-2._10*si)*abs(dph)
+            dbound(2)=(1._KR/si-2._KR*si)*abs(dph)
 c        standard
             if (ibv.eq.0
 c        cross
@@ -399,25 +405,25 @@ c        ikchk = ikchk - ikran, subtracted as unsigned long long's
 c        ikchk = ikchk + ikran, added as unsigned long long's
               call ikrandp(ikchk,ikran)
               cmk=abs(cm(k))
-              sk=sqrt(cmk*(2._10-cmk))
+              sk=sqrt(cmk*(2._KR-cmk))
 c        cmik = 1-cos th(ik)
               cmik=((rp(1,i)-rp(1,k))**2+(rp(2,i)-rp(2,k))**2
-     *          +(rp(3,i)-rp(3,k))**2)/2._10
+     *          +(rp(3,i)-rp(3,k))**2)/2._KR
 c        bik = cik-ci*ck
 c        d = 1-ci^2-ck^2-cik^2+2*ci*ck*cik
 c        cos psi = bik/(si*sk)
 c        sin psi = sqrt(d)/(si*sk)
 c        psi = atan(sqrt(d)/bik) is exterior angle at intersection
               bik=(cmi+cmk)-cmi*cmk-cmik
-              if ((scmi.ge.0.and.cm(k).lt.0._10)
-     *          .or.(scmi.lt.0.and.cm(k).ge.0._10)) bik=-bik
+              if ((scmi.ge.0.and.cm(k).lt.0._KR)
+     *          .or.(scmi.lt.0.and.cm(k).ge.0._KR)) bik=-bik
 c        i and k circles kiss
               if (phw(1,k).eq.phw(2,k)) then
-                d=0._10
+                d=0._KR
               else
-                d=-(cmi-cmk)**2+cmik*(2._10*((cmi+cmk)-cmi*cmk)-cmik)
+                d=-(cmi-cmk)**2+cmik*(2._KR*((cmi+cmk)-cmi*cmk)-cmik)
 c        assert that circles at least touch
-                if (d.lt.0._10) d=0._10
+                if (d.lt.0._KR) d=0._KR
                 d=sqrt(d)
               endif
               ctpsi=bik/d
@@ -425,31 +431,31 @@ c        assert that circles at least touch
 c        increment area
               area=area-psi
 c        t=tan psi/2
-              if (bik.gt.0._10) then
+              if (bik.gt.0._KR) then
                 t=d/(bik+sqrt(bik**2+d**2))
-              elseif (bik.lt.0._10) then
+              elseif (bik.lt.0._KR) then
                 t=(-bik+sqrt(bik**2+d**2))/d
-              elseif (bik.eq.0._10) then
-                t=1._10
+              elseif (bik.eq.0._KR) then
+                t=1._KR
               endif
 c        cti = cot th(i)
-              cti=(1._10-cmi)/si
+              cti=(1._KR-cmi)/si
               if (scmi.lt.0) cti=-cti
 c        ctk = cot th(k)
-              ctk=(1._10-cmk)/sk
-              if (cm(k).lt.0._10) ctk=-ctk
+              ctk=(1._KR-cmk)/sk
+              if (cm(k).lt.0._KR) ctk=-ctk
 c        standard
               if (ibv.eq.0
      *          .or.(ibv.eq.1.and.i.gt.npc.and.k.gt.npc)
      *          .or.(ibv.eq.2.and.i.gt.npc.and.k.gt.npc)
      *          .or.(ibv.eq.3.and.((i.gt.npc.and.k.gt.npc)
      *                         .or.(i.le.npc.and.k.le.npc)))) then
-                if (psi.eq.0._10) then
-                  dvert(1)=0._10
-                  dvert(2)=0._10
+                if (psi.eq.0._KR) then
+                  dvert(1)=0._KR
+                  dvert(2)=0._KR
                 else
-                  dvert(1)=1._10-psi*ctpsi
-                  dvert(2)=t*(3._10+t**2)*(cti+ctk)/2._10
+                  dvert(1)=1._KR-psi*ctpsi
+                  dvert(2)=t*(3._KR+t**2)*(cti+ctk)/2._KR
                 endif
                 vert(1)=vert(1)+dvert(1)
                 vert(2)=vert(2)+dvert(2)
@@ -458,40 +464,40 @@ c        cross
                 if (i.le.npc.and.k.le.npc) then
                   continue
                 else
-                  dvert(1)=PI/2._10*ctpsi
-                  dvert(2)=t*(3._10+t**2)*(cti+ctk)/2._10
+                  dvert(1)=PI/2._KR*ctpsi
+                  dvert(2)=t*(3._KR+t**2)*(cti+ctk)/2._KR
                   vert(1)=vert(1)-dvert(1)
-                  vert(2)=vert(2)+dvert(2)/2._10
-                  t=1._10/t
-                  dvert(2)=t*(3._10+t**2)*(cti-ctk)/2._10
+                  vert(2)=vert(2)+dvert(2)/2._KR
+                  t=1._KR/t
+                  dvert(2)=t*(3._KR+t**2)*(cti-ctk)/2._KR
                   if (i.gt.npc) then
-                    vert(2)=vert(2)-dvert(2)/2._10
+                    vert(2)=vert(2)-dvert(2)/2._KR
                   elseif (k.gt.npc) then
-                    vert(2)=vert(2)+dvert(2)/2._10
+                    vert(2)=vert(2)+dvert(2)/2._KR
                   endif
                 endif
 c        intersection
               elseif (ibv.eq.2) then
                 if (i.le.npc.and.k.le.npc) then
-                  if (psi.eq.0._10) then
-                    dvert(1)=0._10
-                    dvert(2)=0._10
+                  if (psi.eq.0._KR) then
+                    dvert(1)=0._KR
+                    dvert(2)=0._KR
                   else
-                    dvert(1)=1._10-psi*ctpsi
-                    dvert(2)=t*(3._10+t**2)*(cti+ctk)/2._10
+                    dvert(1)=1._KR-psi*ctpsi
+                    dvert(2)=t*(3._KR+t**2)*(cti+ctk)/2._KR
                   endif
                   vert(1)=vert(1)-dvert(1)
                   vert(2)=vert(2)-dvert(2)
                 else
 c        psip = pi - psi
                   psip=atan2(d,-bik)
-                  if (psip.eq.0._10) then
-                    dvert(1)=0._10
-                    dvert(2)=0._10
+                  if (psip.eq.0._KR) then
+                    dvert(1)=0._KR
+                    dvert(2)=0._KR
                   else
-                    dvert(1)=1._10+psip*ctpsi
-                    t=1._10/t
-                    dvert(2)=t*(3._10+t**2)*(cti-ctk)/2._10
+                    dvert(1)=1._KR+psip*ctpsi
+                    t=1._KR/t
+                    dvert(2)=t*(3._KR+t**2)*(cti-ctk)/2._KR
                   endif
                   vert(1)=vert(1)-dvert(1)
                   if (i.gt.npc) then
@@ -502,12 +508,12 @@ c        psip = pi - psi
                 endif
 c        union
               elseif (ibv.eq.3) then
-                if (psi.eq.0._10) then
-                  dvert(1)=0._10
-                  dvert(2)=0._10
+                if (psi.eq.0._KR) then
+                  dvert(1)=0._KR
+                  dvert(2)=0._KR
                 else
-                  dvert(1)=1._10-psi*ctpsi
-                  dvert(2)=t*(3._10+t**2)*(cti+ctk)/2._10
+                  dvert(1)=1._KR-psi*ctpsi
+                  dvert(2)=t*(3._KR+t**2)*(cti+ctk)/2._KR
                 endif
                 vert(1)=vert(1)-dvert(1)
                 vert(2)=vert(2)+dvert(2)
@@ -522,17 +528,17 @@ C    *          ' should =',t
 C             print *,' cot(th_i) =',cti,' cot(th_k) =',ctk
 c        peculiar monopole term
               if (ibv.ge.2) psi=-psi
-              w(1,1)=w(1,1)-psi/sqrt4pi
+              if (lmin.eq.0) w(1,1)=w(1,1)-psi/sqrt4pi
   240       continue
 c        increment spherical transform
             if (ibv.ge.2) dph=-dph
-            call wlm(w,lmax1,im,nw,ri,phi,0,rp(3,i),ci,si,ph,dph,v)
+            call wlm(w,lmin,lmax1,im,nw,ri,phi,0,rp(3,i),ci,si,ph,dph,v)
 c        do another segment
           goto 220
         endif
   280 continue
 c--------check on whether ik endpoints matched ki endpoints
-      if (ikchk.ne.0._10) then
+      if (ikchk.ne.0._KR) then
 C       warn=.true.
 c       print *,'*** from gspher: at tol =',tol,
 c    *    ', ikchk=',ikchk,' should be 0'
@@ -543,12 +549,14 @@ c        retry with enlarged tolerance
 c--------add/subtract 2*pi's to area
       retry=garpi(area,iarea,rp,cm,np,whole,nbd0m,nbd0p,nbd,nmult)
 c        adjust monopole harmonic by corresponding 2*pi/sqrt(4*pi)
-      if (ibv.eq.0.or.ibv.eq.1) then
-        i=nint((w(1,1)*sqrt4pi-area)/TWOPI)
-      elseif (ibv.eq.2.or.ibv.eq.3) then
-        i=nint((w(1,1)*sqrt4pi+area)/TWOPI)
+      if (lmin.eq.0) then
+        if (ibv.eq.0.or.ibv.eq.1) then
+          i=nint((w(1,1)*sqrt4pi-area)/TWOPI)
+        elseif (ibv.eq.2.or.ibv.eq.3) then
+          i=nint((w(1,1)*sqrt4pi+area)/TWOPI)
+        endif
+        w(1,1)=w(1,1)-i*TWOPI/sqrt4pi
       endif
-      w(1,1)=w(1,1)-i*TWOPI/sqrt4pi
 c        retry with modified tolerance
       if (retry.eq.1) then
 C       warn=.true.
@@ -1,31 +1,35 @@
 c-----------------------------------------------------------------------
 c  A J S Hamilton 2001
 c-----------------------------------------------------------------------
-      subroutine gsphera(area,bound,vert,w,lmax1,im,nw,ibv,
+      subroutine gsphera(area,bound,vert,w,lmin,lmax1,im,nw,ibv,
      *  azmin,azmax,elmin,elmax,v,dw)
-      integer lmax1,im,nw,ibv
-      real*10 area,bound(2),vert(2),w(im,nw),
-     *  azmin,azmax,elmin,elmax,dw(nw)
+#include "real.par"
+      integer lmin,lmax1,im,nw,ibv
+      real(KR) area,bound(2),vert(2),w(im,(lmin*(lmin+1))/2+1:nw),
+     *  azmin,azmax,elmin,elmax,dw((lmin*(lmin+1))/2+1:nw)
 c        work array (could be automatic if compiler supports it)
-      real*10 v(lmax1)
+      real(KR) v(lmax1)
 c
 c        parameters
       include 'pi.par'
-      real*10 TWOPI,PIBYTWO
-      parameter (TWOPI=2._10*PI,PIBYTWO=PI/2._10)
+      real(KR) TWOPI,PIBYTWO
+      parameter (TWOPI=2._KR*PI,PIBYTWO=PI/2._KR)
 c        data variables
-      real*10 elmino,elmaxo
+      real(KR) elmino,elmaxo
+      integer lmino,lmax1o
 c        saved variables
-      real*10 cl,cu,dth,sl,su
+      real(KR) cl,cu,dth,sl,su
       save cl,cu,dth,sl,su
+!$omp threadprivate(elmino,elmaxo,lmino,lmax1o,cl,cu,dth,sl,su)
 c        local (automatic) variables
       integer i,l,m,lm,lmax,mmax
-      real*10 azmx,cmph,d,dph,ph,smph,thmin,thmax
+      real(KR) azmx,cmph,d,dph,ph,smph,thmin,thmax
 c *
 c * Accelerated computation of spherical transform
 c * of rectangle bounded by lines of constant latitude & longitude.
 c *
-c  Input: lmax1 = lmax+1 where lmax is maximum desired l of transform.
+c  Input: lmin = minimum desired l of transform.
+c         lmax1 = lmax+1 where lmax is maximum desired l of transform.
 c         im = 1 means compute only real part of harmonics;
 c              2 means compute both real and imaginary parts.
 c              Note harmonics are real if region possesses reflection
@@ -48,41 +52,44 @@ c                 or as explained in gspher ibv>0.
 c         vert = sum over vertices of 1-psi/tan(psi) if ibv=0,
 c                where psi is exterior angle (=pi-interior angle)
 c                at vertex, or as explained in gspher if ibv>0.
-c         dw = integral_thmin^thmax Y_lm(th,0) sin th d th,
+c         dw = integral_thmin^thmax Y_lm(th,0) sin th d th, l=lmin,lmax,
 c              which should be saved between calls.
-c Input/Output: w(i,lm) = spherical transform, dimensioned w(im,nw)
-c            w(i,lm), i=1,im, lm=l*(l+1)/2+m+1, l=0,lmax, m=0,l;
+c Input/Output: w(i,lm) = spherical transform,
+c            dimensioned w(im,lmin*(lmin+1)/2+1:nw)
+c            w(i,lm), i=1,im, lm=l*(l+1)/2+m+1, l=lmin,lmax, m=0,l;
 c            w(1,lm) is real part, w(2,lm) is imaginary part (if im=2).
 c            Note w(l,-m)=(-)**m*[Complex conjugate of w(l,m)], just as
 c                 Y(l,-m)=(-)**m*[Complex conjugate of Y(l,m)].
 c Work arrays: v should be dimensioned at least lmax1.
 c
-      data elmino,elmaxo /2*0._10/
+      data elmino,elmaxo /2*0._KR/
+      data lmino,lmax1o /2*-1/
 c
 c        zero stuff
-      area=0._10
-      bound(1)=0._10
-      bound(2)=0._10
-      vert(1)=0._10
-      vert(2)=0._10
-      do lm=1,nw
+      area=0._KR
+      bound(1)=0._KR
+      bound(2)=0._KR
+      vert(1)=0._KR
+      vert(2)=0._KR
+      do lm=(lmin*(lmin+1))/2+1,nw
         do i=1,im
-          w(i,lm)=0._10
+          w(i,lm)=0._KR
         enddo
       enddo
 c        check input parameters OK
-      if (lmax1.le.0) goto 200
+      if (lmax1.le.lmin) goto 200
       if (elmin.ge.PIBYTWO.or.elmax.le.-PIBYTWO) goto 200
       if (elmin.ge.elmax) goto 200
       azmx=azmax
 c        assume azmax.lt.azmin means need to add 2*pi to azmax
       if (azmx.lt.azmin) azmx=azmx+TWOPI
-c--------compute integrals of harmonics if elmin and elmax changed
-      if (elmino.ne.elmin.or.elmaxo.ne.elmax) then
+c--------compute integrals of harmonics if elmin, elmax or l changed
+      if (elmino.ne.elmin.or.elmaxo.ne.elmax
+     *  .or.lmino.ne.lmin.or.lmax1o.ne.lmax1) then
         if (elmax.ge.PIBYTWO) then
-          thmin=0._10
-          cu=1._10
-          su=0._10
+          thmin=0._KR
+          cu=1._KR
+          su=0._KR
         else
           thmin=PIBYTWO-elmax
           cu=cos(thmin)
@@ -90,8 +97,8 @@ c--------compute integrals of harmonics if elmin and elmax changed
         endif
         if (elmin.le.-PIBYTWO) then
           thmax=PI
-          cl=-1._10
-          sl=0._10
+          cl=-1._KR
+          sl=0._KR
         else
           thmax=PIBYTWO-elmin
           cl=cos(thmax)
@@ -99,18 +106,20 @@ c--------compute integrals of harmonics if elmin and elmax changed
         endif
         dth=thmax-thmin
 c        integrals of harmonics: this takes most time
-        call iylm(thmin,thmax,dw,lmax1,nw,v)
+        call iylm(thmin,thmax,dw,lmin,lmax1,nw,v)
         elmaxo=elmax
         elmino=elmin
+        lmino=lmin
+        lmax1o=lmax1
       endif
 c--------fast computation of harmonics
       dph=azmx-azmin
       area=(cu-cl)*dph
       if (ibv.eq.0.or.ibv.eq.2.or.ibv.eq.3) then
-        bound(1)=(sl+su)*dph+2._10*dth
-        bound(2)=(1._10/sl-2._10*sl+1._10/su-2._10*su)*dph-2._10*dth
-        vert(1)=4._10
-        vert(2)=4._10*(cl/sl-cu/su)
+        bound(1)=(sl+su)*dph+2._KR*dth
+        bound(2)=(1._KR/sl-2._KR*sl+1._KR/su-2._KR*su)*dph-2._KR*dth
+        vert(1)=4._KR
+        vert(2)=4._KR*(cl/sl-cu/su)
         if (ibv.eq.2) then
           bound(1)=-bound(1)
           bound(2)=-bound(2)
@@ -118,22 +127,21 @@ c--------fast computation of harmonics
           vert(2)=-vert(2)
         endif
       endif
-      ph=(azmx+azmin)/2._10
+      ph=(azmx+azmin)/2._KR
       if (ibv.ge.2) dph=-dph
       lmax=lmax1-1
       mmax=lmax
-      if (dph-nint(dph/TWOPI)*TWOPI.eq.0._10) mmax=0
+      if (dph-nint(dph/TWOPI)*TWOPI.eq.0._KR) mmax=0
       do m=0,mmax
         if (m.eq.0) then
           d=dph
         elseif (m.gt.0) then
-          d=sin(m*dph/2._10)*2._10/dble(m)
+          d=sin(m*dph/2._KR)*2._KR/dble(m)
         endif
         cmph=cos(m*ph)
         smph=sin(m*ph)
-        lm=(m*(m+1))/2+1
-        do l=m,lmax
-          lm=lm+l
+        do l=max(m,lmin),lmax
+          lm=(l*(l+1))/2+m+1
           w(1,lm)=w(1,lm)+cmph*d*dw(lm)
           if (im.eq.2) w(2,lm)=w(2,lm)-smph*d*dw(lm)
         enddo
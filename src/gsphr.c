@@ -14,22 +14,25 @@
   It returns the spherical harmonics, and does not worry about bound and vert.
 
    Input: poly is a polygon.
+	  lmin = minimum harmonic number.
 	  lmax = maximum harmonic number.
   Input/Output: *tol = angle within which to merge multiple intersections.
-  Output: w = array containing spherical harmonics of polygon;
-	      NW = ((lmax + 1)(lmax + 2))/ 2 is defined in harmonics.h.
+  Output: w = array containing spherical harmonics of polygon from lmin to lmax,
+	      w[0] being the harmonic l = lmin, m = 0;
+	      NW - NW0 = ((lmax + 1)(lmax + 2) - lmin (lmin + 1))/ 2
+	      is defined in harmonics.h.
   Return value:  0 if ok;
 		 1 if fatal error;
 		-1 if could not allocate temporary memory.
 */
-int gsphr(polygon *poly, int lmax, long double *tol, harmonic w[/*NW*/])
+int gsphr(polygon *poly, int lmin, int lmax, real_t *tol, harmonic w[/*NW - NW0*/])
 {
     logical ldegen;
     int i, ibv, ier, im, iphi, iw, lmax1, npc, nw, verb;
-    long double area, bound[2], darea, vert[2];
+    real_t area, bound[2], darea, vert[2];
     /* work arrays */
     int *iord;
-    long double *v, *phw;
+    real_t *v, *phw;
 
     /* determine area without 2 pi ambiguity, and a good value for tol */
     verb = 1;
@@ -38,7 +41,7 @@ int gsphr(polygon *poly, int lmax, long double *tol, harmonic w[/*NW*/])
 
     /* trivial case of zero area */
     if (area == 0.) {
-	for (iw = 0; iw < NW; iw++) {
+	for (iw = 0; iw < NW - NW0; iw++) {
 	    for (i = 0; i < IM; i++) w[iw][i] = 0.;
 	}
 
@@ -51,12 +54,12 @@ int gsphr(polygon *poly, int lmax, long double *tol, harmonic w[/*NW*/])
 	fprintf(stderr, "gsphr: failed to allocate memory for %d ints\n", poly->np * 2);
 	return(-1);
     }
-    phw = (long double *) malloc(sizeof(long double) * poly->np * 2);
+    phw = (real_t *) malloc(sizeof(real_t) * poly->np * 2);
     if (!phw) {
 	fprintf(stderr, "gsphr: failed to allocate memory for %d long doubles\n", poly->np * 2);
 	return(-1);
     }
-    v = (long double *) malloc(sizeof(long double) * (lmax + 1));
+    v = (real_t *) malloc(sizeof(real_t) * (lmax + 1));
     if (!v) {
 	fprintf(stderr, "gsphr: failed to allocate memory for %d long doubles\n", lmax + 1);
 	return(-1);
@@ -71,10 +74,10 @@ int gsphr(polygon *poly, int lmax, long double *tol, harmonic w[/*NW*/])
     iphi = 0;
 
     /* the fortran routine */
-    gspher_(&darea, bound, vert, w, &lmax1, &im, &nw, poly->rp, poly->cm, &poly->np, &npc, &ibv, &iphi, tol, phw, iord, v, &ldegen);
+    gspher_(&darea, bound, vert, w, &lmin, &lmax1, &im, &nw, poly->rp, poly->cm, &poly->np, &npc, &ibv, &iphi, tol, phw, iord, v, &ldegen);
 
     /* monopole harmonic without 2 pi/sqrtl(4 pi) ambiguity */
-    w[0][0] = area / sqrtl(4. * PI);
+    if (lmin == 0) w[0][0] = area / sqrtl(4. * PI);
 
     /* free work arrays */
     free(iord);
@@ -98,24 +101,26 @@ int gsphr(polygon *poly, int lmax, long double *tol, harmonic w[/*NW*/])
   The overhead means that the accelerated computation is actually slightly
   slower for just a single rectangle.
 
-   Input: lmax = maximum harmonic number.
-  Output: w = array containing spherical harmonics of polygon;
-	      NW = ((lmax + 1)(lmax + 2))/ 2 is defined in harmonics.h.
+   Input: lmin = minimum harmonic number.
+	  lmax = maximum harmonic number.
+  Output: w = array containing spherical harmonics of polygon from lmin to lmax,
+	      as in gsphr.
   Return value:  0 if ok;
 		-1 if could not allocate temporary memory.
 */
-int gsphra(long double azmin, long double azmax, long double elmin, long double elmax, int lmax, harmonic w[/*NW*/])
+int gsphra(real_t azmin, real_t azmax, real_t elmin, real_t elmax, int lmin, int lmax, harmonic w[/*NW - NW0*/])
 {
     /* array used for acceleration */
-    static long double *dw = 0x0;
+    static THREADLOCAL real_t *dw = 0x0;
+    static THREADLOCAL int ndw = 0;
 
     int ibv, im, lmax1, nw;
-    long double area, bound[2], vert[2];
+    real_t area, bound[2], vert[2];
     /* work array */
-    long double *v;
+    real_t *v;
 
     /* allocate memory for work arrays */
-    v = (long double *) malloc(sizeof(long double) * (lmax + 1));
+    v = (real_t *) malloc(sizeof(real_t) * (lmax + 1));
     if (!v) {
 	fprintf(stderr, "gsphra: failed to allocate memory for %d long doubles\n", lmax + 1);
 	return(-1);
@@ -127,17 +132,19 @@ int gsphra(long double azmin, long double azmax, long double elmin, long double
     nw = NW;
     ibv = 0;
 
-    /* dw contains array that is pre-computed, then used by all rects with same elmin, elmax */
-    if (!dw) {
-	dw = (long double *) malloc(sizeof(long double) * NW);
+    /* dw contains array that is pre-computed, then used by all rects with same elmin, elmax, lmin, lmax */
+    if (ndw < NW - NW0) {
+	dw = (real_t *) realloc(dw, sizeof(real_t) * (NW - NW0));
 	if (!dw) {
-	    fprintf(stderr, "gsphra: failed to allocate memory for %d long doubles\n", NW);
+	    fprintf(stderr, "gsphra: failed to allocate memory for %d long doubles\n", NW - NW0);
+	    ndw = 0;
 	    return(-1);
 	}
+	ndw = NW - NW0;
     }
 
     /* fortran routine */
-    gsphera_(&area, bound, vert, w, &lmax1, &im, &nw, &ibv, &azmin, &azmax, &elmin, &elmax, v, dw);
+    gsphera_(&area, bound, vert, w, &lmin, &lmax1, &im, &nw, &ibv, &azmin, &azmax, &elmin, &elmax, v, dw);
 
     /* free work array */
     free(v);
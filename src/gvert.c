@@ -42,12 +42,12 @@
 		1 if fatal degenerate intersection of boundaries;
 		-1 if could not allocate memory.
 */
-int gverts(polygon *poly, int vcirc, long double *tol, int per, int nve, int *nv, vec **ve_p, long double **angle_p, int **ipv_p, int **gp_p, int *nev, int *nev0, int **ev_p)
+int gverts(polygon *poly, int vcirc, real_t *tol, int per, int nve, int *nv, vec **ve_p, real_t **angle_p, int **ipv_p, int **gp_p, int *nev, int *nev0, int **ev_p)
 {
-    static int nvmax = 0, nvemax = 0, npmax = 0;
-    static int *ipv = 0x0, *gp = 0x0, *ev = 0x0;
-    static long double *angle = 0x0;
-    static vec *ve = 0x0;
+    static THREADLOCAL int nvmax = 0, nvemax = 0, npmax = 0;
+    static THREADLOCAL int *ipv = 0x0, *gp = 0x0, *ev = 0x0;
+    static THREADLOCAL real_t *angle = 0x0;
+    static THREADLOCAL vec *ve = 0x0;
 
     int ier;
 
@@ -74,7 +74,7 @@ int gverts(polygon *poly, int vcirc, long double *tol, int per, int nve, int *nv
 		fprintf(stderr, "gverts: failed to allocate memory for %d x %d vecs\n", *nv + DNV, nvemax);
 		return(-1);
 	    }
-	    angle = (long double *) malloc(sizeof(long double) * (*nv + DNV));
+	    angle = (real_t *) malloc(sizeof(real_t) * (*nv + DNV));
 	    if (!angle) {
 		fprintf(stderr, "gverts: failed to allocate memory for %d long doubles\n", *nv + DNV);
 		return(-1);
@@ -155,13 +155,13 @@ int gverts(polygon *poly, int vcirc, long double *tol, int per, int nve, int *nv
 		 1 if fatal intersection of boundaries;
 		-1 if failed to allocate memory.
 */
-int gvert(polygon *poly, int vcirc, long double *tol, int nvmax, int per, int nve, int *nv, vec ve[/*nvmax * nve*/], long double angle[/*nvmax*/], int ipv[/*nvmax*/], int gp[/*poly->np*/], int *nev, int *nev0, int ev[/*nvmax*/])
+int gvert(polygon *poly, int vcirc, real_t *tol, int nvmax, int per, int nve, int *nv, vec ve[/*nvmax * nve*/], real_t angle[/*nvmax*/], int ipv[/*nvmax*/], int gp[/*poly->np*/], int *nev, int *nev0, int ev[/*nvmax*/])
 {
     int iv;
     logical ldegen;
     /* work arrays */
     int *iord, *iwk;
-    long double *phi, *wk;
+    real_t *phi, *wk;
 
     /* allocate memory for work arrays */
     iord = (int *) malloc(sizeof(int) * poly->np * 2);
@@ -169,7 +169,7 @@ int gvert(polygon *poly, int vcirc, long double *tol, int nvmax, int per, int nv
 	fprintf(stderr, "gvert: failed to allocate memory for %d ints\n", poly->np * 2);
 	return(-1);
     }
-    phi = (long double *) malloc(sizeof(long double) * poly->np * 2);
+    phi = (real_t *) malloc(sizeof(real_t) * poly->np * 2);
     if (!phi) {
 	fprintf(stderr, "gvert: failed to allocate memory for %d long doubles\n", poly->np * 2);
 	return(-1);
@@ -179,7 +179,7 @@ int gvert(polygon *poly, int vcirc, long double *tol, int nvmax, int per, int nv
 	fprintf(stderr, "gvert: failed to allocate memory for %d ints\n", nvmax * 4);
 	return(-1);
     }
-    wk = (long double *) malloc(sizeof(long double) * nvmax);
+    wk = (real_t *) malloc(sizeof(real_t) * nvmax);
     if (!wk) {
 	fprintf(stderr, "gvert: failed to allocate memory for %d long doubles\n", nvmax);
 	return(-1);
@@ -47,12 +47,12 @@
 		1 if fatal degenerate intersection of boundaries;
 		-1 if failed to allocate memory.
 */
-int gvlims(polygon *poly, int vcirc, long double *tol, vec vi, int *nv, vec **vmin_p, vec **vmax_p, long double **cmvmin_p, long double **cmvmax_p, long double **cmpmin_p, long double **cmpmax_p, int **ipv_p, int **gp_p, int *nev, int *nev0, int **ev_p)
+int gvlims(polygon *poly, int vcirc, real_t *tol, vec vi, int *nv, vec **vmin_p, vec **vmax_p, real_t **cmvmin_p, real_t **cmvmax_p, real_t **cmpmin_p, real_t **cmpmax_p, int **ipv_p, int **gp_p, int *nev, int *nev0, int **ev_p)
 {
-    static int nvmax = 0, npmax = 0;
-    static int *ipv = 0x0, *gp = 0x0, *ev = 0x0;
-    static long double *cmvmin = 0x0, *cmvmax = 0x0, *cmpmin = 0x0, *cmpmax = 0x0;
-    static vec *vmin = 0x0, *vmax = 0x0;
+    static THREADLOCAL int nvmax = 0, npmax = 0;
+    static THREADLOCAL int *ipv = 0x0, *gp = 0x0, *ev = 0x0;
+    static THREADLOCAL real_t *cmvmin = 0x0, *cmvmax = 0x0, *cmpmin = 0x0, *cmpmax = 0x0;
+    static THREADLOCAL vec *vmin = 0x0, *vmax = 0x0;
 
     int ier;
 
@@ -86,12 +86,12 @@ int gvlims(polygon *poly, int vcirc, long double *tol, vec vi, int *nv, vec **vm
 		fprintf(stderr, "gvlims: failed to allocate memory for %d vecs\n", *nv + DNV);
 		return(-1);
 	    }
-	    cmvmin = (long double *) malloc(sizeof(long double) * (*nv + DNV));
+	    cmvmin = (real_t *) malloc(sizeof(real_t) * (*nv + DNV));
 	    if (!cmvmin) {
 		fprintf(stderr, "gvlims: failed to allocate memory for %d long doubles\n", *nv + DNV);
 		return(-1);
 	    }
-	    cmvmax = (long double *) malloc(sizeof(long double) * (*nv + DNV));
+	    cmvmax = (real_t *) malloc(sizeof(real_t) * (*nv + DNV));
 	    if (!cmvmax) {
 		fprintf(stderr, "gvlims: failed to allocate memory for %d long doubles\n", *nv + DNV);
 		return(-1);
@@ -112,12 +112,12 @@ int gvlims(polygon *poly, int vcirc, long double *tol, vec vi, int *nv, vec **vm
 	    if (cmpmin) free(cmpmin);
 	    if (cmpmax) free(cmpmax);
 	    if (gp) free(gp);
-	    cmpmin = (long double *) malloc(sizeof(long double) * (poly->np + DNV));
+	    cmpmin = (real_t *) malloc(sizeof(real_t) * (poly->np + DNV));
 	    if (!cmpmin) {
 		fprintf(stderr, "gvlims: failed to allocate memory for %d long doubles\n", poly->np + DNV); 
 		return(-1); 
 	    }
-	    cmpmax = (long double *) malloc(sizeof(long double) * (poly->np + DNV));
+	    cmpmax = (real_t *) malloc(sizeof(real_t) * (poly->np + DNV));
 	    if (!cmpmax) {
 		fprintf(stderr, "gvlims: failed to allocate memory for %d long doubles\n", poly->np + DNV); 
 		return(-1); 
@@ -180,12 +180,12 @@ int gvlims(polygon *poly, int vcirc, long double *tol, vec vi, int *nv, vec **vm
 		 1 if fatal degenerate intersection of boundaries;
 		-1 if failed to allocate memory.
 */
-int gvlim(polygon *poly, int vcirc, long double *tol, vec vi, int nvmax, int *nv, vec vmin[/*nvmax*/], vec vmax[/*nvmax*/], long double cmvmin[/*nvmax*/], long double cmvmax[/*nvmax*/], long double cmpmin[/*poly->np*/], long double cmpmax[/*poly->np*/], int ipv[/*nvmax*/], int gp[/*poly->np*/], int *nev, int *nev0, int ev[/*nvmax*/])
+int gvlim(polygon *poly, int vcirc, real_t *tol, vec vi, int nvmax, int *nv, vec vmin[/*nvmax*/], vec vmax[/*nvmax*/], real_t cmvmin[/*nvmax*/], real_t cmvmax[/*nvmax*/], real_t cmpmin[/*poly->np*/], real_t cmpmax[/*poly->np*/], int ipv[/*nvmax*/], int gp[/*poly->np*/], int *nev, int *nev0, int ev[/*nvmax*/])
 {
     logical ldegen;
     /* work arrays */
     int *iord, *iwk;
-    long double *phi, *wk;
+    real_t *phi, *wk;
 
     /* allocate memory for work arrays */
     iord = (int *) malloc(sizeof(int) * poly->np * 2);
@@ -193,7 +193,7 @@ int gvlim(polygon *poly, int vcirc, long double *tol, vec vi, int nvmax, int *nv
 	fprintf(stderr, "gvlim: failed to allocate memory for %d ints\n", poly->np * 2);
 	return(-1);
     }
-    phi = (long double *) malloc(sizeof(long double) * poly->np * 2);
+    phi = (real_t *) malloc(sizeof(real_t) * poly->np * 2);
     if (!phi) {
 	fprintf(stderr, "gvlim: failed to allocate memory for %d long doubles\n", poly->np * 2);
 	return(-1);
@@ -203,7 +203,7 @@ int gvlim(polygon *poly, int vcirc, long double *tol, vec vi, int nvmax, int *nv
 	fprintf(stderr, "gvlim: failed to allocate memory for %d ints\n", nvmax * 4);
 	return(-1);
     }
-    wk = (long double *) malloc(sizeof(long double) * nvmax);
+    wk = (real_t *) malloc(sizeof(real_t) * nvmax);
     if (!wk) {
 	fprintf(stderr, "gvlim: failed to allocate memory for %d long doubles\n", nvmax);
 	return(-1);
@@ -24,11 +24,11 @@
   Return value:  0 if ok;
 		-1 if failed to allocate memory.
 */
-int gvphi(polygon *poly, vec rp, long double cm, vec vi, long double *tol, long double *angle, vec v)
+int gvphi(polygon *poly, vec rp, real_t cm, vec vi, real_t *tol, real_t *angle, vec v)
 {
     /* work arrays */
     int *iord;
-    long double *phi;
+    real_t *phi;
 
     /* allocate memory for work arrays */
     iord = (int *) malloc(sizeof(int) * poly->np * 2);
@@ -36,7 +36,7 @@ int gvphi(polygon *poly, vec rp, long double cm, vec vi, long double *tol, long
 	fprintf(stderr, "gvphi: failed to allocate memory for %d ints\n", poly->np * 2);
 	return(-1);
     }
-    phi = (long double *) malloc(sizeof(long double) * poly->np * 2);
+    phi = (real_t *) malloc(sizeof(real_t) * poly->np * 2);
     if (!phi) {
 	fprintf(stderr, "gvphi: failed to allocate memory for %d long doubles\n", poly->np * 2);
 	return(-1);
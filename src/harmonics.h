@@ -1,7 +1,11 @@
 /*------------------------------------------------------------------------------
  A J S Hamilton 2001
 ------------------------------------------------------------------------------*/
+#include "real.h"
+
 #define IM		2
 #define NW		(((lmax + 1) * (lmax + 2)) / 2)
+/* number of harmonics below lmin, by which a band of harmonics from lmin to lmax is offset */
+#define NW0		((lmin * (lmin + 1)) / 2)
 
-typedef long double harmonic[IM];
+typedef real_t harmonic[IM];
@@ -10,7 +10,7 @@
 #include "defaults.h"
 
 /* getopt options */
-const char *optstr = "dql:m:s:e:i:";
+const char *optstr = "dql:L:m:s:e:i:N:w:C:";
 
 /* allocate polygons as a global array */
 polygon *polys_global[NPOLYSMAX];
@@ -23,10 +23,13 @@ void	usage(void);
 */
 int main(int argc, char *argv[])
 {
-    int ifile, nfiles, npoly, npolys, nws,i;
-    long double area;
-    harmonic *w;
+    char input[] = "input";
+    char *fn;
+    int ifile, imw, iw, lmaxb, lmaxw, lmin, nfiles, npoly, npolys, nw, nws, i;
+    real_t area;
+    harmonic *w, *w0;
     polygon **polys;
+    FILE *file, *wfile;
     polys=polys_global;
 
     /* parse arguments */
@@ -46,14 +49,47 @@ int main(int argc, char *argv[])
 
     msg("---------------- harmonize ----------------\n");
 
+    /* harmonics to which those of the polygons are added */
+    wfile = 0x0;
+    fn = 0x0;
+    if (Wlm_filename) {
+	if (strcmp(Wlm_filename, "-") == 0) {
+	    wfile = stdin;
+	    fn = input;
+	} else {
+	    wfile = fopen(Wlm_filename, "r");
+	    if (!wfile) {
+		fprintf(stderr, "harmonize: cannot open %s for reading\n", Wlm_filename);
+		exit(1);
+	    }
+	    fn = Wlm_filename;
+	}
+	msg("harmonics of the polygons, each signed by its weight, will be added to those in %s\n", fn);
+    }
+
     /* advise harmonic number */
     msg("maximum harmonic number %d\n", lmax);
 
+    /* harmonics computed and written lblock harmonic numbers at a time */
+    if (lblock <= 0 || lblock > lmax) lblock = lmax + 1;
+    if (lblock <= lmax) {
+	if (healpix_nside > 0) {
+	    fprintf(stderr, "harmonize: -N computes all harmonics at once, so cannot be combined with -L\n");
+	    exit(1);
+	}
+	msg("harmonics will be computed and written %d harmonic numbers l at a time\n", lblock);
+    }
+
+    /* directory of harmonics of each polygon */
+    if (harmonic_cache) {
+	msg("harmonics of each polygon will be kept in and reused from directory %s\n", harmonic_cache);
+    }
+
     /* tolerance angle for multiple intersections */
     if (mtol != 0.) {
 	scale(&mtol, munit, 's');
 	munit = 's';
-	msg("multiple intersections closer than %Lg%c will be treated as coincident\n", mtol, munit);
+	msg("multiple intersections closer than %" RL "g%c will be treated as coincident\n", mtol, munit);
 	scale(&mtol, munit, 'r');
 	munit = 'r';
     }
@@ -82,25 +118,90 @@ int main(int argc, char *argv[])
       msg("Running harmonize on polygons that are not snapped and balkanized may give misleading results.\n");
     }
 
-    /* allocate array containing spherical harmonics of complete mask */
-    w = (harmonic *) malloc(sizeof(harmonic) * NW);
+    /* allocate arrays containing spherical harmonics of complete mask,
+       large enough for the largest block of harmonic numbers */
+    nw = 0;
+    for (lmin = 0; lmin <= lmax; lmin += lblock) {
+	lmaxb = (lmin + lblock - 1 < lmax)? lmin + lblock - 1 : lmax;
+	nws = ((lmaxb + 1) * (lmaxb + 2)) / 2 - NW0;
+	if (nws > nw) nw = nws;
+    }
+    w = (harmonic *) malloc(sizeof(harmonic) * nw);
     if (!w) {
-        fprintf(stderr, "harmonize: failed to allocate memory for %d harmonics\n", NW);
+        fprintf(stderr, "harmonize: failed to allocate memory for %d harmonics\n", nw);
         exit(1);
     }
+    w0 = 0x0;
+    if (wfile) {
+	w0 = (harmonic *) malloc(sizeof(harmonic) * nw);
+	if (!w0) {
+	    fprintf(stderr, "harmonize: failed to allocate memory for %d harmonics\n", nw);
+	    exit(1);
+	}
+    }
 
-    /* spherical harmonics of region */
-    npoly = harmonize_polys(npoly, polys, mtol, lmax, w);
-    if (npoly == -1) exit(1);
+    /* open Wlm_outfile for writing */
+    ifile = argc - 1;
+    if (strcmp(argv[ifile], "-") == 0) {
+	file = stdout;
+    } else {
+	file = fopen(argv[ifile], "w");
+	if (!file) {
+	    fprintf(stderr, "harmonize: cannot open %s for writing\n", argv[ifile]);
+	    exit(1);
+	}
+    }
 
-    /* advise area */
-    area = w[0][0] * 2. * sqrtl(PI);
-    msg("area of (weighted) region is %.15Lg str\n", area);
+    /* do each block of harmonic numbers */
+    nws = 0;
+    for (lmin = 0; lmin <= lmax; lmin += lblock) {
+	lmaxb = (lmin + lblock - 1 < lmax)? lmin + lblock - 1 : lmax;
+	nw = ((lmaxb + 1) * (lmaxb + 2)) / 2 - NW0;
+	if (lblock <= lmax) msg("harmonic numbers %d to %d:\n", lmin, lmaxb);
+
+	/* harmonics already computed */
+	if (wfile) {
+	    if (rdspher_band(wfile, fn, &lmaxw, &imw, lmin, lmaxb, w0) == -1) exit(1);
+	    if (lmaxw < lmax) {
+		fprintf(stderr, "harmonize: harmonics in %s go only up to lmax = %d, not %d\n", fn, lmaxw, lmax);
+		exit(1);
+	    }
+	}
 
-    /* write polygons */
-    ifile = argc - 1;
-    nws = wrspher(argv[ifile], lmax, w);
-    if (nws == -1) exit(1);
+	/* spherical harmonics of region */
+	if (healpix_nside > 0) {
+	    msg("approximating harmonics from the mask rasterized on HEALPix pixels at nside %d\n", healpix_nside);
+	    if (harmonize_healpix(healpix_nside, npoly, polys, mtol, lmax, w) == -1) exit(1);
+	} else {
+	    npolys = harmonize_polys(npoly, polys, mtol, lmin, lmaxb, harmonic_cache, w);
+	    if (npolys == -1) exit(1);
+	}
+
+	/* add harmonics already computed */
+	if (wfile) {
+	    for (iw = 0; iw < nw; iw++) {
+		for (i = 0; i < IM; i++) {
+		    w[iw][i] += w0[iw][i];
+		}
+	    }
+	}
+
+	/* advise area */
+	if (lmin == 0) {
+	    area = w[0][0] * 2. * sqrtl(PI);
+	    msg("area of (weighted) region is %.15" RL "g str\n", area);
+	}
+
+	/* write harmonics */
+	nws += wrspher_band(file, lmax, lmin, lmaxb, w);
+    }
+    msg("%d x %d harmonics up to lmax = %d written to %s\n",
+	IM, nws, lmax, (file == stdout)? "output": argv[ifile]);
+
+    if (file != stdout) fclose(file);
+    if (wfile && wfile != stdin) fclose(wfile);
+    free(w);
+    if (w0) free(w0);
 
     for(i=0;i<npoly;i++){
       free_poly(polys[i]);
@@ -114,7 +215,7 @@ int main(int argc, char *argv[])
 void usage(void)
 {
     printf("usage:\n");
-    printf("harmonize [-d] [-q] [-l<lmax>] [-m<a>[u]] [-s<n>] [-e<n>] [-i<f>[<n>][u]] polygon_infile1 [polygon_infile2 ...] Wlm_outfile\n");
+    printf("harmonize [-d] [-q] [-l<lmax>] [-L<n>] [-m<a>[u]] [-s<n>] [-e<n>] [-i<f>[<n>][u]] [-N<n>] [-w<Wlm_infile>] [-C<dir>] polygon_infile1 [polygon_infile2 ...] Wlm_outfile\n");
 #include "usage.h"
 }
 
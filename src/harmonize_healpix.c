@@ -0,0 +1,493 @@
+/*------------------------------------------------------------------------------
+  Fast approximate spherical harmonics of a mask, from its mean weight
+  in HEALPix pixels.
+------------------------------------------------------------------------------*/
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "manglefn.h"
+#include "pi.h"
+
+/* number of extra caps to allocate to polygon, to allow for expansion */
+#define DNP		4
+/* the map is split serially down to this nside, and the pixels there done in parallel */
+#define NSIDE_SPLIT	8
+
+/* pixels at NSIDE_SPLIT, with the polygons that may cut them */
+typedef struct {
+    int n, max;			/* number of pixels, and allocated */
+    int *p;			/* pixel */
+    real_t *wsum;		/* summed weight of polygons containing the pixel */
+    int *start, *ncand;		/* candidate polygons of the pixel in cand */
+    int nc, maxc;		/* number of candidates, and allocated */
+    int *cand;
+} mapsplit;
+
+/* local functions */
+static int pixel_filter(polygon *, int, int, int [], polygon *[], real_t *, int []);
+static int map_split(int, int, int, int, int, int [], int [], polygon *[], real_t, real_t [], mapsplit *);
+static int map_loop(int, int, int, int, int [], int [], polygon *[], real_t, real_t, real_t []);
+
+/*------------------------------------------------------------------------------
+  Sort the candidate polygons of a HEALPix pixel: polygons that the cap
+  containing the pixel is outside of are dropped, those it is inside of
+  add their weight, and the rest, which may cut the pixel, are kept.
+
+   Input: hpoly = HEALPix polygon of pixel, whose fifth cap contains it.
+	  widen = 1 to widen that cap by half, so that it contains the
+		  polygons of the descendants of the pixel too.
+	  ncand = number of candidate polygons.
+	  cand = indices of candidate polygons.
+	  poly = array of pointers to polygons.
+  Output: wsum = incremented by the weights of the polygons containing the pixel.
+	  next = indices of polygons that may cut the pixel.
+  Return value: number of polygons in next.
+*/
+static int pixel_filter(polygon *hpoly, int widen, int ncand, int cand[/*ncand*/], polygon *poly[], real_t *wsum, int next[/*ncand*/])
+{
+    int i, in, inside, ip, k;
+    real_t cmc, th;
+
+    cmc = hpoly->cm[4];
+    if (widen) {
+	th = 3. * asinl(sqrtl(cmc / 2.));
+	cmc = (th < PI)? 2. * sinl(th / 2.) * sinl(th / 2.) : 2.;
+    }
+
+    k = 0;
+    for (i = 0; i < ncand; i++) {
+	inside = 1;
+	for (ip = 0; ip < poly[cand[i]]->np; ip++) {
+	    in = cap_in_cap(hpoly->rp[4], cmc, poly[cand[i]]->rp[ip], poly[cand[i]]->cm[ip]);
+	    if (in == -1) break;
+	    if (in == 0) inside = 0;
+	}
+	if (ip < poly[cand[i]]->np) continue;
+	if (inside) {
+	    *wsum += poly[cand[i]]->weight;
+	} else {
+	    next[k++] = cand[i];
+	}
+    }
+    return(k);
+}
+
+/*------------------------------------------------------------------------------
+  Descend serially from a HEALPix pixel to the pixels at nside ns
+  that the mask may cut, and list them with their candidate polygons.
+  Pixels wholly inside or outside the polygons go straight into the map.
+
+   Input: n, p = HEALPix nside and NESTED number of pixel.
+	  ns = HEALPix nside at which to list pixels.
+	  nside = HEALPix nside of map.
+	  ncand = number of polygons that may cut pixel p.
+	  cand = indices of those polygons.
+	  scratch = space for the candidates of the descendants of p.
+	  poly = array of pointers to polygons.
+	  wsum = summed weight of polygons containing pixel p.
+  Output: map = mean weight in the pixels at nside below pixels wholly
+		inside or outside the polygons.
+	  split = list of pixels at nside ns, reallocated as it grows.
+  Return value: 0 if ok, -1 if error occurred.
+*/
+static int map_split(int n, int p, int ns, int nside, int ncand, int cand[], int scratch[], polygon *poly[], real_t wsum, real_t map[], mapsplit *split)
+{
+    int child, k, *more;
+    long long hpix, nsub;
+    real_t *morew;
+    polygon *hpoly;
+
+    if (n == ns) {
+	if (split->n >= split->max) {
+	    split->max = (split->max > 0)? 2 * split->max : 256;
+	    if (!(more = (int *) realloc(split->p, sizeof(int) * split->max))) goto out_of_memory;
+	    split->p = more;
+	    if (!(morew = (real_t *) realloc(split->wsum, sizeof(real_t) * split->max))) goto out_of_memory;
+	    split->wsum = morew;
+	    if (!(more = (int *) realloc(split->start, sizeof(int) * split->max))) goto out_of_memory;
+	    split->start = more;
+	    if (!(more = (int *) realloc(split->ncand, sizeof(int) * split->max))) goto out_of_memory;
+	    split->ncand = more;
+	}
+	if (split->nc + ncand > split->maxc) {
+	    split->maxc = (split->maxc > 0)? 2 * split->maxc : 1024;
+	    if (split->maxc < split->nc + ncand) split->maxc = split->nc + ncand;
+	    more = (int *) realloc(split->cand, sizeof(int) * split->maxc);
+	    if (!more) goto out_of_memory;
+	    split->cand = more;
+	}
+	split->p[split->n] = p;
+	split->wsum[split->n] = wsum;
+	split->start[split->n] = split->nc;
+	split->ncand[split->n] = ncand;
+	memcpy(&split->cand[split->nc], cand, sizeof(int) * ncand);
+	split->nc += ncand;
+	split->n++;
+	return(0);
+    }
+
+    hpoly = get_healpix_poly(n, p);
+    if (!hpoly) return(-1);
+    k = pixel_filter(hpoly, 1, ncand, cand, poly, &wsum, scratch);
+    free_poly(hpoly);
+
+    /* wholly inside or outside all polygons */
+    if (k == 0) {
+	nsub = (long long)(nside / n) * (nside / n);
+	for (hpix = p * nsub; hpix < (p + 1) * nsub; hpix++) map[hpix] = wsum;
+	return(0);
+    }
+
+    for (child = 4 * p; child < 4 * p + 4; child++) {
+	if (map_split(2 * n, child, ns, nside, k, scratch, &scratch[k], poly, wsum, map, split) == -1) return(-1);
+    }
+    return(0);
+
+    out_of_memory:
+    fprintf(stderr, "map_split: failed to allocate memory for %d pixels\n", split->max);
+    return(-1);
+}
+
+/*------------------------------------------------------------------------------
+  Mean weight of the mask in the HEALPix pixels below a pixel.
+
+   Input: n, p = HEALPix nside and NESTED number of pixel.
+	  nside = HEALPix nside of map.
+	  ncand = number of polygons that may cut pixel p.
+	  cand = indices of those polygons.
+	  scratch = space for the candidates of the descendants of p.
+	  poly = array of pointers to polygons.
+	  wsum = summed weight of polygons containing pixel p.
+	  mtol = tolerance angle for multiple intersections.
+  Output: map = mean weight in the pixels at nside below p.
+  Return value: 0 if ok, -1 if error occurred.
+*/
+static int map_loop(int n, int p, int nside, int ncand, int cand[], int scratch[], polygon *poly[], real_t wsum, real_t mtol, real_t map[])
+{
+    int child, i, ier, k, np, verb;
+    long long hpix, nsub;
+    real_t area, area_h, tol;
+    polygon *hpoly;
+    static THREADLOCAL polygon *part = 0x0;
+
+    hpoly = get_healpix_poly(n, p);
+    if (!hpoly) return(-1);
+    k = pixel_filter(hpoly, (n < nside), ncand, cand, poly, &wsum, scratch);
+
+    /* the pixel is wholly inside or outside all polygons, as are its descendants */
+    if (k == 0) {
+	free_poly(hpoly);
+	nsub = (long long)(nside / n) * (nside / n);
+	for (hpix = p * nsub; hpix < (p + 1) * nsub; hpix++) map[hpix] = wsum;
+	return(0);
+    }
+
+    if (n < nside) {
+	free_poly(hpoly);
+	for (child = 4 * p; child < 4 * p + 4; child++) {
+	    if (map_loop(2 * n, child, nside, k, scratch, &scratch[k], poly, wsum, mtol, map) == -1) return(-1);
+	}
+	return(0);
+    }
+
+    /* fraction of the area of the pixel in each polygon that cuts it */
+    verb = 1;
+    tol = mtol;
+    ier = garea(hpoly, &tol, verb, &area_h);
+    if (ier) goto garea_error;
+    for (i = 0; i < k; i++) {
+	np = poly[scratch[i]]->np + hpoly->np;
+	ier = room_poly(&part, np, DNP, 0);
+	if (ier == -1) {
+	    fprintf(stderr, "healpix_map: failed to allocate memory for polygon of %d caps\n", np + DNP);
+	    free_poly(hpoly);
+	    return(-1);
+	}
+	poly_poly(poly[scratch[i]], hpoly, part);
+	if (trim_poly(part) >= 2) continue;
+	tol = mtol;
+	ier = garea(part, &tol, verb, &area);
+	if (ier) goto garea_error;
+	wsum += poly[scratch[i]]->weight * area / area_h;
+    }
+    free_poly(hpoly);
+    map[p] = wsum;
+    return(0);
+
+    garea_error:
+    fprintf(stderr, "healpix_map: failed to compute area of part of HEALPix pixel %d at nside %d\n", p, nside);
+    free_poly(hpoly);
+    return(-1);
+}
+
+/*------------------------------------------------------------------------------
+  Mean weight of a mask in each HEALPix pixel: the sum over polygons of
+  weight times the fraction of the area of the pixel inside the polygon.
+  The fraction is computed exactly, by intersection, where a polygon cuts
+  a pixel; pixels wholly inside or outside polygons are found from the
+  caps alone, at the coarsest nside they can be.  As in harmonize_polys,
+  the weights of overlapping polygons add.
+
+   Input: nside = HEALPix nside of map.
+	  npoly = number of polygons.
+	  poly = array of pointers to polygons.
+	  mtol = tolerance angle for multiple intersections.
+  Output: map = mean weight in each of the 12 nside^2 pixels, in NESTED order.
+  Return value: 0 if ok, -1 if error occurred.
+*/
+int healpix_map(int nside, int npoly, polygon *poly[/*npoly*/], real_t mtol, real_t map[/*12 nside^2*/])
+{
+    int i, ier, is, levels, n, ncand, ns, *cand, *scratch;
+    long long hpix;
+    mapsplit split;
+
+    for (hpix = 0; hpix < 12 * (long long)nside * nside; hpix++) map[hpix] = 0.;
+
+    /* polygons of nonzero weight */
+    for (levels = 1, n = 1; n < nside; n *= 2) levels++;
+    cand = (int *) malloc(sizeof(int) * npoly * (levels + 1));
+    if (!cand) {
+	fprintf(stderr, "healpix_map: failed to allocate memory for %d ints\n", npoly * (levels + 1));
+	return(-1);
+    }
+    ncand = 0;
+    for (i = 0; i < npoly; i++) {
+	if (poly[i]->weight != 0.) cand[ncand++] = i;
+    }
+
+    /* pixels at nside ns that the mask may cut */
+    ns = (nside < NSIDE_SPLIT)? nside : NSIDE_SPLIT;
+    memset(&split, 0, sizeof(mapsplit));
+    for (i = 0; i < 12; i++) {
+	ier = map_split(1, i, ns, nside, ncand, cand, &cand[ncand], poly, 0., map, &split);
+	if (ier == -1) return(-1);
+    }
+    free(cand);
+
+    /* each of them in parallel, into its own part of the map */
+    ier = 0;
+#ifdef	_OPENMP
+#pragma omp parallel for schedule(dynamic) private(scratch)
+#endif
+    for (is = 0; is < split.n; is++) {
+	scratch = (int *) malloc(sizeof(int) * (split.ncand[is] * levels + 1));
+	if (!scratch
+	    || map_loop(ns, split.p[is], nside, split.ncand[is], &split.cand[split.start[is]], scratch, poly, split.wsum[is], mtol, map) == -1) {
+#ifdef	_OPENMP
+#pragma omp atomic write
+#endif
+	    ier = -1;
+	}
+	if (scratch) free(scratch);
+    }
+    if (ier == -1) return(-1);
+
+    msg("healpix_map: %d of %lld pixels at nside %d cut by the mask\n", split.n, 12 * (long long)ns * ns, ns);
+
+    free(split.p);
+    free(split.wsum);
+    free(split.start);
+    free(split.ncand);
+    if (split.cand) free(split.cand);
+    return(0);
+}
+
+/*------------------------------------------------------------------------------
+  Fast approximate spherical harmonics of a sum of weighted polygons,
+  in place of the exact harmonize_polys, whose cost goes as npoly lmax^2.
+  The mask is rasterized onto HEALPix pixels at nside by healpix_map,
+  and the map analysed ring by ring: for each m, a sum over the equally
+  spaced pixels of a ring in azimuth, then the recursion of the Legendre
+  functions in l, for a northern ring and its southern mirror together.
+  The cost goes as nside lmax^2 + (pixels in mask) lmax, or N^(3/2)
+  for N pixels, with lmax ~ 2 nside.
+
+  The harmonics of the map are those of the mask smoothed over a pixel,
+  so they are divided by the window function of a pixel, taken to be
+  that of a disk of the same area; the correction at lmax is reported.
+  Harmonics above about 2 nside are aliased.
+
+   Input: nside = HEALPix nside.
+	  npoly = number of polygons in poly array.
+	  poly = array of pointers to polygons.
+	  mtol = initial angular tolerance in radians within which to merge multiple intersections.
+	  lmax = maximum harmonic number.
+  Output: w = harmonics, as from harmonize_polys;
+	      NW = ((lmax + 1)(lmax + 2))/ 2 is defined in harmonics.h.
+  Return value: number of HEALPix pixels in the mask,
+		or -1 if error occurred.
+*/
+int harmonize_healpix(int nside, int npoly, polygon *poly[/*npoly*/], real_t mtol, int lmax, harmonic w[/*NW*/])
+{
+    int i, ir, is, iring, iw, j, l, lm, m, n, nhpix, nmap, nring, *jring, *start;
+    long long hpix, mj;
+    real_t al, area, tw, c0, cm, fc, fn[2], fs[2], fsum, phi0, pl, plm, plp, s, sm, x, z, zm, zp;
+    real_t *cosn, *sinn, *fring, *map, *wl, *zmm;
+    harmonic *coef;
+
+    nhpix = 12 * nside * nside;
+    nring = 4 * nside - 1;
+    area = 4. * PI / nhpix;
+
+    map = (real_t *) malloc(sizeof(real_t) * nhpix);
+    if (!map) {
+	fprintf(stderr, "harmonize_healpix: failed to allocate memory for %d long doubles\n", nhpix);
+	return(-1);
+    }
+    if (healpix_map(nside, npoly, poly, mtol, map) == -1) return(-1);
+
+    /* pixels of the mask, grouped by ring, ring iring being from start[iring - 1] to start[iring] */
+    start = (int *) malloc(sizeof(int) * (nring + 2));
+    if (!start) {
+	fprintf(stderr, "harmonize_healpix: failed to allocate memory for %d ints\n", nring + 2);
+	return(-1);
+    }
+    for (ir = 0; ir <= nring; ir++) start[ir] = 0;
+    nmap = 0;
+    for (hpix = 0; hpix < nhpix; hpix++) {
+	if (map[hpix] == 0.) continue;
+	healpix_ring(nside, (int)hpix, &iring, &j);
+	start[iring]++;
+	nmap++;
+    }
+    for (ir = 1; ir <= nring; ir++) start[ir] += start[ir - 1];
+    jring = (int *) malloc(sizeof(int) * (nmap + 1));
+    fring = (real_t *) malloc(sizeof(real_t) * (nmap + 1));
+    if (!jring || !fring) {
+	fprintf(stderr, "harmonize_healpix: failed to allocate memory for %d pixels\n", nmap);
+	return(-1);
+    }
+    for (hpix = nhpix - 1; hpix >= 0; hpix--) {
+	if (map[hpix] == 0.) continue;
+	healpix_ring(nside, (int)hpix, &iring, &j);
+	start[iring]--;
+	jring[start[iring]] = j;
+	fring[start[iring]] = map[hpix];
+    }
+    /* now ring iring is from start[iring] to start[iring + 1], the last ring ending at nmap */
+    start[nring + 1] = nmap;
+    free(map);
+    msg("harmonize_healpix: %d of %d HEALPix pixels at nside %d are in the mask\n", nmap, nhpix, nside);
+
+    /* coefficients of the recursion z(l+1,m) = coef[0] z(l,m) cos th - coef[1] z(l-1,m),
+       where z(l,m) sqrt(2l+1) exp(i m phi) = Y(l,m), as in wrho */
+    coef = (harmonic *) malloc(sizeof(harmonic) * NW);
+    cosn = (real_t *) malloc(sizeof(real_t) * 4 * nside);
+    sinn = (real_t *) malloc(sizeof(real_t) * 4 * nside);
+    zmm = (real_t *) malloc(sizeof(real_t) * (lmax + 1));
+    wl = (real_t *) malloc(sizeof(real_t) * (lmax + 2));
+    if (!coef || !cosn || !sinn || !zmm || !wl) {
+	fprintf(stderr, "harmonize_healpix: failed to allocate memory for %d harmonics\n", NW);
+	return(-1);
+    }
+    for (m = 0; m <= lmax; m++) {
+	for (l = m; l <= lmax; l++) {
+	    lm = (l * (l + 1)) / 2 + m;
+	    coef[lm][0] = (2. * l + 1.) / sqrtl((l + 1. + m) * (l + 1. - m));
+	    coef[lm][1] = sqrtl((l + (real_t)m) * (l - m)) / sqrtl((l + 1. + m) * (l + 1. - m));
+	}
+    }
+
+    for (iw = 0; iw < NW; iw++) {
+	w[iw][0] = 0.;
+	w[iw][1] = 0.;
+    }
+
+    /* northern ring ir, and its southern mirror is, which has the same longitudes */
+    for (ir = 1; ir <= 2 * nside; ir++) {
+	is = 4 * nside - ir;
+	if (start[ir] == start[ir + 1] && (is == ir || start[is] == start[is + 1])) continue;
+
+	n = healpix_ring_z(nside, ir, &x, &phi0);
+	tw = 2. * PI / n;
+	for (i = 0; i < n; i++) {
+	    cosn[i] = cosl(tw * i);
+	    sinn[i] = sinl(tw * i);
+	}
+	/* z(m,m) */
+	s = sqrtl((1. - x) * (1. + x));
+	zmm[0] = 1. / sqrtl(4. * PI);
+	for (m = 1; m <= lmax; m++) zmm[m] = - sqrtl((m - 0.5) / m) * s * zmm[m - 1];
+
+#ifdef	_OPENMP
+#pragma omp parallel for schedule(dynamic, 16) private(al, cm, fc, fn, fs, fsum, i, l, lm, mj, sm, z, zm, zp)
+#endif
+	for (m = 0; m <= lmax; m++) {
+	    /* sum over ring of map exp(-i m phi), phi = phi0 + 2 pi j / n */
+	    cm = cosl(m * phi0);
+	    sm = sinl(m * phi0);
+	    fc = fsum = 0.;
+	    for (i = start[ir]; i < start[ir + 1]; i++) {
+		mj = ((long long)m * jring[i]) % n;
+		fc += fring[i] * cosn[mj];
+		fsum += fring[i] * sinn[mj];
+	    }
+	    fn[0] = cm * fc - sm * fsum;
+	    fn[1] = - sm * fc - cm * fsum;
+	    fc = fsum = 0.;
+	    if (is != ir) {
+		for (i = start[is]; i < start[is + 1]; i++) {
+		    mj = ((long long)m * jring[i]) % n;
+		    fc += fring[i] * cosn[mj];
+		    fsum += fring[i] * sinn[mj];
+		}
+	    }
+	    fs[0] = cm * fc - sm * fsum;
+	    fs[1] = - sm * fc - cm * fsum;
+
+	    /* z(l,-x) = (-1)^(l+m) z(l,x) */
+	    zm = 0.;
+	    z = zmm[m];
+	    for (l = m; l <= lmax; l++) {
+		lm = (l * (l + 1)) / 2 + m;
+		al = z * sqrtl(2. * l + 1.);
+		if ((l + m) % 2 == 0) {
+		    w[lm][0] += al * (fn[0] + fs[0]);
+		    w[lm][1] += al * (fn[1] + fs[1]);
+		} else {
+		    w[lm][0] += al * (fn[0] - fs[0]);
+		    w[lm][1] += al * (fn[1] - fs[1]);
+		}
+		zp = coef[lm][0] * x * z - coef[lm][1] * zm;
+		zm = z;
+		z = zp;
+	    }
+	}
+    }
+
+    /* window function of a disk of the area of a pixel, 1 - cos th = area / 2 pi */
+    c0 = 1. - area / (2. * PI);
+    plm = 1.;
+    pl = c0;
+    wl[0] = 1.;
+    for (l = 1; l <= lmax; l++) {
+	al = l;
+	plp = ((2. * al + 1.) * c0 * pl - al * plm) / (al + 1.);
+	wl[l] = (plm - plp) / ((2. * al + 1.) * (1. - c0));
+	plm = pl;
+	pl = plp;
+    }
+    for (l = 0; l <= lmax; l++) {
+	for (m = 0; m <= l; m++) {
+	    lm = (l * (l + 1)) / 2 + m;
+	    w[lm][0] *= area / wl[l];
+	    w[lm][1] *= area / wl[l];
+	}
+    }
+    msg("harmonize_healpix: harmonics divided by the pixel window function, 1/W_l = %.6" RL "g at lmax = %d\n", 1. / wl[lmax], lmax);
+    if (lmax > 2 * nside) {
+	msg("WARNING: harmonics above l = 2 nside = %d are aliased; use a larger nside\n", 2 * nside);
+    }
+
+    free(start);
+    free(jring);
+    free(fring);
+    free(coef);
+    free(cosn);
+    free(sinn);
+    free(zmm);
+    free(wl);
+
+    return(nmap);
+}
@@ -4,38 +4,152 @@
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "manglefn.h"
 #include "pi.h"
 
 /* advise how many polygons done if lmax >= this */
 #define LMAX_ADVICE		250
 
+/*------------------------------------------------------------------------------
+  Name of the file in directory cache holding the harmonics of a polygon.
+*/
+static char *cache_name(char *cache, unsigned long long key)
+{
+    static THREADLOCAL char *name = 0x0;
+    static THREADLOCAL size_t size = 0;
+    size_t len;
+
+    len = strlen(cache) + 24;
+    if (len > size) {
+	name = (char *) realloc(name, len);
+	if (!name) {
+	    fprintf(stderr, "cache_name: failed to allocate memory for %lu characters\n", (unsigned long)len);
+	    size = 0;
+	    return(0x0);
+	}
+	size = len;
+    }
+    sprintf(name, "%s/%016llx.w", cache, key);
+    return(name);
+}
+
+/*------------------------------------------------------------------------------
+  Read the harmonics of a polygon of unit weight from directory cache.
+  A cache file holds lmax, the caps of the polygon, and the harmonics,
+  in binary; it is used only if its caps are exactly those of poly,
+  and its lmax is at least that wanted.
+
+   Input: cache = name of directory.
+	  key = fingerprint of the caps of poly.
+	  poly = polygon.
+	  lmin = minimum harmonic number.
+	  lmax = maximum harmonic number.
+  Output: dw = harmonics from lmin to lmax.
+  Return value: 1 if harmonics were read from cache;
+		0 if not.
+*/
+static int rd_cache(char *cache, unsigned long long key, polygon *poly, int lmin, int lmax, harmonic dw[/*NW - NW0*/])
+{
+    char *name;
+    int ip, lmaxc, np, ok;
+    real_t cm;
+    vec rp;
+    FILE *file;
+
+    name = cache_name(cache, key);
+    if (!name) return(0);
+    file = fopen(name, "rb");
+    if (!file) return(0);
+
+    ok = (fread(&lmaxc, sizeof(int), 1, file) == 1 && lmaxc >= lmax
+	  && fread(&np, sizeof(int), 1, file) == 1 && np == poly->np);
+    for (ip = 0; ok && ip < np; ip++) {
+	ok = (fread(rp, sizeof(vec), 1, file) == 1 && fread(&cm, sizeof(real_t), 1, file) == 1
+	      && rp[0] == poly->rp[ip][0] && rp[1] == poly->rp[ip][1] && rp[2] == poly->rp[ip][2]
+	      && cm == poly->cm[ip]);
+    }
+    /* harmonics in order of l, so those from lmin to lmax are together */
+    if (ok) ok = (fseek(file, (long)(sizeof(harmonic) * NW0), SEEK_CUR) == 0
+		  && fread(dw, sizeof(harmonic), NW - NW0, file) == NW - NW0);
+
+    fclose(file);
+    return(ok);
+}
+
+/*------------------------------------------------------------------------------
+  Write the harmonics of a polygon of unit weight to directory cache.
+
+   Input: cache = name of directory.
+	  key = fingerprint of the caps of poly.
+	  poly = polygon.
+	  lmax = maximum harmonic number.
+	  dw = harmonics.
+  Return value: 0 if ok;
+		-1 if error occurred.
+*/
+static int wr_cache(char *cache, unsigned long long key, polygon *poly, int lmax, harmonic dw[/*NW*/])
+{
+    char *name;
+    int ip, ok;
+    FILE *file;
+
+    name = cache_name(cache, key);
+    if (!name) return(-1);
+    file = fopen(name, "wb");
+    if (!file) {
+	fprintf(stderr, "harmonize_polys: cannot open %s for writing\n", name);
+	return(-1);
+    }
+
+    ok = (fwrite(&lmax, sizeof(int), 1, file) == 1 && fwrite(&poly->np, sizeof(int), 1, file) == 1);
+    for (ip = 0; ok && ip < poly->np; ip++) {
+	ok = (fwrite(poly->rp[ip], sizeof(vec), 1, file) == 1 && fwrite(&poly->cm[ip], sizeof(real_t), 1, file) == 1);
+    }
+    if (ok) ok = (fwrite(dw, sizeof(harmonic), NW, file) == NW);
+
+    if (fclose(file) != 0) ok = 0;
+    if (!ok) {
+	fprintf(stderr, "harmonize_polys: error writing %s\n", name);
+	remove(name);
+	return(-1);
+    }
+    return(0);
+}
+
 /*------------------------------------------------------------------------------
   Spherical harmonics of sum of weighted polygons.
 
    Input: poly = array of pointers to npoly polygons.
 	  npoly = number of polygons in poly array.
 	  mtol = initial angular tolerance in radians within which to merge multiple intersections.
+	  lmin = minimum harmonic number.
 	  lmax = maximum harmonic number.
-  Output: w = harmonics;
-	      NW = ((lmax + 1)(lmax + 2))/ 2 is defined in harmonics.h.
+	  cache = name of directory in which the harmonics of each polygon
+		  are kept, by fingerprint of its caps, and reused;
+		  0x0 or "" for none;
+		  harmonics are written to it only if lmin = 0.
+  Output: w = harmonics from lmin to lmax, w[0] being the harmonic l = lmin, m = 0;
+	      NW - NW0 = ((lmax + 1)(lmax + 2) - lmin (lmin + 1))/ 2
+	      is defined in harmonics.h.
   Return value: number of polygons for which spherical harmonics were computed,
 		or -1 if error occurred.
 */
-int harmonize_polys(int npoly, polygon *poly[/*npoly*/], long double mtol, int lmax, harmonic w[/*NW*/])
+int harmonize_polys(int npoly, polygon *poly[/*npoly*/], real_t mtol, int lmin, int lmax, char *cache, harmonic w[/*NW - NW0*/])
 {
-    int accelerate, i, ier, ip, ipoly, iq, ir, isrect, iw, naccelerate, ndone, ner, nrect;
-    long double azmin, azmax, elmin, elmax, azmn, azmx, elmn, elmx, tol;
+    int accelerate, cached, i, ier, ip, ipoly, iq, ir, isrect, iw, naccelerate, ncached, ndone, ner, nrect;
+    unsigned long long key;
+    real_t azmin, azmax, elmin, elmax, azmn, azmx, elmn, elmx, tol;
     /* work array contains harmonics of single polygon */
     harmonic *dw;
     /* work arrays to deal with possible acceleration */
     int *iord, *ir_to_ip;
-    long double *elord;
+    real_t *elord;
 
     /* work arrays */
-    dw = (harmonic *) malloc(sizeof(harmonic) * NW);
+    dw = (harmonic *) malloc(sizeof(harmonic) * (NW - NW0));
     if (!dw) {
-	fprintf(stderr, "harmonize_polys: failed to allocate memory for %d harmonics\n", NW);
+	fprintf(stderr, "harmonize_polys: failed to allocate memory for %d harmonics\n", NW - NW0);
 	return(-1);
     }
     iord = (int *) malloc(sizeof(int) * npoly);
@@ -48,14 +162,14 @@ int harmonize_polys(int npoly, polygon *poly[/*npoly*/], long double mtol, int l
 	fprintf(stderr, "harmonize_polys: failed to allocate memory for %d ints\n", npoly);
 	return(-1);
     }
-    elord = (long double *) malloc(sizeof(long double) * npoly);
+    elord = (real_t *) malloc(sizeof(real_t) * npoly);
     if (!elord) {
 	fprintf(stderr, "harmonize_polys: failed to allocate memory for %d long doubles\n", npoly);
 	return(-1);
     }
 
     /* zero harmonics of mask */
-    for (iw = 0; iw < NW; iw++) {
+    for (iw = 0; iw < NW - NW0; iw++) {
 	for (i = 0; i < IM; i++) {
 	    w[iw][i] = 0.;
 	}
@@ -84,15 +198,31 @@ int harmonize_polys(int npoly, polygon *poly[/*npoly*/], long double mtol, int l
     /* do each polygon */
     ndone = 0;
     naccelerate = 0;
+    ncached = 0;
     ner = 0;
+    if (cache && !cache[0]) cache = 0x0;
     if (lmax >= LMAX_ADVICE) msg("doing polygon number (of %d):\n", npoly);
     for (ip = 0; ip < npoly; ip++) {
 	if (lmax >= LMAX_ADVICE) msg(" %d", ip);
 	accelerate = 0;
+	cached = 0;
+	key = 0;
+	ipoly = (ip < nrect)? ir_to_ip[iord[ip]] : ir_to_ip[ip];
+	/* zero weight polygon requires no computation */
+	if (poly[ipoly]->weight == 0.) {
+	    ndone++;
+	    continue;
+	}
+	/* harmonics of polygon already computed */
+	if (cache) {
+	    key = poly_key(poly[ipoly], mtol);
+	    cached = rd_cache(cache, key, poly[ipoly], lmin, lmax, dw);
+	}
+	if (cached) {
+	    ier = 0;
+	    ncached++;
 	/* rectangle */
-	if (ip < nrect) {
-	    ir = iord[ip];
-	    ipoly = ir_to_ip[ir];
+	} else if (ip < nrect) {
 	    poly_to_rect(poly[ipoly], &azmin, &azmax, &elmin, &elmax);
 	    /* does previous rectangle have same elevation limits? */
 	    if (ip > 0) {
@@ -112,26 +242,23 @@ int harmonize_polys(int npoly, polygon *poly[/*npoly*/], long double mtol, int l
 	    }
 	    /* accelerated computation */
 	    if (accelerate) {
-		ier = gsphra(azmin, azmax, elmin, elmax, lmax, dw);
+		ier = gsphra(azmin, azmax, elmin, elmax, lmin, lmax, dw);
 		if (ier == -1) return(-1);
 	    /* standard computation */
 	    } else {
 		tol = mtol;
-		ier = gsphr(poly[ipoly], lmax, &tol, dw);
+		ier = gsphr(poly[ipoly], lmin, lmax, &tol, dw);
 		if (ier == -1) return(-1);
 	    }
 	/* non-rectangle */
 	} else {
-	    ipoly = ir_to_ip[ip];
-	    /* zero weight polygon requires no computation */
-	    if (poly[ipoly]->weight == 0.) {
-		ndone++;
-		continue;
-	    } else {
-		tol = mtol;
-		ier = gsphr(poly[ipoly], lmax, &tol, dw);
-		if (ier == -1) return(-1);
-	    }
+	    tol = mtol;
+	    ier = gsphr(poly[ipoly], lmin, lmax, &tol, dw);
+	    if (ier == -1) return(-1);
+	}
+	/* keep harmonics of polygon for reuse */
+	if (cache && !cached && !ier && lmin == 0) {
+	    if (wr_cache(cache, key, poly[ipoly], lmax, dw) == -1) return(-1);
 	}
 	/* computation failed */
 	if (ier) {
@@ -143,7 +270,7 @@ int harmonize_polys(int npoly, polygon *poly[/*npoly*/], long double mtol, int l
 	    naccelerate += accelerate;
 	    ndone++;
 	    /* increment harmonics of region */
-	    for (iw = 0; iw < NW; iw++) {
+	    for (iw = 0; iw < NW - NW0; iw++) {
 		for (i = 0; i < IM; i++) {
 		    w[iw][i] += dw[iw][i] * poly[ipoly]->weight;
 		}
@@ -154,6 +281,7 @@ int harmonize_polys(int npoly, polygon *poly[/*npoly*/], long double mtol, int l
 
     /* number of computations that were accelerated */
     msg("computation was accelerated for %d rectangles\n", naccelerate);
+    if (cache) msg("harmonics of %d polygons were read from cache %s\n", ncached, cache);
     /* advise */
     if (ner > 0) {
 	fprintf(stderr, "harmonize_polys: discarded %d polygons for which computations failed\n", ner);
@@ -15,10 +15,10 @@ extern polygon *polys[];
       real *8 w(IM,NW)
       call harmonizepolys(mtol, lmax, w)
 */
-void harmonizepolys_(long double *mtol, int *lmax, harmonic w[])
+void harmonizepolys_(real_t *mtol, int *lmax, harmonic w[])
 {
     int ndone;
 
-    ndone = harmonize_polys(npolys, polys, *mtol, *lmax, w);
+    ndone = harmonize_polys(npolys, polys, *mtol, 0, *lmax, 0x0, w);
     if (ndone == -1) exit(1);
 }
@@ -34,7 +34,7 @@
 #include "pi.h"
 #include "manglefn.h"
 
-void healpix_ang2pix_nest( const int nside, long double theta, long double phi, int *ipix) {
+void healpix_ang2pix_nest( const int nside, real_t theta, real_t phi, int *ipix) {
 
   /* =======================================================================
    * subroutine ang2pix_nest(nside, theta, phi, ipix)
@@ -48,21 +48,21 @@ void healpix_ang2pix_nest( const int nside, long double theta, long double phi,
    * =======================================================================
    */
   
-  long double z, za, z0, tt, tp, tmp;
+  real_t z, za, z0, tt, tp, tmp;
   int    face_num,jp,jm;
   int    ifp, ifm;
   int    ix, iy, ix_low, ix_hi, iy_low, iy_hi, ipf, ntt;
   int    i, K, IP, I, J, id;
   int    ns_max = 8192;
-  static int x2pix[128], y2pix[128];
-  static char setup_done = 0;
+  static THREADLOCAL int x2pix[128], y2pix[128];
+  static THREADLOCAL char setup_done = 0;
   
   if( nside < 1 || nside > ns_max ) {
     fprintf(stderr, "healpix_ang2pix_nest: nside out of range: %d\n", nside);
     exit(0);
   }
   if( theta < 0. || theta > PI ) {
-    fprintf(stderr, "healpix_ang2pix_nest: theta out of range: %Lf\n", theta);
+    fprintf(stderr, "healpix_ang2pix_nest: theta out of range: %" RL "f\n", theta);
     exit(0);
   }
   if( !setup_done ) {
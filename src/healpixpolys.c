@@ -6,10 +6,16 @@
 #include "pi.h"
 #include "manglefn.h"
 
+/* defined below */
+static void face_vertex(int, long long, long long, long long, vec);
+static void nest_xy(long long, long long, int *, long long *, long long *);
+
 /*-----------------------------------------------------------
-  get_healpix_poly: uses the HEALPix Fortran subroutine
-                     pix2vec_nest to construct the HEALPix
-                     pixels at the desired resolution
+  get_healpix_poly: constructs a HEALPix pixel at the desired
+                    resolution, bounded by the circles through
+                    the two corners and the midpoint of each
+                    edge, plus a fifth cap about its center
+                    that just contains its corners
 
   Input: nside = HEALPix parameter describing resolution (for
                  res >= 1, simply defined by 2^(res-1); for
@@ -21,232 +27,1107 @@
 
 polygon *get_healpix_poly(int nside, int hpix)
 {
-  int nv, nvmax, i, pix_n, pix_e, pix_s, pix_w, ev[1];
-  vertices *vert;
-  polygon *pixel, *pixelbetter;
-  long double verts_vec[12], verts_vec_n[12], verts_vec_e[12], verts_vec_s[12], verts_vec_w[12], dist_n, dist_w, dist_s, dist_e;
-  vec center, center_n, center_e, center_s, center_w, vertices_vec[4], vertices_vec_n[4], vertices_vec_e[4], vertices_vec_s[4], vertices_vec_w[4];
-  azel *vertices_azel[8], vertices[8];
-
-  for(i=0;i<=7;i++) vertices_azel[i] = &(vertices[i]);
+  /* corners N, W, S, E, each followed by the midpoint of the next edge,
+     in coordinates at 2 nside relative to the south corner */
+  static const int corner[8][2] = {
+    {2, 2}, {1, 2}, {0, 2}, {0, 1}, {0, 0}, {1, 0}, {2, 0}, {2, 1}
+  };
+  int i, face, ev[1];
+  long long x, y;
+  real_t dist;
+  vec center, v[8];
+  azel v_azel[8];
+  vertices vert;
+  polygon *pixel;
 
   if (nside == 0) {
      pixel=new_poly(0);
+     if(!pixel){
+       fprintf(stderr, "error in get_healpix_poly: failed to allocate memory for polygon of 0 caps\n");
+       return(0x0);
+     }
+     pixel->np=0;
      pixel->weight=1;
      pixel->pixel=0;
      
      return(pixel);
   }
 
-  else {
-    healpix_verts(nside, hpix, center, verts_vec);
-    
-    /* north vertex */
-    for(i=0;i<=2;i++) (vertices_vec[0])[i] = verts_vec[i];
+  nest_xy(nside, hpix, &face, &x, &y);
+  for(i=0; i<8; i++){
+    face_vertex(face, 2*x+corner[i][0], 2*y+corner[i][1], 2*(long long)nside, v[i]);
+    rp_to_azel(v[i], &v_azel[i]);
+    if(v_azel[i].az < 0.) v_azel[i].az += TWOPI;
+    if(v_azel[i].az >= TWOPI) v_azel[i].az -= TWOPI;
+  }
+  face_vertex(face, 2*x+1, 2*y+1, 2*(long long)nside, center);
 
-    /* east vertex */
-    for(i=0;i<=2;i++) (vertices_vec[1])[i] = verts_vec[i+3];
+  pixel=new_poly(5);
+  if(!pixel){
+    fprintf(stderr, "error in get_healpix_poly: failed to allocate memory for polygon of 5 caps\n");
+    return(0x0);
+  }
 
-    /* south vertex */
-    for(i=0;i<=2;i++) (vertices_vec[2])[i] = verts_vec[i+6];
+  vert.nv=8; vert.nvmax=8; vert.v=v_azel;
+  ev[0] = 8;
+  edge_to_poly(&vert, 2, &ev[0], pixel);
 
-    /* west vertex */
-    for(i=0;i<=2;i++) (vertices_vec[3])[i] = verts_vec[i+9];
+  /* fifth cap, about the center, just containing the farthest corner */
+  pixel->np = 5;
+  for(i=0;i<=2;i++) pixel->rp[4][i] = center[i];
+  pixel->cm[4] = 0.;
+  for(i=0; i<8; i+=2){
+    dist = cmrpirpj(center, v[i]);
+    if(dist > pixel->cm[4]) pixel->cm[4] = dist;
+  }
+  pixel->cm[4] += 0.000001;
 
-    rp_to_azel(vertices_vec[0], vertices_azel[0]);
-    rp_to_azel(vertices_vec[3], vertices_azel[2]);
-    rp_to_azel(vertices_vec[2], vertices_azel[4]);
-    rp_to_azel(vertices_vec[1], vertices_azel[6]);
+  pixel->id = (long long)hpix;
+  pixel->pixel = 0;
+  pixel->weight = 0.;
 
-    pix_n = 4*hpix + 3;
-    pix_e = 4*hpix + 1;
-    pix_s = 4*hpix;
-    pix_w = 4*hpix + 2;
+  return(pixel);
+}
 
-    healpix_verts(nside*2, pix_n, center_n, verts_vec_n);
-    healpix_verts(nside*2, pix_e, center_e, verts_vec_e);
-    healpix_verts(nside*2, pix_s, center_s, verts_vec_s);
-    healpix_verts(nside*2, pix_w, center_w, verts_vec_w);
+/*-----------------------------------------------------------
+  healpix_polys: constructs many HEALPix pixels at once, in
+                 parallel, as get_healpix_poly does
 
-    /* north vertex of each child pixel */
-    for(i=0;i<=2;i++){
-      (vertices_vec_n[0])[i] = verts_vec_n[i];
-      (vertices_vec_e[0])[i] = verts_vec_e[i];
-      (vertices_vec_s[0])[i] = verts_vec_s[i];
-      (vertices_vec_w[0])[i] = verts_vec_w[i];
-    }
+  Input: nside = HEALPix parameter describing resolution
+         npix = number of pixels
+         hpix = array of id numbers of HEALPix pixels
+  Output: poly = array of pointers to polygons
+  Return value: number of polygons constructed
+                -1 if error occurred
+*/
 
-    /* east vertex of each child pixel */
-    for(i=0;i<=2;i++){
-      (vertices_vec_n[1])[i] = verts_vec_n[i+3];
-      (vertices_vec_e[1])[i] = verts_vec_e[i+3];
-      (vertices_vec_s[1])[i] = verts_vec_s[i+3];
-      (vertices_vec_w[1])[i] = verts_vec_w[i+3];
-    }
+int healpix_polys(int nside, int npix, int hpix[/*npix*/], polygon *poly[/*npix*/])
+{
+  int i, ier;
 
-    /* south vertex of each child pixel */
-    for(i=0;i<=2;i++){
-      (vertices_vec_n[2])[i] = verts_vec_n[i+6];
-      (vertices_vec_e[2])[i] = verts_vec_e[i+6];
-      (vertices_vec_s[2])[i] = verts_vec_s[i+6];
-      (vertices_vec_w[2])[i] = verts_vec_w[i+6];
+  ier = 0;
+#ifdef	_OPENMP
+#pragma omp parallel for schedule(static, 1024)
+#endif
+  for(i=0; i<npix; i++){
+    poly[i] = get_healpix_poly(nside, hpix[i]);
+    if(!poly[i]){
+#ifdef	_OPENMP
+#pragma omp atomic write
+#endif
+      ier = -1;
     }
+  }
+  if(ier == -1) return(-1);
+  return(npix);
+}
 
-    /* west vertex of each child pixel */
-    for(i=0;i<=2;i++){
-      (vertices_vec_n[3])[i] = verts_vec_n[i+9];
-      (vertices_vec_e[3])[i] = verts_vec_e[i+9];
-      (vertices_vec_s[3])[i] = verts_vec_s[i+9];
-      (vertices_vec_w[3])[i] = verts_vec_w[i+9];
-    }
-    
-    rp_to_azel(vertices_vec_n[3], vertices_azel[1]);
-    rp_to_azel(vertices_vec_w[2], vertices_azel[3]);
-    rp_to_azel(vertices_vec_s[1], vertices_azel[5]);
-    rp_to_azel(vertices_vec_e[0], vertices_azel[7]);
-
-    for(i=0; i<8; i++){
-      if(vertices[i].az < 0.) vertices[i].az = vertices[i].az + TWOPI;
-      else {};
-    }
+/*------------------------------------------------------------
+  get_nside: determines the HEALPix nside parameter (related to
+             the resolution) from the number of weights (i.e.,
+	     polygons) listed in the input file
 
-    for(i=0; i<8; i++){
-      if(vertices[i].az >= TWOPI) vertices[i].az = vertices[i].az - TWOPI;
-      else {};
-    } 
+  Input: nweights = number of weights in HEALPix_weight input file
+  Return value: nside parameter
+*/
 
-    nv=8; nvmax=8;
-    vert=new_vert(nvmax);
-    if(!vert){
-      fprintf(stderr, "error in get_healpix_poly: failed to allocate memory for 8 vertices\n");
-      return(0x0);
-    }
-    vert->nv=nv; vert->v=&vertices[0];
+int get_nside(int nweights)
+{
+  int res, nside;
+  real_t res_d;
 
-    pixel=new_poly(4);
-    
-    if(!pixel){
-      fprintf(stderr, "error in get_healpix_poly: failed to allocate memory for polygon of 4 caps\n");
-      return(0x0);
-    }
+  if (nweights == 1) {
+     nside = 0;
+     return(nside);
+  }
+
+  else {
+    res_d = (real_t)(logl(((real_t)nweights)/3.0)/logl(4.0));
+
+    /* res_d is often slightly under the correct res, so we add 0.1 to make it correct upon truncation */
+    res = (int)(res_d+0.1);
+    nside = (int)(powl(2,(int)(res-1)));
+    return(nside);
+  }
+}
+
+/*-------------------------------------------------------------
+  cmrpirpj: C version of Fortran subroutine that calculates the value
+         of (1-cosl(th(ij))), where th(ij) is the angle between the
+	 unit vectors rpi and rpj
 
-    ev[0] = 8;
+  Input: rpi, rpj = unit vectors
+  Return value: 1- cosl(th(ij))
+*/
 
-    edge_to_poly(vert, 2, &ev[0], pixel);
-    pixel->id = (long long)hpix;
+real_t cmrpirpj(vec rpi, vec rpj)
+{
+  real_t cmij;
+  
+  cmij = (powl((rpi[0]-rpj[0]),2)+powl((rpi[1]-rpj[1]),2)+powl((rpi[2]-rpj[2]),2))/2.;
+  return(cmij);
+}
 
-    pixelbetter=new_poly(5);
-    
-    if(!pixelbetter){
-      fprintf(stderr, "error in get_healpix_poly: failed to allocate memory for polygon of 5 caps\n");
-      return(0x0);
-    }
+/*-------------------------------------------------------------
+  The HEALPix-like NESTED pixelization scheme 'h' (see get_pixel)
+  needs pixel polygons that nest exactly, so that a pixel is
+  the union of its children.  HEALPix pixel edges are not
+  circles, so the pixels are not the HEALPix ones, only numbered
+  like them: each of the 12 base pixels is bounded by the
+  circles through the two corners and the midpoint of each of
+  its edges, with a fifth cap, the hemisphere about its center,
+  since some edge caps are larger than a hemisphere.  Each
+  pixel is cut into its 4 children by 2 great circles through
+  points on opposite edges of the pixel polygon itself, placed
+  so that the children have equal area: solved for in pixels
+  down to resolution 5 (see quad_split), and in closed form in
+  finer pixels (see quad_halve).  The pixels at each resolution
+  are therefore equal in area to within 0.3%, little more than
+  the 0.2% by which the base pixels differ, and none is empty.
+  Since each pixel inherits the edges of its parent, the pixels
+  drift from the HEALPix ones as the resolution rises: the
+  point in a pixel is in the HEALPix pixel of the same number
+  (ang2pix_nest) for 99% of points at resolution 1, but only
+  for a minority beyond resolution 5.  Finding the pixel of a
+  point descends through the same cuts, so it is not O(1) as
+  for HEALPix, but takes a fixed amount of work at each
+  resolution, about 0.6 microseconds.
+*/
 
-    pixelbetter->np = 5;
-    pixelbetter->npmax = 5;
+/* ring and longitude of the southernmost corner of each base pixel, as in pix2vec_nest */
+static const int jrll[12] = {2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4};
+static const int jpll[12] = {1, 3, 5, 7, 0, 2, 4, 6, 1, 3, 5, 7};
 
-    for(i=0; i<=3; i++) {
-      pixelbetter->rp[i][0] = pixel->rp[i][0];
-      pixelbetter->rp[i][1] = pixel->rp[i][1];
-      pixelbetter->rp[i][2] = pixel->rp[i][2];
-      pixelbetter->cm[i] = pixel->cm[i];
-    }
+/* the base pixel caps, and corners S, E, N, W, set up once */
+static THREADLOCAL int base_done = 0;
+static THREADLOCAL vec base_rp[12][5];
+static THREADLOCAL real_t base_cm[12][5];
+static THREADLOCAL vec base_v[12][4];
 
-    pixelbetter->rp[4][0] = center[0]; pixelbetter->rp[4][1] = center[1]; pixelbetter->rp[4][2] = center[2];
-    pixelbetter->id = (long long)hpix;
+/*-------------------------------------------------------------
+  face_vertex: unit vector of the HEALPix vertex at integer
+               coordinates x, y in a base pixel at nside n,
+               without the table set up that pix2vec_nest
+               does on every call
 
-    dist_n = cmrpirpj(center, vertices_vec[0]);
-    dist_w = cmrpirpj(center, vertices_vec[3]);
-    dist_s = cmrpirpj(center, vertices_vec[2]);
-    dist_e = cmrpirpj(center, vertices_vec[1]);
+  Input: face = base pixel, 0 to 11
+         x, y = coordinates, 0 to n; x increases to the east
+                and y to the west, so pixel ix, iy has corners
+                S = (ix,iy), E = (ix+1,iy), W = (ix,iy+1) and
+                N = (ix+1,iy+1)
+         n = nside
+  Output: r = unit vector
+*/
+static void face_vertex(int face, long long x, long long y, long long n, vec r)
+{
+  real_t t, u, z, sth, phi;
 
-    if(dist_n>=dist_w && dist_n>=dist_s && dist_n>=dist_e){
-      pixelbetter->cm[4] = dist_n+0.000001;
-    }
-    else if(dist_w>=dist_n && dist_w>=dist_s && dist_w>=dist_e){
-      pixelbetter->cm[4] = dist_w+0.000001;
+  /* ring, in units of nside, counted from the north pole */
+  t = (real_t)(jrll[face]*n - x - y)/n;
+  if(t < 1.){
+    /* north polar cap */
+    z = 1. - t*t/3.;
+    sth = t*sqrtl((2. - t*t/3.)/3.);
+    phi = (t > 0.)? PI/4.*(jpll[face] + (real_t)(x - y)/n/t) : 0.;
+  }
+  else if(t > 3.){
+    /* south polar cap */
+    u = 4. - t;
+    z = -1. + u*u/3.;
+    sth = u*sqrtl((2. - u*u/3.)/3.);
+    phi = (u > 0.)? PI/4.*(jpll[face] + (real_t)(x - y)/n/u) : 0.;
+  }
+  else{
+    z = (2. - t)*2./3.;
+    sth = sqrtl((1. - z)*(1. + z));
+    phi = PI/4.*(jpll[face] + (real_t)(x - y)/n);
+  }
+  r[0] = sth*cosl(phi);
+  r[1] = sth*sinl(phi);
+  r[2] = z;
+}
+
+/*-------------------------------------------------------------
+  nest_xy: base pixel and coordinates x, y of a HEALPix
+           NESTED pixel, whose bits interleave those of x and y
+*/
+static void nest_xy(long long nside, long long hpix, int *face, long long *x, long long *y)
+{
+  int b;
+  long long sub;
+
+  *face = (int)(hpix/(nside*nside));
+  sub = hpix%(nside*nside);
+  *x = *y = 0;
+  for(b=0;(1LL<<b)<nside;b++){
+    *x |= ((sub>>(2*b))&1)<<b;
+    *y |= ((sub>>(2*b+1))&1)<<b;
+  }
+}
+
+/*-------------------------------------------------------------
+  circle_cap: cap bounded by the circle through 3 points
+
+  Input: p0, p1, p2 = unit vectors of points on the circle
+         inside = unit vector of a point inside the cap
+  Output: rp, cm = cap
+*/
+static void circle_cap(vec p0, vec p1, vec p2, vec inside, vec rp, real_t *cm)
+{
+  int i;
+  real_t d, norm;
+  vec a, b;
+
+  for(i=0;i<=2;i++){
+    a[i] = p1[i] - p0[i];
+    b[i] = p2[i] - p0[i];
+  }
+  rp[0] = a[1]*b[2] - a[2]*b[1];
+  rp[1] = a[2]*b[0] - a[0]*b[2];
+  rp[2] = a[0]*b[1] - a[1]*b[0];
+  norm = sqrtl(rp[0]*rp[0] + rp[1]*rp[1] + rp[2]*rp[2]);
+  for(i=0;i<=2;i++) rp[i] /= norm;
+
+  /* the circle is r.rp = d */
+  d = rp[0]*p0[0] + rp[1]*p0[1] + rp[2]*p0[2];
+  *cm = 1. - d;
+  if(rp[0]*inside[0] + rp[1]*inside[1] + rp[2]*inside[2] < d) *cm = -*cm;
+}
+
+/*-------------------------------------------------------------
+  incap: whether unit vector r lies in cap rp, cm, exactly as
+         gptin decides it
+*/
+static int incap(vec rp, real_t cm, vec r)
+{
+  real_t cmij;
+
+  cmij = ((r[0]-rp[0])*(r[0]-rp[0]) + (r[1]-rp[1])*(r[1]-rp[1]) + (r[2]-rp[2])*(r[2]-rp[2]))/2.;
+  if(cm >= 0.) return(cmij <= cm);
+  return(cmij > -cm);
+}
+
+/*-------------------------------------------------------------
+  base_setup: caps of the 12 base pixels.
+  A corner shared by two base pixels can come out slightly
+  differently for each, so points are first merged, and each
+  edge circle is computed from the merged points in the same
+  order for both of its pixels; the two pixels then get the
+  cap and its exact complement.
+*/
+static void base_setup(void)
+{
+  /* corners S, E, W, N and edge midpoints, in coordinates at nside 2 */
+  static const int edge[4][3][2] = {
+    {{0, 0}, {1, 0}, {2, 0}},	/* SE */
+    {{0, 0}, {0, 1}, {0, 2}},	/* SW */
+    {{2, 2}, {2, 1}, {2, 0}},	/* NE */
+    {{2, 2}, {1, 2}, {0, 2}}	/* NW */
+  };
+  /* edge and point of edge[][] at each corner S, E, N, W */
+  static const int corner[4][2] = {{0, 0}, {0, 2}, {2, 0}, {1, 2}};
+  int b, e, i, j, k, ip[4][3], npts;
+  vec center, p, pts[12*4*3];
+
+  npts = 0;
+  for(b=0;b<12;b++){
+    face_vertex(b, 1, 1, 2, center);
+    for(e=0;e<4;e++){
+      for(k=0;k<3;k++){
+	face_vertex(b, edge[e][k][0], edge[e][k][1], 2, p);
+	for(j=0;j<npts;j++){
+	  if(cmrpirpj(pts[j], p) < 1.e-20) break;
+	}
+	if(j==npts){
+	  for(i=0;i<=2;i++) pts[npts][i] = p[i];
+	  npts++;
+	}
+	ip[e][k] = j;
+      }
+      if(ip[e][0] < ip[e][2]){
+	circle_cap(pts[ip[e][0]], pts[ip[e][1]], pts[ip[e][2]], center, base_rp[b][e], &base_cm[b][e]);
+      }
+      else{
+	circle_cap(pts[ip[e][2]], pts[ip[e][1]], pts[ip[e][0]], center, base_rp[b][e], &base_cm[b][e]);
+      }
     }
-    else if(dist_s>=dist_n && dist_s>=dist_w && dist_s>=dist_e){
-      pixelbetter->cm[4] = dist_s+0.000001;
+    for(k=0;k<4;k++){
+      for(i=0;i<=2;i++) base_v[b][k][i] = pts[ip[corner[k][0]][corner[k][1]]][i];
     }
-    else if(dist_e>=dist_n && dist_e>=dist_s && dist_e>=dist_w){
-      pixelbetter->cm[4] = dist_e+0.000001;
+    for(i=0;i<=2;i++) base_rp[b][4][i] = center[i];
+    base_cm[b][4] = 1.;
+  }
+  base_done = 1;
+}
+
+/* edge e of a pixel runs from corner edge_end[e][0] to corner edge_end[e][1],
+   where the edges are SE, SW, NE, NW and the corners S, E, N, W;
+   going counterclockwise around the pixel runs along edges SE and NE,
+   and back along SW and NW */
+static const int edge_end[4][2] = {{0, 1}, {0, 3}, {1, 2}, {3, 2}};
+static const real_t edge_dir[4] = {1., -1., 1., -1.};
+
+/* corners, and caps of the edges, of a pixel polygon of scheme 'h';
+   each edge cap contains the pixel */
+typedef struct {
+  vec v[4];
+  vec rp[4];
+  real_t cm[4];
+} hquad;
+
+/* the 2 cuts of a pixel into its children, each a cap that
+   contains the south child, the points m where they split
+   edges SE, SW, NE, NW, the corner c shared by the children,
+   and the fractions of the way along the edges, t along SW
+   and NE, s along SE and u along NW, that place the cuts */
+typedef struct {
+  vec rp[2];
+  real_t cm[2];
+  vec m[4];
+  vec c;
+  real_t t, s, u;
+} hsplit;
+
+/* relative precision to which the children of a pixel are
+   made equal in area, and the most iterations to get there */
+#define SPLIT_TOL	1.e-9
+#define SPLIT_ITER	32
+
+/* pixels of resolution up to SPLIT_SOLVE_RES are cut by
+   solving for children of equal area, and their fractions
+   t, s, u kept in a table once found; finer pixels, nearly
+   parallelograms, are cut in closed form (see quad_halve) */
+#define SPLIT_SOLVE_RES	5
+static THREADLOCAL real_t *split_table = 0x0;
+
+/*-------------------------------------------------------------
+  small_atan2: atan2(y, x), from its series when y/x is small,
+               as it is for all but the largest pixels
+*/
+static real_t small_atan2(real_t y, real_t x)
+{
+  real_t t, t2;
+
+  if(x > 0. && fabsl(y) < 1.e-2*x){
+    t = y/x;
+    t2 = t*t;
+    return(t*(1. - t2*(1./3. - t2*(1./5. - t2*(1./7. - t2/9.)))));
+  }
+  return(atan2l(y, x));
+}
+
+/*-------------------------------------------------------------
+  unit_cross: unit vector along a x b
+*/
+static void unit_cross(vec a, vec b, vec c)
+{
+  int i;
+  real_t norm;
+
+  c[0] = a[1]*b[2] - a[2]*b[1];
+  c[1] = a[2]*b[0] - a[0]*b[2];
+  c[2] = a[0]*b[1] - a[1]*b[0];
+  norm = 1./sqrtl(c[0]*c[0] + c[1]*c[1] + c[2]*c[2]);
+  for(i=0;i<=2;i++) c[i] *= norm;
+}
+
+/*-------------------------------------------------------------
+  tri_area: area of the spherical triangle with corners a, b, c,
+            positive if they go counterclockwise, by the formula
+            of Van Oosterom & Strackee, which keeps its precision
+            for small triangles
+*/
+static real_t tri_area(vec a, vec b, vec c)
+{
+  real_t x, y;
+
+  y = a[0]*(b[1]*c[2] - b[2]*c[1]) + a[1]*(b[2]*c[0] - b[0]*c[2]) + a[2]*(b[0]*c[1] - b[1]*c[0]);
+  x = 1. + a[0]*b[0] + a[1]*b[1] + a[2]*b[2] + b[0]*c[0] + b[1]*c[1] + b[2]*c[2] + c[0]*a[0] + c[1]*a[1] + c[2]*a[2];
+  return(2.*small_atan2(y, x));
+}
+
+/*-------------------------------------------------------------
+  seg_area: area between the arc from a to b of the circle of
+            cap rp, cm and the great circle through a and b,
+            positive if the cap bulges out beyond the great
+            circle to the right of the arc
+*/
+static real_t seg_area(vec rp, real_t cm, vec a, vec b)
+{
+  int i;
+  real_t d, s;
+  vec n, ap, bp, c;
+
+  /* the cap is r.n >= d */
+  s = (cm >= 0.)? 1. : -1.;
+  for(i=0;i<=2;i++) n[i] = s*rp[i];
+  d = s*(1. - fabsl(cm));
+  for(i=0;i<=2;i++){
+    ap[i] = a[i] - d*n[i];
+    bp[i] = b[i] - d*n[i];
+  }
+  c[0] = ap[1]*bp[2] - ap[2]*bp[1];
+  c[1] = ap[2]*bp[0] - ap[0]*bp[2];
+  c[2] = ap[0]*bp[1] - ap[1]*bp[0];
+  /* sector of the cap, less the triangle with the great circle */
+  return((1. - d)*small_atan2(c[0]*n[0] + c[1]*n[1] + c[2]*n[2], ap[0]*bp[0] + ap[1]*bp[1] + ap[2]*bp[2]) - tri_area(n, a, b));
+}
+
+/*-------------------------------------------------------------
+  edge_seg: seg_area along edge e of a pixel polygon from a to
+            b, which is 0 for the great circles of the cuts, so
+            only edges from the base pixels need it
+*/
+static real_t edge_seg(hquad *q, int e, vec a, vec b)
+{
+  if(fabsl(q->cm[e]) == 1.) return(0.);
+  return(seg_area(q->rp[e], q->cm[e], a, b));
+}
+
+/*-------------------------------------------------------------
+  quad_area: area of a pixel polygon of scheme 'h'
+*/
+static real_t quad_area(hquad *q)
+{
+  int e;
+  real_t area;
+
+  area = tri_area(q->v[0], q->v[1], q->v[2]) + tri_area(q->v[0], q->v[2], q->v[3]);
+  for(e=0;e<4;e++){
+    area += edge_dir[e]*edge_seg(q, e, q->v[edge_end[e][0]], q->v[edge_end[e][1]]);
+  }
+  return(area);
+}
+
+/*-------------------------------------------------------------
+  edge_point: point on edge e of a pixel polygon, where the
+              line from the center of the sphere through the
+              point the fraction s of the way along the straight
+              line between the corners meets the edge, as seen
+              from the axis of the edge circle
+*/
+static void edge_point(hquad *q, int e, real_t s, vec m)
+{
+  int i;
+  real_t d, sth, wr;
+  real_t *a, *b, *rp;
+  vec w;
+
+  a = q->v[edge_end[e][0]];
+  b = q->v[edge_end[e][1]];
+  rp = q->rp[e];
+  for(i=0;i<=2;i++) w[i] = (1. - s)*a[i] + s*b[i];
+  wr = w[0]*rp[0] + w[1]*rp[1] + w[2]*rp[2];
+  for(i=0;i<=2;i++) w[i] -= wr*rp[i];
+  d = 1. - fabsl(q->cm[e]);
+  sth = sqrtl((1. - d)*(1. + d)/(w[0]*w[0] + w[1]*w[1] + w[2]*w[2]));
+  for(i=0;i<=2;i++) m[i] = d*rp[i] + sth*w[i];
+}
+
+/*-------------------------------------------------------------
+  edge_meet: point where the great circle with axis c meets
+             edge e of a pixel, on the same side as point w
+*/
+static void edge_meet(hquad *q, int e, vec c, vec w, vec m)
+{
+  int i;
+  real_t d, g, h, k;
+  real_t *rp;
+  vec x;
+
+  /* the edge is r.rp = d, the great circle r.c = 0, and
+     m = d (rp - g c) h + k rp x c, with g = rp.c, h = 1/(1 - g^2) */
+  rp = q->rp[e];
+  d = 1. - fabsl(q->cm[e]);
+  g = rp[0]*c[0] + rp[1]*c[1] + rp[2]*c[2];
+  h = 1./(1. - g*g);
+  x[0] = rp[1]*c[2] - rp[2]*c[1];
+  x[1] = rp[2]*c[0] - rp[0]*c[2];
+  x[2] = rp[0]*c[1] - rp[1]*c[0];
+  k = sqrtl((1. - d*d*h)*h);
+  if(x[0]*w[0] + x[1]*w[1] + x[2]*w[2] < 0.) k = -k;
+  if(d == 0.){
+    for(i=0;i<=2;i++) m[i] = k*x[i];
+  }
+  else{
+    for(i=0;i<=2;i++) m[i] = d*(rp[i] - g*c[i])*h + k*x[i];
+  }
+}
+
+/*-------------------------------------------------------------
+  cut_ok: whether cap rp, cm contains corners j0 and j1 of a
+          pixel but neither of the other 2
+*/
+static int cut_ok(vec rp, real_t cm, hquad *q, int j0, int j1)
+{
+  int j;
+
+  for(j=0;j<4;j++){
+    if(incap(rp, cm, q->v[j]) != (j==j0 || j==j1)) return(0);
+  }
+  return(1);
+}
+
+/*-------------------------------------------------------------
+  quad_child: corners and edges of child k of a pixel
+*/
+static void quad_child(hquad *q, int k, hsplit *sp)
+{
+  /* corners S, E, N, W of each child, numbered as
+     corners S, E, N, W of the parent 0-3, points m 4-7, and c 8 */
+  static const int cv[4][4] = {{0, 4, 8, 5}, {4, 1, 6, 8}, {5, 8, 7, 3}, {8, 6, 2, 7}};
+  /* edges SE, SW, NE, NW of each child, numbered as
+     edges of the parent 0-3, and cuts 4-5 */
+  static const int ce[4][4] = {{0, 1, 4, 5}, {0, 4, 2, 5}, {5, 1, 4, 3}, {5, 4, 2, 3}};
+  int i, j, kc;
+  real_t *p;
+  hquad parent;
+
+  parent = *q;
+  for(j=0;j<4;j++){
+    p = (cv[k][j] < 4)? parent.v[cv[k][j]] : (cv[k][j] < 8)? sp->m[cv[k][j]-4] : sp->c;
+    for(i=0;i<=2;i++) q->v[j][i] = p[i];
+    if(ce[k][j] < 4){
+      for(i=0;i<=2;i++) q->rp[j][i] = parent.rp[ce[k][j]][i];
+      q->cm[j] = parent.cm[ce[k][j]];
     }
     else{
-      fprintf(stderr, "error in get_healpix_poly: cannot find correct fifth cap\n");
-      return(0x0);
+      /* children 1 and 3 lie outside cut 0, children 2 and 3 outside cut 1 */
+      kc = ce[k][j] - 4;
+      for(i=0;i<=2;i++) q->rp[j][i] = sp->rp[kc][i];
+      q->cm[j] = (k & (1 << kc))? -sp->cm[kc] : sp->cm[kc];
     }
+  }
+}
+
+/*-------------------------------------------------------------
+  cut_at: cut of a pixel through the points the fractions s0
+          and s1 of the way along edges e0 and e1, the great
+          circle, whose cap contains corner S
+*/
+static void cut_at(hquad *q, int e0, real_t s0, int e1, real_t s1, vec rp, real_t *cm, vec m0, vec m1)
+{
+  edge_point(q, e0, s0, m0);
+  edge_point(q, e1, s1, m1);
+  unit_cross(m0, m1, rp);
+  *cm = (incap(rp, 1., q->v[0]))? 1. : -1.;
+}
+
+/*-------------------------------------------------------------
+  cut_through: cut of a pixel, the great circle through points
+               w0 and w1 on the chords of edges e0 and e1, whose
+               cap contains corner S
+*/
+static void cut_through(hquad *q, int e0, vec w0, int e1, vec w1, vec rp, real_t *cm, vec m0, vec m1)
+{
+  unit_cross(w0, w1, rp);
+  *cm = (incap(rp, 1., q->v[0]))? 1. : -1.;
+  edge_meet(q, e0, rp, w0, m0);
+  edge_meet(q, e1, rp, w1, m1);
+}
+
+/*-------------------------------------------------------------
+  cut_corner: the corner shared by the children of a pixel,
+              where its cuts cross
+*/
+static void cut_corner(hsplit *sp)
+{
+  int i;
+  real_t norm;
+  real_t *c;
+
+  c = sp->c;
+  unit_cross(sp->rp[0], sp->rp[1], c);
+  norm = 0.;
+  for(i=0;i<=2;i++) norm += c[i]*(sp->m[0][i] + sp->m[3][i]);
+  if(norm < 0.){
+    for(i=0;i<=2;i++) c[i] = -c[i];
+  }
+}
+
+/*-------------------------------------------------------------
+  cut1_at: cut 1 of a pixel, through the points the fraction t
+           of the way along edges SW and NE
+*/
+static void cut1_at(hquad *q, real_t t, hsplit *sp)
+{
+  sp->t = t;
+  cut_at(q, 1, t, 2, t, sp->rp[1], &sp->cm[1], sp->m[1], sp->m[2]);
+}
+
+/*-------------------------------------------------------------
+  cut0_at: cut 0 of a pixel, given cut 1, through the points
+           the fractions s and u of the way along edges SE
+           and NW, and the corner shared by the children
+*/
+static void cut0_at(hquad *q, real_t s, real_t u, hsplit *sp)
+{
+  sp->s = s;
+  sp->u = u;
+  cut_at(q, 0, s, 3, u, sp->rp[0], &sp->cm[0], sp->m[0], sp->m[3]);
+  cut_corner(sp);
+}
+
+/*-------------------------------------------------------------
+  south_area: area of the south half of a pixel, given cut 1
+*/
+static real_t south_area(hquad *q, hsplit *sp)
+{
+  real_t *m1, *m2;
+
+  m1 = sp->m[1];
+  m2 = sp->m[2];
+  /* counterclockwise S, E, m NE, m SW */
+  return(tri_area(q->v[0], q->v[1], m2) + tri_area(q->v[0], m2, m1)
+	 + edge_seg(q, 0, q->v[0], q->v[1]) + edge_seg(q, 2, q->v[1], m2) + edge_seg(q, 1, m1, q->v[0]));
+}
+
+/*-------------------------------------------------------------
+  west_areas: areas of the west children 0 and 2 of a pixel,
+              given its cuts
+*/
+static void west_areas(hquad *q, hsplit *sp, real_t a[2])
+{
+  real_t *c, *m0, *m1, *m3;
+
+  c = sp->c;
+  m0 = sp->m[0];
+  m1 = sp->m[1];
+  m3 = sp->m[3];
+  /* counterclockwise S, m SE, c, m SW, and m SW, c, m NW, W */
+  a[0] = tri_area(q->v[0], m0, c) + tri_area(q->v[0], c, m1)
+    + edge_seg(q, 0, q->v[0], m0) + edge_seg(q, 1, m1, q->v[0]);
+  a[1] = tri_area(m1, c, m3) + tri_area(m1, m3, q->v[3])
+    + edge_seg(q, 3, m3, q->v[3]) + edge_seg(q, 1, q->v[3], m1);
+}
+
+/*-------------------------------------------------------------
+  quad_split: the 2 great circles that cut a pixel into its 4
+              children of equal area
+
+  Cut 1, between the south children 0, 1 and the north ones
+  2, 3, goes through the points the same fraction of the way
+  along edges SW and NE, found by the secant method to halve
+  the pixel.  Cut 0, between the west children 0, 2 and the
+  east ones 1, 3, goes through points on edges SE and NW
+  placed independently, found by Broyden's method to halve
+  both halves, starting from the Jacobian of a parallelogram.
+  Should either not converge, or a cut not separate the
+  corners it should, the pixel is cut through the middles of
+  its edges, which always gives 4 children, though not quite
+  of equal area.
+
+  Input: q = corners and edges of pixel
+  Output: sp = cuts
+*/
+static void quad_split(hquad *q, hsplit *sp)
+{
+  int it;
+  real_t area, ds, du, den, f0, f1, s, t0, t1, t2, u;
+  real_t a[2], df[2], dx[2], f[2], h[2][2], hdf[2], xh[2];
+
+  area = quad_area(q);
+
+  /* cut 1 */
+  t0 = .5;
+  cut1_at(q, t0, sp);
+  f0 = south_area(q, sp) - area/2.;
+  t1 = t0 - f0/area;
+  for(it=0;it<SPLIT_ITER && fabsl(f0)>SPLIT_TOL*area;it++){
+    cut1_at(q, t1, sp);
+    f1 = south_area(q, sp) - area/2.;
+    t2 = (f1 == f0)? t1 : t1 - f1*(t1 - t0)/(f1 - f0);
+    t0 = t1;
+    f0 = f1;
+    if(t2 == t1) break;
+    t1 = t2;
+  }
+  /* sp now holds cut 1 through t0 */
+  if(fabsl(f0) > SPLIT_TOL*area || t0 <= 0. || t0 >= 1.) goto middle;
+
+  /* cut 0 */
+  s = u = .5;
+  h[0][0] = h[1][1] = 3./area;
+  h[0][1] = h[1][0] = -1./area;
+  cut0_at(q, s, u, sp);
+  west_areas(q, sp, a);
+  f[0] = a[0] - area/4.;
+  f[1] = a[1] - area/4.;
+  for(it=0;it<SPLIT_ITER && fabsl(f[0])+fabsl(f[1])>SPLIT_TOL*area;it++){
+    dx[0] = -(h[0][0]*f[0] + h[0][1]*f[1]);
+    dx[1] = -(h[1][0]*f[0] + h[1][1]*f[1]);
+    s += dx[0];
+    u += dx[1];
+    if(s <= 0. || s >= 1. || u <= 0. || u >= 1.) goto middle;
+    cut0_at(q, s, u, sp);
+    west_areas(q, sp, a);
+    df[0] = a[0] - area/4. - f[0];
+    df[1] = a[1] - area/4. - f[1];
+    f[0] += df[0];
+    f[1] += df[1];
+    hdf[0] = h[0][0]*df[0] + h[0][1]*df[1];
+    hdf[1] = h[1][0]*df[0] + h[1][1]*df[1];
+    den = dx[0]*hdf[0] + dx[1]*hdf[1];
+    if(den == 0.) break;
+    xh[0] = dx[0]*h[0][0] + dx[1]*h[1][0];
+    xh[1] = dx[0]*h[0][1] + dx[1]*h[1][1];
+    ds = (dx[0] - hdf[0])/den;
+    du = (dx[1] - hdf[1])/den;
+    h[0][0] += ds*xh[0];
+    h[0][1] += ds*xh[1];
+    h[1][0] += du*xh[0];
+    h[1][1] += du*xh[1];
+  }
+  if(fabsl(f[0])+fabsl(f[1]) <= SPLIT_TOL*area
+     && cut_ok(sp->rp[0], sp->cm[0], q, 0, 3) && cut_ok(sp->rp[1], sp->cm[1], q, 0, 1)) return;
+
+ middle:
+  cut1_at(q, .5, sp);
+  cut0_at(q, .5, .5, sp);
+}
 
+/*-------------------------------------------------------------
+  halve_root: root x, 0 < x < 1, of
+              a x^2 / 2 + b x + d (3 x^2 - 2 x^3) = c,
+              from the quadratic if d = 0, and refined by 2
+              steps of Newton's method if not, which suffice
+              since d is small; or .5 if there is none
+*/
+static real_t halve_root(real_t a, real_t b, real_t d, real_t c)
+{
+  int it;
+  real_t x;
 
-    if(!pixelbetter){
-      fprintf(stderr, "error in get_healpix_poly: polygon is NULL.\n");
-      return(0x0);
+  x = b*b + 2.*a*c;
+  if(b <= 0. || c <= 0. || x < 0.) return(.5);
+  x = 2.*c/(b + sqrtl(x));
+  if(d != 0.){
+    for(it=0;it<2;it++){
+      x -= (x*(b + a*x/2.) + d*x*x*(3. - 2.*x) - c)/(b + a*x + 6.*d*x*(1. - x));
     }
+  }
+  return((x > 0. && x < 1.)? x : .5);
+}
+
+/*-------------------------------------------------------------
+  quad_halve: the 2 great circles that cut a pixel into its 4
+              children, in closed form
+
+  On the plane tangent to the sphere at the center of the
+  pixel, its corners projected from the center of the sphere
+  span the bilinear image P(a, b) of the unit square, with
+  a = s along edge SE, b = t along edge SW, and Jacobian
+  j0 + j1 a + j2 b.  Lines of constant a or b are straight,
+  so great circles on the sphere, and the areas they cut off
+  are quadratic in a and b: cut 1 is the line b = t that
+  halves the pixel, and cut 0 goes from a = s on edge SE to
+  a = u on edge NW, where s and u halve the south and north
+  halves.  An edge from a base pixel bulges beyond the chord
+  between its corners, by a circular segment whose area up
+  to the fraction x of the way along it is that of the whole
+  times 3 x^2 - 2 x^3, to the order that matters.  The
+  children are equal in area to second order in the size of
+  the pixel and in its departure from a parallelogram, which
+  both halve at each resolution.
+
+  Input: q = corners and edges of pixel
+  Output: sp = cuts
+*/
+static void quad_halve(hquad *q, hsplit *sp)
+{
+  int e, i, j;
+  real_t area, g, j0, j1, j2, norm, s, t, u;
+  real_t bulge[4];
+  vec e1, e2, f, n, p[4], w[4];
+
+  /* corners projected onto the plane tangent at the center */
+  for(i=0;i<=2;i++) n[i] = q->v[0][i] + q->v[1][i] + q->v[2][i] + q->v[3][i];
+  norm = 1./sqrtl(n[0]*n[0] + n[1]*n[1] + n[2]*n[2]);
+  for(i=0;i<=2;i++) n[i] *= norm;
+  for(j=0;j<4;j++){
+    norm = 1./(q->v[j][0]*n[0] + q->v[j][1]*n[1] + q->v[j][2]*n[2]);
+    for(i=0;i<=2;i++) p[j][i] = q->v[j][i]*norm;
+  }
+
+  /* Jacobian of the bilinear map */
+  for(i=0;i<=2;i++){
+    e1[i] = p[1][i] - p[0][i];
+    e2[i] = p[3][i] - p[0][i];
+    f[i] = p[2][i] - p[1][i] - e2[i];
+  }
+  j0 = n[0]*(e1[1]*e2[2] - e1[2]*e2[1]) + n[1]*(e1[2]*e2[0] - e1[0]*e2[2]) + n[2]*(e1[0]*e2[1] - e1[1]*e2[0]);
+  j1 = n[0]*(e1[1]*f[2] - e1[2]*f[1]) + n[1]*(e1[2]*f[0] - e1[0]*f[2]) + n[2]*(e1[0]*f[1] - e1[1]*f[0]);
+  j2 = n[0]*(f[1]*e2[2] - f[2]*e2[1]) + n[1]*(f[2]*e2[0] - f[0]*e2[2]) + n[2]*(f[0]*e2[1] - f[1]*e2[0]);
+
+  /* area, with the bulges of the edges beyond their chords */
+  area = j0 + (j1 + j2)/2.;
+  for(e=0;e<4;e++){
+    bulge[e] = edge_dir[e]*edge_seg(q, e, q->v[edge_end[e][0]], q->v[edge_end[e][1]]);
+    area += bulge[e];
+  }
 
-    return(pixelbetter);
+  t = halve_root(j2, j0 + j1/2., bulge[1] + bulge[2], area/2. - bulge[0]);
+  g = t*t*(3. - 2.*t);
+  s = halve_root(t*j1, t*(j0 + j2*t/2.), bulge[0], area/4. - bulge[1]*g);
+  u = halve_root((1. - t)*j1, (1. - t)*(j0 + j2*(1. + t)/2.), bulge[3], area/4. - bulge[1]*(1. - g));
+
+  /* the cuts through the points at those fractions of the
+     way along the chords of the edges, on the tangent plane */
+  for(i=0;i<=2;i++){
+    w[0][i] = (1. - s)*p[0][i] + s*p[1][i];
+    w[1][i] = (1. - t)*p[0][i] + t*p[3][i];
+    w[2][i] = (1. - t)*p[1][i] + t*p[2][i];
+    w[3][i] = (1. - u)*p[3][i] + u*p[2][i];
   }
+  sp->t = t;
+  sp->s = s;
+  sp->u = u;
+  cut_through(q, 1, w[1], 2, w[2], sp->rp[1], &sp->cm[1], sp->m[1], sp->m[2]);
+  cut_through(q, 0, w[0], 3, w[3], sp->rp[0], &sp->cm[0], sp->m[0], sp->m[3]);
+  cut_corner(sp);
 }
 
-/*------------------------------------------------------------
-  get_nside: determines the HEALPix nside parameter (related to
-             the resolution) from the number of weights (i.e.,
-	     polygons) listed in the input file
+/*-------------------------------------------------------------
+  pixel_split: cuts of a pixel into its children, solved for
+               once for each pixel up to SPLIT_SOLVE_RES, and
+               in closed form after that
 
-  Input: nweights = number of weights in HEALPix_weight input file
-  Return value: nside parameter
+  Input: res = resolution of pixel
+         hpix = NESTED pixel number
+         q = corners and edges of pixel
+  Output: sp = cuts
 */
+static void pixel_split(int res, int hpix, hquad *q, hsplit *sp)
+{
+  long long i, n;
+  real_t *f;
 
-int get_nside(int nweights)
+  if(res <= SPLIT_SOLVE_RES){
+    if(!split_table){
+      /* pixels are numbered on from 4^res - 4 at each resolution;
+	 should there be no memory, every split is solved anew */
+      n = (4LL << (2*SPLIT_SOLVE_RES)) - 4;
+      split_table = (real_t *) malloc(sizeof(real_t) * 3 * n);
+      if(split_table){
+	for(i=0;i<n;i++) split_table[3*i] = -1.;
+      }
+    }
+    if(split_table){
+      f = &split_table[3*((1LL << (2*res)) - 4 + hpix)];
+      if(f[0] < 0.){
+	quad_split(q, sp);
+	f[0] = sp->t;
+	f[1] = sp->s;
+	f[2] = sp->u;
+      }
+      else{
+	cut1_at(q, f[0], sp);
+	cut0_at(q, f[1], f[2], sp);
+      }
+      return;
+    }
+    quad_split(q, sp);
+    return;
+  }
+  quad_halve(q, sp);
+}
+
+/*-------------------------------------------------------------
+  base_quad: corners and edges of a base pixel
+*/
+static void base_quad(int base, hquad *q)
 {
-  int res, nside;
-  long double res_d;
+  int i, j;
 
-  if (nweights == 1) {
-     nside = 0;
-     return(nside);
+  if(!base_done) base_setup();
+
+  for(j=0;j<4;j++){
+    for(i=0;i<=2;i++){
+      q->v[j][i] = base_v[base][j][i];
+      q->rp[j][i] = base_rp[base][j][i];
+    }
+    q->cm[j] = base_cm[base][j];
   }
+}
 
-  else {
-    res_d = (long double)(logl(((long double)nweights)/3.0)/logl(4.0));
+/*-------------------------------------------------------------
+  nest_cuts: the caps that cut a pixel of scheme 'h' out of
+             its base pixel, 2 for each resolution below it
 
-    /* res_d is often slightly under the correct res, so we add 0.1 to make it correct upon truncation */
-    res = (int)(res_d+0.1);
-    nside = (int)(powl(2,(int)(res-1)));
-    return(nside);
+  Input: res = resolution >= 1, nside = 2^(res-1)
+         hpix = NESTED pixel number
+  Output: rp, cm = 2*(res-1) caps
+*/
+static void nest_cuts(int res, int hpix, vec rp[], real_t cm[])
+{
+  int i, k, l;
+  hquad q;
+  hsplit sp;
+
+  base_quad(hpix >> (2*(res-1)), &q);
+  for(l=1;l<res;l++){
+    pixel_split(l, hpix >> (2*(res-l)), &q, &sp);
+    k = (hpix >> (2*(res-l-1))) & 3;
+    for(i=0;i<=2;i++){
+      rp[2*l-2][i] = sp.rp[0][i];
+      rp[2*l-1][i] = sp.rp[1][i];
+    }
+    cm[2*l-2] = (k & 1)? -sp.cm[0] : sp.cm[0];
+    cm[2*l-1] = (k & 2)? -sp.cm[1] : sp.cm[1];
+    quad_child(&q, k, &sp);
   }
 }
 
-/*------------------------------------------------------------
-  healpix_verts: interface to Fortran subroutine that calculates 
-                the exact vertices of any HEALPix pixel at a
-                given nside
+/*-------------------------------------------------------------
+  healpix_nest_caps: caps of the polygon of a pixel of the
+                     HEALPix-like NESTED scheme 'h'
 
-  Input: nside = HEALPix parameter describing resolution
-         pix = pixel number, where the first pixel number
-               for any resolution is always 0
-  Output: center = (x,y,z) coordinates of the pixel center
-          verts = array of (x,y,z) positions of the four
-	          pixel vertices in the order N,E,S,W
+  Input: res = resolution >= 1, nside = 2^(res-1)
+         hpix = NESTED pixel number
+  Output: rp, cm = 5+2*(res-1) caps
+  Return value: number of caps
+*/
+int healpix_nest_caps(int res, int hpix, vec rp[], real_t cm[])
+{
+  int i, np, base;
+
+  if(!base_done) base_setup();
+
+  base = hpix >> (2*(res-1));
+  for(np=0;np<5;np++){
+    for(i=0;i<=2;i++) rp[np][i] = base_rp[base][np][i];
+    cm[np] = base_cm[base][np];
+  }
+  nest_cuts(res, hpix, &rp[np], &cm[np]);
+  return(np+2*(res-1));
+}
+
+/*-------------------------------------------------------------
+  healpix_child_caps: the 2 caps that cut a pixel of the
+                      HEALPix-like NESTED scheme 'h' out of its
+                      parent, so the caps of the pixel are those
+                      of its parent followed by these 2
+
+  Input: res = resolution >= 2, nside = 2^(res-1)
+         hpix = NESTED pixel number
+  Output: rp, cm = 2 caps
 */
+void healpix_child_caps(int res, int hpix, vec rp[2], real_t cm[2])
+{
+  int i, k;
+  vec rpl[2*(HEALPIX_RES_LIMIT-1)];
+  real_t cml[2*(HEALPIX_RES_LIMIT-1)];
+
+  nest_cuts(res, hpix, rpl, cml);
+  for(k=0;k<2;k++){
+    for(i=0;i<=2;i++) rp[k][i] = rpl[2*res-4+k][i];
+    cm[k] = cml[2*res-4+k];
+  }
+}
 
-void healpix_verts(int nside, int pix, vec center, long double verts[12])
+/*-------------------------------------------------------------
+  healpix_nest_pixel: pixel of the HEALPix-like NESTED scheme
+                      'h' whose polygon contains a point, found
+                      by descending from the base pixels through
+                      the same cuts as healpix_nest_caps
+
+  Input: res = resolution >= 1, nside = 2^(res-1)
+         r = unit vector of point
+  Return value: NESTED pixel number
+*/
+int healpix_nest_pixel(int res, vec r)
 {
-  pix2vec_nest__(&nside, &pix, &(center[0]), &(center[1]), &(center[2]), &(verts[0]), &(verts[1]), &(verts[2]), &(verts[3]), &(verts[4]), &(verts[5]), &(verts[6]), &(verts[7]), &(verts[8]), &(verts[9]), &(verts[10]), &(verts[11]));
+  int b, e, hpix, k, l;
+  hquad q;
+  hsplit sp;
+  azel v;
+
+  if(!base_done) base_setup();
+
+  for(b=0;b<12;b++){
+    for(e=0;e<5;e++){
+      if(!incap(base_rp[b][e], base_cm[b][e], r)) break;
+    }
+    if(e==5) break;
+  }
+  if(b==12){
+    /* on a corner, to numerical precision */
+    rp_to_azel(r, &v);
+    healpix_ang2pix_nest(1, PIBYTWO-v.el, (v.az < 0.)? v.az+TWOPI : v.az, &b);
+  }
+
+  base_quad(b, &q);
+  hpix = b;
+  for(l=1;l<res;l++){
+    pixel_split(l, hpix, &q, &sp);
+    k = (incap(sp.rp[0], sp.cm[0], r)? 0 : 1) + (incap(sp.rp[1], sp.cm[1], r)? 0 : 2);
+    quad_child(&q, k, &sp);
+    hpix = 4*hpix + k;
+  }
+  return(hpix);
 }
 
 /*-------------------------------------------------------------
-  cmrpirpj: C version of Fortran subroutine that calculates the value
-         of (1-cosl(th(ij))), where th(ij) is the angle between the
-	 unit vectors rpi and rpj
+  healpix_ring: ring of HEALPix pixel centers, counted from
+                the north pole, that a NESTED pixel is on, and
+                its place in the ring, as in pix2ang_nest;
+                the pixel centers of a ring are equally spaced
+                in longitude
 
-  Input: rpi, rpj = unit vectors
-  Return value: 1- cosl(th(ij))
+  Input: nside = HEALPix nside
+         hpix = HEALPix NESTED pixel number
+  Output: iring = ring, 1 to 4 nside - 1
+          j = place of pixel in ring, 0 to n - 1, eastward
+  Return value: n = number of pixels in ring
 */
+int healpix_ring(int nside, int hpix, int *iring, int *j)
+{
+  int face, kshift, nr, jp;
+  long long x, y;
+
+  nest_xy(nside, hpix, &face, &x, &y);
+  *iring = jrll[face]*nside - (int)(x + y) - 1;
+  if(*iring < nside) nr = *iring;
+  else if(*iring > 3*nside) nr = 4*nside - *iring;
+  else nr = nside;
+  kshift = (nr == nside)? (*iring - nside)&1 : 0;
+  jp = (jpll[face]*nr + (int)(x - y) + 1 + kshift)/2;
+  if(jp > 4*nside) jp -= 4*nside;
+  if(jp < 1) jp += 4*nside;
+  *j = jp - 1;
+  return(4*nr);
+}
 
-long double cmrpirpj(vec rpi, vec rpj)
+/*-------------------------------------------------------------
+  healpix_ring_z: position of a ring of HEALPix pixel centers
+
+  Input: nside = HEALPix nside
+         iring = ring, 1 to 4 nside - 1, from the north pole
+  Output: z = cos of polar angle of ring
+          phi0 = longitude of place 0 of ring
+  Return value: n = number of pixels in ring
+*/
+int healpix_ring_z(int nside, int iring, real_t *z, real_t *phi0)
 {
-  long double cmij;
-  
-  cmij = (powl((rpi[0]-rpj[0]),2)+powl((rpi[1]-rpj[1]),2)+powl((rpi[2]-rpj[2]),2))/2.;
-  return(cmij);
+  int kshift, nr;
+
+  if(iring < nside){
+    /* north polar cap */
+    nr = iring;
+    *z = 1. - (real_t)nr*nr/(3.*(real_t)nside*nside);
+    kshift = 0;
+  }
+  else if(iring > 3*nside){
+    /* south polar cap */
+    nr = 4*nside - iring;
+    *z = -1. + (real_t)nr*nr/(3.*(real_t)nside*nside);
+    kshift = 0;
+  }
+  else{
+    nr = nside;
+    *z = (real_t)(2*nside - iring)*2./(3.*nside);
+    kshift = (iring - nside)&1;
+  }
+  *phi0 = (1 - kshift)*PI/(4.*nr);
+  return(4*nr);
 }
@@ -11,25 +11,30 @@
 
   Pseudo-random unsigned long or unsigned long long associated with integer ik,
   returned as a double.
+
+  The number is a fixed hash of ik, so ikrand neither reads nor disturbs
+  the state of random(), and may be called from several threads at once.
 */
 void ikrand_(int *ik, double *ikran)
 {
     unsigned long *likran;
     unsigned long long *llikran;
+    unsigned long long h;
 
-    /* seed random number generator with *ik */
-    srandom((unsigned int) *ik);
+    /* splitmix64 finalizer applied to *ik */
+    h = (unsigned long long)(unsigned int) *ik + 0x9e3779b97f4a7c15ULL;
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+    h ^= h >> 31;
 
-    /* generate pseudo-random unsigned long */
+    /* pseudo-random unsigned long */
     if (sizeof(long long) > sizeof(double)) {
 	likran = (unsigned long *)ikran;
-	*likran = random();
-    /* generate pseudo-random unsigned long long */
+	*likran = (unsigned long)h;
+    /* pseudo-random unsigned long long */
     } else {
 	llikran = (unsigned long long *)ikran;
-	*llikran = (unsigned int)random();
-	*llikran <<= (8 * sizeof(unsigned int));
-	*llikran |= (unsigned int)random();
+	*llikran = h;
     }
 }
 
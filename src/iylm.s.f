@@ -1,17 +1,18 @@
 c-----------------------------------------------------------------------
-      subroutine iylm(thmin,thmax,w,lmax1,nw,v)
-      integer lmax1,nw
-      real*10 thmin,thmax,w(nw)
+      subroutine iylm(thmin,thmax,w,lmin,lmax1,nw,v)
+#include "real.par"
+      integer lmin,lmax1,nw
+      real(KR) thmin,thmax,w((lmin*(lmin+1))/2+1:nw)
 c        work array (could be automatic if compiler supports it)
-      real*10 v(lmax1)
+      real(KR) v(lmax1)
 c
 c        parameters
       include 'pi.par'
 c        data variables
-      real*10 tiny
+      real(KR) tiny
 c        local (automatic) variables
       integer lm,lmx1,qphi
-      real*10 ri,phi,zi,ci,si,ph,dph
+      real(KR) ri,phi,zi,ci,si,ph,dph
 c *
 c * w_lm = integral from thmin to thmax Y_lm(th,0) sin th d th
 c *
@@ -20,53 +21,55 @@ c * I can find an expansion in incomplete beta functions,
 c * but the expansion is not much shorter, and not as pretty.
 c *
 c  Input: thmin, thmax = minimum, maximum polar angle in radians.
+c         lmin = minimum desired l of transform.
 c         lmax1 = lmax+1 where lmax is maximum desired l of transform.
 c         nw = [(lmax+1)*(lmax+2)]/2 .
-c Output: w(lm) = integral from thmax to thmin Y_lm(th,0) d cos th .
+c Output: w(lm) = integral from thmax to thmin Y_lm(th,0) d cos th ,
+c              for l=lmin,lmax .
 c Work array: v should be dimensioned at least lmax1 .
 c
-      data tiny /1.e-30_10/
+      data tiny /1.e-30_KR/
 c
-      do 120 lm=1,nw
-        w(lm)=0._10
+      do 120 lm=(lmin*(lmin+1))/2+1,nw
+        w(lm)=0._KR
   120 continue
 c        upper latitude term
-      ri=0._10
-      zi=1._10
-      phi=0._10
-      ph=0._10
+      ri=0._KR
+      zi=1._KR
+      phi=0._KR
+      ph=0._KR
       dph=-tiny
-      if (thmin.eq.0._10.or.thmin.eq.PI) then
-        si=0._10
+      if (thmin.eq.0._KR.or.thmin.eq.PI) then
+        si=0._KR
         lmx1=1
       else
         si=sin(thmin)
         lmx1=lmax1
       endif
       ci=cos(thmin)
-      call wlm(w,lmx1,1,nw,ri,phi,0,zi,ci,si,ph,dph,v)
+      call wlm(w,lmin,lmx1,1,nw,ri,phi,0,zi,ci,si,ph,dph,v)
 c        lower latitude term
       dph=tiny
-      if (thmax.eq.0._10.or.thmax.eq.PI) then
-        si=0._10
+      if (thmax.eq.0._KR.or.thmax.eq.PI) then
+        si=0._KR
         lmx1=1
       else
         si=sin(thmax)
         lmx1=lmax1
       endif
       ci=cos(thmax)
-      call wlm(w,lmx1,1,nw,ri,phi,0,zi,ci,si,ph,dph,v)
+      call wlm(w,lmin,lmx1,1,nw,ri,phi,0,zi,ci,si,ph,dph,v)
 c        longitude term
-      ri=1._10
-      zi=0._10
-      ci=0._10
-      si=1._10
+      ri=1._KR
+      zi=0._KR
+      ci=0._KR
+      si=1._KR
       phi=tiny
       qphi=-1
-      ph=PI-(thmin+thmax)/2._10
+      ph=PI-(thmin+thmax)/2._KR
       dph=thmax-thmin
-      call wlm(w,lmax1,1,nw,ri,phi,qphi,zi,ci,si,ph,dph,v)
-      do 140 lm=1,nw
+      call wlm(w,lmin,lmax1,1,nw,ri,phi,qphi,zi,ci,si,ph,dph,v)
+      do 140 lm=(lmin*(lmin+1))/2+1,nw
         w(lm)=w(lm)/tiny
   140 continue
       return
@@ -0,0 +1,713 @@
+/*------------------------------------------------------------------------------
+  mangled: resident mask query server.
+------------------------------------------------------------------------------*/
+#include <errno.h>
+#include <math.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include "manglefn.h"
+#include "defaults.h"
+
+/* getopt options */
+const char *optstr = "dqm:s:e:u:";
+
+/* allocate polygons as a global array */
+polygon *poly_global[NPOLYSMAX];
+
+/*
+  Binary protocol, in the native byte order of the host
+  (the socket is local, so client and server share it).
+
+  A client sends any number of requests on a connection.
+  Each request is a header
+	char magic[4]	"MNGQ"
+	int op		MANGLED_INFO, MANGLED_ID, MANGLED_WEIGHT, MANGLED_RANDOM
+			or MANGLED_QUIT
+	int mask	index of mask, in the order the masks were given
+			on the command line, starting at 0
+	int n		number of points
+	long long seed	seed of random points (MANGLED_RANDOM only)
+  followed, for MANGLED_ID and MANGLED_WEIGHT, by n pairs of doubles az, el
+  in the input units (-u).
+
+  Each reply is a header
+	char magic[4]	"MNGR"
+	int status	0 if ok, -1 if the request failed
+	int n		number of points
+	int nval	number of values
+  followed by
+    MANGLED_INFO:	int npoly[n], double area[nval], for each of the
+			n = nval masks
+    MANGLED_ID:		int count[n] of polygons containing each point,
+			then the long long id[nval] of those polygons
+    MANGLED_WEIGHT:	int count[n], then the double weight[nval]
+    MANGLED_RANDOM:	double azel[2 n] of n random points, in the output
+			units, weighted by polygon weight,
+			then the long long id[nval = n] of their polygons
+    MANGLED_QUIT:	nothing; the server exits after replying
+
+  A request for more than MANGLED_NMAX points fails; for MANGLED_ID
+  and MANGLED_WEIGHT the server then drops the connection after
+  replying, since it does not read the points.
+
+  The server holds up to MANGLED_MAXCONN connections open at once,
+  and answers one request at a time from whichever connection has one,
+  so a client that sits idle between requests holds up no one.
+  A client that stalls part way through sending a request, or does not
+  take its reply, for MANGLED_TIMEOUT seconds is disconnected.
+*/
+#define MANGLED_INFO	0
+#define MANGLED_ID	1
+#define MANGLED_WEIGHT	2
+#define MANGLED_RANDOM	3
+#define MANGLED_QUIT	4
+
+/* maximum number of connections open at once */
+#define MANGLED_MAXCONN	64
+/* seconds a connection may stall part way through a request or reply */
+#define MANGLED_TIMEOUT	10
+/* maximum number of points in a request */
+#define MANGLED_NMAX	(1 << 22)
+
+typedef struct {		/* request header */
+    char magic[4];
+    int op;
+    int mask;
+    int n;
+    long long seed;
+} mangled_request;
+
+typedef struct {		/* reply header */
+    char magic[4];
+    int status;
+    int n;
+    int nval;
+} mangled_reply;
+
+typedef struct {		/* mask held by the server */
+    char *name;			/* polygon file it was read from */
+    int npoly;			/* number of polygons */
+    polygon **poly;		/* polygons, sorted by pixel */
+    char scheme;		/* pixelization scheme */
+    int res_max;		/* maximum resolution of pixels */
+    pixeldir dir;		/* directory of pixels occupied by polygons */
+    real_t *wcum;		/* cumulative weight * area of polygons */
+    real_t area;		/* area of mask */
+} mangled_mask;
+
+/* local functions */
+void	usage(void);
+int	load_mask(char *, format *, int npolysmax, polygon *[/*npolysmax*/], mangled_mask *);
+int	mask_ids(mangled_mask *, real_t, real_t, long long **, real_t **);
+int	serve(int, int, mangled_mask *, format *);
+int	readn(int, void *, size_t);
+int	writen(int, void *, size_t);
+int	unlink_socket(char *);
+
+/*------------------------------------------------------------------------------
+  Main program.
+*/
+int main(int argc, char *argv[])
+{
+    int ic, ifile, imask, ier, listener, conn, nconn, nmask, npoly, npolys, quit;
+    polygon **poly;
+    mangled_mask *mask;
+    struct sockaddr_un addr;
+    struct pollfd pfd[MANGLED_MAXCONN + 1];
+    struct timeval timeout;
+
+    poly = poly_global;
+
+    /* parse arguments */
+    parse_args(argc, argv);
+
+    /* a socket name and at least one input filename required as arguments */
+    if (argc - optind < 2) {
+	if (optind > 1 || argc - optind >= 1) {
+	    fprintf(stderr, "%s requires at least 2 arguments: socket and polygon_infile\n", argv[0]);
+	    usage();
+	    exit(1);
+	} else {
+	    usage();
+	    exit(0);
+	}
+    }
+
+    msg("---------------- mangled ----------------\n");
+
+    /* advise data format */
+    advise_fmt(&fmt);
+
+    /* tolerance angle for multiple intersections */
+    if (mtol != 0.) {
+	scale(&mtol, munit, 's');
+	munit = 's';
+	msg("multiple intersections closer than %" RL "g%c will be treated as coincident\n", mtol, munit);
+	scale(&mtol, munit, 'r');
+	munit = 'r';
+    }
+
+    /* read each mask */
+    nmask = argc - 1 - optind;
+    mask = (mangled_mask *) malloc(sizeof(mangled_mask) * nmask);
+    if (!mask) {
+	fprintf(stderr, "mangled: failed to allocate memory for %d masks\n", nmask);
+	exit(1);
+    }
+    npoly = 0;
+    for (ifile = optind + 1; ifile < argc; ifile++) {
+	imask = ifile - optind - 1;
+	npolys = load_mask(argv[ifile], &fmt, NPOLYSMAX - npoly, &poly[npoly], &mask[imask]);
+	if (npolys == -1) exit(1);
+	msg("mask %d: %d polygons of area %.15" RL "g str from %s\n", imask, npolys, mask[imask].area, argv[ifile]);
+	npoly += npolys;
+    }
+
+    /* a client going away should not kill the server */
+    signal(SIGPIPE, SIG_IGN);
+
+    /* listen on socket */
+    if (strlen(argv[optind]) >= sizeof(addr.sun_path)) {
+	fprintf(stderr, "mangled: socket name %s is too long\n", argv[optind]);
+	exit(1);
+    }
+    listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener == -1) {
+	fprintf(stderr, "mangled: cannot create socket: %s\n", strerror(errno));
+	exit(1);
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, argv[optind]);
+    if (unlink_socket(argv[optind]) == -1) {
+	fprintf(stderr, "mangled: %s exists and is not a socket; not replacing it\n", argv[optind]);
+	exit(1);
+    }
+    if (bind(listener, (struct sockaddr *)&addr, sizeof(addr)) == -1
+	|| listen(listener, 16) == -1) {
+	fprintf(stderr, "mangled: cannot listen on %s: %s\n", argv[optind], strerror(errno));
+	exit(1);
+    }
+    msg("serving %d masks on %s\n", nmask, argv[optind]);
+
+    /* serve requests from all open connections, till told to quit;
+       pfd[0] is the listener, pfd[1..nconn] the connections */
+    pfd[0].fd = listener;
+    pfd[0].events = POLLIN;
+    nconn = 0;
+    timeout.tv_sec = MANGLED_TIMEOUT;
+    timeout.tv_usec = 0;
+    quit = 0;
+    while (!quit) {
+	if (poll(pfd, nconn + 1, -1) == -1) {
+	    if (errno == EINTR) continue;
+	    fprintf(stderr, "mangled: poll failed: %s\n", strerror(errno));
+	    break;
+	}
+
+	/* a request on each connection that has one */
+	for (ic = 1; ic <= nconn && !quit; ic++) {
+	    if (!(pfd[ic].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+	    ier = serve(pfd[ic].fd, nmask, mask, &fmt);
+	    if (ier == 0) continue;
+	    if (ier == 1) quit = 1;
+	    /* closed, broken, or told to quit: drop the connection */
+	    close(pfd[ic].fd);
+	    pfd[ic] = pfd[nconn];
+	    nconn--;
+	    ic--;
+	}
+	if (quit) break;
+
+	/* new connection */
+	if (pfd[0].revents & POLLIN) {
+	    conn = accept(listener, 0x0, 0x0);
+	    if (conn == -1) {
+		if (errno == EINTR || errno == EAGAIN || errno == ECONNABORTED) continue;
+		fprintf(stderr, "mangled: accept failed: %s\n", strerror(errno));
+		break;
+	    }
+	    if (nconn >= MANGLED_MAXCONN) {
+		fprintf(stderr, "mangled: %d connections already open; refusing another\n", nconn);
+		close(conn);
+		continue;
+	    }
+	    if (setsockopt(conn, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) == -1
+		|| setsockopt(conn, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)) == -1) {
+		fprintf(stderr, "mangled: cannot set timeout on connection: %s\n", strerror(errno));
+		close(conn);
+		continue;
+	    }
+	    nconn++;
+	    pfd[nconn].fd = conn;
+	    pfd[nconn].events = POLLIN;
+	    pfd[nconn].revents = 0;
+	}
+    }
+
+    for (ic = 1; ic <= nconn; ic++) close(pfd[ic].fd);
+    close(listener);
+    unlink_socket(argv[optind]);
+    msg("mangled: done\n");
+
+    return(0);
+}
+
+/*------------------------------------------------------------------------------
+*/
+void usage(void)
+{
+    printf("usage:\n");
+    printf("mangled [-d] [-q] [-m<a>[u]] [-s<n>] [-e<n>] [-u<inunit>[,<outunit>]] socket polygon_infile1 [polygon_infile2 ...]\n");
+    printf("  each polygon_infile is served as a separate mask, numbered from 0\n");
+#include "usage.h"
+}
+
+/*------------------------------------------------------------------------------
+*/
+#include "parse_args.c"
+
+/*------------------------------------------------------------------------------
+  Read a mask and index it for queries.
+
+   Input: filename = name of polygon file.
+	  fmt = pointer to format structure.
+	  npolysmax = maximum number of polygons in poly array.
+  Output: poly = polygons of mask.
+	  mask = pointer to indexed mask.
+  Return value: number of polygons read,
+		or -1 if error occurred.
+*/
+int load_mask(char *filename, format *fmt, int npolysmax, polygon *poly[/*npolysmax*/], mangled_mask *mask)
+{
+    int ier, ipoly, npoly, sorted;
+    real_t area, tol, w;
+
+    /* each mask carries its own pixelization */
+    infiles = 0;
+    pixelized = 0;
+    snapped = 0;
+    balkanized = 0;
+
+    npoly = rdmask(filename, fmt, npolysmax, poly);
+    if (npoly == -1) return(-1);
+    if (npoly == 0) {
+	fprintf(stderr, "mangled: no polygons in %s\n", filename);
+	return(-1);
+    }
+    if (snapped == 0) {
+	msg("WARNING: 'snapped' keyword not found in %s.\n", filename);
+    }
+
+    mask->name = filename;
+    mask->npoly = npoly;
+    mask->poly = poly;
+    mask->scheme = scheme;
+
+    /* lists of polygons in each pixel, as in polyid */
+    sorted = 0;
+    do {
+	ier = pixel_dir(npoly, poly, &mask->dir);
+	if (ier == -1) {
+	    if (sorted) {
+		fprintf(stderr, "mangled: error building pixel index lists of %s\n", filename);
+		return(-1);
+	    }
+	    msg("sorting polygons...\n");
+	    poly_sort(npoly, poly, 'p');
+	    sorted = 1;
+	}
+    } while (ier == -1);
+    mask->res_max = get_res(mask->dir.pixel[mask->dir.npix - 1], scheme);
+
+    /* cumulative weight times area, for random points */
+    mask->wcum = (real_t *) malloc(sizeof(real_t) * npoly);
+    if (!mask->wcum) {
+	fprintf(stderr, "mangled: failed to allocate memory for %d long doubles\n", npoly);
+	return(-1);
+    }
+    w = 0.;
+    mask->area = 0.;
+    for (ipoly = 0; ipoly < npoly; ipoly++) {
+	tol = mtol;
+	ier = garea(poly[ipoly], &tol, 1, &area);
+	if (ier) return(-1);
+	if (poly[ipoly]->weight > 0.) w += poly[ipoly]->weight * area;
+	mask->wcum[ipoly] = w;
+	mask->area += area;
+    }
+
+    return(npoly);
+}
+
+/*------------------------------------------------------------------------------
+  Id numbers and weights of polygons of mask containing position az, el,
+  searched pixel by pixel as in polyid.
+
+   Input: mask = pointer to mask.
+	  az, el = angular position in radians.
+  Output: id_p, weight_p = pointers to arrays of id numbers and weights,
+	  as returned by poly_id.
+  Return value: number of polygons that contain az, el position,
+		or -1 if error occurred.
+*/
+int mask_ids(mangled_mask *mask, real_t az, real_t el, long long **id_p, real_t **weight_p)
+{
+    static THREADLOCAL int nparent = 0;
+    static THREADLOCAL long long *parent_pixels = 0x0;
+    int nid, q, res;
+    long long p;
+
+    if (!parent_pixels || mask->res_max + 1 > nparent) {
+	if (parent_pixels) free(parent_pixels);
+	parent_pixels = (long long *) malloc(sizeof(long long) * (mask->res_max + 1));
+	if (!parent_pixels) {
+	    fprintf(stderr, "mask_ids: failed to allocate memory for %d long longs\n", mask->res_max + 1);
+	    return(-1);
+	}
+	nparent = mask->res_max + 1;
+    }
+
+    if (which_pixels(1, &az, &el, mask->res_max, mask->scheme, &p, parent_pixels) == -1) return(-1);
+
+    nid = 0;
+    for (res = mask->res_max; res >= 0; res--) {
+	q = pixel_find(&mask->dir, parent_pixels[res]);
+	if (q == -1) continue;
+	nid = poly_id(mask->dir.total[q], &mask->poly[mask->dir.start[q]], az, el, id_p, weight_p);
+    }
+
+    return(nid);
+}
+
+/*------------------------------------------------------------------------------
+  Answer one request on a connection.
+
+   Input: conn = connected socket, with a request, or end of file, to read.
+	  nmask = number of masks.
+	  mask = array of masks.
+	  fmt = pointer to format structure.
+  Return value: 0 if the request was answered;
+		1 if the client asked the server to quit;
+		2 when the client closes the connection;
+		-1 on a broken or stalled connection.
+*/
+int serve(int conn, int nmask, mangled_mask mask[/*nmask*/], format *fmt)
+{
+    static char magicq[4] = {'M', 'N', 'G', 'Q'}, magicr[4] = {'M', 'N', 'G', 'R'};
+    static char state[256];
+    int i, ier, im, ip, ipmin, nid, nval, tries, in;
+    int *count;
+    long long *id, *ids, *id1;
+    real_t cmi, cmmin, phi, rpoly, si, x, y, z;
+    real_t *weight;
+    double *buf, *vals, *weight1;
+    vec rp, xi, yi;
+    azel v;
+    mangled_request req;
+    mangled_reply rep;
+    mangled_mask *m;
+
+    ier = readn(conn, &req, sizeof(req));
+    if (ier == 0) return(2);
+    if (ier == -1 || memcmp(req.magic, magicq, 4) != 0) {
+	fprintf(stderr, "mangled: bad or stalled request; dropping connection\n");
+	return(-1);
+    }
+
+    memcpy(rep.magic, magicr, 4);
+    rep.status = 0;
+    rep.n = 0;
+    rep.nval = 0;
+    buf = 0x0;
+    count = 0x0;
+    ids = 0x0;
+    vals = 0x0;
+    id1 = 0x0;
+    weight1 = 0x0;
+
+    /* points of query */
+    if (req.op == MANGLED_ID || req.op == MANGLED_WEIGHT) {
+	if (req.n < 0 || req.n > MANGLED_NMAX) {
+	    /* the points are not read, so the connection cannot go on */
+	    fprintf(stderr, "mangled: request for %d points, not 0 to %d; dropping connection\n", req.n, MANGLED_NMAX);
+	    rep.status = -1;
+	    writen(conn, &rep, sizeof(rep));
+	    return(-1);
+	}
+	buf = (double *) malloc(sizeof(double) * 2 * ((size_t)req.n + 1));
+	if (!buf) {
+	    fprintf(stderr, "mangled: failed to allocate memory for %d doubles\n", 2 * req.n);
+	    return(-1);
+	}
+	if (readn(conn, buf, sizeof(double) * 2 * (size_t)req.n) != 1) {
+	    free(buf);
+	    return(-1);
+	}
+    }
+
+    if (req.op != MANGLED_INFO && req.op != MANGLED_QUIT
+	&& (req.mask < 0 || req.mask >= nmask || req.n < 0 || req.n > MANGLED_NMAX)) {
+	fprintf(stderr, "mangled: request for mask %d of %d, or for %d points\n", req.mask, nmask, req.n);
+	rep.status = -1;
+	req.op = -1;
+    }
+    m = &mask[(rep.status == 0 && req.op != MANGLED_INFO && req.op != MANGLED_QUIT)? req.mask : 0];
+
+    switch (req.op) {
+
+    case MANGLED_INFO:
+	count = (int *) malloc(sizeof(int) * nmask);
+	vals = (double *) malloc(sizeof(double) * nmask);
+	if (!count || !vals) {
+	    rep.status = -1;
+	    break;
+	}
+	for (im = 0; im < nmask; im++) {
+	    count[im] = mask[im].npoly;
+	    vals[im] = mask[im].area;
+	}
+	rep.n = rep.nval = nmask;
+	break;
+
+    case MANGLED_ID:
+    case MANGLED_WEIGHT:
+	rep.n = req.n;
+	count = (int *) malloc(sizeof(int) * ((size_t)req.n + 1));
+	id1 = (long long *) malloc(sizeof(long long) * ((size_t)req.n + 1));
+	weight1 = (double *) malloc(sizeof(double) * ((size_t)req.n + 1));
+	if (!count || !id1 || !weight1) {
+	    rep.status = -1;
+	    break;
+	}
+	/* count polygons containing each point, in parallel,
+	   keeping the first polygon, which is usually the only one */
+	ier = 0;
+#ifdef _OPENMP
+#pragma omp parallel for private(v, id, weight) reduction(+:ier) schedule(dynamic, 256)
+#endif
+	for (i = 0; i < req.n; i++) {
+	    v.az = buf[2 * i];
+	    v.el = buf[2 * i + 1];
+	    scale_azel(&v, fmt->inunit, 'r');
+	    count[i] = mask_ids(m, v.az, v.el, &id, &weight);
+	    if (count[i] == -1) {
+		count[i] = 0;
+		ier++;
+	    } else if (count[i] > 0) {
+		id1[i] = id[0];
+		weight1[i] = weight[0];
+	    }
+	}
+	if (ier) {
+	    rep.status = -1;
+	    break;
+	}
+	nval = 0;
+	for (i = 0; i < req.n; i++) nval += count[i];
+	if (req.op == MANGLED_ID) {
+	    ids = (long long *) malloc(sizeof(long long) * ((size_t)nval + 1));
+	} else {
+	    vals = (double *) malloc(sizeof(double) * ((size_t)nval + 1));
+	}
+	if (!ids && !vals) {
+	    rep.status = -1;
+	    break;
+	}
+	/* gather id numbers or weights */
+	nval = 0;
+	for (i = 0; i < req.n; i++) {
+	    if (count[i] == 0) continue;
+	    if (count[i] == 1) {
+		if (ids) {
+		    ids[nval++] = id1[i];
+		} else {
+		    vals[nval++] = weight1[i];
+		}
+		continue;
+	    }
+	    v.az = buf[2 * i];
+	    v.el = buf[2 * i + 1];
+	    scale_azel(&v, fmt->inunit, 'r');
+	    nid = mask_ids(m, v.az, v.el, &id, &weight);
+	    for (ip = 0; ip < nid && ip < count[i]; ip++) {
+		if (ids) {
+		    ids[nval++] = id[ip];
+		} else {
+		    vals[nval++] = weight[ip];
+		}
+	    }
+	}
+	rep.nval = nval;
+	break;
+
+    case MANGLED_RANDOM:
+	rep.n = rep.nval = req.n;
+	vals = (double *) malloc(sizeof(double) * 2 * ((size_t)req.n + 1));
+	ids = (long long *) malloc(sizeof(long long) * ((size_t)req.n + 1));
+	if (!vals || !ids) {
+	    rep.status = -1;
+	    break;
+	}
+	if (m->wcum[m->npoly - 1] <= 0.) {
+	    fprintf(stderr, "mangled: mask %d has no polygons with positive weight * area\n", req.mask);
+	    rep.status = -1;
+	    break;
+	}
+	initstate((unsigned int)req.seed, state, sizeof(state));
+	for (i = 0; i < req.n; i++) {
+	    /* polygon to put random point in */
+	    rpoly = drandom() * m->wcum[m->npoly - 1];
+	    ip = search(m->npoly, m->wcum, rpoly);
+	    if (ip >= m->npoly) ip = m->npoly - 1;
+	    /* random point within smallest cap, till it is inside polygon, as in ransack */
+	    cmminf(m->poly[ip], &ipmin, &cmmin);
+	    tries = 0;
+	    do {
+		tries++;
+		phi = TWOPI * drandom();
+		cmi = cmmin * drandom();
+		si = sqrtl(cmi * (2. - cmi));
+		x = si * cosl(phi);
+		y = si * sinl(phi);
+		z = 1. - cmi;
+		if (m->poly[ip]->np > 0) {
+		    if (m->poly[ip]->cm[ipmin] < 0.) z = -z;
+		    gaxisi_(m->poly[ip]->rp[ipmin], xi, yi);
+		    for (im = 0; im < 3; im++) rp[im] = x * xi[im] + y * yi[im] + z * m->poly[ip]->rp[ipmin][im];
+		    in = gptin(m->poly[ip], rp);
+		} else {
+		    rp[0] = x;
+		    rp[1] = y;
+		    rp[2] = z;
+		    in = 1;
+		}
+	    } while (!in);
+	    rp_to_azel(rp, &v);
+	    v.az -= floorl(v.az / TWOPI) * TWOPI;
+	    scale_azel(&v, 'r', fmt->outunit);
+	    vals[2 * i] = v.az;
+	    vals[2 * i + 1] = v.el;
+	    ids[i] = m->poly[ip]->id;
+	}
+	break;
+
+    case MANGLED_QUIT:
+	break;
+
+    default:
+	if (rep.status == 0) fprintf(stderr, "mangled: unknown request %d\n", req.op);
+	rep.status = -1;
+	break;
+    }
+
+    if (rep.status != 0) {
+	rep.n = 0;
+	rep.nval = 0;
+    }
+
+    /* reply */
+    ier = writen(conn, &rep, sizeof(rep));
+    if (ier == 1 && rep.status == 0) {
+	switch (req.op) {
+	case MANGLED_INFO:
+	    ier = writen(conn, count, sizeof(int) * rep.n);
+	    if (ier == 1) ier = writen(conn, vals, sizeof(double) * rep.nval);
+	    break;
+	case MANGLED_ID:
+	    ier = writen(conn, count, sizeof(int) * rep.n);
+	    if (ier == 1) ier = writen(conn, ids, sizeof(long long) * rep.nval);
+	    break;
+	case MANGLED_WEIGHT:
+	    ier = writen(conn, count, sizeof(int) * rep.n);
+	    if (ier == 1) ier = writen(conn, vals, sizeof(double) * rep.nval);
+	    break;
+	case MANGLED_RANDOM:
+	    ier = writen(conn, vals, sizeof(double) * 2 * rep.n);
+	    if (ier == 1) ier = writen(conn, ids, sizeof(long long) * rep.nval);
+	    break;
+	}
+    }
+
+    if (buf) free(buf);
+    if (count) free(count);
+    if (ids) free(ids);
+    if (vals) free(vals);
+    if (id1) free(id1);
+    if (weight1) free(weight1);
+
+    if (ier != 1) return(-1);
+    if (req.op == MANGLED_QUIT) return(1);
+
+    return(0);
+}
+
+/*------------------------------------------------------------------------------
+  Read exactly n bytes from a socket.
+
+  Return value: 1 if n bytes were read;
+		0 on end of file before any byte was read;
+		-1 if error occurred, or end of file came part way.
+*/
+int readn(int fd, void *buf, size_t n)
+{
+    size_t done;
+    ssize_t r;
+
+    for (done = 0; done < n; done += r) {
+	r = read(fd, (char *)buf + done, n - done);
+	if (r == -1 && errno == EINTR) {
+	    r = 0;
+	    continue;
+	}
+	if (r <= 0) return((r == 0 && done == 0)? 0 : -1);
+    }
+    return(1);
+}
+
+/*------------------------------------------------------------------------------
+  Write exactly n bytes to a socket.
+
+  Return value: 1 if n bytes were written;
+		-1 if error occurred.
+*/
+int writen(int fd, void *buf, size_t n)
+{
+    size_t done;
+    ssize_t r;
+
+    for (done = 0; done < n; done += r) {
+	r = write(fd, (char *)buf + done, n - done);
+	if (r == -1 && errno == EINTR) {
+	    r = 0;
+	    continue;
+	}
+	if (r <= 0) return(-1);
+    }
+    return(1);
+}
+
+/*------------------------------------------------------------------------------
+  Remove a socket, but not a file of any other kind of the same name,
+  such as a mask given by mistake in place of the socket.
+
+  Return value: 0 if there is no longer anything of that name;
+		-1 if it is not a socket, and was left alone.
+*/
+int unlink_socket(char *name)
+{
+    struct stat st;
+
+    if (lstat(name, &st) == -1) return(0);
+    if (!S_ISSOCK(st.st_mode)) return(-1);
+    unlink(name);
+    return(0);
+}
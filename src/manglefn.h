@@ -11,26 +11,28 @@
 #include "polygon.h"
 #include "vertices.h"
 #include "polysort.h"
+#include "pixeldir.h"
 
 void	advise_fmt(format *);
 
-void	azel_(long double *, long double *, long double *, long double *, long double *, long double *, long double *);
-void	azell_(long double *, long double *, long double *, long double *, long double *, long double *, long double *, long double *, long double *);
+void	azel_(real_t *, real_t *, real_t *, real_t *, real_t *, real_t *, real_t *);
+void	azell_(real_t *, real_t *, real_t *, real_t *, real_t *, real_t *, real_t *, real_t *, real_t *);
 
-void	braktop(long double, int *, long double [], int, int);
-void	brakbot(long double, int *, long double [], int, int);
-void	braktpa(long double, int *, long double [], int, int);
-void	brakbta(long double, int *, long double [], int, int);
-void	braktop_(long double *, int *, long double [], int *, int *);
-void	brakbot_(long double *, int *, long double [], int *, int *);
-void	braktpa_(long double *, int *, long double [], int *, int *);
-void	brakbta_(long double *, int *, long double [], int *, int *);
+void	braktop(real_t, int *, real_t [], int, int);
+void	brakbot(real_t, int *, real_t [], int, int);
+void	braktpa(real_t, int *, real_t [], int, int);
+void	brakbta(real_t, int *, real_t [], int, int);
+void	braktop_(real_t *, int *, real_t [], int *, int *);
+void	brakbot_(real_t *, int *, real_t [], int *, int *);
+void	braktpa_(real_t *, int *, real_t [], int *, int *);
+void	brakbta_(real_t *, int *, real_t [], int *, int *);
 
-void	cmminf(polygon *, int *, long double *);
+void	cmminf(polygon *, int *, real_t *);
+int	cap_in_cap(vec, real_t, vec, real_t);
 
 void	vert_to_poly(vertices *, polygon *);
 void	edge_to_poly(vertices *, int, int *, polygon *);
-void    rect_to_poly(long double [4], polygon *);
+void    rect_to_poly(real_t [4], polygon *);
 
 #ifdef	GCC
 void	rps_to_vert(int nv, vec [nv], vertices *);
@@ -39,17 +41,17 @@ void	rps_to_vert(int nv, vec [/*nv*/], vertices *);
 #endif
 void	rp_to_azel(vec, azel *);
 void	azel_to_rp(azel *, vec);
-void	azel_to_gc(azel *, azel *, vec, long double *);
-void	rp_to_gc(vec, vec, vec, long double *);
-void	edge_to_rpcm(azel *, azel *, azel *, vec, long double *);
-void	rp_to_rpcm(vec, vec, vec, vec, long double *);
-void	circ_to_rpcm(long double [3], vec, long double *);
-void	rpcm_to_circ(vec, long double *, long double [3]);
-void	az_to_rpcm(long double, int, vec, long double *);
-void	el_to_rpcm(long double, int, vec, long double *);
-long double	thij(vec, vec);
-long double	cmij(vec, vec);
-int	poly_to_rect(polygon *, long double *, long double *, long double *, long double *);
+void	azel_to_gc(azel *, azel *, vec, real_t *);
+void	rp_to_gc(vec, vec, vec, real_t *);
+void	edge_to_rpcm(azel *, azel *, azel *, vec, real_t *);
+void	rp_to_rpcm(vec, vec, vec, vec, real_t *);
+void	circ_to_rpcm(real_t [3], vec, real_t *);
+void	rpcm_to_circ(vec, real_t *, real_t [3]);
+void	az_to_rpcm(real_t, int, vec, real_t *);
+void	el_to_rpcm(real_t, int, vec, real_t *);
+real_t	thij(vec, vec);
+real_t	cmij(vec, vec);
+int	poly_to_rect(polygon *, real_t *, real_t *, real_t *, real_t *);
 int	antivert(vertices *, polygon *);
 
 void	copy_format(format *, format *);
@@ -64,35 +66,35 @@ void	group_poly(polygon *poly, int [poly->np], int, polygon *);
 void	group_poly(polygon *poly, int [/*poly->np*/], int, polygon *);
 #endif
 void    assign_parameters();
-void    pix2ang(int, unsigned long, long double *, long double *);
-void    ang2pix(int, long double, long double, unsigned long *);
-void    pix2ang_radec(int, unsigned long, long double *, long double *);
-void    ang2pix_radec(int, long double, long double, unsigned long *);
-void    csurvey2eq(long double, long double, long double *, long double *);
-void    eq2csurvey(long double, long double, long double *, long double *);
+void    pix2ang(int, unsigned long, real_t *, real_t *);
+void    ang2pix(int, real_t, real_t, unsigned long *);
+void    pix2ang_radec(int, unsigned long, real_t *, real_t *);
+void    ang2pix_radec(int, real_t, real_t, unsigned long *);
+void    csurvey2eq(real_t, real_t, real_t *, real_t *);
+void    eq2csurvey(real_t, real_t, real_t *, real_t *);
 void    superpix(int, unsigned long, int, unsigned long *);
 void    subpix(int, unsigned long, unsigned long *, unsigned long *, unsigned long *, unsigned long *);
-void    pix_bound(int, unsigned long, long double *, long double *, long double *, long double *);
-long double  pix_area(int, unsigned long);
-void    pix2xyz(int, unsigned long, long double *, long double *, long double *);
-void    area_index(int, long double, long double, long double, long double, unsigned long *, unsigned long *, unsigned long *, unsigned long *);
+void    pix_bound(int, unsigned long, real_t *, real_t *, real_t *, real_t *);
+real_t  pix_area(int, unsigned long);
+void    pix2xyz(int, unsigned long, real_t *, real_t *, real_t *);
+void    area_index(int, real_t, real_t, real_t, real_t, unsigned long *, unsigned long *, unsigned long *, unsigned long *);
 void    area_index_stripe(int, int, unsigned long *, unsigned long *, unsigned long *, unsigned long *);
 
-long double	drandom(void);
+real_t	drandom(void);
 
 #ifdef	GCC
-int	cmlim_polys(int npoly, polygon *[npoly], long double, vec);
-int	drangle_polys(int npoly, polygon *[npoly], long double, vec, int nth, long double [nth], long double [nth]);
+int	cmlim_polys(int npoly, polygon *[npoly], real_t, vec);
+int	drangle_polys(int npoly, polygon *[npoly], real_t, vec, int nth, real_t [nth], real_t [nth]);
 #else
-int	cmlim_polys(int npoly, polygon *[/*npoly*/], long double, vec);
-int	drangle_polys(int npoly, polygon *[/*npoly*/], long double, vec, int nth, long double [/*nth*/], long double [/*nth*/]);
+int	cmlim_polys(int npoly, polygon *[/*npoly*/], real_t, vec);
+int	drangle_polys(int npoly, polygon *[/*npoly*/], real_t, vec, int nth, real_t [/*nth*/], real_t [/*nth*/]);
 #endif
 
-void	cmlimpolys_(long double *, vec);
+void	cmlimpolys_(real_t *, vec);
 #ifdef	GCC
-void	dranglepolys_(long double *, vec, int *nth, long double [*nth], long double [*nth]);
+void	dranglepolys_(real_t *, vec, int *nth, real_t [*nth], real_t [*nth]);
 #else
-void	dranglepolys_(long double *, vec, int *nth, long double [/**nth*/], long double [/**nth*/]);
+void	dranglepolys_(real_t *, vec, int *nth, real_t [/**nth*/], real_t [/**nth*/]);
 #endif
 
 #ifdef	GCC
@@ -101,88 +103,107 @@ void	dump_poly(int npoly, polygon *[npoly]);
 void	dump_poly(int, polygon *[/*npoly*/]);
 #endif
 
-void	fframe_(int *, long double *, long double *, int *, long double *, long double *);
+void	fframe_(int *, real_t *, real_t *, int *, real_t *, real_t *);
 
-void	findtop(long double [], int, int [], int);
-void	findbot(long double [], int, int [], int);
-void	findtpa(long double [], int, int [], int);
-void	findbta(long double [], int, int [], int);
+void	findtop(real_t [], int, int [], int);
+void	findbot(real_t [], int, int [], int);
+void	findtpa(real_t [], int, int [], int);
+void	findbta(real_t [], int, int [], int);
 void	finitop(int [], int, int [], int);
 void	finibot(int [], int, int [], int);
 void	finitpa(int [], int, int [], int);
 void	finibta(int [], int, int [], int);
 
-void	findtop_(long double [], int *, int [], int *);
-void	findbot_(long double [], int *, int [], int *);
-void	findtpa_(long double [], int *, int [], int *);
-void	findbta_(long double [], int *, int [], int *);
+void	findtop_(real_t [], int *, int [], int *);
+void	findbot_(real_t [], int *, int [], int *);
+void	findtpa_(real_t [], int *, int [], int *);
+void	findbta_(real_t [], int *, int [], int *);
 void	finitop_(int [], int *, int [], int *);
 void	finibot_(int [], int *, int [], int *);
 void	finitpa_(int [], int *, int [], int *);
 void	finibta_(int [], int *, int [], int *);
 
-polygon *get_pixel(int,char);
-int     get_child_pixels(int, int [], char);
-int     get_parent_pixels(int, int [], char);
-int     get_res(int,char);
+polygon *get_pixel(long long,char);
+polygon *pixel_poly(long long, char);
+int     get_child_pixels(long long, long long [], char);
+int     get_parent_pixels(long long, long long [], char);
+int     get_res(long long,char);
 
-void    healpix_ang2pix_nest(int, long double, long double, int *);
+void    healpix_ang2pix_nest(int, real_t, real_t, int *);
 polygon *get_healpix_poly(int, int);
+#ifdef	GCC
+int     healpix_polys(int, int npix, int [npix], polygon *[npix]);
+#else
+int     healpix_polys(int, int npix, int [/*npix*/], polygon *[/*npix*/]);
+#endif
 int     get_nside(int);
-void    healpix_verts(int, int, vec, long double []);
-void    pix2vec_nest__(int *, int *, long double *, long double *, long double *, long double *, long double *, long double *, long double *, long double *, long double *, long double *, long double *, long double *, long double *, long double *, long double *);
-long double  cmrpirpj(vec, vec);
-
-int	garea(polygon *, long double *, int, long double *);
-int	gcmlim(polygon *, long double *, vec, long double *, long double *);
-int	gphbv(polygon *, int, int, long double *, long double [2], long double [2]);
-int	gphi(polygon *, long double *, vec, long double, long double *);
+int     healpix_nest_caps(int, int, vec [], real_t []);
+void    healpix_child_caps(int, int, vec [2], real_t [2]);
+int     healpix_nest_pixel(int, vec);
+int     healpix_ring(int, int, int *, int *);
+int     healpix_ring_z(int, int, real_t *, real_t *);
+void    pix2vec_nest__(int *, int *, real_t *, real_t *, real_t *, real_t *, real_t *, real_t *, real_t *, real_t *, real_t *, real_t *, real_t *, real_t *, real_t *, real_t *, real_t *);
+real_t  cmrpirpj(vec, vec);
+
+int	garea(polygon *, real_t *, int, real_t *);
+int	poly_area(polygon *, real_t *, int, real_t *);
+unsigned long long poly_key(polygon *, real_t);
+int	gcmlim(polygon *, real_t *, vec, real_t *, real_t *);
+int	gphbv(polygon *, int, int, real_t *, real_t [2], real_t [2]);
+int	gphi(polygon *, real_t *, vec, real_t, real_t *);
 int	gptin(polygon *, vec);
 #ifdef	GCC
-int	gspher(polygon *, int lmax, long double *, long double *, long double [2], long double [2], harmonic [NW]);
-int	gsphera(long double, long double, long double, long double, int lmax, long double *, long double [2], long double [2], harmonic [NW]);
-int	gsphr(polygon *, int lmax, long double *, harmonic [NW]);
-int	gsphra(long double, long double, long double, long double, int lmax, harmonic [NW]);
+int	gspher(polygon *, int lmax, real_t *, real_t *, real_t [2], real_t [2], harmonic [NW]);
+int	gsphera(real_t, real_t, real_t, real_t, int lmax, real_t *, real_t [2], real_t [2], harmonic [NW]);
+int	gsphr(polygon *, int lmin, int lmax, real_t *, harmonic [NW - NW0]);
+int	gsphra(real_t, real_t, real_t, real_t, int lmin, int lmax, harmonic [NW - NW0]);
 #else
-int	gspher(polygon *, int lmax, long double *, long double *, long double [2], long double [2], harmonic [/*NW*/]);
-int	gsphera(long double, long double, long double, long double, int lmax, long double *, long double [2], long double [2], harmonic [/*NW*/]);
-int	gsphr(polygon *, int lmax, long double *, harmonic [/*NW*/]);
-int	gsphra(long double, long double, long double, long double, int lmax, harmonic [/*NW*/]);
+int	gspher(polygon *, int lmax, real_t *, real_t *, real_t [2], real_t [2], harmonic [/*NW*/]);
+int	gsphera(real_t, real_t, real_t, real_t, int lmax, real_t *, real_t [2], real_t [2], harmonic [/*NW*/]);
+int	gsphr(polygon *, int lmin, int lmax, real_t *, harmonic [/*NW - NW0*/]);
+int	gsphra(real_t, real_t, real_t, real_t, int lmin, int lmax, harmonic [/*NW - NW0*/]);
 #endif
-int	gverts(polygon *, int, long double *, int, int, int *, vec **, long double **, int **, int **, int *, int *, int **);
+int	gverts(polygon *, int, real_t *, int, int, int *, vec **, real_t **, int **, int **, int *, int *, int **);
 #ifdef	GCC
-int	gvert(polygon *poly, int, long double *, int nvmax, int, int nve, int *, vec [nvmax * nve], long double [nvmax], int [nvmax], int [poly->np], int *, int *, int [nvmax]);
+int	gvert(polygon *poly, int, real_t *, int nvmax, int, int nve, int *, vec [nvmax * nve], real_t [nvmax], int [nvmax], int [poly->np], int *, int *, int [nvmax]);
 #else
-int	gvert(polygon *poly, int, long double *, int nvmax, int, int nve, int *, vec [/*nvmax * nve*/], long double [/*nvmax*/], int [/*nvmax*/], int [/*poly->np*/], int *, int *, int [/*nvmax*/]);
+int	gvert(polygon *poly, int, real_t *, int nvmax, int, int nve, int *, vec [/*nvmax * nve*/], real_t [/*nvmax*/], int [/*nvmax*/], int [/*poly->np*/], int *, int *, int [/*nvmax*/]);
 #endif
-int	gvlims(polygon *, int, long double *, vec, int *, vec **, vec **, long double **, long double **, long double **, long double **, int **, int **, int *, int *, int **);
+int	gvlims(polygon *, int, real_t *, vec, int *, vec **, vec **, real_t **, real_t **, real_t **, real_t **, int **, int **, int *, int *, int **);
 #ifdef	GCC
-int	gvlim(polygon *poly, int, long double *, vec, int nvmax, int *, vec [nvmax], vec [nvmax], long double [nvmax], long double [nvmax], long double [poly->np], long double [poly->np], int [nvmax], int [poly->np], int *, int *, int [nvmax]);
+int	gvlim(polygon *poly, int, real_t *, vec, int nvmax, int *, vec [nvmax], vec [nvmax], real_t [nvmax], real_t [nvmax], real_t [poly->np], real_t [poly->np], int [nvmax], int [poly->np], int *, int *, int [nvmax]);
 #else
-int	gvlim(polygon *poly, int, long double *, vec, int nvmax, int *, vec [/*nvmax*/], vec [/*nvmax*/], long double [/*nvmax*/], long double [/*nvmax*/], long double [/*poly->np*/], long double [/*poly->np*/], int [/*nvmax*/], int [/*poly->np*/], int *, int *, int [/*nvmax*/]);
+int	gvlim(polygon *poly, int, real_t *, vec, int nvmax, int *, vec [/*nvmax*/], vec [/*nvmax*/], real_t [/*nvmax*/], real_t [/*nvmax*/], real_t [/*poly->np*/], real_t [/*poly->np*/], int [/*nvmax*/], int [/*poly->np*/], int *, int *, int [/*nvmax*/]);
 #endif
-int	gvphi(polygon *, vec, long double, vec, long double *, long double *, vec);
+int	gvphi(polygon *, vec, real_t, vec, real_t *, real_t *, vec);
 
-void	garea_(long double *, vec [], long double [], int *, long double *, int *, long double *, int *, logical *);
+void	garea_(real_t *, vec [], real_t [], int *, real_t *, int *, real_t *, int *, logical *);
 void	gaxisi_(vec, vec, vec);
-void	gcmlim_(vec [], long double [], int *, vec, long double *, long double *, long double *, long double *, int *);
-void	gphbv_(long double [2], long double [2], vec [], long double [], int *, int *, int *, int *, long double *, long double *, int *);
-void	gphi_(long double *, vec [], long double [], int *, vec, long double *, long double *, long double *, int *);
-logical	gptin_(vec [], long double [], int *, vec);
-void	gspher_(long double *, long double [2], long double [2], harmonic [], int *, int *, int *, vec [], long double [], int *, int *, int *, int *, long double *, long double *, int *, long double *, logical *);
-void	gsphera_(long double *, long double [2], long double [2], harmonic [], int *, int *, int *, int *, long double *, long double *, long double *, long double *, long double *, long double *);
-void	gvert_(vec [], long double [], int [], int [], int [], int *, int *, int *, int *, int *, int *, vec [], long double [], int *, int *, long double *, long double *, int *, long double *, int *, logical *);
+void	gcmlim_(vec [], real_t [], int *, vec, real_t *, real_t *, real_t *, real_t *, int *);
+void	gphbv_(real_t [2], real_t [2], vec [], real_t [], int *, int *, int *, int *, real_t *, real_t *, int *);
+void	gphi_(real_t *, vec [], real_t [], int *, vec, real_t *, real_t *, real_t *, int *);
+logical	gptin_(vec [], real_t [], int *, vec);
+void	gspher_(real_t *, real_t [2], real_t [2], harmonic [], int *, int *, int *, int *, vec [], real_t [], int *, int *, int *, int *, real_t *, real_t *, int *, real_t *, logical *);
+void	gsphera_(real_t *, real_t [2], real_t [2], harmonic [], int *, int *, int *, int *, int *, real_t *, real_t *, real_t *, real_t *, real_t *, real_t *);
+void	gvert_(vec [], real_t [], int [], int [], int [], int *, int *, int *, int *, int *, int *, vec [], real_t [], int *, int *, real_t *, real_t *, int *, real_t *, int *, logical *);
 
-void	gvlim_(vec [], vec [], long double [], long double [], long double [], long double [], int [], int [], int [], int *, int *, int *, int *, vec [], long double [], int *, long double [], int *, long double *, long double *, int *, long double *, int *, logical *);
-void	gvphi_(long double *, vec, vec [], long double [], int *, vec, long double *, vec, long double *, long double *, int *);
+void	gvlim_(vec [], vec [], real_t [], real_t [], real_t [], real_t [], int [], int [], int [], int *, int *, int *, int *, vec [], real_t [], int *, real_t [], int *, real_t *, real_t *, int *, real_t *, int *, logical *);
+void	gvphi_(real_t *, vec, vec [], real_t [], int *, vec, real_t *, vec, real_t *, real_t *, int *);
 
 #ifdef	GCC
-int	harmonize_polys(int npoly, polygon *[npoly], long double, int lmax, harmonic w[NW]);
+int	harmonize_polys(int npoly, polygon *[npoly], real_t, int lmin, int lmax, char *, harmonic w[NW - NW0]);
 #else
-int	harmonize_polys(int npoly, polygon *poly[/*npoly*/], long double, int lmax, harmonic w[/*NW*/]);
+int	harmonize_polys(int npoly, polygon *poly[/*npoly*/], real_t, int lmin, int lmax, char *, harmonic w[/*NW - NW0*/]);
 #endif
 
-void	harmonizepolys_(long double *, int *, harmonic []);
+#ifdef	GCC
+int	harmonize_healpix(int nside, int npoly, polygon *[npoly], real_t, int lmax, harmonic w[NW]);
+#else
+int	harmonize_healpix(int nside, int npoly, polygon *poly[/*npoly*/], real_t, int lmax, harmonic w[/*NW*/]);
+#endif
+int	healpix_map(int, int, polygon *[], real_t, real_t []);
+
+void	harmonizepolys_(real_t *, int *, harmonic []);
 
 void	ikrand_(int *, double *);
 void	ikrandp_(double *, double *);
@@ -203,38 +224,43 @@ void	parse_args(int, char *[]);
 int	parse_fopt(void);
 
 #ifdef	GCC
-int	partition_poly(polygon **, int npolys, polygon *[npolys], long double, int, int, int, int, int *);
-int	partition_gpoly(polygon *, int npolys, polygon *[npolys], long double, int, int, int, int *);
-int	part_poly(polygon *, int npolys, polygon *[npolys], long double, int, int, int, int *, int *);
-int     pixel_list(int npoly, polygon *[npoly], int max_pixel, int [max_pixel], int [max_pixel]);
-int     grow_poly(polygon **, int npolys, polygon *[npolys], long double, long double, int *);
+int	partition_poly(polygon **, int npolys, polygon *[npolys], real_t, int, int, int, int, int *);
+int	partition_gpoly(polygon *, int npolys, polygon *[npolys], real_t, int, int, int, int *);
+int	part_poly(polygon *, int npolys, polygon *[npolys], real_t, int, int, int, int *, int *);
+int     pixel_dir(int npoly, polygon *[npoly], pixeldir *);
+int     grow_poly(polygon **, int npolys, polygon *[npolys], real_t, real_t, int *);
 #else
-int	partition_poly(polygon **, int npolys, polygon *[/*npolys*/], long double, int, int, int, int, int *);
-int	partition_gpoly(polygon *, int npolys, polygon *[/*npolys*/], long double, int, int, int, int *);
-int	part_poly(polygon *, int npolys, polygon *[/*npolys*/], long double, int, int, int, int *, int *);
-int     pixel_list(int npoly, polygon *[/*npoly*/], int max_pixel, int [/*max_pixel*/], int [/*max_pixel*/]);
-int     grow_poly(polygon **, int npolys, polygon *[/*npolys*/], long double, long double, int *);
+int	partition_poly(polygon **, int npolys, polygon *[/*npolys*/], real_t, int, int, int, int, int *);
+int	partition_gpoly(polygon *, int npolys, polygon *[/*npolys*/], real_t, int, int, int, int *);
+int	part_poly(polygon *, int npolys, polygon *[/*npolys*/], real_t, int, int, int, int *, int *);
+int     pixel_dir(int npoly, polygon *[/*npoly*/], pixeldir *);
+int     grow_poly(polygon **, int npolys, polygon *[/*npolys*/], real_t, real_t, int *);
 #endif
 
-int     pixel_start(int, char);
+long long pixel_start(int, char);
+int     pixel_dir_all(int, pixeldir *);
+int     pixel_find(pixeldir *, long long);
+void    free_pixel_dir(pixeldir *);
 
-long double	places(long double, int);
+real_t	places(real_t, int);
 int     poly_cmp(polygon **, polygon **);
 
 #ifdef	GCC
-int	poly_id(int npoly, polygon *[npoly], long double, long double, long long **, long double **);
+int	poly_id(int npoly, polygon *[npoly], real_t, real_t, long long **, real_t **);
 void	poly_sort(int npoly, polygon *[npoly], char);
 #else
-int	poly_id(int npoly, polygon *[/*npoly*/], long double, long double, long long **, long double **);
+int	poly_id(int npoly, polygon *[/*npoly*/], real_t, real_t, long long **, real_t **);
 void	poly_sort(int npoly, polygon *[/*npoly*/], char);
 #endif
 
 
-int	prune_poly(polygon *, long double);
+int	prune_poly(polygon *, real_t);
 int	trim_poly(polygon *);
 int	touch_poly(polygon *);
 
-int	rdangle(char *, char **, char, long double *);
+int	rdangle(char *, char **, char, real_t *);
+int	rdreal(char *, char **, real_t *);
+int	rdinteger(char *, char **, long long *);
 
 #ifdef	GCC
 int	rdmask(char *, format *, int npolys, polygon *[npolys]);
@@ -245,30 +271,35 @@ int	rdmask(char *, format *, int npolys, polygon *[/*npolys*/]);
 void	rdmask_(void);
 
 int	rdspher(char *, int *, harmonic **);
+#ifdef	GCC
+int	rdspher_band(FILE *, char *, int *, int *, int lmin, int lmax, harmonic [NW - NW0]);
+#else
+int	rdspher_band(FILE *, char *, int *, int *, int lmin, int lmax, harmonic [/*NW - NW0*/]);
+#endif
 
-void	scale(long double *, char, char);
+void	scale(real_t *, char, char);
 void	scale_azel(azel *, char, char);
 void	scale_vert(vertices *, char, char);
 
 #ifdef	GCC
-int	search(int n, long double [n], long double);
+int	search(int n, real_t [n], real_t);
 #else
-int	search(int n, long double [/*n*/], long double);
+int	search(int n, real_t [/*n*/], real_t);
 #endif
 
 #ifdef	GCC
-int	snap_polys(format *fmt, int npoly, polygon *poly[npoly], int, long double, long double, long double, long double, long double, int, char *);
+int	snap_polys(format *fmt, int npoly, polygon *poly[npoly], int, real_t, real_t, real_t, real_t, real_t, int, char *);
 #else
-int	snap_polys(format *fmt, int npoly, polygon *poly[/*npoly*/], int, long double, long double, long double, long double, long double, int, char *);
+int	snap_polys(format *fmt, int npoly, polygon *poly[/*npoly*/], int, real_t, real_t, real_t, real_t, real_t, int, char *);
 #endif
-int	snap_poly(polygon *, polygon *, long double, long double);
-int	snap_polyth(polygon *, polygon *, long double, long double, long double);
+int	snap_poly(polygon *, polygon *, real_t, real_t);
+int	snap_polyth(polygon *, polygon *, real_t, real_t, real_t);
 
-int	split_poly(polygon **, polygon *, polygon **, long double);
+int	split_poly(polygon **, polygon *, polygon **, real_t);
 #ifdef	GCC
-int	fragment_poly(polygon **, polygon *, int, int npolys, polygon *[npolys], long double, char);
+int	fragment_poly(polygon **, polygon *, int, int npolys, polygon *[npolys], real_t, char);
 #else
-int	fragment_poly(polygon **, polygon *, int, int npolys, polygon *[/*npolys*/], long double, char);
+int	fragment_poly(polygon **, polygon *, int, int npolys, polygon *[/*npolys*/], real_t, char);
 #endif
 
 int	strcmpl(const char *, const char *);
@@ -278,35 +309,55 @@ int	strdict(char *, char *[]);
 int	strdictl(char *, char *[]);
 
 #ifdef	GCC
-int	vmid(polygon *, long double, int nv, int nve, vec [nv * nve], int [nv], int [nv], int *, vec **);
+int	vmid(polygon *, real_t, int nv, int nve, vec [nv * nve], int [nv], int [nv], int *, vec **);
 int	vmidc(polygon *, int nv, int nve, vec [nv * nve], int [nv], int [nv], int *, vec **);
 #else
-int	vmid(polygon *, long double, int nv, int nve, vec [/*nv * nve*/], int [/*nv*/], int [/*nv*/], int *, vec **);
+int	vmid(polygon *, real_t, int nv, int nve, vec [/*nv * nve*/], int [/*nv*/], int [/*nv*/], int *, vec **);
 int	vmidc(polygon *, int nv, int nve, vec [/*nv * nve*/], int [/*nv*/], int [/*nv*/], int *, vec **);
 #endif
 
-long double	weight_fn(long double, long double, char *);
-long double	rdweight(char *);
+real_t	weight_fn(real_t, real_t, char *);
+real_t	rdweight(char *);
+int	rdidweight(char *);
+int	idweight(long long, real_t *);
+
+real_t	twoqz_(real_t *, real_t *, int *);
+real_t	twodf100k_(real_t *, real_t *);
+real_t	twodf230k_(real_t *, real_t *);
 
-long double	twoqz_(long double *, long double *, int *);
-long double	twodf100k_(long double *, long double *);
-long double	twodf230k_(long double *, long double *);
+long long which_pixel(real_t, real_t, int, char);
+#ifdef	GCC
+int	which_pixels(int n, real_t [n], real_t [n], int, char, long long [n], long long []);
+#else
+int	which_pixels(int n, real_t [/*n*/], real_t [/*n*/], int, char, long long [/*n*/], long long []);
+#endif
 
-int     which_pixel(long double, long double, int, char);
+#ifdef	GCC
+void	wrangle(real_t, char, int, size_t str_len, char [str_len]);
+int	wrrealf(real_t, int, size_t str_len, char [str_len]);
+int	wrrealg(real_t, int, int, size_t str_len, char [str_len]);
+#else
+void	wrangle(real_t, char, int, size_t str_len, char [/*str_len*/]);
+int	wrrealf(real_t, int, size_t str_len, char [/*str_len*/]);
+int	wrrealg(real_t, int, int, size_t str_len, char [/*str_len*/]);
+#endif
+int	wrbuf(FILE *);
+int	wrclose(FILE *);
 
 #ifdef	GCC
-void	wrangle(long double, char, int, size_t str_len, char [str_len]);
+real_t	wrho(real_t, real_t, int lmax, int, harmonic w[NW], real_t, real_t);
 #else
-void	wrangle(long double, char, int, size_t str_len, char [/*str_len*/]);
+real_t	wrho(real_t, real_t, int lmax, int, harmonic w[/*NW*/], real_t, real_t);
 #endif
 
 #ifdef	GCC
-long double	wrho(long double, long double, int lmax, int, harmonic w[NW], long double, long double);
+int	wrhos(int npt, azel [npt], int lmax, int, harmonic w[NW], real_t, real_t, real_t, real_t [npt]);
 #else
-long double	wrho(long double, long double, int lmax, int, harmonic w[/*NW*/], long double, long double);
+int	wrhos(int npt, azel [/*npt*/], int lmax, int, harmonic w[/*NW*/], real_t, real_t, real_t, real_t [/*npt*/]);
 #endif
 
-long double	wrho_(long double *, long double *, harmonic *, int *, int *, int *, int *, long double *, long double *);
+real_t	wrho_(real_t *, real_t *, harmonic *, int *, int *, int *, int *, real_t *, real_t *);
+void	wrhoel_(real_t *, harmonic *, int *, int *, int *, int *, real_t *, real_t *, real_t *);
 
 #ifdef	GCC
 int	wrmask(char *, format *, int npolys, polygon *[npolys]);
@@ -320,7 +371,7 @@ int	wr_area(char *, format *, int npolys, polygon *[npolys], int);
 int	wr_id(char *, int npolys, polygon *[npolys], int);
 int	wr_midpoint(char *, format *, int npolys, polygon *[npolys], int);
 int	wr_weight(char *, format *, int npolys, polygon *[npolys], int);
-int     wr_healpix_weight(char *, format *, int numweight, long double [numweight]);
+int     wr_healpix_weight(char *, format *, int numweight, real_t [numweight], long long [numweight], int);
 int	wr_list(char *, format *, int npolys, polygon *[npolys], int);
 int	discard_poly(int npolys, polygon *[npolys]);
 #else
@@ -334,17 +385,19 @@ int	wr_area(char *, format *, int npolys, polygon *[/*npolys*/], int);
 int	wr_id(char *, int npolys, polygon *[/*npolys*/], int);
 int	wr_midpoint(char *, format *, int npolys, polygon *[/*npolys*/], int);
 int	wr_weight(char *, format *, int npolys, polygon *[/*npolys*/], int);
-int     wr_healpix_weight(char *, format *, int numweight, long double [/*numweight*/]);
+int     wr_healpix_weight(char *, format *, int numweight, real_t [/*numweight*/], long long [/*numweight*/], int);
 int	wr_list(char *, format *, int npolys, polygon *[/*npolys*/], int);
 int	discard_poly(int npolys, polygon *[/*npolys*/]);
 #endif
 
-int	wrrrcoeffs(char *, long double, long double [2], long double [2]);
+int	wrrrcoeffs(char *, real_t, real_t [2], real_t [2]);
 
 #ifdef	GCC
 int	wrspher(char *, int lmax, harmonic [NW]);
+int	wrspher_band(FILE *, int, int lmin, int lmax, harmonic [NW - NW0]);
 #else
 int	wrspher(char *, int lmax, harmonic [/*NW*/]);
+int	wrspher_band(FILE *, int, int lmin, int lmax, harmonic [/*NW - NW0*/]);
 #endif
 
 #endif	/* MANGLEFN_H */
@@ -5,6 +5,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include "azelfile.h"
 #include "inputfile.h"
 #include "manglefn.h"
 #include "defaults.h"
@@ -14,14 +15,14 @@
 #define LMAX		MAXINT
 
 /* getopt options */
-const char *optstr = "dqw:l:g:x:u:p:";
+const char *optstr = "dqw:l:g:E:x:u:p:FI:O:";
 
 /* local functions */
 void	usage(void);
 #ifdef	GCC
-int	map(char *, char *, format *, int lmax, harmonic w[NW], long double, long double);
+int	map(char *, char *, format *, int lmax, harmonic w[NW], real_t, real_t, real_t);
 #else
-int	map(char *, char *, format *, int lmax, harmonic w[/*NW*/], long double, long double);
+int	map(char *, char *, format *, int lmax, harmonic w[/*NW*/], real_t, real_t, real_t);
 #endif
 
 /*------------------------------------------------------------------------------
@@ -62,18 +63,21 @@ int main(int argc, char *argv[])
     if (lsmooth == 0.) {
 	msg("no smoothing\n");
     } else {
-	msg("smoothing harmonic number lsmooth = %Lg\n", lsmooth);
+	msg("smoothing harmonic number lsmooth = %" RL "g\n", lsmooth);
 	if (esmooth != 2.) {
-	    msg("smoothing exponent = %Lg\n", esmooth);
+	    msg("smoothing exponent = %" RL "g\n", esmooth);
 	}
     }
+    if (eltol > 0.) {
+	msg("will interpolate between elevations to relative accuracy %" RL "g\n", eltol);
+    }
 
     /* read harmonics */
     nws = rdspher(Wlm_filename, &lmax, &w_p);
     if (nws == -1) exit(1);
 
     /* map */
-    nmap = map(argv[argc - 2], argv[argc - 1], &fmt, lmax, w_p, lsmooth, esmooth);
+    nmap = map(argv[argc - 2], argv[argc - 1], &fmt, lmax, w_p, lsmooth, esmooth, eltol);
     if (nmap == -1) exit(1);
 
     return(0);
@@ -84,7 +88,7 @@ int main(int argc, char *argv[])
 void usage(void)
 {
     printf("usage:\n");
-    printf("map [-d] [-q] -w<Wlmfile> [-l<lmax>] [-g<lsmooth>] [-u<inunit>[,<outunit>]] [-p[+|-][<n>]] azel_infile outfile\n");
+    printf("map [-d] [-q] -w<Wlmfile> [-l<lmax>] [-g<lsmooth>] [-E<tol>] [-u<inunit>[,<outunit>]] [-p[+|-][<n>]] azel_infile outfile\n");
 #include "usage.h"
 }
 
@@ -94,6 +98,9 @@ void usage(void)
 
 /*------------------------------------------------------------------------------
   Map.  Implemented as interpretive read/write, to permit interactive behaviour.
+  Points are read in batches, and evaluated together by wrhos, which shares
+  the sums over l among points at the same elevation; with -F (flush_lines),
+  each batch is one point, so each line is answered as soon as it is read.
 
    Input: in_filename = name of file to read from;
 			"" or "-" means read from standard input.
@@ -104,14 +111,17 @@ void usage(void)
 	  lmax = maximum harmonic number.
 	  lsmooth = smoothing harmonic number (0. = no smooth).
 	  esmooth = smoothing exponent (2. = gaussian).
+	  eltol = tolerance of interpolation in elevation (0. = exact).
   Return value: number of items written,
 		or -1 if error occurred.
 */
-int map(char *in_filename, char *out_filename, format *fmt, int lmax, harmonic w[/*NW*/], long double lsmooth, long double esmooth)
+int map(char *in_filename, char *out_filename, format *fmt, int lmax, harmonic w[/*NW*/], real_t lsmooth, real_t esmooth, real_t eltol)
 {
 /* precision of map values written to file */
 #define PRECISION	8
 #define AZEL_STR_LEN	32
+/* number of points evaluated at a time */
+#define NBATCH		262144
     inputfile file = {
 	'\0',	/* input filename */
 	0x0,	/* input file stream */
@@ -122,10 +132,14 @@ int map(char *in_filename, char *out_filename, format *fmt, int lmax, harmonic w
     };
     char input[] = "input", output[] = "output";
     char *word, *next;
-    char az_str[AZEL_STR_LEN], el_str[AZEL_STR_LEN];
-    int ird, len, mmax, nmap, width;
-    long double rho;
+    char az_str[AZEL_STR_LEN], el_str[AZEL_STR_LEN], rho_str[AZEL_STR_LEN];
+    int eof, i, ird, len, mmax, nb, nbatch, nmap, nread, width;
+    long long id;
+    long long *ids;
+    real_t *rhos;
     azel v;
+    azel *vs;
+    azelfile azelin, azelout;
     char *out_fn;
     FILE *outfile;
 
@@ -143,6 +157,17 @@ int map(char *in_filename, char *out_filename, format *fmt, int lmax, harmonic w
     }
     file.line_number = 0;
 
+    /* binary input: the header gives the angular units */
+    if (fmt->inazel != 't') {
+	azelin.name = file.name;
+	azelin.file = file.file;
+	azelin.fmt = fmt->inazel;
+	azelin.unit = fmt->inunit;
+	ird = rdazel_head(&azelin);
+	if (ird == -1) return(-1);
+	if (ird == 1) fmt->inunit = azelin.unit;
+    }
+
     /* open out_filename for writing */
     if (!out_filename || strcmp(out_filename, "-") == 0) {
 	outfile = stdout;
@@ -153,6 +178,7 @@ int map(char *in_filename, char *out_filename, format *fmt, int lmax, harmonic w
 	    fprintf(stderr, "cannot open %s for writing\n", out_filename);
 	    return(-1);
 	}
+	wrbuf(outfile);
 	out_fn = out_filename;
     }
 
@@ -177,68 +203,141 @@ int map(char *in_filename, char *out_filename, format *fmt, int lmax, harmonic w
     width = PRECISION + 6;
 
     /* write header */
-    v.az = 0.;
-    wrangle(v.az, fmt->outunit, fmt->outprecision, AZEL_STR_LEN, az_str);
-    len = strlen(az_str);
-    if (fmt->outunit == 'h') {
-	sprintf(az_str, "az(hms)");
-	sprintf(el_str, "el(dms)");
+    if (fmt->outazel != 't') {
+	/* the map value goes in the weight column; any input ids are carried through */
+	azelout.name = out_fn;
+	azelout.file = outfile;
+	azelout.fmt = fmt->outazel;
+	azelout.columns = AZEL_WEIGHT | ((fmt->inazel != 't')? (azelin.columns & AZEL_ID) : 0);
+	azelout.unit = fmt->outunit;
+	if (wrazel_head(&azelout) == -1) return(-1);
     } else {
-	sprintf(az_str, "az(%c)", fmt->outunit);
-	sprintf(el_str, "el(%c)", fmt->outunit);
+	v.az = 0.;
+	wrangle(v.az, fmt->outunit, fmt->outprecision, AZEL_STR_LEN, az_str);
+	len = strlen(az_str);
+	if (fmt->outunit == 'h') {
+	    sprintf(az_str, "az(hms)");
+	    sprintf(el_str, "el(dms)");
+	} else {
+	    sprintf(az_str, "az(%c)", fmt->outunit);
+	    sprintf(el_str, "el(%c)", fmt->outunit);
+	}
+	fprintf(outfile, "%*s %*s %*s\n", len, az_str, len, el_str, width - 4, "wrho");
+    }
+
+    /* batch of points */
+    nbatch = (flush_lines)? 1 : NBATCH;
+    vs = (azel *) malloc(sizeof(azel) * nbatch);
+    ids = (long long *) malloc(sizeof(long long) * nbatch);
+    rhos = (real_t *) malloc(sizeof(real_t) * nbatch);
+    if (!vs || !ids || !rhos) {
+	fprintf(stderr, "map: failed to allocate memory for %d points\n", nbatch);
+	return(-1);
     }
-    fprintf(outfile, "%*s %*s %*s\n", len, az_str, len, el_str, width - 4, "wrho");
 
     /* interpretive read/write loop */
     nmap = 0;
-    while (1) {
-	/* read line */
-	ird = rdline(&file);
-	/* serious error */
-	if (ird == -1) return(-1);
-	/* EOF */
-	if (ird == 0) break;
-
-	/* read <az> */
-	word = file.line;
-	ird = rdangle(word, &next, fmt->inunit, &v.az);
-	/* skip header */
-	if (ird != 1 && nmap == 0) continue;
-	/* otherwise exit on unrecognized characters */
-	if (ird != 1) break;
-
-	/* read <el> */
-	word = next;
-	ird = rdangle(word, &next, fmt->inunit, &v.el);
-	/* skip header */
-	if (ird != 1 && nmap == 0) continue;
-	/* otherwise exit on unrecognized characters */
-	if (ird != 1) break;
-
-	/* convert az and el from input units to radians */
-	scale_azel(&v, fmt->inunit, 'r');
+    nread = 0;
+    id = 0;
+    eof = 0;
+    while (!eof) {
+	/* read a batch of points */
+	nb = 0;
+	while (nb < nbatch) {
+	    if (fmt->inazel != 't') {
+		/* read binary record */
+		ird = rdazel(&azelin, &v, &id, 0x0);
+		/* serious error */
+		if (ird == -1) return(-1);
+		/* EOF */
+		if (ird == 0) {
+		    eof = 1;
+		    break;
+		}
+	    } else {
+		/* read line */
+		ird = rdline(&file);
+		/* serious error */
+		if (ird == -1) return(-1);
+		/* EOF */
+		if (ird == 0) {
+		    eof = 1;
+		    break;
+		}
+
+		/* read <az> */
+		word = file.line;
+		ird = rdangle(word, &next, fmt->inunit, &v.az);
+		/* skip header */
+		if (ird != 1 && nread == 0) continue;
+		/* otherwise exit on unrecognized characters */
+		if (ird != 1) {
+		    eof = 1;
+		    break;
+		}
+
+		/* read <el> */
+		word = next;
+		ird = rdangle(word, &next, fmt->inunit, &v.el);
+		/* skip header */
+		if (ird != 1 && nread == 0) continue;
+		/* otherwise exit on unrecognized characters */
+		if (ird != 1) {
+		    eof = 1;
+		    break;
+		}
+	    }
+
+	    /* convert az and el from input units to radians */
+	    scale_azel(&v, fmt->inunit, 'r');
+
+	    vs[nb] = v;
+	    ids[nb] = id;
+	    nb++;
+	    nread++;
+	}
+	if (nb == 0) break;
 
 	/*
 	  The entire of map.c is an interface to the next line of code.
 	  Bizarre, huh?
 	*/
-        /* compute the value of the window function at this point */
-	rho = wrho(v.az, v.el, lmax, mmax, w, lsmooth, esmooth);
-
-	/* convert az and el from radians to output units */
-	scale_azel(&v, 'r', fmt->outunit);
-
-	/* write result */
-	wrangle(v.az, fmt->outunit, fmt->outprecision, AZEL_STR_LEN, az_str);
-	wrangle(v.el, fmt->outunit, fmt->outprecision, AZEL_STR_LEN, el_str);
-	fprintf(outfile, "%s %s %- #*.*Lg\n", az_str, el_str, width, PRECISION, rho);
-	fflush(outfile);
+        /* compute the value of the window function at these points */
+	if (wrhos(nb, vs, lmax, mmax, w, lsmooth, esmooth, eltol, rhos) == -1) return(-1);
+
+	for (i = 0; i < nb; i++) {
+	    v = vs[i];
+
+	    /* convert az and el from radians to output units */
+	    scale_azel(&v, 'r', fmt->outunit);
+
+	    /* write result */
+	    if (fmt->outazel != 't') {
+		if (wrazel(&azelout, &v, ids[i], rhos[i], 0) == -1) return(-1);
+	    } else {
+		wrangle(v.az, fmt->outunit, fmt->outprecision, AZEL_STR_LEN, az_str);
+		wrangle(v.el, fmt->outunit, fmt->outprecision, AZEL_STR_LEN, el_str);
+		/* as "%- #*.*Lg" */
+		rho_str[0] = ' ';
+		wrrealg(rhos[i], PRECISION, 1, AZEL_STR_LEN - 1, (signbit(rhos[i]))? rho_str : &rho_str[1]);
+		fprintf(outfile, "%s %s %-*s\n", az_str, el_str, width, rho_str);
+	    }
+	    if (flush_lines) fflush(outfile);
+
+	    /* increment counter of results */
+	    nmap++;
+	}
+    }
+    free(vs);
+    free(ids);
+    free(rhos);
 
-        /* increment counter of results */
-	nmap++;
+    if (fmt->outazel != 't') {
+	if (wrazel_end(&azelout) == -1) return(-1);
     }
 
     if (outfile != stdout) {
+	wrclose(outfile);
 	msg("map: %d values written to %s\n", nmap, out_fn);
     }
 
@@ -5,7 +5,14 @@
 #include <stdlib.h>
 #include "manglefn.h"
 
-#define MEG(i)		(long double)((i+999)/1000)/1000.
+#define MEG(i)		(real_t)((i+999)/1000)/1000.
+
+/* memory tallies may be updated from several threads at once */
+#ifdef	_OPENMP
+#define ATOMIC		_Pragma("omp atomic")
+#else
+#define ATOMIC
+#endif
 
 static long memory = 0, femory = 0;
 static int mpoly = 0, fpoly = 0;
@@ -24,22 +31,25 @@ polygon *new_poly(int npmax)
     /* allocate memory for new polygon */
     poly = (polygon *) malloc(sizeof(polygon));
     if (!poly) return(0x0);
-    mpoly++;
-    memory += sizeof(polygon);
+    ATOMIC mpoly++;
+    ATOMIC memory += sizeof(polygon);
 
     /* allocate new rp array */
     poly->rp = (vec *) malloc(sizeof(vec) * npmax);
     if (!poly->rp) return(0x0);
-    memory += sizeof(vec) * npmax;
+    ATOMIC memory += sizeof(vec) * npmax;
 
     /* allocate new cm array */
-    poly->cm = (long double *) malloc(sizeof(long double) * npmax);
+    poly->cm = (real_t *) malloc(sizeof(real_t) * npmax);
     if (!poly->cm) return(0x0);
-    memory += sizeof(long double) * npmax;
+    ATOMIC memory += sizeof(real_t) * npmax;
 
     /* allocated number of caps of polygon */
     poly->npmax = npmax;
 
+    /* no area kept */
+    poly->areaok = 0;
+
     return(poly);
 }
 
@@ -51,19 +61,20 @@ void free_poly(polygon *poly)
   
     if (poly) {
 
-	fpoly++;
-	femory += sizeof(polygon);
+	ATOMIC fpoly++;
+	ATOMIC femory += sizeof(polygon);
 	if (poly->rp) {
 	  free(poly->rp);
 	  poly->rp = 0x0;
-	  femory += sizeof(vec) * poly->npmax;
+	  ATOMIC femory += sizeof(vec) * poly->npmax;
 	}
 
 	if (poly->cm) {
 	    free(poly->cm);
 	    poly->cm = 0x0;
-	    femory += sizeof(long double) * poly->npmax;
+	    ATOMIC femory += sizeof(real_t) * poly->npmax;
 	}
+
 	free(poly);
     }
 }
@@ -115,6 +126,6 @@ int room_poly(polygon **poly, int np, int dnp, int save)
 void memmsg(void)
 {
     if (mpoly > 0)
-	msg("%d polygons (%.3LfMb) allocated, %d (%.3LfMb) freed\n",
+	msg("%d polygons (%.3" RL "fMb) allocated, %d (%.3" RL "fMb) freed\n",
 	    mpoly, MEG(memory), fpoly, MEG(femory));
 }
@@ -27,6 +27,7 @@ void parse_args(int argc, char *argv[])
 	    if (*optstr) {
 		if ((strchr(optstr, 'l')) && LMAX < MAXINT) printf(" -l%d", LMAX);
 		if (strchr(optstr, 'g')) printf(" -g%g", LSMOOTH);
+		if (strchr(optstr, 'E')) printf(" -E%g", ELTOL);
 		if (strchr(optstr, 'c')) printf(" -c%u", SEED);
 		if (strchr(optstr, 'r')) printf(" -r%d", NRANDOM);
 		if (strchr(optstr, 'a')) printf(" -a%.15g%c", AXTOL, AXUNIT);
@@ -39,8 +40,10 @@ void parse_args(int argc, char *argv[])
 		if (strchr(optstr, 'v')) printf(" -v%c", fmt.newid);
 		if (strchr(optstr, 'f')) printf(" -f%.15g,%.15g,%.15g%c", AZN, ELN, AZP, TRUNIT);
 		if (strchr(optstr, 'u')) printf(" -u%c,%c", INUNIT, OUTUNIT);
+		if (strchr(optstr, 'I')) printf(" -I%c", INAZEL);
+		if (strchr(optstr, 'O')) printf(" -O%c", OUTAZEL);
 		if (strchr(optstr, 'p')) printf(" -p%c%s", OUTPHASE, "auto");
-		if (strchr(optstr, 'P')) printf(" -P%c%d,%d", SCHEME,POLYS_PER_PIXEL,RES_MAX);
+		if (strchr(optstr, 'P')) printf(" -P%c%d,%d,%d", SCHEME,POLYS_PER_PIXEL,RES_MAX,CAPS_PER_PIXEL);
 		if (strchr(optstr, 'B')) printf(" -B%c", BMETHOD);
 		if (strchr(optstr, 'G')) printf(" -G%.15g%c", GROW_ANGLE, GUNIT);
 		if (strchr(optstr, 'i')) {
@@ -76,11 +79,21 @@ void parse_args(int argc, char *argv[])
 	    Wlm_filename = (char *) malloc(sizeof(char) * (strlen(optarg) + 1));
 	    sscanf(optarg, "%s", Wlm_filename);
 	    break;
+	case 'C':		/* directory of harmonics of each polygon */
+	    if (harmonic_cache) free(harmonic_cache);
+	    harmonic_cache = (char *) malloc(sizeof(char) * (strlen(optarg) + 1));
+	    sscanf(optarg, "%s", harmonic_cache);
+	    break;
 	case 'z':		/* survey, or name of file containing weights */
 	    if (survey) free(survey);
 	    survey = (char *) malloc(sizeof(char) * (strlen(optarg) + 1));
 	    sscanf(optarg, "%s", survey);
 	    break;
+	case 'Z':		/* file containing table of polygon ids and weights */
+	    if (idweight_filename) free(idweight_filename);
+	    idweight_filename = (char *) malloc(sizeof(char) * (strlen(optarg) + 1));
+	    sscanf(optarg, "%s", idweight_filename);
+	    break;
 	case 'l':		/* maximum harmonic number */
 	    iscan = sscanf(optarg, "%d", &lmax);
 	    if (iscan != 1) {
@@ -92,14 +105,36 @@ void parse_args(int argc, char *argv[])
 		exit(1);
 	    }
 	    break;
+	case 'L':		/* number of harmonic numbers computed at a time */
+	    iscan = sscanf(optarg, "%d", &lblock);
+	    if (iscan != 1) {
+		fprintf(stderr, "-%c%s: expecting integer argument\n", opt, optarg);
+		exit(1);
+	    }
+	    if (lblock < 0) {
+		fprintf(stderr, "-%c%s: number %d of harmonic numbers at a time must >= 0\n", opt, optarg, lblock);
+		exit(1);
+	    }
+	    break;
 	case 'g':		/* smoothing harmonic number */
 				/* and smoothing exponent (default 2.) */
-	    iscan = sscanf(optarg, "%Lg %*[,] %Lg", &lsmooth, &esmooth);
+	    iscan = sscanf(optarg, "%" RL "g %*[,] %" RL "g", &lsmooth, &esmooth);
 	    if (iscan < 1) {
 		fprintf(stderr, "-%c%s: expecting real argument\n", opt, optarg);
 		exit(1);
 	    }
 	    break;
+	case 'E':		/* tolerance of interpolation in elevation */
+	    iscan = sscanf(optarg, "%" RL "g", &eltol);
+	    if (iscan != 1) {
+		fprintf(stderr, "-%c%s: expecting real argument\n", opt, optarg);
+		exit(1);
+	    }
+	    if (eltol < 0.) {
+		fprintf(stderr, "-%c%s: tolerance %" RL "g must be >= 0\n", opt, optarg, eltol);
+		exit(1);
+	    }
+	    break;
 	case 'c':		/* seed for random number generator */
 	    iscan = sscanf(optarg, "%u", &seed);
 	    if (iscan != 1) {
@@ -123,7 +158,7 @@ void parse_args(int argc, char *argv[])
 	    selfsnap = 1;
 	    break;
 	case 'a':		/* axis tolerance */
-	    iscan = sscanf(optarg, "%Lg %c", &axtol, &axunit);
+	    iscan = sscanf(optarg, "%" RL "g %c", &axtol, &axunit);
 	    if (iscan < 1) {
 		iscan = sscanf(optarg, " %c", &axunit);
 	    }
@@ -133,7 +168,7 @@ void parse_args(int argc, char *argv[])
 	    }
 	    break;
 	case 'b':		/* latitude tolerance */
-	    iscan = sscanf(optarg, "%Lg %c", &btol, &bunit);
+	    iscan = sscanf(optarg, "%" RL "g %c", &btol, &bunit);
 	    if (iscan < 1) {
 		iscan = sscanf(optarg, " %c", &bunit);
 	    }
@@ -143,7 +178,7 @@ void parse_args(int argc, char *argv[])
 	    }
 	    break;
 	case 't':		/* edge tolerance */
-	    iscan = sscanf(optarg, "%Lg %c", &thtol, &thunit);
+	    iscan = sscanf(optarg, "%" RL "g %c", &thtol, &thunit);
 	    if (iscan < 1) {
 		iscan = sscanf(optarg, " %c", &thunit);
 	    }
@@ -153,14 +188,14 @@ void parse_args(int argc, char *argv[])
 	    }
 	    break;
 	case 'y':		/* edge to length tolerance */
-	    iscan = sscanf(optarg, "%Lg", &ytol);
+	    iscan = sscanf(optarg, "%" RL "g", &ytol);
 	    if (iscan < 1) {
 		fprintf(stderr, "-%c%s: expecting real argument\n", opt, optarg);
 		exit(1);
 	    }
 	    break;
 	case 'm':		/* multiple intersection tolerance */
-	    iscan = sscanf(optarg, "%Lg %c", &mtol, &munit);
+	    iscan = sscanf(optarg, "%" RL "g %c", &mtol, &munit);
 	    if (iscan < 1) {
 		iscan = sscanf(optarg, " %c", &munit);
 	    }
@@ -170,7 +205,7 @@ void parse_args(int argc, char *argv[])
 	    }
 	    break;
 	case 'G':		/* growth angle */
-	    iscan = sscanf(optarg, "%Lg %c", &grow_angle, &gunit);
+	    iscan = sscanf(optarg, "%" RL "g %c", &grow_angle, &gunit);
 	    if (iscan < 1) {
 		iscan = sscanf(optarg, " %c", &gunit);
 	    }
@@ -181,9 +216,9 @@ void parse_args(int argc, char *argv[])
 	    break;
 
 	case 'j':		/* keep weights in interval [min, max] */
-	    iscan = sscanf(optarg, "%Lg %*[,] %Lg", &weight_min, &weight_max);
+	    iscan = sscanf(optarg, "%" RL "g %*[,] %" RL "g", &weight_min, &weight_max);
 	    if (iscan < 1) {
-		iscan = sscanf(optarg, " %*[,] %Lg", &weight_max);
+		iscan = sscanf(optarg, " %*[,] %" RL "g", &weight_max);
 		if (iscan < 1) {
 		    fprintf(stderr, "-%c%s: expecting -%c<min> or -%c<min>,<max> or -%c,<max>\n", opt, optarg, opt, opt, opt);
 		    exit(1);
@@ -197,9 +232,9 @@ void parse_args(int argc, char *argv[])
 	    }
 	    break;
 	case 'k':		/* keep areas in interval [min, max] */
-	    iscan = sscanf(optarg, "%Lg %*[,] %Lg", &area_min, &area_max);
+	    iscan = sscanf(optarg, "%" RL "g %*[,] %" RL "g", &area_min, &area_max);
 	    if (iscan < 1) {
-		iscan = sscanf(optarg, " %*[,] %Lg", &area_max);
+		iscan = sscanf(optarg, " %*[,] %" RL "g", &area_max);
 		if (iscan < 1) {
 		    fprintf(stderr, "-%c%s: expecting -%c<min> or -%c<min>,<max> or -%c,<max>\n", opt, optarg, opt, opt, opt);
 		    exit(1);
@@ -229,9 +264,9 @@ void parse_args(int argc, char *argv[])
 	    }
 	    break;
 	case 'K':		/* keep pixels in interval [min, max] */
-	    iscan = sscanf(optarg, "%d %*[,] %d", &pixel_min, &pixel_max);
+	    iscan = sscanf(optarg, "%lld %*[,] %lld", &pixel_min, &pixel_max);
 	    if (iscan < 1) {
-		iscan = sscanf(optarg, " %*[,] %d", &pixel_max);
+		iscan = sscanf(optarg, " %*[,] %lld", &pixel_max);
 		if (iscan < 1) {
 		    fprintf(stderr, "-%c%s: expecting -%c<min> or -%c<min>,<max> or -%c,<max>\n", opt, optarg, opt, opt, opt);
 		    exit(1);
@@ -330,6 +365,19 @@ void parse_args(int argc, char *argv[])
 		exit(1);
 	    }
 	    break;
+	case 'I':		/* format of input az, el data */
+	case 'O':		/* format of output az, el data */
+	    iscan = sscanf(optarg, " %c", &in);
+	    if (iscan != 1 || !strchr(AZELFMTS, in)) {
+		fprintf(stderr, "-%c%s: format of az, el data must be one of %s (t text, b binary, f FITS)\n", opt, optarg, AZELFMTS);
+		exit(1);
+	    }
+	    if (opt == 'I') {
+		fmt.inazel = in;
+	    } else {
+		fmt.outazel = in;
+	    }
+	    break;
 	case 'p':		/* phase of output azimuth, and number of digits after decimal place in output angles */
 	    iscan = sscanf(optarg, " %c", &in);
 	    switch (in) {
@@ -355,11 +403,11 @@ void parse_args(int argc, char *argv[])
 	  //if there is no scheme specified, look for polys_per_pixel and res_max
 	  if(strchr("0123456789,",scheme)){
 	    scheme=SCHEME;
-	    iscan = sscanf(optarg, "%d %*[,] %d", &polys_per_pixel, &res_max);
+	    iscan = sscanf(optarg, "%d %*[,] %d %*[,] %d", &polys_per_pixel, &res_max, &caps_per_pixel);
 	    if (iscan < 1) {
-	      iscan = sscanf(optarg, " %*[,] %d", &res_max);
+	      iscan = sscanf(optarg, " %*[,] %d %*[,] %d", &res_max, &caps_per_pixel);
 	      if (iscan < 1) {
-		fprintf(stderr, "-%c%s: expecting -%c<polys_per_pixel> or -%c<polys_per_pixel>,<res_max> or -%c,<res_max>\n", opt, optarg, opt, opt, opt);
+		fprintf(stderr, "-%c%s: expecting -%c<polys_per_pixel> or -%c<polys_per_pixel>,<res_max>[,<caps_per_pixel>] or -%c,<res_max>[,<caps_per_pixel>]\n", opt, optarg, opt, opt, opt);
 		exit(1);
 	      }
 	    }
@@ -373,16 +421,28 @@ void parse_args(int argc, char *argv[])
 	  else{
 	    optarg++;  
 	    if (*optarg) {
-	      iscan = sscanf(optarg, "%d %*[,] %d", &polys_per_pixel, &res_max);
+	      iscan = sscanf(optarg, "%d %*[,] %d %*[,] %d", &polys_per_pixel, &res_max, &caps_per_pixel);
 	      if (iscan < 1) {
-		iscan = sscanf(optarg, " %*[,] %d", &res_max);
+		iscan = sscanf(optarg, " %*[,] %d %*[,] %d", &res_max, &caps_per_pixel);
 		if (iscan < 1) {
-		  fprintf(stderr, "-%c%s: expecting -%c%c<polys_per_pixel> or -%c%c<polys_per_pixel>,<res_max> or -%c%c,<res_max>\n", opt, optarg, opt,scheme, opt,scheme, opt,scheme);
+		  fprintf(stderr, "-%c%s: expecting -%c%c<polys_per_pixel> or -%c%c<polys_per_pixel>,<res_max>[,<caps_per_pixel>] or -%c%c,<res_max>[,<caps_per_pixel>]\n", opt, optarg, opt,scheme, opt,scheme, opt,scheme);
 		  exit(1);
 		}
 	      }
 	    } 
 	  }
+	  if (res_max < 0 || res_max > RES_LIMIT) {
+	    fprintf(stderr, "-%c: maximum resolution %d must be between 0 and %d\n", opt, res_max, RES_LIMIT);
+	    exit(1);
+	  }
+	  if (scheme == 'h' && res_max > HEALPIX_RES_LIMIT) {
+	    fprintf(stderr, "-%c: maximum resolution %d of HEALPix-like scheme h must be at most %d\n", opt, res_max, HEALPIX_RES_LIMIT);
+	    exit(1);
+	  }
+	  if (caps_per_pixel < 0) {
+	    fprintf(stderr, "-%c: number of caps per pixel %d must be >= 0\n", opt, caps_per_pixel);
+	    exit(1);
+	  }
 	  break;
 	case 'U':  //unify across pixels to unpixelize a mask
 	  unpixelize=1;
@@ -390,9 +450,23 @@ void parse_args(int argc, char *argv[])
 	case 'W':  //print out weights rather than id numbers in polyid
 	  polyid_weight=1;
 	  break;	  
+	case 'F':  //flush output after every line, for interactive use
+	  flush_lines=1;
+	  break;	  
 	case 'T':  //use rasterize to slice mask polygons rather than returning the average-weighted rasterizer polygons
 	  sliceordice=1;
 	  break;	  
+	case 'N':  //HEALPix nside of rasterizer polygons that rasterize generates itself, or of harmonize map
+	  iscan = sscanf(optarg, "%d", &healpix_nside);
+	  if (iscan != 1) {
+	    fprintf(stderr, "-%c%s: expecting integer HEALPix nside\n", opt, optarg);
+	    exit(1);
+	  }
+	  if (healpix_nside < 1 || healpix_nside > (1 << (HEALPIX_RES_LIMIT - 1)) || (healpix_nside & (healpix_nside - 1))) {
+	    fprintf(stderr, "-%c: HEALPix nside %d must be a power of 2 between 1 and %d\n", opt, healpix_nside, 1 << (HEALPIX_RES_LIMIT - 1));
+	    exit(1);
+	  }
+	  break;	  
 	case 'i':		/* format of input files */
 	    sscanf(optarg, " %c", &in);
 	    switch (in) {
@@ -0,0 +1,14 @@
+/*------------------------------------------------------------------------------
+  Sparse directory of the pixels occupied by a polygon array sorted by pixel.
+------------------------------------------------------------------------------*/
+#ifndef PIXELDIR_H
+#define PIXELDIR_H
+
+typedef struct {		/* directory of pixels */
+  int npix;			/* number of distinct pixels */
+  long long *pixel;		/* pointer to array pixel[npix] of pixel numbers, increasing */
+  int *start;			/* pointer to array start[npix] of index of first polygon in pixel */
+  int *total;			/* pointer to array total[npix] of number of polygons in pixel */
+} pixeldir;
+
+#endif	/* PIXELDIR_H */
@@ -19,11 +19,11 @@ polygon *polys_global[NPOLYSMAX];
 void	usage(void);
 #ifdef	GCC
 int	pixelize(int npoly, polygon *[npoly], int npolys, polygon *[npolys]);
-int	pixel_loop(int pix, int n, polygon *[n], int out_max, polygon *[out_max]);
+int	pixel_loop(long long pix, int n, polygon *[n], int out_max, polygon *[out_max]);
 
 #else
 int	pixelize(int npoly, polygon *[/*npoly*/], int npolys, polygon *[/*npolys*/]);
-int	pixel_loop(int pix, int n, polygon *[/*n*/], int out_max, polygon *[/*out_max*/]);
+int	pixel_loop(long long pix, int n, polygon *[/*n*/], int out_max, polygon *[/*out_max*/]);
 
 #endif
 
@@ -80,13 +80,14 @@ int main(int argc, char *argv[])
   if (mtol != 0.) {
     scale(&mtol, munit, 's');
     munit = 's';
-    msg("multiple intersections closer than %Lg%c will be treated as coincident\n", mtol, munit);
+    msg("multiple intersections closer than %" RL "g%c will be treated as coincident\n", mtol, munit);
     scale(&mtol, munit, 'r');
     munit = 'r';
   }
   
   msg("pixelization scheme %c, maximum resolution %d\n", scheme, res_max);
   msg("maximum number of polygons allowed in each pixel: %d\n", polys_per_pixel);
+  if (caps_per_pixel > 0) msg("maximum number of caps allowed in each pixel: %d\n", caps_per_pixel);
   scheme_temp=scheme;
   res_max_temp=res_max;
   
@@ -142,7 +143,7 @@ void usage(void)
 {
   printf("usage:\n");
   //  printf("pixelize [-d] [-q] [-a<a>[u]] [-b<a>[u]] [-t<a>[u]] [-y<r>] [-m<a>[u]] [-s<n>] [-e<n>] [-vo|-vn|-vp] [-p[+|-][<n>]] [-P[scheme][<r>][,<p>]] [-i<f>[<n>][u]] [-o<f>[u]] polygon_infile1 [polygon_infile2 ...] polygon_outfile\n");
- printf("pixelize [-d] [-q] [-m<a>[u]] [-s<n>] [-e<n>] [-vo|-vn|-vp] [-p[+|-][<n>]] [-P[scheme][<p>][,<r>]] [-i<f>[<n>][u]] [-o<f>[u]] polygon_infile1 [polygon_infile2 ...] polygon_outfile\n");
+ printf("pixelize [-d] [-q] [-m<a>[u]] [-s<n>] [-e<n>] [-vo|-vn|-vp] [-p[+|-][<n>]] [-P[scheme][<p>][,<r>][,<c>]] [-i<f>[<n>][u]] [-o<f>[u]] polygon_infile1 [polygon_infile2 ...] polygon_outfile\n");
 #include "usage.h"
 }
 
@@ -398,7 +399,9 @@ int pixelize(int npoly, polygon *poly[/*npoly*/], int npolys, polygon *polys[/*n
 /*
   Function pixel_loop takes a list of all of the polygons in the input pixel and then splits 
   them into the four child pixels of the input pixel.  It then recursively calls itself on
-  each of the child pixels, until the desired level of pixelization is reached.
+  each of the child pixels, until the desired level of pixelization is reached:
+  a child pixel is refined only while it holds more than polys_per_pixel polygons,
+  or (if caps_per_pixel > 0) while its polygons have more than caps_per_pixel caps in total.
   Inputs: 
   pix: input pixel number
   n = number of polygons.
@@ -410,9 +413,9 @@ int pixelize(int npoly, polygon *poly[/*npoly*/], int npolys, polygon *polys[/*n
   or -1 if error occurred.
 */
 
-int pixel_loop(int pix, int n, polygon *input[/*n*/], int out_max, polygon *output[/*out_max*/]){
-  int *child_pix,children;
-  int i,j,k,m,out,nout;
+int pixel_loop(long long pix, int n, polygon *input[/*n*/], int out_max, polygon *output[/*out_max*/]){
+  long long *child_pix, ncaps;
+  int i,j,k,m,out,nout,children;
   int ier, iprune, np;
   polygon *pixel;
   polygon **poly;
@@ -426,18 +429,26 @@ int pixel_loop(int pix, int n, polygon *input[/*n*/], int out_max, polygon *outp
   
   // allocate memory for child_pix array
   if(pix==0 && scheme=='d'){
-    child_pix=(int *) malloc(sizeof(int) * 117);
+    child_pix=(long long *) malloc(sizeof(long long) * 117);
     children=117;
     if(!child_pix){
-      fprintf(stderr, "pixel_loop: failed to allocate memory for 117 integers\n");
+      fprintf(stderr, "pixel_loop: failed to allocate memory for 117 long longs\n");
+      return(-1);
+    }
+  }
+  else if(pix==0 && scheme=='h'){
+    child_pix=(long long *) malloc(sizeof(long long) * 12);
+    children=12;
+    if(!child_pix){
+      fprintf(stderr, "pixel_loop: failed to allocate memory for 12 long longs\n");
       return(-1);
     }
   }
   else{
-    child_pix=(int *) malloc(sizeof(int) * 4);
+    child_pix=(long long *) malloc(sizeof(long long) * 4);
     children=4;
     if(!child_pix){
-      fprintf(stderr, "pixel_loop: failed to allocate memory for %d integers\n", 4);
+      fprintf(stderr, "pixel_loop: failed to allocate memory for %d long longs\n", 4);
       return(-1);
     }
   }
@@ -446,11 +457,11 @@ int pixel_loop(int pix, int n, polygon *input[/*n*/], int out_max, polygon *outp
   out=0;
   
   for(i=0;i<children;i++){    
-    /*get the current child pixel*/
-    pixel=get_pixel(child_pix[i], scheme);
+    /*get the current child pixel; it belongs to the pixel cache, and is not used after the recursion below*/
+    pixel=pixel_poly(child_pix[i], scheme);
  
     if(!pixel){
-      fprintf(stderr, "error in pixel_loop: could not get pixel %d\n", child_pix[i]); 
+      fprintf(stderr, "error in pixel_loop: could not get pixel %lld\n", child_pix[i]); 
       return(-1);
     }
     
@@ -474,7 +485,7 @@ int pixel_loop(int pix, int n, polygon *input[/*n*/], int out_max, polygon *outp
     
       iprune = prune_poly(poly[j], mtol);
       if (iprune == -1) {
-	fprintf(stderr, "pixelize: failed to prune polygon for pixel %d; continuing ...\n", poly[j]->pixel);
+	fprintf(stderr, "pixelize: failed to prune polygon for pixel %lld; continuing ...\n", poly[j]->pixel);
 	//return(-1);
       }
       /*if polygon is null, get rid of it*/
@@ -497,8 +508,14 @@ int pixel_loop(int pix, int n, polygon *input[/*n*/], int out_max, polygon *outp
       poly[j]=0x0;
     }
     
+    /*total number of caps in the current child pixel*/
+    ncaps=0;
+    if(caps_per_pixel>0){
+      for(k=0;k<m;k++) ncaps+=poly[k]->np;
+    }
+
     /*if we're below the max resolution, recursively call pixel_loop on the current child pixel */ 
-    if(m>polys_per_pixel && get_res(child_pix[i],scheme)<res_max){
+    if((m>polys_per_pixel || (caps_per_pixel>0 && ncaps>caps_per_pixel)) && get_res(child_pix[i],scheme)<res_max){
       //printf("calling pixel loop for pixel %d with %d polygons\n",child_pix[i],m);
       nout=pixel_loop(child_pix[i],m,poly,out_max-out,&output[out]);
       if(nout==-1) return(-1);
@@ -526,7 +543,6 @@ int pixel_loop(int pix, int n, polygon *input[/*n*/], int out_max, polygon *outp
     }
     /*free up memory for next child pixel*/
     
-    free_poly(pixel);
     for(j=0;j<n;j++){
       free_poly(poly[j]);
     }
@@ -14,8 +14,16 @@ const char *optstr = "dqm:s:e:v:p:P:i:o:";
 /* allocate polygons as a global array */
 polygon *polys_global[NPOLYSMAX];
 
+/* pixel of the map, and pixel of the mask within it */
+typedef struct {
+  long long k;			/* pixel of the map */
+  int p;			/* index of pixel of the mask in pixel directory */
+  real_t weight;		/* weight times area of polygons in the map pixel */
+} map_pixel;
+
 /* local functions */
 void	usage(void);
+int	map_pixel_cmp(const void *, const void *);
 #ifdef	GCC
 int	pixelmap(int *npoly, polygon *[*npoly]);
 #else
@@ -58,7 +66,7 @@ int main(int argc, char *argv[])
     if (mtol != 0.) {
 	scale(&mtol, munit, 's');
 	munit = 's';
-	msg("multiple intersections closer than %Lg%c will be treated as coincident\n", mtol, munit);
+	msg("multiple intersections closer than %" RL "g%c will be treated as coincident\n", mtol, munit);
 	scale(&mtol, munit, 'r');
 	munit = 'r';
     }
@@ -124,6 +132,17 @@ void usage(void)
 */
 #include "parse_args.c"
 
+/*------------------------------------------------------------------------------
+  Order pixels of the mask by pixel of the map, then by pixel of the mask.
+*/
+int map_pixel_cmp(const void *mp1, const void *mp2)
+{
+  const map_pixel *m1 = (const map_pixel *)mp1, *m2 = (const map_pixel *)mp2;
+
+  if (m1->k != m2->k) return((m1->k > m2->k)? 1 : -1);
+  return((m1->p > m2->p)? 1 : (m1->p < m2->p)? -1 : 0);
+}
+
 /*------------------------------------------------------------------------------
   Take pixelized polygons, find the average weight within each pixel, and return a set of polygons consisting of the pixels weighted with the average weight.
 
@@ -135,20 +154,17 @@ void usage(void)
 */
 int pixelmap(int *npoly, polygon *poly[/**npoly*/])
 {
-  int i, j, nadj, k, kstart,kend,numpix;
-  int *start;
-  int *total;
-  int *parent_pixels;
-  int begin, end, p,max_pixel,min_pixel, ier, verb,res1,res2;
-  long double tol,area, tot_area;
-  long double *av_weight;
-  long double *av_weight0;
+  int i, j, nadj, numpix, p, q;
+  long long k;
+  long long *parent_pixels;
+  int begin, end, ier, verb,res1,res2;
+  pixeldir dir;
+  map_pixel *mp;
+  real_t tol,area, tot_area;
 
   poly_sort(*npoly,poly,'p');
-  min_pixel = poly[0]->pixel; 
-  max_pixel = poly[*npoly-1]->pixel+1; 
-  res1=get_res(min_pixel,scheme);
-  res2=get_res(max_pixel,scheme);
+  res1=get_res(poly[0]->pixel,scheme);
+  res2=get_res(poly[*npoly-1]->pixel,scheme);
 
   if(res1<res_max){
     fprintf(stderr,"pixelmap: there are pixels in the mask with a lower resolution than the desired pixelmap resolution %d.  The desired pixelmap resolution can be set with the -P option.\n",res_max);
@@ -156,70 +172,49 @@ int pixelmap(int *npoly, polygon *poly[/**npoly*/])
     return(-1);
   }
 
- 
-  /* allocate memory for pixel info arrays start and total */ 
-  start = (int *) malloc(sizeof(int) * max_pixel);
-  if (!start) {
-    fprintf(stderr, "pixelmap: failed to allocate memory for %d integers\n", max_pixel);
-    return(-1);
-  }
-  total = (int *) malloc(sizeof(int) * max_pixel);
-  if (!total) {
-    fprintf(stderr, "pixelmap: failed to allocate memory for %d integers\n", max_pixel);
-    return(-1);
-  }
-
-  /* build lists of starting indices of each pixel and total number of polygons in each pixel*/
-  ier=pixel_list(*npoly, poly, max_pixel, start, total);
+  /* build directory of starting indices of each pixel and total number of polygons in each pixel*/
+  ier=pixel_dir(*npoly, poly, &dir);
   if (ier == -1) {
     fprintf(stderr, "pixelmap: error building pixel index lists\n");
     return(-1);
   } 
 
   //allocate memory for parent pixels array
-  parent_pixels = (int *) malloc(sizeof(int) * (res2+1));
+  parent_pixels = (long long *) malloc(sizeof(long long) * (res2+1));
   if (!parent_pixels) {
-    fprintf(stderr, "pixelmap: failed to allocate memory for %d integers\n", res2+1);
+    fprintf(stderr, "pixelmap: failed to allocate memory for %d long longs\n", res2+1);
     return(-1);
   }
 
-  //kstart=number of first pixel at desired output resolution
-  //kend=number of last pixel at desired output resolution
-  if(res_max==-1){
-    kstart=pixel_start(res1,scheme);
-    kend=pixel_start(res2+1,scheme)-1;
-  }
-  else{
-    kstart=pixel_start(res_max,scheme);
-    kend=pixel_start(res_max+1,scheme)-1;
-  }
-  av_weight0= (long double *) malloc(sizeof(long double) * (kend-kstart+1) );
-  if (!av_weight0) {
-    fprintf(stderr, "pixelmap: failed to allocate memory for %d integers\n", kend-kstart+1 );
+  //one entry for each pixel of the mask, rather than for each pixel of the map,
+  //so memory goes as the number of pixels the mask occupies
+  mp = (map_pixel *) malloc(sizeof(map_pixel) * (dir.npix+1));
+  if (!mp) {
+    fprintf(stderr, "pixelmap: failed to allocate memory for %d pixels\n", dir.npix);
     return(-1);
   }
-  //make av_weight an array indexed by the pixel number 
-  av_weight=av_weight0-kstart;
 
-  //set av_weight array to 0 initially
-  for(k=kstart;k<=kend;k++){
-    av_weight[k]=0;
+  //set k to the pixel at the desired output resolution, or to the pixel number if using
+  //existing resolution
+  for(p=0;p<dir.npix;p++){
+    ier=get_parent_pixels(dir.pixel[p],parent_pixels,scheme);
+    if(ier) return(-1);
+    mp[p].k=(res_max==-1) ? dir.pixel[p] : parent_pixels[res_max];
+    mp[p].p=p;
+    mp[p].weight=0.;
   }
 
+  //bring together the pixels of the mask in each pixel of the map, in order of pixel number
+  mysort(mp, dir.npix, sizeof(map_pixel), map_pixel_cmp);
+
   nadj = 0;
   verb=1;
    
-  /*find average weight of polygons within each pixel*/
-  for(p=min_pixel;p<max_pixel;p++){
-    begin=start[p];
-    end=start[p]+total[p];
-    ier=get_parent_pixels(p,parent_pixels,scheme);
-    if(ier) return(-1);
-    
-    //set k to the pixel at the desired output resolution, or to the pixel number if using
-    //existing resolution
-
-    k=(res_max==-1) ? p : parent_pixels[res_max];
+  /*find average weight of polygons within each pixel, accumulated in the first entry for the pixel*/
+  for(q=0;q<dir.npix;q++){
+    if(q==0 || mp[q].k!=mp[q-1].k) j=q;
+    begin=dir.start[mp[q].p];
+    end=begin+dir.total[mp[q].p];
     
     for (i = begin; i < end; i++) {
       if (!poly[i]) continue;
@@ -230,23 +225,25 @@ int pixelmap(int *npoly, polygon *poly[/**npoly*/])
 	continue;
       }
       
-      av_weight[k]+=poly[i]->weight * area;
+      mp[j].weight+=poly[i]->weight * area;
     }
   }
   
   //replace polygons in input array with non-zero weight pixels
   j=0;
-  for(k=kstart;k<=kend;k++){
-    if(av_weight[k]==0) continue;
+  for(q=0;q<dir.npix;q++){
+    if(q>0 && mp[q].k==mp[q-1].k) continue;
+    if(mp[q].weight==0) continue;
+    k=mp[q].k;
     free_poly(poly[j]);
     poly[j]=get_pixel(k,scheme);
     tol=mtol;
     ier = garea(poly[j], &tol, verb, &tot_area);
     if(ier==1 || ier == -1){
-      fprintf(stderr, "pixelmap: error in garea in pixel %d\n",p);
+      fprintf(stderr, "pixelmap: error in garea in pixel %lld\n",k);
       continue;
     }
-    poly[j]->weight=av_weight[k]/tot_area;
+    poly[j]->weight=mp[q].weight/tot_area;
     j++;
     if(j> *npoly ){
       fprintf(stderr,"pixelmap: number of pixels with non-zero weight exceeds number of polygons.\n");
@@ -264,10 +261,9 @@ int pixelmap(int *npoly, polygon *poly[/**npoly*/])
 
   *npoly=numpix;
 
-  free(start);
-  free(total);
+  free_pixel_dir(&dir);
   free(parent_pixels);
-  free(av_weight0);
+  free(mp);
   
   /* assign new polygon id numbers */
   if (fmt.newid == 'n') {
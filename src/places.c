@@ -7,7 +7,7 @@
 /*------------------------------------------------------------------------------
   Round x to n decimal places.
 */
-long double places(long double x, int n)
+real_t places(real_t x, int n)
 {
     int i;
 
@@ -18,9 +18,9 @@ polygon *polys_global[NPOLYSMAX];
 /* local functions */
 void	usage(void);
 #ifdef	GCC
-int	intersect_poly(int npoly1, polygon *[npoly1], int npoly2, polygon *[npoly2], long double);
+int	intersect_poly(int npoly1, polygon *[npoly1], int npoly2, polygon *[npoly2], real_t);
 #else
-int	intersect_poly(int npoly1, polygon *[/*npoly1*/], int npoly2, polygon *[/*npoly2*/], long double);
+int	intersect_poly(int npoly1, polygon *[/*npoly1*/], int npoly2, polygon *[/*npoly2*/], real_t);
 #endif
 
 /*------------------------------------------------------------------------------
@@ -55,7 +55,7 @@ int main(int argc, char *argv[])
     if (mtol != 0.) {
 	scale (&mtol, munit, 's');
 	munit = 's';
-	msg("multiple intersections closer than %Lg%c will be treated as coincident\n", mtol, munit);
+	msg("multiple intersections closer than %" RL "g%c will be treated as coincident\n", mtol, munit);
 	scale (&mtol, munit, 'r');
 	munit = 'r';
     }
@@ -64,31 +64,31 @@ int main(int argc, char *argv[])
     if (is_weight_min && is_weight_max) {
 	/* min <= max */
 	if (weight_min <= weight_max) {
-	    msg("will keep only polygons with weights inside [%Lg, %Lg]\n", weight_min, weight_max);
+	    msg("will keep only polygons with weights inside [%" RL "g, %" RL "g]\n", weight_min, weight_max);
 	/* min > max */
 	} else {
-	    msg("will keep only polygons with weights >= %Lg or <= %Lg\n", weight_min, weight_max);
-	    msg("         (only polygons with weights outside (%Lg, %Lg))\n", weight_max, weight_min);
+	    msg("will keep only polygons with weights >= %" RL "g or <= %" RL "g\n", weight_min, weight_max);
+	    msg("         (only polygons with weights outside (%" RL "g, %" RL "g))\n", weight_max, weight_min);
 	}
     } else if (is_weight_min) {
-	msg("will keep only polygons with weights >= %Lg\n", weight_min);
+	msg("will keep only polygons with weights >= %" RL "g\n", weight_min);
     } else if (is_weight_max) {
-	msg("will keep only polygons with weights <= %Lg\n", weight_max);
+	msg("will keep only polygons with weights <= %" RL "g\n", weight_max);
     }
     /* area limits */
     if (is_area_min && is_area_max) {
 	/* min <= max */
 	if (area_min < area_max) {
-	    msg("will keep only polygons with areas inside [%Lg, %Lg]\n", area_min, area_max);
+	    msg("will keep only polygons with areas inside [%" RL "g, %" RL "g]\n", area_min, area_max);
 	/* min > max */
 	} else {
-	    msg("will keep only polygons with areas >= %Lg or <= %Lg\n", area_min, area_max);
-	    msg("         (only polygons with areas outside (%Lg, %Lg))\n", area_max, area_min);
+	    msg("will keep only polygons with areas >= %" RL "g or <= %" RL "g\n", area_min, area_max);
+	    msg("         (only polygons with areas outside (%" RL "g, %" RL "g))\n", area_max, area_min);
 	}
     } else if (is_area_min) {
-	msg("will keep only polygons with areas >= %Lg\n", area_min);
+	msg("will keep only polygons with areas >= %" RL "g\n", area_min);
     } else if (is_area_max) {
-	msg("will keep only polygons with areas <= %Lg\n", area_max);
+	msg("will keep only polygons with areas <= %" RL "g\n", area_max);
     }
     /* id limits */
     if (is_id_min && is_id_max) {
@@ -109,16 +109,16 @@ int main(int argc, char *argv[])
     if (is_pixel_min && is_pixel_max) {
 	/* min <= max */
 	if (pixel_min < pixel_max) {
-	    msg("will keep only polygons with pixel numbers inside [%d, %d]\n", pixel_min, pixel_max);
+	    msg("will keep only polygons with pixel numbers inside [%lld, %lld]\n", pixel_min, pixel_max);
 	/* min > max */
 	} else {
-	    msg("will keep only polygons with pixel numbers >= %d or <= %d\n", pixel_min, pixel_max);
-	    msg("         (only polygons with pixel numbers outside (%d, %d))\n", pixel_max, pixel_min);
+	    msg("will keep only polygons with pixel numbers >= %lld or <= %lld\n", pixel_min, pixel_max);
+	    msg("         (only polygons with pixel numbers outside (%lld, %lld))\n", pixel_max, pixel_min);
 	}
     } else if (is_pixel_min) {
-	msg("will keep only polygons with pixel numbers >= %d\n", pixel_min);
+	msg("will keep only polygons with pixel numbers >= %lld\n", pixel_min);
     } else if (is_pixel_max) {
-	msg("will keep only polygons with pixel numbers <= %d\n", pixel_max);
+	msg("will keep only polygons with pixel numbers <= %lld\n", pixel_max);
     }
 
     /* advise data format */
@@ -185,29 +185,108 @@ void usage(void)
 */
 #include "parse_args.c"
 
+/* (id, pixel) key of a polygon of poly2, with its index */
+typedef struct {
+  long long id;
+  long long pixel;
+  int j;
+} idkey;
+
+/*------------------------------------------------------------------------------
+  Order keys by id, then pixel, then original index,
+  so that matching poly2 polygons are applied in their original order.
+*/
+static int idkey_cmp(const void *v1, const void *v2)
+{
+    const idkey *k1 = (const idkey *)v1, *k2 = (const idkey *)v2;
+
+    if (k1->id < k2->id) return(-1);
+    if (k1->id > k2->id) return(1);
+    if (k1->pixel < k2->pixel) return(-1);
+    if (k1->pixel > k2->pixel) return(1);
+    return(k1->j - k2->j);
+}
+
 /*------------------------------------------------------------------------------
   Intersect polygons of poly1 with any polygon(s) of poly2 having the
   same id number.
 
   This subroutine implements the -n option of poly2poly.
+
+  The poly2 polygons are sorted on (id, pixel), and each poly1 polygon
+  finds its matches by binary search, so the cost is O((npoly1 + npoly2) log npoly2)
+  rather than O(npoly1 npoly2).  The poly1 polygons are independent,
+  so are intersected and pruned in parallel.
 */
-int intersect_poly(int npoly1, polygon *poly1[/*npoly1*/], int npoly2, polygon *poly2[/*npoly2*/], long double mtol)
+int intersect_poly(int npoly1, polygon *poly1[/*npoly1*/], int npoly2, polygon *poly2[/*npoly2*/], real_t mtol)
 {
-    int ier, inull, iprune, i, j, k, np;
+    int ier, inull, i, j, k, np;
+    int *iprune;
+    idkey *key;
 
-    /* intersect each poly1 with any poly2 having same id number */
+    /* sort poly2 on (id, pixel) */
+    key = (idkey *) malloc(sizeof(idkey) * (npoly2 > 0 ? npoly2 : 1));
+    if (!key) {
+	fprintf(stderr, "intersect_poly: failed to allocate memory for %d keys\n", npoly2);
+	return(-1);
+    }
+    iprune = (int *) malloc(sizeof(int) * (npoly1 > 0 ? npoly1 : 1));
+    if (!iprune) {
+	fprintf(stderr, "intersect_poly: failed to allocate memory for %d integers\n", npoly1);
+	free(key);
+	return(-1);
+    }
+    for (j = 0; j < npoly2; j++) {
+	key[j].id = poly2[j]->id;
+	key[j].pixel = poly2[j]->pixel;
+	key[j].j = j;
+    }
+    qsort(key, npoly2, sizeof(idkey), idkey_cmp);
+
+    /* intersect each poly1 with any poly2 having same id number, and prune */
+    ier = 0;
+#ifdef	_OPENMP
+#pragma omp parallel for schedule(dynamic, 64) private(j, k, np)
+#endif
     for (i = 0; i < npoly1; i++) {
-	for (j = 0; j < npoly2; j++) {
-	    if (poly1[i]->id == poly2[j]->id && poly1[i]->pixel == poly2[j]->pixel ) {
-		/* make sure poly1 contains enough space for intersection */
-		np = poly1[i]->np + poly2[j]->np;
-		ier = room_poly(&poly1[i], np, 0, 1);
-		if (ier == -1) goto out_of_memory;
-
-		/* intersection of poly1 and poly2 */
-		poly_poly(poly1[i], poly2[j], poly1[i]);
+	int lo, hi, mid;
+
+	/* first key >= (id, pixel) of poly1[i] */
+	lo = 0;
+	hi = npoly2;
+	while (lo < hi) {
+	    mid = (lo + hi) / 2;
+	    if (key[mid].id < poly1[i]->id
+		|| (key[mid].id == poly1[i]->id && key[mid].pixel < poly1[i]->pixel)) {
+		lo = mid + 1;
+	    } else {
+		hi = mid;
 	    }
 	}
+
+	for (k = lo; k < npoly2 && key[k].id == poly1[i]->id && key[k].pixel == poly1[i]->pixel; k++) {
+	    j = key[k].j;
+	    /* make sure poly1 contains enough space for intersection */
+	    np = poly1[i]->np + poly2[j]->np;
+	    if (room_poly(&poly1[i], np, 0, 1) == -1) {
+		fprintf(stderr, "intersect_poly: failed to allocate memory for polygon of %d caps\n", np);
+#ifdef	_OPENMP
+#pragma omp atomic write
+#endif
+		ier = -1;
+		break;
+	    }
+
+	    /* intersection of poly1 and poly2 */
+	    poly_poly(poly1[i], poly2[j], poly1[i]);
+	}
+
+	iprune[i] = prune_poly(poly1[i], mtol);
+    }
+    free(key);
+    if (ier == -1) {
+	free(iprune);
+	return(-1);
     }
 
     /* free poly2 polygons */
@@ -220,11 +299,10 @@ int intersect_poly(int npoly1, polygon *poly1[/*npoly1*/], int npoly2, polygon *
     j = 0;
     inull = 0;
     for (i = 0; i < npoly1; i++) {
-          iprune = prune_poly(poly1[i], mtol);
-        if (iprune == -1) {
+        if (iprune[i] == -1) {
 	  fprintf(stderr, "intersect_poly: failed to prune polygon %lld; continuing ...\n", (fmt.newid == 'o')? poly1[i]->id : (long long)j+fmt.idstart);
 	}
-	if (iprune >= 2) {
+	if (iprune[i] >= 2) {
 	    free_poly(poly1[i]);
 	    poly1[i] = 0x0;
 	    inull++;
@@ -232,6 +310,7 @@ int intersect_poly(int npoly1, polygon *poly1[/*npoly1*/], int npoly2, polygon *
 	    j++;
 	}
    }
+    free(iprune);
 
    /*copy down non-null polygons*/
     k=0;
@@ -254,9 +333,4 @@ int intersect_poly(int npoly1, polygon *poly1[/*npoly1*/], int npoly2, polygon *
     npoly1 = j;
 
     return(npoly1);
-
-    /* ---------------- error returns ---------------- */
-    out_of_memory:
-    fprintf(stderr, "intersect_poly: failed to allocate memory for polygon of %d caps\n", np);
-    return(-1);
 }
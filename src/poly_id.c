@@ -16,16 +16,16 @@
 		 the required memory is allocated.
   Return value: number of polygons that contain az, el position.
 */
-int poly_id(int npoly, polygon *poly[/*npoly*/], long double az, long double el, long long **id_p, long double **weight_p)
+int poly_id(int npoly, polygon *poly[/*npoly*/], real_t az, real_t el, long long **id_p, real_t **weight_p)
 {
 /* number of extra polygon id numbers to allocate, to allow for expansion */
 #define DNID		16
-    static int nidmax = 0;
-    static long long *id = 0x0;
-    static long double *weight = 0x0;
+    static THREADLOCAL int nidmax = 0;
+    static THREADLOCAL long long *id = 0x0;
+    static THREADLOCAL real_t *weight = 0x0;
 
     int ipoly, nid;
-    long double rp[3];
+    real_t rp[3];
 
     /* unit vector corresponding to angular position az, el */
     rp[0] = cosl(el) * cosl(az);
@@ -41,7 +41,7 @@ int poly_id(int npoly, polygon *poly[/*npoly*/], long double az, long double el,
             if (id) free(id);
             if (weight) free(weight);
             id = (long long *) malloc(sizeof(long long) * (nid + DNID));
-	    weight = (long double *) malloc(sizeof(long double) * (nid + DNID));
+	    weight = (real_t *) malloc(sizeof(real_t) * (nid + DNID));
             if (!id) {
                 fprintf(stderr, "poly_id: failed to allocate memory for %d long longs\n", nid + DNID);
                 return(-1);
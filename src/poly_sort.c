@@ -7,8 +7,8 @@
 /*polygon comparison functions*/
 int poly_cmp_pixel(polygon **poly1, polygon **poly2)
 {
-  int pixel=(*poly1)->pixel - (*poly2)->pixel;
-  return(pixel);
+  long long pixel=(*poly1)->pixel - (*poly2)->pixel;
+  return((pixel>0)? 1 : (pixel<0)? -1 : 0);
 }
 int poly_cmp_id(polygon **poly1, polygon **poly2)
 {
@@ -26,7 +26,7 @@ int poly_cmp_id(polygon **poly1, polygon **poly2)
 int poly_cmp_weight(polygon **poly1, polygon **poly2)
 {
   int intweight;
-  long double weight=(*poly1)->weight - (*poly2)->weight;
+  real_t weight=(*poly1)->weight - (*poly2)->weight;
   if(weight>0){
     intweight=1;
   } else if(weight<0){
@@ -57,48 +57,120 @@ void poly_sort(int npoly, polygon *poly[],char key){
 
 }
 
-/* Function pixel_list generates arrays start[] and total[] from a polygon array which has been
-   sorted by pixel number.
+/* Function pixel_dir builds a sparse directory of the pixels occupied by a polygon array
+   which has been sorted by pixel number, so that memory goes as the number of occupied
+   pixels, not as the highest pixel number.
    inputs: 
    npoly: number of polygons in polys
    poly[]: array of pointers to polygons (must be sorted by pixel number)
-   max_pixel: highest allowed pixel number in the polygon array
    outputs:
-   start[k] contains the starting index for the polygons in pixel k
-   total[k] contains the total number of polygons in pixel k
+   dir->npix is the number of distinct pixels
+   dir->pixel[i] is the i'th distinct pixel number, in increasing order
+   dir->start[i] contains the starting index for the polygons in pixel dir->pixel[i]
+   dir->total[i] contains the total number of polygons in pixel dir->pixel[i]
    returns 0 if successful, -1 if there's an error
-
   */ 
-int pixel_list(int npoly, polygon *poly[], int max_pixel, int start[], int total[]){
-  int i,j,k,k_old;
+int pixel_dir(int npoly, polygon *poly[], pixeldir *dir){
+  int i,j;
+  long long k,k_old;
 
-  /* initialize output arrays */
+  dir->npix=0;
+  dir->pixel=0x0;
+  dir->start=0x0;
+  dir->total=0x0;
 
-  for(i=0;i<max_pixel;i++){
-    start[i]=0;
-    total[i]=0;
-  }
+  /* count distinct pixels */
   k_old=-1;
   for(j=0;j<npoly;j++){
     k=poly[j]->pixel;
     if(k<k_old){
-      fprintf(stderr, "Error in pixel_list: polygon array not sorted.  Please use poly_sort first.\n");
-      return(-1);
-    }
-    if(k>max_pixel){
-      fprintf(stderr, "Error in pixel_list: polygon %d is in pixel %d > max_pixel %d\n", j, k, max_pixel);
+      fprintf(stderr, "Error in pixel_dir: polygon array not sorted.  Please use poly_sort first.\n");
       return(-1);
     }
-    
-    if(k==k_old){
-      total[k]++;
-    }
-    else if(k>k_old){
-      start[k]=j;
-      total[k]++;
+    if(k>k_old) dir->npix++;
+    k_old=k;
+  }
+
+  dir->pixel=(long long *) malloc(sizeof(long long) * (dir->npix+1));
+  dir->start=(int *) malloc(sizeof(int) * (dir->npix+1));
+  dir->total=(int *) malloc(sizeof(int) * (dir->npix+1));
+  if(!dir->pixel || !dir->start || !dir->total){
+    fprintf(stderr, "pixel_dir: failed to allocate memory for %d pixels\n", dir->npix);
+    free_pixel_dir(dir);
+    return(-1);
+  }
+
+  i=-1;
+  k_old=-1;
+  for(j=0;j<npoly;j++){
+    k=poly[j]->pixel;
+    if(k>k_old){
+      i++;
+      dir->pixel[i]=k;
+      dir->start[i]=j;
+      dir->total[i]=0;
     }
+    dir->total[i]++;
     k_old=k;
   }
   return(0);
 }
 
+/* Function pixel_dir_all builds a pixel directory that puts all polygons in a single group,
+   pixel 0, for when the pixelization is to be ignored.
+   inputs: 
+   npoly: number of polygons
+   outputs:
+   dir: pixel directory with dir->npix=1
+   returns 0 if successful, -1 if there's an error
+  */ 
+int pixel_dir_all(int npoly, pixeldir *dir){
+  dir->npix=1;
+  dir->pixel=(long long *) malloc(sizeof(long long));
+  dir->start=(int *) malloc(sizeof(int));
+  dir->total=(int *) malloc(sizeof(int));
+  if(!dir->pixel || !dir->start || !dir->total){
+    fprintf(stderr, "pixel_dir_all: failed to allocate memory for 1 pixel\n");
+    free_pixel_dir(dir);
+    return(-1);
+  }
+  dir->pixel[0]=0;
+  dir->start[0]=0;
+  dir->total[0]=npoly;
+  return(0);
+}
+
+/* Function pixel_find looks up a pixel in a pixel directory.
+   inputs:
+   dir: pointer to pixel directory built by pixel_dir
+   pix: pixel number
+   returns the index i such that dir->pixel[i]=pix, or -1 if pixel pix holds no polygons
+*/
+int pixel_find(pixeldir *dir, long long pix){
+  int lo,hi,mid;
+
+  if(dir->npix==0 || pix<dir->pixel[0] || pix>dir->pixel[dir->npix-1]) return(-1);
+  /* binary search */
+  lo=0;
+  hi=dir->npix-1;
+  while(lo<hi){
+    mid=(lo+hi)/2;
+    if(dir->pixel[mid]<pix){
+      lo=mid+1;
+    } else {
+      hi=mid;
+    }
+  }
+  return((dir->pixel[lo]==pix)? lo : -1);
+}
+
+/* Function free_pixel_dir frees the arrays of a pixel directory. */
+void free_pixel_dir(pixeldir *dir){
+  free(dir->pixel);
+  free(dir->start);
+  free(dir->total);
+  dir->npix=0;
+  dir->pixel=0x0;
+  dir->start=0x0;
+  dir->total=0x0;
+}
@@ -4,16 +4,23 @@
 #ifndef POLYGON_H
 #define POLYGON_H
 
-typedef long double vec[3];
+#include "real.h"
+
+typedef real_t vec[3];
 
 typedef struct {		/* polygon structure */
   int np;			/* number of caps of polygon */
   int npmax;			/* dimension of allocated rp and cm arrays */
   vec *rp;			/* pointer to array rp[np][3] of axis coords */
-  long double *cm;			/* pointer to array cm[np] of 1 - cosl(theta) */
+  real_t *cm;			/* pointer to array cm[np] of 1 - cosl(theta) */
   long long id;			/* id number of polygon */
-  int pixel;                    /* pixel that polygon is in */
-  long double weight;		/* weight of polygon */
+  long long pixel;              /* pixel that polygon is in */
+  real_t weight;		/* weight of polygon */
+  real_t area;			/* area of polygon kept by poly_area */
+  real_t areatolin;		/* tolerance input to garea for area */
+  real_t areatol;		/* tolerance output by garea along with area */
+  int areaok;			/* 1 if area is valid for the caps, 0 if not;
+				   cleared wherever the caps change */
 } polygon;
 
 #endif	/* POLYGON_H */
@@ -6,12 +6,13 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include "azelfile.h"
 #include "inputfile.h"
 #include "manglefn.h"
 #include "defaults.h"
 
 /* getopt options */
-const char *optstr = "dqu:p:P:W";
+const char *optstr = "dqu:p:P:WFI:O:";
 
 /* allocate polygons as a global array */
 polygon *poly_global[NPOLYSMAX];
@@ -121,49 +122,28 @@ int poly_ids(char *in_filename, char *out_filename, format *fmt, int npoly, poly
 #define AZEL_STR_LEN	32
     char input[] = "input", output[] = "output";
     char *word, *next;
-    char az_str[AZEL_STR_LEN], el_str[AZEL_STR_LEN];
+    char az_str[AZEL_STR_LEN], el_str[AZEL_STR_LEN], w_str[AZEL_STR_LEN];
     int i, idwidth, ird, len, nid, nids, nid0, nid2, np;
-    long long idmin, idmax;
+    long long idmin, idmax, inid;
     long long *id;
-    long double *weight;
+    real_t *weight;
     azel v;
+    azelfile azelin, azelout;
     char *out_fn;
     FILE *outfile;
-    int *start;
-    int *total;
-    int *parent_pixels;
-    int p, res, max_pixel, ier, sorted;
+    pixeldir dir;
+    long long *parent_pixels;
+    long long p;
+    int q, res, ier, sorted;
 
     ier=-1;
     sorted=0;
     while(ier!=0){
-      max_pixel= poly[npoly-1]->pixel; 
-      res_max=get_res(max_pixel, scheme);
-      max_pixel=pixel_start(res_max+1,scheme);
+      /* build directory of starting indices of each pixel and total number of polygons in each pixel*/
       
-      /* allocate memory for pixel info arrays start and total */ 
-      msg("res_max=%d, max_pixel=%d\n",res_max,max_pixel);
-      start = (int *) malloc(sizeof(int) * max_pixel);
-      if (!start) {
-	fprintf(stderr, "polyid: failed to allocate memory for %d integers\n", max_pixel);
-	return(-1);
-      }
-      total = (int *) malloc(sizeof(int) * max_pixel);
-      if (!total) {
-	fprintf(stderr, "polyid: failed to allocate memory for %d integers\n", max_pixel);
-	return(-1);
-      }
-      parent_pixels = (int *) malloc(sizeof(int) * (res_max+1));
-      if (!parent_pixels) {
-	fprintf(stderr, "polyid: failed to allocate memory for %d integers\n", res_max+1);
-	return(-1);
-      }
-      
-      /* build lists of starting indices of each pixel and total number of polygons in each pixel*/
-      
-      ier=pixel_list(npoly, poly, max_pixel, start, total);
+      ier=pixel_dir(npoly, poly, &dir);
       if (ier == -1) {
-	// if pixel_list returns an error, try sorting the polygons and trying again
+	// if pixel_dir returns an error, try sorting the polygons and trying again
 	if(!sorted){
 	  msg("sorting polygons...\n");
 	  poly_sort(npoly,poly,'p');
@@ -175,6 +155,13 @@ int poly_ids(char *in_filename, char *out_filename, format *fmt, int npoly, poly
 	}
       } 
     }
+    res_max=get_res(dir.pixel[dir.npix-1], scheme);
+    msg("res_max=%d, %d pixels occupied\n",res_max,dir.npix);
+    parent_pixels = (long long *) malloc(sizeof(long long) * (res_max+1));
+    if (!parent_pixels) {
+      fprintf(stderr, "polyid: failed to allocate memory for %d long longs\n", res_max+1);
+      return(-1);
+    }
     
     /* open in_filename for reading */
     if (!in_filename || strcmp(in_filename, "-") == 0) {
@@ -190,6 +177,17 @@ int poly_ids(char *in_filename, char *out_filename, format *fmt, int npoly, poly
     }
     file.line_number = 0;
 
+    /* binary input: the header gives the angular units */
+    if (fmt->inazel != 't') {
+	azelin.name = file.name;
+	azelin.file = file.file;
+	azelin.fmt = fmt->inazel;
+	azelin.unit = fmt->inunit;
+	ird = rdazel_head(&azelin);
+	if (ird == -1) return(-1);
+	if (ird == 1) fmt->inunit = azelin.unit;
+    }
+
     /* open out_filename for writing */
     if (!out_filename || strcmp(out_filename, "-") == 0) {
 	outfile = stdout;
@@ -200,6 +198,7 @@ int poly_ids(char *in_filename, char *out_filename, format *fmt, int npoly, poly
 	    fprintf(stderr, "cannot open %s for writing\n", out_filename);
 	    return(-1);
 	}
+	wrbuf(outfile);
 	out_fn = out_filename;
     }
 
@@ -225,31 +224,42 @@ int poly_ids(char *in_filename, char *out_filename, format *fmt, int npoly, poly
 	if (poly[i]->id < idmin) idmin = poly[i]->id;
 	if (poly[i]->id > idmax) idmax = poly[i]->id;
     }
-    idmin = ((idmin < 0)? floorl(log10l((long double)-idmin)) + 2 : 1);
-    idmax = ((idmax > 0)? floorl(log10l((long double)idmax)) + 1 : 1);
+    idmin = ((idmin < 0)? floorl(log10l((real_t)-idmin)) + 2 : 1);
+    idmax = ((idmax > 0)? floorl(log10l((real_t)idmax)) + 1 : 1);
     idwidth = ((idmin > idmax)? idmin : idmax);
 
     /* write header */
-    v.az = 0.;
-    wrangle(v.az, fmt->outunit, fmt->outprecision, AZEL_STR_LEN, az_str);
-    len = strlen(az_str);
-    if (fmt->outunit == 'h') {
-	sprintf(az_str, "az(hms)");
-	sprintf(el_str, "el(dms)");
+    if (fmt->outazel != 't') {
+	azelout.name = out_fn;
+	azelout.file = outfile;
+	azelout.fmt = fmt->outazel;
+	/* the id of the point, to join the records back to the input,
+	   then the weight or id of the polygon */
+	azelout.columns = AZEL_ID | ((polyid_weight == 1)? AZEL_WEIGHT : AZEL_POLYID);
+	azelout.unit = fmt->outunit;
+	if (wrazel_head(&azelout) == -1) return(-1);
     } else {
-	sprintf(az_str, "az(%c)", fmt->outunit);
-	sprintf(el_str, "el(%c)", fmt->outunit);
-    }
-    fprintf(outfile, "%*s %*s", len, az_str, len, el_str);
-    if (npoly > 0){
-      if(polyid_weight==1){
-	fprintf(outfile, " polygon_weights");
-      }
-      else{
-	fprintf(outfile, " polygon_ids");	
-      }
+	v.az = 0.;
+	wrangle(v.az, fmt->outunit, fmt->outprecision, AZEL_STR_LEN, az_str);
+	len = strlen(az_str);
+	if (fmt->outunit == 'h') {
+	    sprintf(az_str, "az(hms)");
+	    sprintf(el_str, "el(dms)");
+	} else {
+	    sprintf(az_str, "az(%c)", fmt->outunit);
+	    sprintf(el_str, "el(%c)", fmt->outunit);
+	}
+	fprintf(outfile, "%*s %*s", len, az_str, len, el_str);
+	if (npoly > 0){
+	  if(polyid_weight==1){
+	    fprintf(outfile, " polygon_weights");
+	  }
+	  else{
+	    fprintf(outfile, " polygon_ids");	
+	  }
+	}
+	fprintf(outfile, "\n");
     }
-    fprintf(outfile, "\n");
 
     /* interpretive read/write loop */
     np = 0;
@@ -258,62 +268,85 @@ int poly_ids(char *in_filename, char *out_filename, format *fmt, int npoly, poly
     nid0 = 0;
     nid2 = 0;
     while (1) {
-	/* read line */
-	ird = rdline(&file);
-	/* serious error */
-	if (ird == -1) return(-1);
-	/* EOF */
-	if (ird == 0) break;
+	if (fmt->inazel != 't') {
+	    /* read binary record */
+	    ird = rdazel(&azelin, &v, &inid, 0x0);
+	    /* serious error */
+	    if (ird == -1) return(-1);
+	    /* EOF */
+	    if (ird == 0) break;
+	} else {
+	    /* read line */
+	    ird = rdline(&file);
+	    /* serious error */
+	    if (ird == -1) return(-1);
+	    /* EOF */
+	    if (ird == 0) break;
 
-	/* read <az> */
-	word = file.line;
-	ird = rdangle(word, &next, fmt->inunit, &v.az);
-	/* skip header */
-	if (ird != 1 && np == 0) continue;
-	/* otherwise exit on unrecognized characters */
-	if (ird != 1) break;
+	    /* read <az> */
+	    word = file.line;
+	    ird = rdangle(word, &next, fmt->inunit, &v.az);
+	    /* skip header */
+	    if (ird != 1 && np == 0) continue;
+	    /* otherwise exit on unrecognized characters */
+	    if (ird != 1) break;
+
+	    /* read <el> */
+	    word = next;
+	    ird = rdangle(word, &next, fmt->inunit, &v.el);
+	    /* skip header */
+	    if (ird != 1 && np == 0) continue;
+	    /* otherwise exit on unrecognized characters */
+	    if (ird != 1) break;
+	}
 
-	/* read <el> */
-	word = next;
-	ird = rdangle(word, &next, fmt->inunit, &v.el);
-	/* skip header */
-	if (ird != 1 && np == 0) continue;
-	/* otherwise exit on unrecognized characters */
-	if (ird != 1) break;
+	/* points without an id are numbered from 0 in the order read */
+	if (fmt->inazel == 't' || !(azelin.columns & AZEL_ID)) inid = np;
 
 	/* convert az and el from input units to radians */
 	scale_azel(&v, fmt->inunit, 'r');
 	
-	//find out what pixel the az el point is in at the maximum resolution
-	p=which_pixel(v.az, v.el, res_max, scheme);
-	//get the list of all the possible parent pixels
-	get_parent_pixels(p, parent_pixels, scheme);
-
+	//find out what pixel the az el point is in at the maximum resolution,
+	//and the list of all the possible parent pixels
 	nid=0;
-	for(res=res_max;res>=0;res--){
-	  p=parent_pixels[res];
-	  //if this pixel isn't in the polygon list, go to next parent pixel
-	  if(total[p]==0) continue;
-	  // id numbers of the polygons containing position az, el 
-	  nid = poly_id(total[p], &poly[start[p]], v.az, v.el, &id, &weight);
+	if(which_pixels(1, &v.az, &v.el, res_max, scheme, &p, parent_pixels)==0){
+	  for(res=res_max;res>=0;res--){
+	    q=pixel_find(&dir, parent_pixels[res]);
+	    //if this pixel isn't in the polygon list, go to next parent pixel
+	    if(q==-1) continue;
+	    // id numbers of the polygons containing position az, el 
+	    nid = poly_id(dir.total[q], &poly[dir.start[q]], v.az, v.el, &id, &weight);
+	  }
 	}
 	
 	/* convert az and el from radians to output units */
 	scale_azel(&v, 'r', fmt->outunit);
 
 	/* write result */
-	wrangle(v.az, fmt->outunit, fmt->outprecision, AZEL_STR_LEN, az_str);
-	wrangle(v.el, fmt->outunit, fmt->outprecision, AZEL_STR_LEN, el_str);
-	fprintf(outfile, "%s %s", az_str, el_str);
-	for (i = 0; i < nid; i++) {
-	  if(polyid_weight==1){
-	    fprintf(outfile, " %.18Lg", weight[i]);
-	  } else{
-	    fprintf(outfile, " %*lld", idwidth, id[i]);
-	  }
+	if (fmt->outazel != 't') {
+	    /* one record per polygon containing the point,
+	       or one with polygon id -1 and weight 0 if there is none */
+	    if (nid == 0) {
+		if (wrazel(&azelout, &v, inid, 0., -1) == -1) return(-1);
+	    }
+	    for (i = 0; i < nid; i++) {
+		if (wrazel(&azelout, &v, inid, weight[i], id[i]) == -1) return(-1);
+	    }
+	} else {
+	    wrangle(v.az, fmt->outunit, fmt->outprecision, AZEL_STR_LEN, az_str);
+	    wrangle(v.el, fmt->outunit, fmt->outprecision, AZEL_STR_LEN, el_str);
+	    fprintf(outfile, "%s %s", az_str, el_str);
+	    for (i = 0; i < nid; i++) {
+	      if(polyid_weight==1){
+		wrrealg(weight[i], 18, 0, AZEL_STR_LEN, w_str);
+		fprintf(outfile, " %s", w_str);
+	      } else{
+		fprintf(outfile, " %*lld", idwidth, id[i]);
+	      }
+	    }
+	    fprintf(outfile, "\n");
 	}
-	fprintf(outfile, "\n");
-	fflush(outfile);
+	if (flush_lines) fflush(outfile);
 
         /* increment counters of results */
 	np++;
@@ -324,12 +357,16 @@ int poly_ids(char *in_filename, char *out_filename, format *fmt, int npoly, poly
 	  nid2++;
 	}
     }
+    if (fmt->outazel != 't') {
+	if (wrazel_end(&azelout) == -1) return(-1);
+    }
 
     /* advise */
     if (nid0 > 0) msg("%d points were not inside any polygon\n", nid0);
     if (nid2 > 0) msg("%d points were inside >= 2 polygons\n", nid2);
 
     if (outfile != stdout) {
+      wrclose(outfile);
       if(polyid_weight==1){
 	msg("polyid: %d weights at %d positions written to %s\n", nids, np, out_fn);
       } else {
@@ -337,8 +374,7 @@ int poly_ids(char *in_filename, char *out_filename, format *fmt, int npoly, poly
       }
     }
     
-    free(start);
-    free(total);
+    free_pixel_dir(&dir);
     free(parent_pixels);
 
     return(np);
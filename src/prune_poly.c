@@ -1,8 +1,14 @@
 /*------------------------------------------------------------------------------
  A J S Hamilton 2001
 ------------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
 #include "manglefn.h"
 
+/* use the single pass over edges only for polygons with more than this many caps;
+   for fewer caps, testing each cap with garea is quicker */
+#define NPEDGES		6
+
 /*------------------------------------------------------------------------------
   Remove all superfluous caps from polygon.
 
@@ -14,6 +20,13 @@
   there are any redundant caps enclosing the entire polygon, in which case it
   removes those caps, in addition to removing caps suppressed by trim_poly().
 
+  A cap of a non-null polygon is redundant if and only if its boundary
+  contributes no edge to the polygon, so for polygons with many caps
+  the edges are first enumerated with gverts,
+  and all caps without edges are suppressed in one go.
+  If the area of the polygon is then exactly unchanged, that is the answer;
+  otherwise (degenerate cases) each cap is tested in turn with garea.
+
   Null polygons are replaced with a single null cap.
   Note that a polygon with no caps is the whole sphere, not a null polygon.
 
@@ -28,10 +41,17 @@
 		2 if nothing changed, and polygon is null;
 		3 if polygon was changed to null polygon.
 */
-int prune_poly(polygon *poly, long double mtol)
+int prune_poly(polygon *poly, real_t mtol)
 {
-    int i, ier, ip, iret, jp, verb;
-    long double area, area_tot, cm, tol;
+    const int do_vcirc = 1, nve = 1, per = 0;
+    static THREADLOCAL int ncmmax = 0;
+    static THREADLOCAL real_t *cmsave = 0x0;
+
+    int i, ier, ip, iret, iv, jp, nev, nev0, nv, verb;
+    int *ipv, *gp, *ev;
+    real_t area, area_tot, cm, tol;
+    real_t *angle;
+    vec *ve;
 
     /* first cut */
     iret = trim_poly(poly);
@@ -45,7 +65,7 @@ int prune_poly(polygon *poly, long double mtol)
     verb = 1;
     ier = garea(poly, &tol, verb, &area_tot);
     if (ier) {
-      printf("prune_poly: received error message from garea, mtol = %Lf\n", tol);
+      printf("prune_poly: received error message from garea, mtol = %" RL "f\n", tol);
       return(-1);
     }
 
@@ -56,15 +76,59 @@ int prune_poly(polygon *poly, long double mtol)
 	poly->rp[0][2] = 1.;
 	poly->cm[0] = 0.;
 	poly->np = 1;
+	poly->areaok = 0;
 	return(3);
     }
 
+    /* make sure cmsave contains enough space */
+    if (ncmmax < poly->np) {
+	if (cmsave) free(cmsave);
+	ncmmax = poly->np + DNP;
+	cmsave = (real_t *) malloc(sizeof(real_t) * ncmmax);
+	if (!cmsave) {
+	    fprintf(stderr, "prune_poly: failed to allocate memory for %d long doubles\n", ncmmax);
+	    ncmmax = 0;
+	    return(-1);
+	}
+    }
+
+    /* edges of polygon, including bounding circles with no intersections */
+    ier = 1;
+    if (poly->np > NPEDGES) {
+	tol = mtol;
+	ier = gverts(poly, do_vcirc, &tol, per, nve, &nv, &ve, &angle, &ipv, &gp, &nev, &nev0, &ev);
+	if (ier == -1) return(-1);
+    }
+    if (ier == 0) {
+	/* flag caps that contribute an edge with cmsave = 2 */
+	for (ip = 0; ip < poly->np; ip++) cmsave[ip] = poly->cm[ip];
+	for (iv = 0; iv < nv; iv++) cmsave[ipv[iv]] = 2.;
+	/* suppress all other caps */
+	for (ip = 0; ip < poly->np; ip++) {
+	    if (cmsave[ip] < 2.) poly->cm[ip] = 2.;
+	}
+	poly->areaok = 0;
+	tol = mtol;
+	verb = 0;
+	ier = garea(poly, &tol, verb, &area);
+	if (ier == -1) return(-1);
+	/* restore caps if area changed */
+	if (ier || area != area_tot) {
+	    for (ip = 0; ip < poly->np; ip++) {
+		if (cmsave[ip] < 2.) poly->cm[ip] = cmsave[ip];
+	    }
+	} else {
+	    goto remove;
+	}
+    }
+
     /* test whether suppressing cap changes area or not */
     verb = 0;
     for (ip = 0; ip < poly->np; ip++) {
 	if (poly->cm[ip] >= 2.) continue;	/* cap is already superfluous */
 	cm = poly->cm[ip];			/* save latitude */
 	poly->cm[ip] = 2.;			/* suppress cap */
+	poly->areaok = 0;
 	tol = mtol;
 	//if(tol > 0.01) printf("prune_poly: tol = %Lf\n", tol);
 	ier = garea(poly, &tol, verb, &area);	/* area sans cap */
@@ -79,6 +143,7 @@ int prune_poly(polygon *poly, long double mtol)
     }
 
     /* remove superfluous caps */
+    remove:
     ip = 0;
     for (jp = 0; jp < poly->np; jp++) {
 	/* copy down cap */
@@ -94,6 +159,7 @@ int prune_poly(polygon *poly, long double mtol)
 	}
     }
     poly->np = ip;
+    poly->areaok = 0;
 
     return(iret);
 }
@@ -148,6 +214,7 @@ int trim_poly(polygon *poly)
 		poly->rp[0][2] = 1.;
 		poly->cm[0] = 0.;
 		poly->np = 1;
+		poly->areaok = 0;
 		return(3);
 	    }
 	}
@@ -167,6 +234,7 @@ int trim_poly(polygon *poly)
 		/* suppress coincident cap ip */
 		if (poly->cm[ip] == poly->cm[jp]) {
 		    poly->cm[ip] = 2.;
+		    poly->areaok = 0;
 		    iret = 1;
 		} else if (poly->cm[ip] == - poly->cm[jp]) {
 		/* complementary cap means polygon is null */
@@ -175,6 +243,7 @@ int trim_poly(polygon *poly)
 		    poly->rp[0][2] = 1.;
 		    poly->cm[0] = 0.;
 		    poly->np = 1;
+		    poly->areaok = 0;
 		    return(3);
 		}
 	    }
@@ -224,6 +293,7 @@ int touch_poly(polygon *poly)
 		/* suppress coincident cap ip */
 		if (poly->cm[ip] == poly->cm[jp]) {
 		    poly->cm[ip] = 2.;
+		    poly->areaok = 0;
 		    iret = 1;
 		}
 	    }
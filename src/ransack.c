@@ -6,11 +6,12 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include "azelfile.h"
 #include "manglefn.h"
 #include "defaults.h"
 
 /* getopt options */
-const char *optstr = "dqm:c:r:s:e:u:p:";
+const char *optstr = "dqm:c:r:s:e:u:p:FO:";
 
 /* allocate polygons as a global array */
 polygon *poly_global[NPOLYSMAX];
@@ -19,10 +20,10 @@ polygon *poly_global[NPOLYSMAX];
 void	usage(void);
 #ifdef	GCC
 int	ransack(char *, format *, int, int npolysmax, polygon *[npolysmax]);
-int	lasso_poly(polygon **, int npolys, polygon *[npolys], long double, int *);
+int	lasso_poly(polygon **, int npolys, polygon *[npolys], real_t, int *);
 #else
 int	ransack(char *, format *, int, int npolysmax, polygon *[/*npolysmax*/]);
-int	lasso_poly(polygon **, int npolys, polygon *[/*npolys*/], long double, int *);
+int	lasso_poly(polygon **, int npolys, polygon *[/*npolys*/], real_t, int *);
 #endif
 
 /*------------------------------------------------------------------------------
@@ -58,7 +59,7 @@ int main(int argc, char *argv[])
     if (mtol != 0.) {
 	scale(&mtol, munit, 's');
 	munit = 's';
-	msg("multiple intersections closer than %Lg%c will be treated as coincident\n", mtol, munit);
+	msg("multiple intersections closer than %" RL "g%c will be treated as coincident\n", mtol, munit);
 	scale(&mtol, munit, 'r');
 	munit = 'r';
     }
@@ -141,10 +142,11 @@ int ransack(char *out_filename, format *fmt, int npoly, int npolysmax, polygon *
     int dnp, dnwl, i, idwidth, ier, in, inull, ip, ipmin, ipoly, iprune, irandom, lassoed, np, nwl, tries, verb, width, k;
     long long idmin,idmax;
     int *dlasso=0x0, *lasso=0x0;
-    long double area, cmmin, cmi, phi, rpoly, si, tol, w, wcum, x, y, z;
-    long double *wpoly;
+    real_t area, cmmin, cmi, phi, rpoly, si, tol, w, wcum, x, y, z;
+    real_t *wpoly;
     vec rp, xi, yi;
     azel v;
+    azelfile azelout;
     char *out_fn;
     FILE *outfile;
 
@@ -158,6 +160,7 @@ int ransack(char *out_filename, format *fmt, int npoly, int npolysmax, polygon *
 	    fprintf(stderr, "ransack: cannot open %s for writing\n", out_filename);
 	    goto error;
 	}
+	wrbuf(outfile);
 	out_fn = out_filename;
     }
 
@@ -287,7 +290,7 @@ int ransack(char *out_filename, format *fmt, int npoly, int npolysmax, polygon *
 
     /* allocate memory for wpoly array */
     nwl = npoly;
-    wpoly = (long double *) malloc(sizeof(long double) * nwl);
+    wpoly = (real_t *) malloc(sizeof(real_t) * nwl);
     if (!wpoly) {
         fprintf(stderr, "ransack: failed to allocate memory for %d long doubles\n", nwl);
         goto error;
@@ -316,21 +319,30 @@ int ransack(char *out_filename, format *fmt, int npoly, int npolysmax, polygon *
 	if (poly[ipoly]->id < idmin) idmin = poly[ipoly]->id;
 	if (poly[ipoly]->id > idmax) idmax = poly[ipoly]->id;
     }
-    idmin = ((idmin < 0)? floorl(log10l((long double)-idmin)) + 2 : 1);
-    idmax = ((idmax > 0)? floorl(log10l((long double)idmax)) + 1 : 1);
+    idmin = ((idmin < 0)? floorl(log10l((real_t)-idmin)) + 2 : 1);
+    idmax = ((idmax > 0)? floorl(log10l((real_t)idmax)) + 1 : 1);
     idwidth = ((idmin > idmax)? idmin : idmax);
 
     /* write header */
-    wrangle(0., fmt->outunit, fmt->outprecision, AZEL_STR_LEN, az_str);
-    width = strlen(az_str);
-    if (fmt->outunit == 'h') {
-	sprintf(az_str, "az(hms)");
-	sprintf(el_str, "el(dms)");
+    if (fmt->outazel != 't') {
+	azelout.name = out_fn;
+	azelout.file = outfile;
+	azelout.fmt = fmt->outazel;
+	azelout.columns = AZEL_ID;
+	azelout.unit = fmt->outunit;
+	if (wrazel_head(&azelout) == -1) goto error;
     } else {
-	sprintf(az_str, "az(%c)", fmt->outunit);
-	sprintf(el_str, "el(%c)", fmt->outunit);
+	wrangle(0., fmt->outunit, fmt->outprecision, AZEL_STR_LEN, az_str);
+	width = strlen(az_str);
+	if (fmt->outunit == 'h') {
+	    sprintf(az_str, "az(hms)");
+	    sprintf(el_str, "el(dms)");
+	} else {
+	    sprintf(az_str, "az(%c)", fmt->outunit);
+	    sprintf(el_str, "el(%c)", fmt->outunit);
+	}
+	fprintf(outfile, "%*s\t%*s\t%*s\n", width, az_str, width, el_str, idwidth, "id");
     }
-    fprintf(outfile, "%*s\t%*s\t%*s\n", width, az_str, width, el_str, idwidth, "id");
 
     /* accept error messages from garea */
     /* unprunable polygons were already discarded, so garea should give no errors */
@@ -343,7 +355,7 @@ int ransack(char *out_filename, format *fmt, int npoly, int npolysmax, polygon *
 	if (poly[ipoly]) {
 	    /* area of polygon */
 	    tol = mtol;
-	    ier = garea(poly[ipoly], &tol, verb, &area);
+	    ier = poly_area(poly[ipoly], &tol, verb, &area);
 	    if (ier) goto error;
 	    /* accumulate weight times area */
 	    w += poly[ipoly]->weight * area;
@@ -368,7 +380,7 @@ int ransack(char *out_filename, format *fmt, int npoly, int npolysmax, polygon *
 
 	/* guard against roundoff */
 	if (ipoly >= npoly) {
-	    fprintf(stderr, "ransack: %d should be < %d (i.e. %.15Lg < %.15Lg)\n", ipoly, npoly, rpoly, wpoly[npoly - 1]);
+	    fprintf(stderr, "ransack: %d should be < %d (i.e. %.15" RL "g < %.15" RL "g)\n", ipoly, npoly, rpoly, wpoly[npoly - 1]);
 	    ipoly = npoly - 1;
 	}
 
@@ -415,7 +427,7 @@ int ransack(char *out_filename, format *fmt, int npoly, int npolysmax, polygon *
 			/* enlarge memory for wpoly, lasso, and dlasso arrays */
 			if (np + dnp > nwl) {
 			    dnwl = dnp + 1024;
-			    wpoly = (long double *) realloc(wpoly, sizeof(long double) * (nwl + dnwl));
+			    wpoly = (real_t *) realloc(wpoly, sizeof(real_t) * (nwl + dnwl));
 			    if (!wpoly) {
 				fprintf(stderr, "ransack: failed to reallocate memory for %d long doubles\n", nwl + dnwl);
 				goto error;
@@ -470,7 +482,7 @@ int ransack(char *out_filename, format *fmt, int npoly, int npolysmax, polygon *
 
 		/* guard against roundoff */
 		if (ip >= lasso[ipoly] + dlasso[ipoly]) {
-		    fprintf(stderr, "ransack: %d should be < %d (i.e. %.15Lg < %.15Lg)\n", ip, lasso[ipoly] + dlasso[ipoly], rpoly, wpoly[lasso[ipoly] + dlasso[ipoly] - 1]);
+		    fprintf(stderr, "ransack: %d should be < %d (i.e. %.15" RL "g < %.15" RL "g)\n", ip, lasso[ipoly] + dlasso[ipoly], rpoly, wpoly[lasso[ipoly] + dlasso[ipoly] - 1]);
 		    ip = lasso[ipoly] + dlasso[ipoly] - 1;
 		}
 
@@ -522,15 +534,24 @@ int ransack(char *out_filename, format *fmt, int npoly, int npolysmax, polygon *
 	scale_azel(&v, 'r', fmt->outunit);
 
 	/* write result */
-	wrangle(v.az, fmt->outunit, fmt->outprecision, AZEL_STR_LEN, az_str);
-	wrangle(v.el, fmt->outunit, fmt->outprecision, AZEL_STR_LEN, el_str);
-	fprintf(outfile, "%s\t%s\t%*lld\n", az_str, el_str, idwidth, poly[ipoly]->id);
+	if (fmt->outazel != 't') {
+	    if (wrazel(&azelout, &v, poly[ipoly]->id, 1., 0) == -1) goto error;
+	} else {
+	    wrangle(v.az, fmt->outunit, fmt->outprecision, AZEL_STR_LEN, az_str);
+	    wrangle(v.el, fmt->outunit, fmt->outprecision, AZEL_STR_LEN, el_str);
+	    fprintf(outfile, "%s\t%s\t%*lld\n", az_str, el_str, idwidth, poly[ipoly]->id);
+	}
+	if (flush_lines) fflush(outfile);
 	/* fprintf(outfile, "%s %s %d %d %d %Lg %Lg %Lg %Lg %d %d\n", az_str, el_str, irandom, ipoly, tries, wcum, rpoly / wcum, area, TWOPI * cmmin / area, ipmin, poly[ipoly]->np); */
 
     }
+    if (fmt->outazel != 't') {
+	if (wrazel_end(&azelout) == -1) goto error;
+    }
 
     /* advise */
     if (outfile != stdout) {
+	wrclose(outfile);
 	msg("ransack: %d random positions written to %s\n", nrandom, out_fn);
     }
 
@@ -553,7 +574,7 @@ int ransack(char *out_filename, format *fmt, int npoly, int npolysmax, polygon *
 		 0 ok;
 		 1 if *poly was only partially partioned.
 */
-int lasso_poly(polygon **poly, int npolys, polygon *polys[/*npolys*/], long double mtol, int *np)
+int lasso_poly(polygon **poly, int npolys, polygon *polys[/*npolys*/], real_t mtol, int *np)
 {
 /* part_poly should lasso all one-boundary polygons */
 #define ALL_ONEBOUNDARY		2
@@ -564,7 +585,7 @@ int lasso_poly(polygon **poly, int npolys, polygon *polys[/*npolys*/], long doub
 /* partition_poly should never overwrite original polygons */
 #define	OVERWRITE_ORIGINAL	0
     int ier, ip, ipmin;
-    long double cmmin, cmmino, cmmint;
+    real_t cmmin, cmmino, cmmint;
 
     /* area/(2 pi) of smallest cap of polygon */
     cmminf(*poly, &ipmin, &cmmino);
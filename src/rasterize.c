@@ -14,7 +14,7 @@
 #define DNP             4
 
 /* getopt options */
-const char *optstr = "B:dqm:a:b:t:y:s:e:v:p:i:o:HT";
+const char *optstr = "B:dqm:a:b:t:y:s:e:v:p:i:o:O:HTN:";
 
 /* allocate polygons as a global array */
 polygon *polys_global[NPOLYSMAX];
@@ -23,26 +23,33 @@ long long raster_ids[NPOLYSMAX];
 /* local functions */
 void     usage(void);
 #ifdef  GCC
-int     rasterize(int nhealpix_poly, int npoly, polygon *[npoly], int npolys, polygon *[npolys], int nweights, long long rastid_min, long double [nweights], long long raster_ids[npolys]);
+int     rasterize(int nhealpix_poly, int npoly, polygon *[npoly], int npolys, polygon *[npolys], int nweights, long long rast_id[nweights], real_t [nweights], long long raster_ids[npolys]);
 #else
-int     rasterize(int nhealpix_poly, int npoly, polygon *[/*npoly*/], int npolys, polygon *[/*npolys*/], int nweights, long long rastid_min, long double [/*nweights*/], long long raster_ids[/*npolys*/]);
+int     rasterize(int nhealpix_poly, int npoly, polygon *[/*npoly*/], int npolys, polygon *[/*npolys*/], int nweights, long long rast_id[/*nweights*/], real_t [/*nweights*/], long long raster_ids[/*npolys*/]);
 #endif
+int     weight_index(long long id, int nweights, long long rast_id[/*nweights*/]);
+int     healpix_rasterizer(int nside, int npoly, polygon *[/*npoly*/], int npolys, polygon *[/*npolys*/]);
+int     healpix_footprint(int nside, int npoly, polygon *[/*npoly*/], int **hpix);
+int     footprint_loop(int n, int p, int nside, int ncand, int cand[], int scratch[], polygon *poly[], int *nhpix, int *mhpix, int **hpix);
+int     rasterizer_loop(long long pix, polygon *rpoly, vec c, real_t cmc, pixeldir *mask, pixeldir *need, polygon ***piece, int *npiece);
+int     llcmp(const void *, const void *);
 
 /*--------------------------------------------------------------------
   Main program.
 */
 int main(int argc, char *argv[])
 {
-  int ifile, nfiles, npoly, npolys, nhealpix_poly, nhealpix_polys, j, k, nweights, nweight,npolyw;
+  int ifile, imask, nfiles, npoly, npolys, nhealpix_poly, nhealpix_polys, k, nweights, nweight,npolyw;
   long long rastid_min, rastid_max;
-  long double *weights;
+  long long *rast_id;
+  real_t *weights;
   char *filename;
   char subfilename[1000];
   int nchars;
   char *stringbegin;
   char *stringend;
 
-  polygon **polys;
+  polygon **polys, **mask_polys;
   polys=polys_global;
 
   /* default output format */
@@ -54,8 +61,13 @@ int main(int argc, char *argv[])
   /* parse arguments */
   parse_args(argc, argv);
 
-  /* at least two input and one output filenames required as arguments */
-  if (argc - optind < 3) {
+  /* at least two input and one output filenames required as arguments,
+     or one input if the rasterizer polygons are generated */
+  if (healpix_nside > 0 && argc - optind < 2) {
+      fprintf(stderr, "%s -N requires at least 2 arguments: polygon_infile2 and polygon_outfile\n", argv[0]);
+      usage();
+      exit(1);
+  } else if (healpix_nside == 0 && argc - optind < 3) {
       if (optind > 1 || argc - optind == 1 || argc - optind == 2) {
          fprintf(stderr, "%s requires at least 3 arguments: polygon_infile1, polygon_infile2, and polygon_outfile\n", argv[0]);
          usage();
@@ -75,7 +87,7 @@ int main(int argc, char *argv[])
   axunit = 's';
   bunit = 's';
   thunit = 's';
-  msg("snap angles: axis %Lg%c latitude %Lg%c edge %Lg%c\n", axtol, axunit, btol, bunit, thtol, thunit);
+  msg("snap angles: axis %" RL "g%c latitude %" RL "g%c edge %" RL "g%c\n", axtol, axunit, btol, bunit, thtol, thunit);
   scale(&axtol, axunit, 'r');
   scale(&btol, bunit, 'r');
   scale(&thtol, thunit, 'r');
@@ -87,7 +99,7 @@ int main(int argc, char *argv[])
   if (mtol != 0.) {
      scale(&mtol, munit, 's');
      munit = 's';
-     msg("multiple intersections closer than %Lg%c will be treated as coincident\n", mtol, munit);
+     msg("multiple intersections closer than %" RL "g%c will be treated as coincident\n", mtol, munit);
      scale(&mtol, munit, 'r');
      munit = 'r';
   }
@@ -106,22 +118,57 @@ int main(int argc, char *argv[])
      for example, if you are using HEALPix, the id numbers should match the HEALPix pixel numbers
      in the NESTED scheme */
   nhealpix_poly = 0;
-  ifile = optind;
-  nhealpix_polys = rdmask(argv[ifile], &fmt, NPOLYSMAX - nhealpix_poly, &polys[nhealpix_poly]);
-  if (nhealpix_polys == -1) exit(1);
-  nhealpix_poly += nhealpix_polys;
+  if (healpix_nside == 0) {
+    ifile = optind;
+    nhealpix_polys = rdmask(argv[ifile], &fmt, NPOLYSMAX - nhealpix_poly, &polys[nhealpix_poly]);
+    if (nhealpix_polys == -1) exit(1);
+    nhealpix_poly += nhealpix_polys;
+
+    if (nhealpix_poly == 0) {
+       msg("STOP\n");
+       exit(0);
+    }
 
-  if (nhealpix_poly == 0) {
-     msg("STOP\n");
-     exit(0);
+    /* Input rasterizer polygons need not be balkanized if they are non-overlapping by construction,
+       which is the case for the HEALPix polygons.  This is a special case - all other mangle functions
+       that require balkanization require all input files to be balkanized.  To avoid getting an error
+       here, increment the 'balkanized' counter here if the rasterizer polygons are not balkanized. */
+    if (balkanized == 0) {
+      balkanized++;
+    }
   }
 
-  /* Input rasterizer polygons need not be balkanized if they are non-overlapping by construction,
-     which is the case for the HEALPix polygons.  This is a special case - all other mangle functions
-     that require balkanization require all input files to be balkanized.  To avoid getting an error
-     here, increment the 'balkanized' counter here if the rasterizer polygons are not balkanized. */
-  if (balkanized == 0) {
-    balkanized++;
+  /* read polygons from polygon_infile2, polygon_infile3, etc. */
+  npoly = nhealpix_poly;
+  imask = (healpix_nside > 0)? optind : optind + 1;
+  nfiles = argc - 1 - imask;
+  for (ifile = imask; ifile < imask + nfiles; ifile++) {
+      npolys = rdmask(argv[ifile], &fmt, NPOLYSMAX - npoly, &polys[npoly]);
+      if (npolys == -1) exit(1);
+      npoly += npolys;      
+  }
+  if (nfiles >= 2) {
+    msg("total of %d polygons read from mask files\n", npoly-nhealpix_poly);
+  }
+  if (npoly-nhealpix_poly == 0) {
+    msg("STOP\n");
+    exit(0);
+  }
+
+  /* generate the HEALPix rasterizer polygons over the mask, and put them in front of it */
+  if (healpix_nside > 0) {
+    nhealpix_poly = healpix_rasterizer(healpix_nside, npoly, polys, NPOLYSMAX - npoly, &polys[npoly]);
+    if (nhealpix_poly == -1) exit(1);
+    mask_polys = (polygon **) malloc(sizeof(polygon *) * npoly);
+    if (!mask_polys) {
+      fprintf(stderr, "rasterize: failed to allocate memory for %d polygon pointers\n", npoly);
+      exit(1);
+    }
+    memcpy(mask_polys, polys, sizeof(polygon *) * npoly);
+    memmove(polys, &polys[npoly], sizeof(polygon *) * nhealpix_poly);
+    memcpy(&polys[nhealpix_poly], mask_polys, sizeof(polygon *) * npoly);
+    free(mask_polys);
+    npoly += nhealpix_poly;
   }
 
   /* find maximum id number in rasterizer file*/
@@ -136,25 +183,34 @@ int main(int argc, char *argv[])
     if (polys[k]->id <= rastid_min) rastid_min = polys[k]->id;
   }
 
-  /* set nweights equal to max id in rasterizer file - min id in rasterizer file plus 1*/
-  nweights=rastid_max-rastid_min+1;
-  
-  /* read polygons from polygon_infile2, polygon_infile3, etc. */
-  npoly = nhealpix_poly;
-  nfiles = argc - 2 - optind;
-  for (ifile = optind + 1; ifile < optind + 1 + nfiles; ifile++) {
-      npolys = rdmask(argv[ifile], &fmt, NPOLYSMAX - npoly, &polys[npoly]);
-      if (npolys == -1) exit(1);
-      npoly += npolys;      
+  /* set nweights equal to max id in rasterizer file - min id in rasterizer file plus 1,
+     or, for generated rasterizer polygons, which cover only the mask, to the number of
+     distinct HEALPix pixels among them, so the weights are a sparse map */
+  if (healpix_nside > 0) {
+    nweights = 0;
+    for (k = 0; k < nhealpix_poly; k++) {
+      if (k == 0 || polys[k]->id != polys[k - 1]->id) nweights++;
+    }
+  } else {
+    nweights=rastid_max-rastid_min+1;
   }
-  if (nfiles >= 2) {
-    msg("total of %d polygons read from mask files\n", npoly-nhealpix_poly);
+
+  /* rasterizer id of each weight, in increasing order */
+  rast_id = (long long *) malloc(sizeof(long long) * (nweights));
+  if (!rast_id) {
+     fprintf(stderr, "rasterize: failed to allocate memory for %d long longs\n", nweights);
+     exit(1);
   }
-  if (npoly-nhealpix_poly == 0) {
-    msg("STOP\n");
-    exit(0);
+  if (healpix_nside > 0) {
+    /* generated in NESTED order */
+    nweights = 0;
+    for (k = 0; k < nhealpix_poly; k++) {
+      if (k == 0 || polys[k]->id != polys[k - 1]->id) rast_id[nweights++] = polys[k]->id;
+    }
+  } else {
+    for (k = 0; k < nweights; k++) rast_id[k] = rastid_min + k;
   }
-
+  
   /*only check for snapped and balkanized if averaging within rasterizer polygons - if slicing input polygons
     into the rasterizer polygons (sliceordice=1) it doesn't matter if input is snapped or balkanized.*/ 
   if(!sliceordice){
@@ -166,7 +222,7 @@ int main(int argc, char *argv[])
   }
 
   /* allocate memory for weights array */
-  weights = (long double *) malloc(sizeof(long double) * (nweights));
+  weights = (real_t *) malloc(sizeof(real_t) * (nweights));
   if (!weights) {
      fprintf(stderr, "rasterize: failed to allocate memory for %d long doubles\n", nweights);
      exit(1);
@@ -176,24 +232,24 @@ int main(int argc, char *argv[])
   for (k = 0; k < nweights; k++) weights[k] = 0.;
 
   /* rasterize */
-  npolys = rasterize(nhealpix_poly, npoly, polys, NPOLYSMAX - npoly, &polys[npoly], nweights, rastid_min, weights,raster_ids);
+  npolys = rasterize(nhealpix_poly, npoly, polys, NPOLYSMAX - npoly, &polys[npoly], nweights, rast_id, weights,raster_ids);
   if (npolys == -1) exit(1);
 
   if(!sliceordice){
     /* copy new weights to original rasterizer polygons */
     for (k = 0; k < nhealpix_poly; k++) {
-      for (j = 0; j < nweights; j++) {
-	if (polys[k]->id == (long long)j+rastid_min) {
-	  polys[k]->weight = weights[j];
-	  break;
-	}
-      }
+      nweight = weight_index(polys[k]->id, nweights, rast_id);
+      if (nweight != -1) polys[k]->weight = weights[nweight];
     }
   }
 
   ifile = argc - 1;
   if (strcmp(fmt.out, "healpix_weight") == 0) {
-    npolys = wr_healpix_weight(argv[ifile], &fmt, nweights, weights);
+    if (healpix_nside > 0) {
+      npolys = wr_healpix_weight(argv[ifile], &fmt, nweights, weights, rast_id, healpix_nside);
+    } else {
+      npolys = wr_healpix_weight(argv[ifile], &fmt, nweights, weights, 0x0, 0);
+    }
     if (npolys == -1) exit(1);
   }
   else if (strcmp(fmt.out, "dpolygon") == 0) {
@@ -238,6 +294,7 @@ int main(int argc, char *argv[])
     free_poly(polys[k]);
   }
   free(weights);
+  free(rast_id);
   return(0);
 }
 
@@ -246,7 +303,7 @@ int main(int argc, char *argv[])
 void usage(void)
 {
      printf("usage:\n");
-     printf("rasterize [-d] [-q] [-m<a>[u]] [-s<n>] [-a<a>[u]] [-b<a>[u]] [-t<a>[u]] [-y<r>] [-e<n>] [-vo|-vn] [-p[+|-][<n>]] [-i<f>[<n>][u]] [-o<f>[u]] [-H] [-T] polygon_infile1 polygon_infile2 [polygon_infile3 ...] polygon_outfile\n");
+     printf("rasterize [-d] [-q] [-m<a>[u]] [-s<n>] [-a<a>[u]] [-b<a>[u]] [-t<a>[u]] [-y<r>] [-e<n>] [-vo|-vn] [-p[+|-][<n>]] [-i<f>[<n>][u]] [-o<f>[u]] [-H] [-T] [-N<n>] polygon_infile1 polygon_infile2 [polygon_infile3 ...] polygon_outfile\n");
 #include "usage.h"
 }
 
@@ -261,21 +318,23 @@ void usage(void)
          npoly = total number of polygons in input array.
 	 poly = array of pointers to polygons.
 	 nweights = number of weights in output array.
+	 rast_id = rasterizer id of each weight, in increasing order.
   Output: weights = array of rasterizer weights.
   Return value: number of weights in array,
                 or -1 if error occurred.
 */
 
-int rasterize(int nhealpix_poly, int npoly, polygon *poly[/*npoly*/], int npolys, polygon *polys[/*npolys*/], int nweights, long long rastid_min, long double weights[/*nweights*/],long long raster_ids[/*npolys*/])
+int rasterize(int nhealpix_poly, int npoly, polygon *poly[/*npoly*/], int npolys, polygon *polys[/*npolys*/], int nweights, long long rast_id[/*nweights*/], real_t weights[/*nweights*/],long long raster_ids[/*npolys*/])
 {
 #define WARNMAX                 0
 
-  int min_pixel, max_pixel, ier, ier_h, ier_i, i, j,k, ipix, ipoly, begin_r, end_r, begin_m, end_m, verb, np, iprune,n,selfsnap,nadj;
-  int *start_r, *start_m, *total_r, *total_m;
-  long double *areas, area_h, area_i, tol;
-  polygon *rasterizer_and_poly[2];
+  int ier, ier_h, ier_i, i, j,k, ipoly, begin_r, end_r, begin_m, end_m, verb, np, iprune,n,selfsnap,nadj;
+  int ir, im;
+  pixeldir dir_r, dir_m;
+  real_t *areas, area_h, area_i, tol;
+  polygon *rasterizer_and_poly[2], *hpoly;
   char snapped_polys[2];
-  static polygon *polyint = 0x0;
+  static THREADLOCAL polygon *polyint = 0x0;
   
   if(!sliceordice){
     /* make sure weights are all zero for rasterizer pixels */
@@ -285,7 +344,7 @@ int rasterize(int nhealpix_poly, int npoly, polygon *poly[/*npoly*/], int npolys
   }
   
   /* allocate memory for rasterizer areas array */
-  areas = (long double *) malloc(sizeof(long double) * (nweights));
+  areas = (real_t *) malloc(sizeof(real_t) * (nweights));
   if (!areas) {
     fprintf(stderr, "rasterize: failed to allocate memory for %d long doubles\n", nweights);
     exit(1);
@@ -302,22 +361,28 @@ int rasterize(int nhealpix_poly, int npoly, polygon *poly[/*npoly*/], int npolys
   
   if(!sliceordice){ 
     /* find areas of rasterizer pixels for later use */
-    for (i = 0; i < nweights; i++) {
-      for (j = 0; j < nhealpix_poly; j++) {
-	if (poly[j]->id == (long long)i+rastid_min) {
-	  tol = mtol;
-	  ier_h = garea(poly[j], &tol, verb, &area_h);
-	  if (ier_h == 1) {
-	    fprintf(stderr, "fatal error in garea\n");
-	    exit(1);
-	  }
-	  if (ier_h == -1) {
-	    fprintf(stderr, "failed to allocate memory in garea\n");
-	    exit(1);
-	  }
-	  areas[i] += area_h;
-	}
+    for (j = 0; j < nhealpix_poly; j++) {
+      /* generated rasterizer polygons are only the parts in the pixels of the mask,
+	 so take the area of the whole HEALPix pixel, once */
+      k = weight_index(poly[j]->id, nweights, rast_id);
+      hpoly = poly[j];
+      if (healpix_nside > 0) {
+	if (areas[k] != 0.) continue;
+	hpoly = get_healpix_poly(healpix_nside, (int)poly[j]->id);
+	if (!hpoly) return(-1);
       }
+      tol = mtol;
+      ier_h = garea(hpoly, &tol, verb, &area_h);
+      if (hpoly != poly[j]) free_poly(hpoly);
+      if (ier_h == 1) {
+	fprintf(stderr, "fatal error in garea\n");
+	exit(1);
+      }
+      if (ier_h == -1) {
+	fprintf(stderr, "failed to allocate memory in garea\n");
+	exit(1);
+      }
+      areas[k] += area_h;
     }
   }
 
@@ -325,56 +390,37 @@ int rasterize(int nhealpix_poly, int npoly, polygon *poly[/*npoly*/], int npolys
   poly_sort(nhealpix_poly, poly, 'p');
   poly_sort(npoly-nhealpix_poly, &(poly[nhealpix_poly]), 'p');
 
-  /* allocate memory for pixel info arrays start_r, start_m, total_r, and total_m */
-  min_pixel = poly[0]->pixel;
-  max_pixel = (poly[nhealpix_poly-1]->pixel+1>poly[npoly-1]->pixel+1)?(poly[nhealpix_poly-1]->pixel+1):(poly[npoly-1]->pixel+1);
-  start_r = (int *) malloc(sizeof(int) * max_pixel);
-  if (!start_r) {
-    fprintf(stderr, "rasterize: failed to allocate memory for %d integers\n", max_pixel);
-    return(-1);
-  }
-  start_m = (int *) malloc(sizeof(int) * max_pixel);
-  if (!start_m) {
-    fprintf(stderr, "rasterize: failed to allocate memory for %d integers\n", max_pixel);
-    return(-1);
-  }
-  total_r = (int *) malloc(sizeof(int) * max_pixel);
-  if (!total_r) {
-    fprintf(stderr, "rasterize: failed to allocate memory for %d integers\n", max_pixel);
-    return(-1);
-  }
-  total_m = (int *) malloc(sizeof(int) * max_pixel);
-  if (!total_m) {
-    fprintf(stderr, "rasterize: failed to allocate memory for %d integers\n", max_pixel);
-    return(-1);
-  }
-
-  /* build lists of starting indices of each pixel and total number of polygons in each pixel */
-  ier = pixel_list(nhealpix_poly, poly, max_pixel, start_r, total_r);
+  /* build directories of starting indices of each pixel and total number of polygons in each pixel */
+  ier = pixel_dir(nhealpix_poly, poly, &dir_r);
   if (ier == -1) {
     fprintf(stderr, "rasterize: error building pixel index lists for rasterizer polygons\n");
     return(-1);
   }
 
-  ier = pixel_list(npoly-nhealpix_poly, &(poly[nhealpix_poly]), max_pixel, start_m, total_m);
+  ier = pixel_dir(npoly-nhealpix_poly, &(poly[nhealpix_poly]), &dir_m);
   if (ier == -1) {
     fprintf(stderr, "rasterize: error building pixel index lists for input mask polygons\n");
     return(-1);
   }
 
-  /* correction due to the start_m array's offset */
-  for (i = min_pixel; i < max_pixel; i++) {
-    start_m[i] += nhealpix_poly;
+  /* correction due to the dir_m.start array's offset */
+  for (im = 0; im < dir_m.npix; im++) {
+    dir_m.start[im] += nhealpix_poly;
   }
 
   j=0;
 
-  /* compute intersection of each input mask polygon with each rasterizer polygon */
-  for (ipix = min_pixel; ipix < max_pixel; ipix++) {
-    begin_r = start_r[ipix];
-    end_r = start_r[ipix] + total_r[ipix];
-    begin_m = start_m[ipix];
-    end_m = start_m[ipix] + total_m[ipix];
+  /* compute intersection of each input mask polygon with each rasterizer polygon,
+     in each pixel occupied by both, stepping through the two directories together */
+  ir = 0;
+  for (im = 0; im < dir_m.npix; im++) {
+    while (ir < dir_r.npix && dir_r.pixel[ir] < dir_m.pixel[im]) ir++;
+    if (ir == dir_r.npix) break;
+    if (dir_r.pixel[ir] != dir_m.pixel[im]) continue;
+    begin_r = dir_r.start[ir];
+    end_r = dir_r.start[ir] + dir_r.total[ir];
+    begin_m = dir_m.start[im];
+    end_m = dir_m.start[im] + dir_m.total[im];
 
     for (ipoly = begin_m; ipoly < end_m; ipoly++) {
       /* disregard any null polygons */
@@ -464,7 +510,7 @@ int rasterize(int nhealpix_poly, int npoly, polygon *poly[/*npoly*/], int npolys
 	  }
 	}
 	if(!sliceordice){
-	  k=(int)((poly[i]->id)-rastid_min);
+	  k=weight_index(poly[i]->id, nweights, rast_id);
 	  weights[k] += (area_i)*(poly[ipoly]->weight);
 	}
       }
@@ -479,7 +525,7 @@ int rasterize(int nhealpix_poly, int npoly, polygon *poly[/*npoly*/], int npolys
       else{
 	weights[i]=0;
 	if (strcmp(fmt.out, "healpix_weight") == 0) {
-	  fprintf(stderr,"WARNING: rasterize: area of rasterizer polygon %d is zero.  Assigning zero weight.\n",i);
+	  fprintf(stderr,"WARNING: rasterize: area of rasterizer polygon %lld is zero.  Assigning zero weight.\n",rast_id[i]);
 	}
       }
     }
@@ -501,10 +547,8 @@ int rasterize(int nhealpix_poly, int npoly, polygon *poly[/*npoly*/], int npolys
   }
   
 
-  free(start_r);
-  free(start_m); 
-  free(total_r);
-  free(total_m);
+  free_pixel_dir(&dir_r);
+  free_pixel_dir(&dir_m);
   free(areas);
  
   return(n);
@@ -516,3 +560,373 @@ int rasterize(int nhealpix_poly, int npoly, polygon *poly[/*npoly*/], int npolys
   return(-1);
 
 }
+
+/*-------------------------------------------------------------------------
+  Compare long longs, for sorting.
+*/
+int llcmp(const void *a, const void *b)
+{
+  long long x = *(const long long *)a, y = *(const long long *)b;
+
+  return((x < y)? -1 : (x > y)? 1 : 0);
+}
+
+/*-------------------------------------------------------------------------
+  Index of the weight of a rasterizer polygon.
+
+  Input: id = id number of rasterizer polygon.
+         nweights = number of weights.
+	 rast_id = rasterizer id of each weight, in increasing order.
+  Return value: index of id in rast_id,
+                or -1 if it is not there.
+*/
+int weight_index(long long id, int nweights, long long rast_id[/*nweights*/])
+{
+  int lo, hi, mid;
+
+  /* consecutive ids, as from a rasterizer file */
+  if (nweights > 0 && rast_id[nweights - 1] - rast_id[0] == nweights - 1) {
+    return((id >= rast_id[0] && id <= rast_id[nweights - 1])? (int)(id - rast_id[0]) : -1);
+  }
+
+  lo = 0;
+  hi = nweights;
+  while (lo < hi) {
+    mid = (lo + hi) / 2;
+    if (rast_id[mid] < id) lo = mid + 1;
+    else hi = mid;
+  }
+  return((lo < nweights && rast_id[lo] == id)? lo : -1);
+}
+
+/*-------------------------------------------------------------------------
+  Split a rasterizer polygon into the pixels of the mask, descending only
+  into pixels that are, or contain, pixels of the mask, as pixelize would
+  if it stopped at the pixels of the mask.
+
+  Input: pix = pixel containing rpoly.
+         rpoly = rasterizer polygon, or the part of it in pix.
+	 c, cmc = cap containing rpoly.
+	 mask = directory of the pixels of the mask.
+	 need = directory of the pixels of the mask and their parents.
+  Output: piece = array of *npiece pointers to the parts of rpoly in pixels of the mask,
+                  reallocated as it grows.
+  Return value: 0 if ok, -1 if error occurred.
+*/
+int rasterizer_loop(long long pix, polygon *rpoly, vec c, real_t cmc, pixeldir *mask, pixeldir *need, polygon ***piece, int *npiece)
+{
+  int children, i, inside, ip, iprune, ier, in;
+  long long child_pix[117];
+  polygon *pixel, *part, **more;
+
+  children = (pix == 0 && scheme == 'd')? 117 : (pix == 0 && scheme == 'h')? 12 : 4;
+  if (get_child_pixels(pix, child_pix, scheme)) return(-1);
+
+  for (i = 0; i < children; i++) {
+    if (pixel_find(need, child_pix[i]) == -1) continue;
+
+    /* the pixel belongs to the pixel cache, and is not used after the recursion below */
+    pixel = pixel_poly(child_pix[i], scheme);
+    if (!pixel) {
+      fprintf(stderr, "rasterize: could not get pixel %lld\n", child_pix[i]);
+      return(-1);
+    }
+
+    /* rasterizer polygons are mostly far smaller than the pixels */
+    inside = 1;
+    for (ip = 0; ip < pixel->np; ip++) {
+      in = cap_in_cap(c, cmc, pixel->rp[ip], pixel->cm[ip]);
+      if (in == -1) break;
+      if (in == 0) inside = 0;
+    }
+    if (ip < pixel->np) continue;
+
+    part = new_poly(rpoly->np + ((inside)? 0 : pixel->np));
+    if (!part) {
+      fprintf(stderr, "rasterize: failed to allocate memory for polygon of %d caps\n", rpoly->np + pixel->np);
+      return(-1);
+    }
+    if (inside) {
+      copy_poly(rpoly, part);
+    } else {
+      poly_poly(rpoly, pixel, part);
+      iprune = prune_poly(part, mtol);
+      if (iprune == -1) {
+	fprintf(stderr, "rasterize: failed to prune rasterizer polygon %lld for pixel %lld; continuing ...\n", rpoly->id, child_pix[i]);
+      }
+      if (iprune >= 2) {
+	free_poly(part);
+	continue;
+      }
+    }
+    part->pixel = child_pix[i];
+
+    if (pixel_find(mask, child_pix[i]) != -1) {
+      more = (polygon **) realloc(*piece, sizeof(polygon *) * (*npiece + 1));
+      if (!more) {
+	fprintf(stderr, "rasterize: failed to allocate memory for %d polygon pointers\n", *npiece + 1);
+	free_poly(part);
+	return(-1);
+      }
+      *piece = more;
+      (*piece)[(*npiece)++] = part;
+    } else {
+      ier = rasterizer_loop(child_pix[i], part, c, cmc, mask, need, piece, npiece);
+      free_poly(part);
+      if (ier == -1) return(-1);
+    }
+  }
+  return(0);
+}
+
+/*-------------------------------------------------------------------------
+  Descend the HEALPix NESTED hierarchy below a pixel, keeping only the mask
+  polygons not excluded from the pixel by one of their caps.
+
+  Input: n, p = HEALPix nside and NESTED number of pixel.
+         nside = HEALPix nside of footprint.
+	 ncand = number of mask polygons that may overlap pixel p.
+	 cand = indices of those mask polygons.
+	 scratch = space for the candidates of the descendants of p.
+	 poly = array of pointers to mask polygons.
+  Output: hpix = array of *nhpix pixels at nside, of size *mhpix,
+                 reallocated as it grows.
+  Return value: 0 if ok, -1 if error occurred.
+*/
+int footprint_loop(int n, int p, int nside, int ncand, int cand[], int scratch[], polygon *poly[], int *nhpix, int *mhpix, int **hpix)
+{
+  int child, i, ip, k, *more;
+  real_t cmc, th;
+  polygon *hpoly;
+
+  if (n == nside) {
+    if (*nhpix >= *mhpix) {
+      *mhpix = (*mhpix > 0)? 2 * *mhpix : 1024;
+      more = (int *) realloc(*hpix, sizeof(int) * *mhpix);
+      if (!more) {
+	fprintf(stderr, "rasterize: failed to allocate memory for %d HEALPix pixels\n", *mhpix);
+	return(-1);
+      }
+      *hpix = more;
+    }
+    (*hpix)[(*nhpix)++] = p;
+    return(0);
+  }
+
+  /* the fifth cap of a HEALPix polygon passes through its corners, but the pixel
+     bulges out of it a little, as do the polygons of its descendants,
+     so widen it by half */
+  hpoly = get_healpix_poly(n, p);
+  if (!hpoly) return(-1);
+  th = 3. * asinl(sqrtl(hpoly->cm[4] / 2.));
+  cmc = (th < PI)? 2. * sinl(th / 2.) * sinl(th / 2.) : 2.;
+
+  /* a polygon is excluded from the pixel if the pixel is outside any one of its caps */
+  k = 0;
+  for (i = 0; i < ncand; i++) {
+    for (ip = 0; ip < poly[cand[i]]->np; ip++) {
+      if (cap_in_cap(hpoly->rp[4], cmc, poly[cand[i]]->rp[ip], poly[cand[i]]->cm[ip]) == -1) break;
+    }
+    if (ip == poly[cand[i]]->np) scratch[k++] = cand[i];
+  }
+  free_poly(hpoly);
+  if (k == 0) return(0);
+
+  for (child = 4 * p; child < 4 * p + 4; child++) {
+    if (footprint_loop(2 * n, child, nside, k, scratch, &scratch[k], poly, nhpix, mhpix, hpix) == -1) return(-1);
+  }
+  return(0);
+}
+
+/*-------------------------------------------------------------------------
+  Find the HEALPix pixels that may overlap a mask, so that a mask covering
+  a small part of the sky does not cost all 12 nside^2 pixels.  A pixel is
+  kept if it is a child of a pixel whose bounding cap is not outside one of
+  the caps of every mask polygon; the children are left to rasterizer_loop.
+
+  Input: nside = HEALPix nside.
+         npoly = number of mask polygons.
+	 poly = array of pointers to mask polygons.
+  Output: *hpix = array of HEALPix pixels, in NESTED order.
+  Return value: number of pixels,
+                or -1 if error occurred.
+*/
+int healpix_footprint(int nside, int npoly, polygon *poly[/*npoly*/], int **hpix)
+{
+  int i, levels, mhpix, n, nhpix, p, *cand, *more;
+
+  /* candidate mask polygons at each level of the descent */
+  for (levels = 1, n = 1; n < nside; n *= 2) levels++;
+  cand = (int *) malloc(sizeof(int) * npoly * (levels + 1));
+  if (!cand) {
+    fprintf(stderr, "rasterize: failed to allocate memory for %d ints\n", npoly * (levels + 1));
+    return(-1);
+  }
+  for (i = 0; i < npoly; i++) cand[i] = i;
+
+  *hpix = 0x0;
+  nhpix = 0;
+  mhpix = 0;
+  if (nside == 1) {
+    /* too few pixels to bother */
+    for (i = 0; i < 12; i++) {
+      if (footprint_loop(1, i, 1, npoly, cand, &cand[npoly], poly, &nhpix, &mhpix, hpix) == -1) return(-1);
+    }
+  } else {
+    for (i = 0; i < 12; i++) {
+      if (footprint_loop(1, i, nside / 2, npoly, cand, &cand[npoly], poly, &nhpix, &mhpix, hpix) == -1) return(-1);
+    }
+    /* children of the pixels at nside / 2, in place */
+    if (4 * nhpix > mhpix) {
+      mhpix = 4 * nhpix;
+      more = (int *) realloc(*hpix, sizeof(int) * mhpix);
+      if (!more) {
+	fprintf(stderr, "rasterize: failed to allocate memory for %d HEALPix pixels\n", mhpix);
+	return(-1);
+      }
+      *hpix = more;
+    }
+    for (i = nhpix - 1; i >= 0; i--) {
+      p = (*hpix)[i];
+      for (n = 0; n < 4; n++) (*hpix)[4 * i + n] = 4 * p + n;
+    }
+    nhpix *= 4;
+  }
+
+  free(cand);
+  return(nhpix);
+}
+
+/*-------------------------------------------------------------------------
+  Generate the HEALPix rasterizer polygons at nside over a mask, in place
+  of a rasterizer file made by healpixpolys and pixelize: each HEALPix pixel
+  near the mask is split into the pixels of the mask, and parts outside the
+  pixels of the mask are discarded.  The HEALPix pixels are generated in
+  chunks, in parallel.
+
+  Input: nside = HEALPix nside of rasterizer polygons.
+         npoly = number of mask polygons.
+	 poly = array of pointers to mask polygons.
+	 npolys = maximum number of rasterizer polygons.
+  Output: polys = array of pointers to rasterizer polygons.
+  Return value: number of rasterizer polygons,
+                or -1 if error occurred.
+*/
+int healpix_rasterizer(int nside, int npoly, polygon *poly[/*npoly*/], int npolys, polygon *polys[/*npolys*/])
+{
+#define HEALPIX_CHUNK		65536
+  int i, ier, ip, k, n, nchunk, nhpix, hpix0, r, res;
+  int *hpix, *footprint, *npiece;
+  long long parent_pixels[RES_LIMIT + 1];
+  polygon **chunk, ***piece;
+  pixeldir mask, need;
+
+  /* pixels of the mask */
+  poly_sort(npoly, poly, 'p');
+  ier = pixel_dir(npoly, poly, &mask);
+  if (ier == -1) {
+    fprintf(stderr, "rasterize: error building pixel index lists for input mask polygons\n");
+    return(-1);
+  }
+
+  /* pixels of the mask and their parents */
+  need.npix = 0;
+  need.pixel = (long long *) malloc(sizeof(long long) * mask.npix * (RES_LIMIT + 1));
+  need.start = need.total = 0x0;
+  if (!need.pixel) {
+    fprintf(stderr, "rasterize: failed to allocate memory for %d long longs\n", mask.npix * (RES_LIMIT + 1));
+    return(-1);
+  }
+  for (ip = 0; ip < mask.npix; ip++) {
+    res = get_res(mask.pixel[ip], scheme);
+    if (res == -1 || get_parent_pixels(mask.pixel[ip], parent_pixels, scheme)) return(-1);
+    for (r = 0; r <= res; r++) need.pixel[need.npix++] = parent_pixels[r];
+  }
+  mysort(need.pixel, need.npix, sizeof(long long), llcmp);
+  for (i = k = 0; i < need.npix; i++) {
+    if (k == 0 || need.pixel[i] != need.pixel[k - 1]) need.pixel[k++] = need.pixel[i];
+  }
+  need.npix = k;
+
+  /* HEALPix pixels near the mask */
+  nhpix = healpix_footprint(nside, npoly, poly, &footprint);
+  if (nhpix == -1) return(-1);
+
+  npiece = (int *) malloc(sizeof(int) * HEALPIX_CHUNK);
+  chunk = (polygon **) malloc(sizeof(polygon *) * HEALPIX_CHUNK);
+  piece = (polygon ***) malloc(sizeof(polygon **) * HEALPIX_CHUNK);
+  if (!npiece || !chunk || !piece) {
+    fprintf(stderr, "rasterize: failed to allocate memory for %d HEALPix pixels\n", HEALPIX_CHUNK);
+    return(-1);
+  }
+
+  n = 0;
+  for (hpix0 = 0; hpix0 < nhpix; hpix0 += nchunk) {
+    nchunk = (nhpix - hpix0 < HEALPIX_CHUNK)? nhpix - hpix0 : HEALPIX_CHUNK;
+    hpix = &footprint[hpix0];
+    ier = healpix_polys(nside, nchunk, hpix, chunk);
+    if (ier == -1) {
+      fprintf(stderr, "rasterize: failed to generate HEALPix rasterizer polygons\n");
+      return(-1);
+    }
+
+    /* split each HEALPix pixel into the pixels of the mask; the fifth cap of a HEALPix polygon contains it */
+    ier = 0;
+#ifdef	_OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+    for (i = 0; i < nchunk; i++) {
+      npiece[i] = 0;
+      piece[i] = 0x0;
+      if (pixel_find(&mask, 0) != -1) {
+	/* unpixelized mask */
+	piece[i] = (polygon **) malloc(sizeof(polygon *));
+	if (piece[i]) {
+	  piece[i][npiece[i]++] = chunk[i];
+	  chunk[i] = 0x0;
+	} else {
+	  fprintf(stderr, "rasterize: failed to allocate memory for 1 polygon pointer\n");
+#ifdef	_OPENMP
+#pragma omp atomic write
+#endif
+	  ier = -1;
+	}
+      } else if (rasterizer_loop(0, chunk[i], chunk[i]->rp[4], chunk[i]->cm[4], &mask, &need, &piece[i], &npiece[i]) == -1) {
+#ifdef	_OPENMP
+#pragma omp atomic write
+#endif
+	ier = -1;
+      }
+      if (chunk[i]) free_poly(chunk[i]);
+    }
+    if (ier == -1) {
+      for (i = 0; i < nchunk; i++) {
+	for (k = 0; k < npiece[i]; k++) free_poly(piece[i][k]);
+	if (piece[i]) free(piece[i]);
+      }
+      return(-1);
+    }
+
+    for (i = 0; i < nchunk; i++) {
+      for (k = 0; k < npiece[i]; k++) {
+	if (n >= npolys) {
+	  fprintf(stderr, "rasterize: number of HEALPix rasterizer polygons exceeds maximum %d\n", npolys);
+	  fprintf(stderr, "if you need more space, enlarge NPOLYSMAX in defines.h, and recompile\n");
+	  return(-1);
+	}
+	polys[n++] = piece[i][k];
+      }
+      free(piece[i]);
+    }
+  }
+
+  msg("%d HEALPix rasterizer polygons generated at nside %d from %d of %lld HEALPix pixels, over %d pixels of the mask\n", n, nside, nhpix, 12 * (long long)nside * nside, mask.npix);
+
+  if (footprint) free(footprint);
+  free(npiece);
+  free(chunk);
+  free(piece);
+  free_pixel_dir(&mask);
+  free_pixel_dir(&need);
+  return(n);
+}
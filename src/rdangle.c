@@ -18,14 +18,14 @@
   Return value: 1 = ok,
 		otherwise error.
 */
-int rdangle(char *word, char **next, char unit, long double *angle)
+int rdangle(char *word, char **next, char unit, real_t *angle)
 {
     const char *blank = " \t\n\r";
     const char *number = "+-.0123456789eE";
 
     int i, ird, sgn;
     unsigned int deg, min;
-    long double sec;
+    real_t sec;
     char *ch;
 
     /* find first non-blank character */
@@ -41,7 +41,7 @@ int rdangle(char *word, char **next, char unit, long double *angle)
 	    sgn = -1;
 	    ch++;
 	}
-	ird = sscanf(ch, "%d %d %Lf", &deg, &min, &sec);
+	ird = sscanf(ch, "%d %d %" RL "f", &deg, &min, &sec);
 	*angle = sgn * ((sec/60. + min)/60. + deg);
 	for (i = 0; i < ird; i++) {
 	    while (*ch && strchr(blank, *ch)) ch++;
@@ -53,7 +53,7 @@ int rdangle(char *word, char **next, char unit, long double *angle)
 	   ird = 0;
 	}
     } else {
-	ird = sscanf(ch, "%Lf", angle);
+	ird = rdreal(ch, &ch, angle);
 	while (*ch && strchr(number, *ch)) ch++;
     }
 
@@ -0,0 +1,225 @@
+/*------------------------------------------------------------------------------
+  Read binary and FITS az, el files.
+------------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "azelfile.h"
+#include "manglefn.h"
+
+/* names of FITS columns, and TUNITs */
+static char *az_names[] = {"AZ", "RA", 0x0};
+static char *el_names[] = {"EL", "DEC", 0x0};
+static char *id_names[] = {"ID", 0x0};
+static char *weight_names[] = {"WEIGHT", 0x0};
+static char *unit_names[] = {"rad", "deg", "arcmin", "arcsec", "hour", "radian", "degree", "degrees", 0x0};
+static char unit_codes[] = "rdmshrdd";
+
+/*------------------------------------------------------------------------------
+  Read header of FITS az, el file.
+*/
+static int rdazel_fits_head(azelfile *file)
+{
+    int i, ird;
+
+    ird = rdfits_table(file->file, file->name, &file->table);
+    if (ird != 1) return(ird);
+
+    file->icol[0] = fits_column(&file->table, az_names);
+    file->icol[1] = fits_column(&file->table, el_names);
+    if (file->icol[0] == -1 || file->icol[1] == -1) {
+	fprintf(stderr, "rdazel_head: %s has no AZ and EL, or RA and DEC, columns\n", file->name);
+	free_fits_table(&file->table);
+	return(-1);
+    }
+    file->icol[2] = fits_column(&file->table, id_names);
+    file->icol[3] = fits_column(&file->table, weight_names);
+    if (file->icol[2] != -1) file->columns |= AZEL_ID;
+    if (file->icol[3] != -1) file->columns |= AZEL_WEIGHT;
+
+    for (i = 0; unit_names[i]; i++) {
+	if (strcmp(file->table.col[file->icol[0]].unit, unit_names[i]) == 0) {
+	    file->unit = unit_codes[i];
+	    break;
+	}
+    }
+    return(1);
+}
+
+/*------------------------------------------------------------------------------
+  Read header of binary or FITS az, el file.
+
+   Input: file = pointer to azelfile structure, with name, file and fmt set,
+		 and unit set to the unit to assume if the file does not say.
+  Output: file->columns, file->unit.
+  Return value:  1 = ok;
+		 0 = empty file;
+		-1 = error.
+*/
+int rdazel_head(azelfile *file)
+{
+    unsigned char head[AZEL_HEADSIZE];
+    int columns, version;
+    size_t nread;
+
+    file->columns = 0;
+    file->nrec = 0;
+    if (file->fmt == 'f') return(rdazel_fits_head(file));
+
+    nread = fread(head, 1, AZEL_HEADSIZE, file->file);
+    if (nread == 0) return(0);
+    if (nread < AZEL_HEADSIZE || memcmp(head, AZEL_MAGIC, 8) != 0) {
+	fprintf(stderr, "rdazel_head: %s is not a binary az, el file\n", file->name);
+	return(-1);
+    }
+
+    memcpy(&version, &head[8], sizeof(int));
+    memcpy(&columns, &head[12], sizeof(int));
+    if (version != AZEL_VERSION) {
+	if (version == (int)((unsigned int)AZEL_VERSION << 24)) {
+	    fprintf(stderr, "rdazel_head: %s was written on a machine of the opposite byte order\n", file->name);
+	} else {
+	    fprintf(stderr, "rdazel_head: %s has unknown version %d\n", file->name, version);
+	}
+	return(-1);
+    }
+    if (columns & ~(AZEL_ID | AZEL_WEIGHT | AZEL_POLYID)) {
+	fprintf(stderr, "rdazel_head: %s has unknown columns %d\n", file->name, columns);
+	return(-1);
+    }
+    if (!head[16] || !strchr(UNITS, head[16])) {
+	fprintf(stderr, "rdazel_head: %s has unknown angular unit %c\n", file->name, head[16]);
+	return(-1);
+    }
+
+    file->columns = columns;
+    file->unit = head[16];
+    return(1);
+}
+
+/*------------------------------------------------------------------------------
+  Report a value of a FITS column that could not be read.
+*/
+static void bad_value(azelfile *file, int icol, int ier)
+{
+    fprintf(stderr, "rdazel: row %lld of %s has %s %s\n", file->nrec + 1, file->name,
+	(ier == 1)? "undefined" : "non-integer or too large",
+	file->table.col[file->icol[icol]].name);
+}
+
+/*------------------------------------------------------------------------------
+  Read one row of FITS az, el file.
+  The table layout is freed at the end of the table, or on error.
+*/
+static int rdazel_fits(azelfile *file, azel *v, long long *id, real_t *weight)
+{
+    static THREADLOCAL unsigned char *row = 0x0;
+    static THREADLOCAL int rowlen = 0;
+    fitscol *col;
+    double d;
+    int i, ier;
+
+    if (file->nrec >= file->table.nrows) {
+	free_fits_table(&file->table);
+	return(0);
+    }
+
+    if (rowlen < file->table.rowlen) {
+	if (row) free(row);
+	rowlen = file->table.rowlen;
+	row = (unsigned char *) malloc(rowlen);
+	if (!row) {
+	    fprintf(stderr, "rdazel: failed to allocate memory for %d bytes\n", rowlen);
+	    rowlen = 0;
+	    free_fits_table(&file->table);
+	    return(-1);
+	}
+    }
+    if (fread(row, 1, file->table.rowlen, file->file) != (size_t)file->table.rowlen) {
+	fprintf(stderr, "rdazel: %s ends after %lld of %lld rows\n", file->name, file->nrec, file->table.nrows);
+	free_fits_table(&file->table);
+	return(-1);
+    }
+
+    col = file->table.col;
+    for (i = 0; i < 2; i++) {
+	ier = fits_getd(&row[col[file->icol[i]].offset], &col[file->icol[i]], &d);
+	if (ier) break;
+	if (i == 0) v->az = d; else v->el = d;
+    }
+    if (!ier && id) {
+	*id = 0;
+	i = 2;
+	if (file->icol[i] != -1) ier = fits_getk(&row[col[file->icol[i]].offset], &col[file->icol[i]], id);
+    }
+    if (!ier && weight) {
+	d = 1.;
+	i = 3;
+	if (file->icol[i] != -1) ier = fits_getd(&row[col[file->icol[i]].offset], &col[file->icol[i]], &d);
+	*weight = d;
+    }
+    if (ier) {
+	bad_value(file, i, ier);
+	free_fits_table(&file->table);
+	return(-1);
+    }
+    file->nrec++;
+    return(1);
+}
+
+/*------------------------------------------------------------------------------
+  Read one position from binary or FITS az, el file.
+
+   Input: file = pointer to azelfile structure, whose header has been read.
+  Output: v = az, el, in the units file->unit of the file.
+	  id = id, or 0 if the file has no id column;
+	       not set if id is null.
+	  weight = weight, or 1 if the file has no weight column;
+	       not set if weight is null.
+	  Any polyid column is skipped.
+  Return value:  1 = ok;
+		 0 = EOF;
+		-1 = error.
+*/
+int rdazel(azelfile *file, azel *v, long long *id, real_t *weight)
+{
+    unsigned char rec[5 * 8];
+    double az, el, w;
+    long long i;
+    size_t n, nread;
+
+    if (file->fmt == 'f') return(rdazel_fits(file, v, id, weight));
+
+    n = 16;
+    if (file->columns & AZEL_ID) n += 8;
+    if (file->columns & AZEL_WEIGHT) n += 8;
+    if (file->columns & AZEL_POLYID) n += 8;
+
+    nread = fread(rec, 1, n, file->file);
+    if (nread == 0) return(0);
+    if (nread < n) {
+	fprintf(stderr, "rdazel: %s ends in a partial record\n", file->name);
+	return(-1);
+    }
+
+    memcpy(&az, &rec[0], 8);
+    memcpy(&el, &rec[8], 8);
+    v->az = az;
+    v->el = el;
+    n = 16;
+    if (file->columns & AZEL_ID) {
+	memcpy(&i, &rec[n], 8);
+	n += 8;
+	if (id) *id = i;
+    } else if (id) {
+	*id = 0;
+    }
+    if (file->columns & AZEL_WEIGHT) {
+	memcpy(&w, &rec[n], 8);
+	if (weight) *weight = w;
+    } else if (weight) {
+	*weight = 1.;
+    }
+    file->nrec++;
+    return(1);
+}
@@ -264,19 +264,21 @@ int rdmask(char *name, format *fmt, int npolys, polygon *polys[/*npolys*/])
 char *get_keyword(char *str, char **str_rest, format *fmt)
 {
     const char *blank = " \t\n\r";
-    char *c=0;
-    int id, ird, n;
+    long long id, n;
 
-    char *word;
-    int ikey;
+    char *word, *next;
+    int alpha, ikey;
     size_t word_len;
 
     /* first word in str */
     word = get_word(str, blank, 0, &word_len);
     if (!word) return(0x0);
 
+    /* keywords start with a letter, whereas most lines of data start with a number */
+    alpha = ((*word >= 'a' && *word <= 'z') || (*word >= 'A' && *word <= 'Z'));
+
     /* compare first word in str against keywords */
-    for (ikey = 0; keywords[ikey]; ikey++) {
+    for (ikey = 0; alpha && keywords[ikey]; ikey++) {
 	if (strncmp(word, keywords[ikey], strlen(keywords[ikey])) == 0) {
 	   *str_rest = word + word_len;
 	   return(keywords[ikey]);
@@ -285,20 +287,17 @@ char *get_keyword(char *str, char **str_rest, format *fmt)
 
     /* format not yet specified, or spolygon */
     if (!fmt->in || strcmp(fmt->in, "spolygon") == 0) {
-      /* check for line starting with 2 integers, indicating spolygon format */
+      /* check for line starting with 2 integers followed by a blank, indicating spolygon format */
       //implemented fix from Guilhem Lavaux here  --Molly
-      c = (char *)malloc(1000);
-      ird = sscanf(str, "%d %d%[ \t\n]", &id, &n, c);
-      free(c);
-      c = 0;
-       if (ird == 3 && n >= 0) {
+      if (rdinteger(str, &next, &id) && rdinteger(next, &next, &n)
+	  && (*next == ' ' || *next == '\t' || *next == '\n') && n >= 0) {
 	*str_rest = word;
 	return(keywords[SPOLYGON]);
       }
     }
     
     /* check for possibly truncated keyword */
-    for (ikey = 0; keywords[ikey]; ikey++) {
+    for (ikey = 0; alpha && keywords[ikey]; ikey++) {
 	if (strlen(word) >= 4 && strncmp(word, keywords[ikey], 4) == 0) {
 	    msg("at line %d of %s: is  %.*s  supposed to be the keyword  %s ?\n", file.line_number, file.name, word_len, word, keywords[ikey]);
 	}
@@ -325,17 +324,19 @@ int new_fmt(char *keyword, char **line_rest, format *fmt)
     /* const char *generic_fmt = "%d ( %d caps, %Lf weight ...:"; */
     //const char *generic_fmt = "%d%*[^0-9]%d%*[^0-9-.]%Lf";
     //const char *edges_fmt = "%d%*[^0-9]%d%*[^0-9]%d%*[^0-9-.]%Lf";
-    const char *healpix_weight_fmt = "%d";
+    const char *healpix_weight_fmt = "%d [%d]";
     const char *skip_fmt = "%d";
     const char *end_fmt = "%d";
     const char *unit_fmt = " %c";
     const char *pix_fmt = "%d%c";
     const char *real_fmt = " %d";
-    char *word;
+    char *word, *next;
     char *blank = " \t\n\r";
     int ird, iscan, nholes, i, flag;
+    long long num;
     size_t word_len;
-    long double temp_pixel;
+    long long temp_pixel;
+    real_t temp_real;
     int res_max_temp;
     char scheme_temp;
 
@@ -386,6 +387,7 @@ int new_fmt(char *keyword, char **line_rest, format *fmt)
 	}
 	fmt->n = 1;
 	fmt->single = 0;
+	fmt->nside = 0;
 	ird = 0;
 	word = *line_rest;
 	do {
@@ -393,11 +395,12 @@ int new_fmt(char *keyword, char **line_rest, format *fmt)
 	   if (!word) break;
 	   switch (ird) {
 	   case 0: iscan = sscanf(word, "%d", &fmt->nweights);           break;
+	   case 1: iscan = sscanf(word, "%d", &fmt->nside);              break;
 	   }
 	   if (iscan == 1) ird++;
 	   word += word_len;
-	} while (word && ird < 1);
-	if (ird != 1) {
+	} while (word && ird < 2);
+	if (ird < 1) {
 	   WHERE;
 	   fprintf(stderr, " expecting line of format:\n");
 	   fprintf(stderr, "%s %s\n", keyword, healpix_weight_fmt);
@@ -410,18 +413,31 @@ int new_fmt(char *keyword, char **line_rest, format *fmt)
 	  fprintf(stderr, "%s %s\n", keyword, healpix_weight_fmt);
 	  return(-1);
 	}
-	/* check whether nweights is a valid number based on the HEALPix pixelization scheme */
-	for (i=1; i<=8192; i=2*i) {
-       	    if (12*powl(i,2) == fmt->nweights) {
-	       flag = 1;
-	       break;
+	/* sparse map of some pixels at nside */
+	if (fmt->nside > 0) {
+	    for (i=1; i<=8192; i=2*i) {
+		if (i == fmt->nside) break;
 	    }
-	    else {
-	       flag = 0;
-	       continue;
+	    if (i > 8192 || fmt->nweights > 12*powl(fmt->nside,2)) {
+		fprintf(stderr, "error: input file does not contain a valid number of weights or nside according\n");
+		fprintf(stderr, "to the HEALPix pixelization scheme (see http://healpix.jpl.nasa.gov)\n");
+		return(-1);
+	    }
+	    flag = 1;
+	} else {
+	    /* check whether nweights is a valid number based on the HEALPix pixelization scheme */
+	    for (i=1; i<=8192; i=2*i) {
+		if (12*powl(i,2) == fmt->nweights) {
+		    flag = 1;
+		    break;
+		}
+		else {
+		    flag = 0;
+		    continue;
+		}
 	    }
+	    if (fmt->nweights == 1) flag = 1;
 	}
-	if (fmt->nweights == 1) flag = 1;
 	if (flag == 0) {
   	   fprintf(stderr, "error: input file does not contain a valid number of weights according\n");
 	   fprintf(stderr, "to the HEALPix pixelization scheme (see http://healpix.jpl.nasa.gov)\n");
@@ -443,10 +459,14 @@ int new_fmt(char *keyword, char **line_rest, format *fmt)
 		word = get_word(word, blank, 0, &word_len);
 		if (!word) break;
 		switch (ird) {
-		case 0:	iscan = sscanf(word, "%lld", &fmt->id);		break;
-		case 1:	iscan = sscanf(word, "%d", &fmt->innve);	break;
-		case 2:	iscan = sscanf(word, "%d", &fmt->n);		break;
-		case 3:	iscan = sscanf(word, "%Lf", &fmt->weight);	break;
+		case 0:	iscan = rdinteger(word, &next, &fmt->id);	break;
+		case 1:	iscan = rdinteger(word, &next, &num);
+			if (iscan) fmt->innve = num;
+			break;
+		case 2:	iscan = rdinteger(word, &next, &num);
+			if (iscan) fmt->n = num;
+			break;
+		case 3:	iscan = rdreal(word, &next, &fmt->weight);	break;
 		}
 		if (iscan == 1) ird++;
 		word += word_len;
@@ -462,13 +482,21 @@ int new_fmt(char *keyword, char **line_rest, format *fmt)
 		word = get_word(word, blank, 0, &word_len);
 		if (!word) break;
 		switch (ird) {
-		case 0:	iscan = sscanf(word, "%lld", &fmt->id);          break;
-		case 1:	iscan = sscanf(word, "%d", &fmt->n);           break;
-		case 2:	iscan = sscanf(word, "%Lf", &fmt->weight);     break;
+		case 0:	iscan = rdinteger(word, &next, &fmt->id);	break;
+		case 1:	iscan = rdinteger(word, &next, &num);
+			if (iscan) fmt->n = num;
+			break;
+		case 2:	iscan = rdreal(word, &next, &fmt->weight);	break;
 		case 3:	
 		  /* checks to see if 3rd number is an integer - if it is, assume its a pixel number */
-		  iscan = sscanf(word, "%Lf", &temp_pixel);
-		  fmt->pixel=(floorl(temp_pixel)-temp_pixel==0) ? (int)temp_pixel :0;
+		  /* read as an integer, so a 64-bit pixel number loses no precision */
+		  iscan = rdinteger(word, &next, &temp_pixel);
+		  if (iscan == 1 && *next != '.' && *next != 'e' && *next != 'E') {
+		    fmt->pixel = temp_pixel;
+		  } else {
+		    iscan = rdreal(word, &next, &temp_real);
+		    fmt->pixel = 0;
+		  }
 		  break;
 		}
 		if (iscan == 1) ird++;
@@ -606,9 +634,9 @@ int new_fmt(char *keyword, char **line_rest, format *fmt)
 	fprintf(stderr, " expecting integer following keyword real\n");
 	return(-1);
       }
-      if(real==8){
-	fprintf(stderr,"WARNING: this polygon file was produced with the real*8 version of mangle and could produce bugs if used with the real*10 version.\n");
-      } else if(real!=10){
+      if((real==8 || real==10) && real!=REAL){
+	fprintf(stderr,"WARNING: this polygon file was produced with the real*%d version of mangle and could produce bugs if used with the real*%d version.\n",real,REAL);
+      } else if(real!=10 && real!=8){
 	WHERE;
 	fprintf(stderr," integer following keyword real should be either 8 or 10 to denote a file made with the real*8 or real*10 version of mangle.\n");
 	return(-1);
@@ -730,7 +758,7 @@ int get_nang(format *fmt, char *lin, int nh)
     char unit;
     char *next, *word;
     int i, iang, ird;
-    long double angle;
+    real_t angle;
 
     word = lin;
     iang = 0;
@@ -808,8 +836,8 @@ polygon *get_poly(format *fmt)
     }
 
     if (poly) {
-	/* id number */
-	poly->id = fmt->id;
+	/* id number; HEALPix polygons are numbered by their pixel */
+	if (strcmp(fmt->in, "healpix_weight") != 0) poly->id = fmt->id;
         /* pixel number */
 	poly->pixel = fmt->pixel;
 	/* weight */
@@ -834,6 +862,7 @@ polygon *get_poly(format *fmt)
 polygon *rd_poly(format *fmt)
 {
     int ip, ird;
+    char *next;
     polygon *poly = 0x0;
 
     /* allocate memory for new polygon */
@@ -846,6 +875,7 @@ polygon *rd_poly(format *fmt)
 
     /* read caps */
     poly->np = fmt->n;
+    poly->areaok = 0;
     for (ip = 0; ip < fmt->n; ip++) {
 	/* read line of data */
 	ird = rdline(&file);
@@ -859,8 +889,11 @@ polygon *rd_poly(format *fmt)
 	    exit(1);
 	}
 	/* read rp and cm of cap from line */
-	ird = sscanf(file.line, "%Lf %Lf %Lf %Lf",
-	    &poly->rp[ip][0], &poly->rp[ip][1], &poly->rp[ip][2], &poly->cm[ip]);
+	next = file.line;
+	ird = rdreal(next, &next, &poly->rp[ip][0]);
+	if (ird == 1) ird += rdreal(next, &next, &poly->rp[ip][1]);
+	if (ird == 2) ird += rdreal(next, &next, &poly->rp[ip][2]);
+	if (ird == 3) ird += rdreal(next, &next, &poly->cm[ip]);
 	if (ird != 4) {
 	    WHERE;
 	    fprintf(stderr, " expecting 4 reals\n");
@@ -875,7 +908,7 @@ polygon *rd_poly(format *fmt)
 /*------------------------------------------------------------------------------
   Read polygon from HEALPix weights; in other words, simply read in the weights
   from the input file and use get_healpix_poly to assign each to the correct
-  HEALPix polygon.
+  HEALPix polygon.  In a sparse map, each weight is followed by its pixel.
 
   Input: fmt = pointer to format structure.
   Return value: pointer to polygon.
@@ -884,8 +917,9 @@ polygon *rd_poly(format *fmt)
 polygon *rd_hpix(format *fmt)
 {
   int nweight, ird, nside;
+  long long hpix;
   polygon *poly;
-  long double weight;
+  real_t weight;
 
   if(fmt->nweights == 0) return(0x0);
 
@@ -902,16 +936,15 @@ polygon *rd_hpix(format *fmt)
      return(0x0);
   }
 
-  /* allocate memory for new polygon */
-  poly = new_poly(5);
-  if (!poly) {
-     WHERE;
-     fprintf(stderr, " failed to allocate memory for polygon of 5 caps\n");
-     return(0x0);
+  /* read weight, and pixel of sparse map, from line */
+  if (fmt->nside > 0) {
+    ird = sscanf(file.line, "%" RL "f %lld", &weight, &hpix);
+    if (ird == 2) ird = 1;
+    else if (ird == 1) ird = 0;
+  } else {
+    ird = sscanf(file.line, "%" RL "f", &weight);
+    hpix = fmt->id;
   }
-
-  /* read weight from line */
-  ird = sscanf(file.line, "%Lf", &weight);
   /* comment line at top of input file */
   if (ird != 1 && fmt->id == 0) {
      return(0x0);
@@ -928,14 +961,12 @@ polygon *rd_hpix(format *fmt)
   if (ird == -1) {
       WHERE;
       fprintf(stderr, " unexpected EOF: expecting 1 real\n");
-      free_poly(poly);
       exit(1);
   }
   /* incorrect line */
   if (ird != 1) {
       WHERE;
       fprintf(stderr, " expecting 1 real\n");
-      free_poly(poly);
       exit(1);
   }
 
@@ -946,14 +977,24 @@ polygon *rd_hpix(format *fmt)
     exit(1);
   }
 
-  nside = get_nside(fmt->nweights);
+  if (fmt->nside > 0) {
+    nside = fmt->nside;
+    if (hpix < 0 || hpix >= 12 * (long long)nside * nside) {
+      WHERE;
+      fprintf(stderr, " HEALPix pixel %lld out of range at nside %d\n", hpix, nside);
+      exit(1);
+    }
+  } else {
+    nside = get_nside(fmt->nweights);
+  }
 
   /* calculate correct HEALPix polygon */
-  poly = get_healpix_poly(nside, fmt->id);
+  poly = get_healpix_poly(nside, (int)hpix);
   if(!poly){
     fprintf(stderr, " error in calculating HEALPix polygon vertices\n");
     return(0x0);
   }
+  poly->id = hpix;
   poly->weight = weight;
   
   if(ird == 1 && (poly->cm[0] != 0 || poly->cm[1] != 0)) {
@@ -977,7 +1018,7 @@ polygon *rd_circ(format *fmt)
     char unit;
     char *next, *word;
     int i, iang, icirc, ird, ncirc;
-    long double angle[3];
+    real_t angle[3];
     polygon *poly = 0x0;
 
     /* point word to start of line */
@@ -1010,6 +1051,7 @@ polygon *rd_circ(format *fmt)
     /* read circles */
     iang = 0;
     poly->np = ncirc;
+    poly->areaok = 0;
     for (icirc = 0; icirc < ncirc; icirc++) {
 	/* read azimuth, elevation, radius of axis of circle from line */
 	for (i = 0; i < 3; i++) {
@@ -1040,7 +1082,7 @@ polygon *rd_circ(format *fmt)
 	if (fabsl(angle[2]) > PI) {
 	    WHERE;
 	    if (icirc > 0) fprintf(stderr, " %d'th", icirc + 1);
-	    fprintf(stderr, " circle has radius %.16Lg deg", places(angle[2] * 180./PI, 14));
+	    fprintf(stderr, " circle has radius %.16" RL "g deg", places(angle[2] * 180./PI, 14));
 	    if (angle[2] < -PI) {
 		fprintf(stderr, " < 180 deg\n");
 	    } else if (angle[2] > PI) {
@@ -1067,15 +1109,15 @@ polygon *rd_edge(format *fmt)
 #define ONEEDGESPECIAL	1
 /* number of extra edges to allocate, to allow for expansion */
 #define DNV		4
-    static vertices *vert = 0x0;
-    static int *ev = 0x0;
+    static THREADLOCAL vertices *vert = 0x0;
+    static THREADLOCAL int *ev = 0x0;
 
     const char *blank = " \t\n\r";
     char unit;
     char *next, *word;
     int anti, i, iang, iedge, iev, ird, iv, ive, ivert, nedge, nv, nve, nvert, reverse;
-    long double *angle;
-    long double az, el;
+    real_t *angle;
+    real_t az, el;
     polygon *poly = 0x0;
 
     /* point word to start of line */
@@ -1306,7 +1348,7 @@ polygon *rd_rect(format *fmt)
     char unit;
     char *next, *word;
     int i, iang, irect, ird, nrect;
-    long double angle[4];
+    real_t angle[4];
     polygon *poly = 0x0;
     polygon *poly_rect = 0x0;
 
@@ -1338,6 +1380,7 @@ polygon *rd_rect(format *fmt)
 	return(0x0);
     }
     poly->np=0;
+    poly->areaok=0;
 
     /* read rectangles */
     iang = 0;
@@ -0,0 +1,187 @@
+/*------------------------------------------------------------------------------
+  Fast, locale-free reading of numbers from text.
+------------------------------------------------------------------------------*/
+#include <float.h>
+#include <stdlib.h>
+#include "manglefn.h"
+
+/*
+  A decimal number of at most MAXDIG significant digits is an exact integer
+  in real_t, as is 10^k for k <= MAXPOW10; so m * 10^k or m / 10^k is a single
+  correctly rounded operation, the same result as strtold.
+  Anything else (more digits, huge exponents, inf, nan, hex) goes to strtold.
+*/
+#if !defined(REAL8) && LDBL_MANT_DIG == 64
+#define MAXDIG		19
+#define MAXPOW10	27
+#define STRTOR		strtold
+#else
+#define MAXDIG		15
+#define MAXPOW10	22
+#ifdef REAL8
+#define STRTOR		strtod
+#else
+#define STRTOR		strtold
+#endif
+#endif
+
+static const real_t pow10r[] = {
+    1e0L, 1e1L, 1e2L, 1e3L, 1e4L, 1e5L, 1e6L, 1e7L, 1e8L, 1e9L,
+    1e10L, 1e11L, 1e12L, 1e13L, 1e14L, 1e15L, 1e16L, 1e17L, 1e18L, 1e19L,
+    1e20L, 1e21L, 1e22L, 1e23L, 1e24L, 1e25L, 1e26L, 1e27L
+};
+
+#define ISBLANK(c)	((c) == ' ' || (c) == '\t' || (c) == '\n' || (c) == '\r' || (c) == '\f' || (c) == '\v')
+#define ISDIGIT(c)	((c) >= '0' && (c) <= '9')
+
+/*------------------------------------------------------------------------------
+  Read real number from word, as sscanf(word, "%Lf", x) would.
+
+   Input: word = pointer to string; leading blanks are skipped.
+  Output: *next = pointer to character immediately after number.
+	  x = number.
+  Return value: 1 = ok;
+		0 = no number.
+*/
+int rdreal(char *word, char **next, real_t *x)
+{
+    char *ch, *end;
+    int digits, dexp, e, esgn, nd, sgn, zeros;
+    unsigned long long m;
+
+    ch = word;
+    while (ISBLANK(*ch)) ch++;
+    word = ch;
+
+    sgn = 0;
+    if (*ch == '-') {
+	sgn = 1;
+	ch++;
+    } else if (*ch == '+') {
+	ch++;
+    }
+
+    /* hex is left to strtold */
+    if (ch[0] == '0' && (ch[1] == 'x' || ch[1] == 'X')) goto slow;
+
+    /* digits: m holds the significant digits, less any trailing zeros,
+       which are held in abeyance in zeros */
+    m = 0;
+    nd = 0;
+    zeros = 0;
+    digits = 0;
+    dexp = 0;
+    for (; ISDIGIT(*ch); ch++) {
+	digits++;
+	if (*ch == '0') {
+	    if (nd > 0) zeros++;
+	} else {
+	    if (nd + zeros >= MAXDIG) goto slow;
+	    for (; zeros > 0; zeros--) {
+		m *= 10;
+		nd++;
+	    }
+	    m = m * 10 + (*ch - '0');
+	    nd++;
+	}
+    }
+    if (*ch == '.') {
+	ch++;
+	for (; ISDIGIT(*ch); ch++) {
+	    digits++;
+	    dexp--;
+	    if (*ch == '0') {
+		if (nd > 0) zeros++;
+	    } else {
+		if (nd + zeros >= MAXDIG) goto slow;
+		for (; zeros > 0; zeros--) {
+		    m *= 10;
+		    nd++;
+		}
+		m = m * 10 + (*ch - '0');
+		nd++;
+	    }
+	}
+    }
+    if (digits == 0) goto slow;
+    dexp += zeros;
+
+    /* exponent, only if it has digits */
+    if (*ch == 'e' || *ch == 'E') {
+	end = ch + 1;
+	esgn = 1;
+	if (*end == '-') {
+	    esgn = -1;
+	    end++;
+	} else if (*end == '+') {
+	    end++;
+	}
+	if (ISDIGIT(*end)) {
+	    for (e = 0; ISDIGIT(*end); end++) {
+		if (e < 100000) e = e * 10 + (*end - '0');
+	    }
+	    dexp += esgn * e;
+	    ch = end;
+	}
+    }
+
+    if (m == 0) {
+	*x = (sgn)? -0. : 0.;
+    } else if (dexp >= 0 && dexp <= MAXPOW10) {
+	*x = (real_t)m * pow10r[dexp];
+	if (sgn) *x = -*x;
+    } else if (dexp < 0 && dexp >= -MAXPOW10) {
+	*x = (real_t)m / pow10r[-dexp];
+	if (sgn) *x = -*x;
+    } else {
+	goto slow;
+    }
+
+    *next = ch;
+    return(1);
+
+    slow:
+    *x = STRTOR(word, &end);
+    if (end == word) {
+	*next = word;
+	return(0);
+    }
+    *next = end;
+    return(1);
+}
+
+/*------------------------------------------------------------------------------
+  Read integer from word, as sscanf(word, "%lld", n) would.
+
+   Input: word = pointer to string; leading blanks are skipped.
+  Output: *next = pointer to character immediately after integer.
+	  n = integer.
+  Return value: 1 = ok;
+		0 = no integer.
+*/
+int rdinteger(char *word, char **next, long long *n)
+{
+    char *ch;
+    int sgn;
+    unsigned long long u;
+
+    ch = word;
+    while (ISBLANK(*ch)) ch++;
+
+    sgn = 0;
+    if (*ch == '-') {
+	sgn = 1;
+	ch++;
+    } else if (*ch == '+') {
+	ch++;
+    }
+    if (!ISDIGIT(*ch)) {
+	*next = word;
+	return(0);
+    }
+    for (u = 0; ISDIGIT(*ch); ch++) u = u * 10 + (*ch - '0');
+
+    *n = (sgn)? -(long long)u : (long long)u;
+    *next = ch;
+    return(1);
+}
@@ -67,7 +67,7 @@ int rdspher(char *filename, int *lmax_p, harmonic **w_p)
     /* read harmonics */
     for (iw = 0; iw < NW; iw++) {
 	for (i = 0; i < im; i++) {
-	    iscan = fscanf(file, "%Lg", &w[iw][i]);
+	    iscan = fscanf(file, "%" RL "g", &w[iw][i]);
 	    if (iscan != 1) {
 		fprintf(stderr, "rdspher: error reading line %d of %s\n", iw + 2, fn);
 		return(-1);
@@ -88,3 +88,62 @@ int rdspher(char *filename, int *lmax_p, harmonic **w_p)
 
     return(NW);
 }
+
+/*------------------------------------------------------------------------------
+  Read a band of spherical harmonics, from lmin to lmax.
+  Successive bands, starting from lmin = 0, read from the same file
+  give the same harmonics as rdspher, without all the harmonics
+  having to be held at once.
+
+   Input: file = file to read from.
+	  fn = name of file, for messages.
+	  lmin, lmax = minimum, maximum harmonic number of the band.
+  Input/Output: *lmaxw_p, *imw_p = maximum harmonic number in file,
+		and number of parts of each harmonic in file;
+		these are read from the header along with the band starting
+		at lmin = 0, and should be passed unchanged with later bands.
+  Output: w = array containing harmonics from lmin to lmax,
+	      those beyond the maximum harmonic number in file being zero;
+	      NW - NW0 = ((lmax + 1)(lmax + 2) - lmin (lmin + 1))/ 2
+	      is defined in harmonics.h.
+  Return value: number of (complex) harmonics read,
+		or -1 if error occurred.
+*/
+int rdspher_band(FILE *file, char *fn, int *lmaxw_p, int *imw_p, int lmin, int lmax, harmonic w[/*NW - NW0*/])
+{
+    int i, iscan, iw, lmaxr, nw, nwr;
+
+    /* read header */
+    if (lmin == 0) {
+	iscan = fscanf(file, "%d %d %d", lmaxw_p, imw_p, &nw);
+	if (iscan != 3) {
+	    fprintf(stderr, "rdspher_band: at line 1 of %s\n", fn);
+	    fprintf(stderr, " expecting 3 integers\n");
+	    return(-1);
+	}
+    }
+
+    /* zero harmonics */
+    for (iw = 0; iw < NW - NW0; iw++) {
+	for (i = 0; i < IM; i++) {
+	    w[iw][i] = 0.;
+	}
+    }
+
+    /* number of harmonics of band in file */
+    lmaxr = (*lmaxw_p < lmax)? *lmaxw_p : lmax;
+    nwr = (lmaxr >= lmin)? ((lmaxr + 1) * (lmaxr + 2)) / 2 - NW0 : 0;
+
+    /* read harmonics */
+    for (iw = 0; iw < nwr; iw++) {
+	for (i = 0; i < *imw_p; i++) {
+	    iscan = fscanf(file, "%" RL "g", &w[iw][i]);
+	    if (iscan != 1) {
+		fprintf(stderr, "rdspher_band: error reading line %d of %s\n", NW0 + iw + 2, fn);
+		return(-1);
+	    }
+	}
+    }
+
+    return(nwr);
+}
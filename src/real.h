@@ -0,0 +1,45 @@
+/*------------------------------------------------------------------------------
+  Floating point type of the geometry.
+------------------------------------------------------------------------------*/
+#ifndef REAL_H
+#define REAL_H
+
+#include <math.h>
+
+/*
+  real_t is equivalent to fortran's real(KR) of real.par.
+  It is long double (real*10) by default,
+  or double (real*8) if mangle is compiled with -DREAL8,
+  which gives up 3 digits for SSE arithmetic that the compiler can vectorize.
+
+  RL is the printf/scanf length modifier of real_t, as in "%" RL "g".
+
+  In the real*8 version, the long double maths functions are mapped
+  to their double counterparts, so the same sources serve both versions.
+*/
+#ifdef REAL8
+typedef double real_t;
+#define RL		"l"
+
+#define acosl		acos
+#define asinl		asin
+#define atan2l		atan2
+#define atanl		atan
+#define ceill		ceil
+#define cosl		cos
+#define fabsl		fabs
+#define floorl		floor
+#define fmodl		fmod
+#define frexpl		frexp
+#define ldexpl		ldexp
+#define log10l		log10
+#define logl		log
+#define powl		pow
+#define sinl		sin
+#define sqrtl		sqrt
+#else
+typedef long double real_t;
+#define RL		"L"
+#endif
+
+#endif	/* REAL_H */
@@ -6,12 +6,13 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include "azelfile.h"
 #include "inputfile.h"
 #include "manglefn.h"
 #include "defaults.h"
 
 /* getopt options */
-const char *optstr = "dqf:u:p:";
+const char *optstr = "dqf:u:p:FI:O:";
 
 /* local functions */
 void	usage(void);
@@ -100,8 +101,10 @@ int rotate(char *in_filename, char *out_filename, format *fmt)
     char *word, *next;
     char az_str[AZEL_STR_LEN], el_str[AZEL_STR_LEN];
     int ird, len, np;
-    long double circle;
+    long long id;
+    real_t circle, weight;
     azel vi, vf;
+    azelfile azelin, azelout;
     char *out_fn;
     FILE *outfile;
 
@@ -119,6 +122,17 @@ int rotate(char *in_filename, char *out_filename, format *fmt)
     }
     file.line_number = 0;
 
+    /* binary input: the header gives the angular units */
+    if (fmt->inazel != 't') {
+	azelin.name = file.name;
+	azelin.file = file.file;
+	azelin.fmt = fmt->inazel;
+	azelin.unit = fmt->inunit;
+	ird = rdazel_head(&azelin);
+	if (ird == -1) return(-1);
+	if (ird == 1) fmt->inunit = azelin.unit;
+    }
+
     /* open out_filename for writing */
     if (!out_filename || strcmp(out_filename, "-") == 0) {
 	outfile = stdout;
@@ -129,6 +143,7 @@ int rotate(char *in_filename, char *out_filename, format *fmt)
 	    fprintf(stderr, "cannot open %s for writing\n", out_filename);
 	    return(-1);
 	}
+	wrbuf(outfile);
 	out_fn = out_filename;
     }
 
@@ -137,11 +152,11 @@ int rotate(char *in_filename, char *out_filename, format *fmt)
 	/* multiple transformation */
 	if (strchr(fopt, ':')) {
 	    msg(" -f%s is equivalent to\n", fopt);
-	    msg(" -f%.16Lg,%.16Lg,%.16Lg%c\n",
+	    msg(" -f%.16" RL "g,%.16" RL "g,%.16" RL "g%c\n",
 		places(fmt->azn, 14), places(fmt->eln, 14), places(fmt->azp, 14), fmt->trunit);
 	/* single transformation */
 	} else {
-	    msg("rotate -f%.16Lg,%.16Lg,%.16Lg%c\n",
+	    msg("rotate -f%.16" RL "g,%.16" RL "g,%.16" RL "g%c\n",
 		fmt->azn, fmt->eln, fmt->azp, fmt->trunit);
 	}
     /* advise standard transformation */
@@ -150,7 +165,7 @@ int rotate(char *in_filename, char *out_filename, format *fmt)
 	    frames[fmt->inframe], frames[fmt->outframe]);
 	msg(" -f%s,%s is equivalent to\n",
 	    frames[fmt->inframe], frames[fmt->outframe]);
-        msg(" -f%.16Lg,%.16Lg,%.16Lg%c\n",
+        msg(" -f%.16" RL "g,%.16" RL "g,%.16" RL "g%c\n",
 	    places(fmt->azn, 14), places(fmt->eln, 14), places(fmt->azp, 14), fmt->trunit);
     }
 
@@ -169,43 +184,64 @@ int rotate(char *in_filename, char *out_filename, format *fmt)
     }
 
     /* write header */
-    vf.az = 0.;
-    wrangle(vf.az, fmt->outunit, fmt->outprecision, AZEL_STR_LEN, az_str);
-    len = strlen(az_str);
-    if (fmt->outunit == 'h') {
-	sprintf(az_str, "az(hms)");
-	sprintf(el_str, "el(dms)");
+    if (fmt->outazel != 't') {
+	/* carry any id and weight columns of binary input through */
+	azelout.name = out_fn;
+	azelout.file = outfile;
+	azelout.fmt = fmt->outazel;
+	azelout.columns = (fmt->inazel != 't')? (azelin.columns & (AZEL_ID | AZEL_WEIGHT)) : 0;
+	azelout.unit = fmt->outunit;
+	if (wrazel_head(&azelout) == -1) return(-1);
     } else {
-	sprintf(az_str, "az(%c)", fmt->outunit);
-	sprintf(el_str, "el(%c)", fmt->outunit);
+	vf.az = 0.;
+	wrangle(vf.az, fmt->outunit, fmt->outprecision, AZEL_STR_LEN, az_str);
+	len = strlen(az_str);
+	if (fmt->outunit == 'h') {
+	    sprintf(az_str, "az(hms)");
+	    sprintf(el_str, "el(dms)");
+	} else {
+	    sprintf(az_str, "az(%c)", fmt->outunit);
+	    sprintf(el_str, "el(%c)", fmt->outunit);
+	}
+	fprintf(outfile, "%*s %*s\n", len, az_str, len, el_str);
     }
-    fprintf(outfile, "%*s %*s\n", len, az_str, len, el_str);
 
     /* interpretive read/write loop */
     np = 0;
+    id = 0;
+    weight = 1.;
     while (1) {
-	/* read line */
-	ird = rdline(&file);
-	/* serious error */
-	if (ird == -1) return(-1);
-	/* EOF */
-	if (ird == 0) break;
-
-	/* read <az> */
-	word = file.line;
-	ird = rdangle(word, &next, fmt->inunit, &vi.az);
-	/* skip header */
-	if (ird != 1 && np == 0) continue;
-	/* otherwise exit on unrecognized characters */
-	if (ird != 1) break;
-
-	/* read <el> */
-	word = next;
-	ird = rdangle(word, &next, fmt->inunit, &vi.el);
-	/* skip header */
-	if (ird != 1 && np == 0) continue;
-	/* otherwise exit on unrecognized characters */
-	if (ird != 1) break;
+	if (fmt->inazel != 't') {
+	    /* read binary record */
+	    ird = rdazel(&azelin, &vi, &id, &weight);
+	    /* serious error */
+	    if (ird == -1) return(-1);
+	    /* EOF */
+	    if (ird == 0) break;
+	} else {
+	    /* read line */
+	    ird = rdline(&file);
+	    /* serious error */
+	    if (ird == -1) return(-1);
+	    /* EOF */
+	    if (ird == 0) break;
+
+	    /* read <az> */
+	    word = file.line;
+	    ird = rdangle(word, &next, fmt->inunit, &vi.az);
+	    /* skip header */
+	    if (ird != 1 && np == 0) continue;
+	    /* otherwise exit on unrecognized characters */
+	    if (ird != 1) break;
+
+	    /* read <el> */
+	    word = next;
+	    ird = rdangle(word, &next, fmt->inunit, &vi.el);
+	    /* skip header */
+	    if (ird != 1 && np == 0) continue;
+	    /* otherwise exit on unrecognized characters */
+	    if (ird != 1) break;
+	}
 
 	/* identity: treat specially to avoid loss of precision in scaling */
 	if (fmt->inframe == fmt->outframe) {
@@ -244,16 +280,24 @@ int rotate(char *in_filename, char *out_filename, format *fmt)
 	}
 
 	/* write result */
-	wrangle(vf.az, fmt->outunit, fmt->outprecision, AZEL_STR_LEN, az_str);
-	wrangle(vf.el, fmt->outunit, fmt->outprecision, AZEL_STR_LEN, el_str);
-	fprintf(outfile, "%s %s\n", az_str, el_str);
-	fflush(outfile);
+	if (fmt->outazel != 't') {
+	    if (wrazel(&azelout, &vf, id, weight, 0) == -1) return(-1);
+	} else {
+	    wrangle(vf.az, fmt->outunit, fmt->outprecision, AZEL_STR_LEN, az_str);
+	    wrangle(vf.el, fmt->outunit, fmt->outprecision, AZEL_STR_LEN, el_str);
+	    fprintf(outfile, "%s %s\n", az_str, el_str);
+	}
+	if (flush_lines) fflush(outfile);
 
         /* increment counters of results */
 	np++;
     }
+    if (fmt->outazel != 't') {
+	if (wrazel_end(&azelout) == -1) return(-1);
+    }
 
     if (outfile != stdout) {
+	wrclose(outfile);
 	msg("rotate: %d positions written to %s\n", np, out_fn);
     }
 
@@ -19,9 +19,9 @@ polygon *polys_global[NPOLYSMAX];
 /* local functions */
 void	usage(void);
 #ifdef	GCC
-int	rotatepolys(int npoly, polygon *[npoly], long double, long double, long double);
+int	rotatepolys(int npoly, polygon *[npoly], real_t, real_t, real_t);
 #else
-int	rotatepolys(int npoly, polygon *[/*npoly*/], long double, long double, long double);
+int	rotatepolys(int npoly, polygon *[/*npoly*/], real_t, real_t, real_t);
 #endif
 
 /*------------------------------------------------------------------------------
@@ -118,19 +118,19 @@ void usage(void)
   Return value: number of polygons weighted,
 		or -1 if error occurred.
 */
-int rotatepolys(int npoly, polygon *poly[/*npoly*/], long double azn,long double eln, long double azp)
+int rotatepolys(int npoly, polygon *poly[/*npoly*/], real_t azn,real_t eln, real_t azp)
 {
 #define AZEL_STR_LEN	32
 
   int ipoly, ip,j;
-  long double cpsi,spsi,ctheta,stheta,cphi,sphi,xold,yold,zold,r;
+  real_t cpsi,spsi,ctheta,stheta,cphi,sphi,xold,yold,zold,r;
   //rows of rotation matrix
   vec row0,row1, row2;
   char az_str[AZEL_STR_LEN], el_str[AZEL_STR_LEN];
   azel vf;
 
 
-  msg("Rotating polygons to new frame: azn=%Lf,eln=%Lf,azp=%Lf\n",azn,eln,azp);
+  msg("Rotating polygons to new frame: azn=%" RL "f,eln=%" RL "f,azp=%" RL "f\n",azn,eln,azp);
   if(pixelized==1){
     msg("NOTE: rotating polygons removes pixelization info - to repixelize in new frame, run pixelize again.\n");
   }
@@ -154,6 +154,7 @@ int rotatepolys(int npoly, polygon *poly[/*npoly*/], long double azn,long double
   
   for (ipoly = 0; ipoly < npoly; ipoly++) {
     poly[ipoly]->pixel=0;
+    poly[ipoly]->areaok=0;
     for (ip = 0; ip < poly[ipoly]->np; ip++) {
       /*
       rp_to_azel(poly[ipoly]->rp[ip],&vf);
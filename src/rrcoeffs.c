@@ -15,12 +15,27 @@ const char *optstr = "dqm:s:e:i:";
 /* allocate polygons as a global array */
 polygon *polys_global[NPOLYSMAX];
 
+/* one cap of one polygon, as an entry in the index of boundaries */
+typedef struct {
+  real_t *rp;
+  real_t cm;
+  int ipoly;
+  int ip;
+} capent;
+
+/* boundary shared by cap ip of poly[ipoly] and cap jp of poly[jpoly], jpoly < ipoly */
+typedef struct {
+  int ipoly, ip, jpoly, jp;
+  int ier;
+  real_t bound[2], vert[2];
+} abut;
+
 /* local functions */
 void	usage(void);
 #ifdef	GCC
-int	rrcoeffs(int npoly, polygon *[npoly], long double *, long double [2], long double[2]);
+int	rrcoeffs(int npoly, polygon *[npoly], real_t *, real_t [2], real_t[2]);
 #else
-int	rrcoeffs(int npoly, polygon *[/*npoly*/], long double *, long double [2], long double[2]);
+int	rrcoeffs(int npoly, polygon *[/*npoly*/], real_t *, real_t [2], real_t[2]);
 #endif
 
 /*------------------------------------------------------------------------------
@@ -29,7 +44,7 @@ int	rrcoeffs(int npoly, polygon *[/*npoly*/], long double *, long double [2], lo
 int main(int argc, char *argv[])
 {
     int ifile, nfiles, npoly, npolys, nws,i;
-    long double area, bound[2], vert[2];
+    real_t area, bound[2], vert[2];
     polygon **polys;
     polys=polys_global;
 
@@ -57,7 +72,7 @@ int main(int argc, char *argv[])
     if (mtol != 0.) {
 	scale(&mtol, munit, 's');
 	munit = 's';
-	msg("multiple intersections closer than %Lg%c will be treated as coincident\n", mtol, munit);
+	msg("multiple intersections closer than %" RL "g%c will be treated as coincident\n", mtol, munit);
 	scale(&mtol, munit, 'r');
 	munit = 'r';
     }
@@ -86,7 +101,7 @@ int main(int argc, char *argv[])
     if (npoly == -1) exit(1);
 
     /* advise area */
-    msg("area of (weighted^2) region is %.15Lg str\n", area);
+    msg("area of (weighted^2) region is %.15" RL "g str\n", area);
 
     /* write polygons */
     ifile = argc - 1;
@@ -113,6 +128,121 @@ void usage(void)
 */
 #include "parse_args.c"
 
+/*------------------------------------------------------------------------------
+  Order cap entries by axis and |cm|, then by polygon and cap.
+*/
+static int capent_cmp(const void *v1, const void *v2)
+{
+    const capent *c1 = (const capent *)v1, *c2 = (const capent *)v2;
+    real_t a1, a2;
+    int k;
+
+    for (k = 0; k < 3; k++) {
+	if (c1->rp[k] < c2->rp[k]) return(-1);
+	if (c1->rp[k] > c2->rp[k]) return(1);
+    }
+    a1 = fabsl(c1->cm);
+    a2 = fabsl(c2->cm);
+    if (a1 < a2) return(-1);
+    if (a1 > a2) return(1);
+    if (c1->ipoly != c2->ipoly) return(c1->ipoly - c2->ipoly);
+    return(c1->ip - c2->ip);
+}
+
+/*------------------------------------------------------------------------------
+  Order abutting pairs as the original double loop over ipoly, jpoly, ip, jp visits them.
+*/
+static int abut_cmp(const void *v1, const void *v2)
+{
+    const abut *a1 = (const abut *)v1, *a2 = (const abut *)v2;
+
+    if (a1->ipoly != a2->ipoly) return(a1->ipoly - a2->ipoly);
+    if (a1->jpoly != a2->jpoly) return(a1->jpoly - a2->jpoly);
+    if (a1->ip != a2->ip) return(a1->ip - a2->ip);
+    return(a1->jp - a2->jp);
+}
+
+/*------------------------------------------------------------------------------
+  Find all pairs of weighted polygons that abut along a common boundary,
+  i.e. where a cap of one has the same rp and the opposite cm of a cap of
+  the other.  Rather than comparing every pair of polygons, the caps of
+  all polygons are sorted on (rp, |cm|), so the two sides of a boundary
+  are adjacent.
+
+  Return value: number of abutting pairs, placed in *abuts,
+		or -1 if error occurred.
+*/
+static int find_abuts(int npoly, polygon *poly[/*npoly*/], abut **abuts)
+{
+    int ia, ie, ipoly, ip, i, j, nabut, ncap, nent;
+    capent *ent;
+    abut *ab;
+
+    *abuts = 0x0;
+
+    ncap = 0;
+    for (ipoly = 0; ipoly < npoly; ipoly++) {
+	if (poly[ipoly]->weight != 0.) ncap += poly[ipoly]->np;
+    }
+    if (ncap < 2) return(0);
+
+    ent = (capent *) malloc(sizeof(capent) * ncap);
+    if (!ent) {
+	fprintf(stderr, "rrcoeffs: failed to allocate memory for %d cap entries\n", ncap);
+	return(-1);
+    }
+    nent = 0;
+    for (ipoly = 0; ipoly < npoly; ipoly++) {
+	if (poly[ipoly]->weight == 0.) continue;
+	for (ip = 0; ip < poly[ipoly]->np; ip++) {
+	    ent[nent].rp = poly[ipoly]->rp[ip];
+	    ent[nent].cm = poly[ipoly]->cm[ip];
+	    ent[nent].ipoly = ipoly;
+	    ent[nent].ip = ip;
+	    nent++;
+	}
+    }
+    qsort(ent, nent, sizeof(capent), capent_cmp);
+
+    /* two passes: count, then fill */
+    ab = 0x0;
+    for (;;) {
+	nabut = 0;
+	for (ia = 0; ia < nent; ia = ie) {
+	    for (ie = ia + 1; ie < nent
+		&& ent[ie].rp[0] == ent[ia].rp[0]
+		&& ent[ie].rp[1] == ent[ia].rp[1]
+		&& ent[ie].rp[2] == ent[ia].rp[2]
+		&& fabsl(ent[ie].cm) == fabsl(ent[ia].cm); ie++);
+	    for (i = ia; i < ie; i++) {
+		for (j = i + 1; j < ie; j++) {
+		    if (ent[i].ipoly == ent[j].ipoly || ent[i].cm != - ent[j].cm) continue;
+		    if (ab) {
+			/* entries are sorted on ipoly, so ent[j] has the larger index */
+			ab[nabut].ipoly = ent[j].ipoly;
+			ab[nabut].ip = ent[j].ip;
+			ab[nabut].jpoly = ent[i].ipoly;
+			ab[nabut].jp = ent[i].ip;
+		    }
+		    nabut++;
+		}
+	    }
+	}
+	if (ab || nabut == 0) break;
+	ab = (abut *) malloc(sizeof(abut) * nabut);
+	if (!ab) {
+	    fprintf(stderr, "rrcoeffs: failed to allocate memory for %d abutting pairs\n", nabut);
+	    free(ent);
+	    return(-1);
+	}
+    }
+    free(ent);
+
+    if (ab) qsort(ab, nabut, sizeof(abut), abut_cmp);
+    *abuts = ab;
+    return(nabut);
+}
+
 /*------------------------------------------------------------------------------
   Coefficients of series expansion of correlation <WW> at angular separation th
   <WW> = 2 pi area
@@ -123,12 +253,13 @@ void usage(void)
   Return value: number of polygons for which area, bound, and vert were computed.
 		    or -1 if error occurred.
 */
-int rrcoeffs(int npoly, polygon *poly[/*npoly*/], long double *area, long double bound[2], long double vert[2])
+int rrcoeffs(int npoly, polygon *poly[/*npoly*/], real_t *area, real_t bound[2], real_t vert[2])
 {
-    int ier, ip, ipoly, jp, jpoly, ndone, ner, np;
-    long double darea, dbound[2], dvert[2], toli, tolj, ww;
-    harmonic dw[1];
-    polygon *polyij = 0x0;
+    int ier, ipoly, m, nabut, ndone, ner;
+    int *sier;
+    real_t ww;
+    real_t *sarea, *sbound, *svert, *stol;
+    abut *ab;
 
     /* initialize area, bound, and vert to zero */
     *area = 0.;
@@ -137,11 +268,112 @@ int rrcoeffs(int npoly, polygon *poly[/*npoly*/], long double *area, long double
     vert[0] = 0.;
     vert[1] = 0.;
 
+    if (npoly == 0) return(0);
+
+    /* self terms of each polygon */
+    sier = (int *) malloc(sizeof(int) * npoly);
+    sarea = (real_t *) malloc(sizeof(real_t) * npoly * 7);
+    if (!sier || !sarea) {
+	fprintf(stderr, "rrcoeffs: failed to allocate memory for %d polygons\n", npoly);
+	if (sier) free(sier);
+	if (sarea) free(sarea);
+	return(-1);
+    }
+    sbound = sarea + npoly;
+    svert = sbound + 2 * npoly;
+    stol = svert + 2 * npoly;
+
+    /* pairs of polygons that abut along a common boundary:
+       only these contribute cross terms */
+    nabut = find_abuts(npoly, poly, &ab);
+    if (nabut == -1) {
+	free(sier);
+	free(sarea);
+	return(-1);
+    }
+    msg("%d boundaries shared between weighted polygons\n", nabut);
+
+    ier = 0;
+#ifdef	_OPENMP
+#pragma omp parallel
+#endif
+    {
+	int i, j, np, lmax;
+	real_t tol;
+	harmonic dw[1];
+	polygon *polyij = 0x0;
+
+	lmax = 0;
+
+	/* contribution to correlation from self-correlation of polygons */
+#ifdef	_OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+	for (i = 0; i < npoly; i++) {
+	    sier[i] = 0;
+	    stol[i] = mtol;
+	    /* zero weight polygon requires no computation */
+	    if (poly[i]->weight == 0.) continue;
+	    /* compute area, bound, and vert */
+	    sier[i] = gspher(poly[i], lmax, &stol[i], &sarea[i], &sbound[2 * i], &svert[2 * i], dw);
+	    if (sier[i] == -1) {
+#ifdef	_OPENMP
+#pragma omp atomic write
+#endif
+		ier = -1;
+	    }
+	}
+
+	/* contribution to correlation from abutting polygons */
+#ifdef	_OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+	for (m = 0; m < nabut; m++) {
+	    i = ab[m].ipoly;
+	    j = ab[m].jpoly;
+
+	    /* make sure polyij contains enough space for intersection */
+	    np = poly[i]->np + poly[j]->np;
+	    if (room_poly(&polyij, np, DNP, 0) == -1) {
+		fprintf(stderr, "rrcoeffs: failed to allocate memory for polygon of %d caps\n", np + DNP);
+		ab[m].ier = -1;
+#ifdef	_OPENMP
+#pragma omp atomic write
+#endif
+		ier = -1;
+		continue;
+	    }
+
+	    /* make polygon which is the intersection of the 2 polygons */
+	    poly_poly(poly[i], poly[j], polyij);
+
+	    /* suppress abutting boundary from poly[jpoly] */
+	    polyij->cm[poly[i]->np + ab[m].jp] = 2.;
+
+	    /* compute bound and vert */
+	    tol = stol[i];
+	    ab[m].ier = gphbv(polyij, poly[i]->np, ab[m].ip, &tol, ab[m].bound, ab[m].vert);
+	    if (ab[m].ier == -1) {
+#ifdef	_OPENMP
+#pragma omp atomic write
+#endif
+		ier = -1;
+	    }
+	}
+
+	free_poly(polyij);
+    }
+    if (ier == -1) {
+	free(sier);
+	free(sarea);
+	if (ab) free(ab);
+	return(-1);
+    }
+
+    /* accumulate, in the same order as a serial double loop */
     ndone = 0;
     ner = 0;
-    lmax = 0;
-
-    /* each polygon */
+    m = 0;
     for (ipoly = 0; ipoly < npoly; ipoly++) {
 	ww = poly[ipoly]->weight * poly[ipoly]->weight;
 
@@ -149,18 +381,10 @@ int rrcoeffs(int npoly, polygon *poly[/*npoly*/], long double *area, long double
 	if (ww == 0.) {
 	    ndone++;
 	    continue;
-
-	/* contribution to correlation from self-correlation of polygons */
-	} else {
-	    /* compute area, bound, and vert */
-	    toli = mtol;
-	    ier = gspher(poly[ipoly], lmax, &toli, &darea, dbound, dvert, dw);
-	    if (ier == -1) return(-1);
-
 	}
 
 	/* computation failed */
-	if (ier) {
+	if (sier[ipoly]) {
 	    ner++;
 	    fprintf(stderr, "rrcoeffs: computation failed for polygon %d; discard it\n", ipoly);
 
@@ -168,65 +392,27 @@ int rrcoeffs(int npoly, polygon *poly[/*npoly*/], long double *area, long double
 	} else {
 	    ndone++;
 	    /* increment area, bound, and vert */
-	    *area += darea * ww;
-	    bound[0] += dbound[0] * ww;
-	    bound[1] += dbound[1] * ww;
-	    vert[0] += dvert[0] * ww;
-	    vert[1] += dvert[1] * ww;
-
+	    *area += sarea[ipoly] * ww;
+	    bound[0] += sbound[2 * ipoly] * ww;
+	    bound[1] += sbound[2 * ipoly + 1] * ww;
+	    vert[0] += svert[2 * ipoly] * ww;
+	    vert[1] += svert[2 * ipoly + 1] * ww;
 	}
 
-	/* contribution to correlation from abutting polygons */
-	for (jpoly = 0; jpoly < ipoly; jpoly++) {
-	    ww = - 2. * poly[ipoly]->weight * poly[jpoly]->weight;
-	    if (ww == 0.) continue;
-
-	    /* look for boundary dividing poly[ipoly] and poly[jpoly] */
-	    for (ip = 0; ip < poly[ipoly]->np; ip++) {
-
-		for (jp = 0; jp < poly[jpoly]->np; jp++) {
-
-		    /* poly[ipoly] and poly[jpoly] abut along a common boundary */
-		    if (poly[ipoly]->cm[ip] == - poly[jpoly]->cm[jp]
-			&& poly[ipoly]->rp[ip][0] == poly[jpoly]->rp[jp][0]
-			&& poly[ipoly]->rp[ip][1] == poly[jpoly]->rp[jp][1]
-			&& poly[ipoly]->rp[ip][2] == poly[jpoly]->rp[jp][2]) {
-
-			/* make sure polyij contains enough space for intersection */
-			np = poly[ipoly]->np + poly[jpoly]->np;
-			ier = room_poly(&polyij, np, DNP, 0);
-			if (ier == -1) {
-			    fprintf(stderr, "rrcoeffs: failed to allocate memory for polygon of %d caps\n", np + DNP);
-			    return(-1);
-			}
-
-			/* make polygon which is the intersection of the 2 polygons */
-			poly_poly(poly[ipoly], poly[jpoly], polyij);
-
-			/* suppress abutting boundary from poly[jpoly] */
-			polyij->cm[poly[ipoly]->np + jp] = 2.;
-
-			/* compute bound and vert */
-			tolj = toli;
-			ier = gphbv(polyij, poly[ipoly]->np, ip, &tolj, dbound, dvert);
-			if (ier == -1) return(-1);
-
-			/* increment bound and vert */
-			bound[0] += dbound[0] * ww;
-			bound[1] += dbound[1] * ww;
-			vert[0] += dvert[0] * ww;
-			vert[1] += dvert[1] * ww;
-
-		    }
-
-		}
-
-	    }
-
+	/* increment bound and vert from abutting polygons */
+	for (; m < nabut && ab[m].ipoly == ipoly; m++) {
+	    ww = - 2. * poly[ipoly]->weight * poly[ab[m].jpoly]->weight;
+	    bound[0] += ab[m].bound[0] * ww;
+	    bound[1] += ab[m].bound[1] * ww;
+	    vert[0] += ab[m].vert[0] * ww;
+	    vert[1] += ab[m].vert[1] * ww;
 	}
-
     }
 
+    free(sier);
+    free(sarea);
+    if (ab) free(ab);
+
     /* advise */
     if (ner > 0) {
 	msg("discarded %d polygons for which computations failed\n", ner);
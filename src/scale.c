@@ -6,7 +6,7 @@
 /*------------------------------------------------------------------------------
   Convert angle from specified unit to specified unit.
 */
-void scale(long double *angle, char from, char to)
+void scale(real_t *angle, char from, char to)
 {
     /* scale from specified unit to arcseconds */
     switch (from) {
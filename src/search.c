@@ -12,7 +12,7 @@
 		0 if point < array[0]
 		n if point >= array[n-1]
 */
-int search(int n, long double array[/*n*/], long double point)
+int search(int n, real_t array[/*n*/], real_t point)
 {
     int i, im, ip;
 
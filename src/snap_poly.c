@@ -37,7 +37,7 @@
 			 set to 0x0 on input to ignore.
   Return value: number of caps adjusted.
 */
-int snap_polys(format *fmt, int npoly, polygon *poly[/*npoly*/], int selfsnap, long double axtol, long double btol, long double thtol, long double ytol, long double mtol, int warnmax, char snapped_poly[/*npoly*/])
+int snap_polys(format *fmt, int npoly, polygon *poly[/*npoly*/], int selfsnap, real_t axtol, real_t btol, real_t thtol, real_t ytol, real_t mtol, int warnmax, char snapped_poly[/*npoly*/])
 {
     int dnadj, dnadjo, i, j, nadj, pass, snapped, stuck, warn;
 
@@ -63,7 +63,7 @@ int snap_polys(format *fmt, int npoly, polygon *poly[/*npoly*/], int selfsnap, l
 		for (j = i; ((selfsnap)? j == i : j < npoly); j++) {
 		    snapped = snap_poly(poly[i], poly[j], axtol, btol);
 		    if(snapped==-1){
-		      fprintf(stderr, "snap_polys: error in snap_poly for polys %d and %d in pixel %d\n",i,j,poly[i]->pixel);
+		      fprintf(stderr, "snap_polys: error in snap_poly for polys %d and %d in pixel %lld\n",i,j,poly[i]->pixel);
 		      return(-1);
 		    }
 		    
@@ -99,7 +99,7 @@ int snap_polys(format *fmt, int npoly, polygon *poly[/*npoly*/], int selfsnap, l
     } while (dnadj && stuck < 2);
     if (dnadj) {
       if(poly[0]->pixel > 0){
-	fprintf(stderr, "snap_polys stage 1: stuck in a loop in pixel %d. continuing ...\n",poly[0]->pixel);
+	fprintf(stderr, "snap_polys stage 1: stuck in a loop in pixel %lld. continuing ...\n",poly[0]->pixel);
       }
       else{
 	fprintf(stderr, "snap_polys stage 1: seem to be stuck in a loop ... exit\n");
@@ -126,7 +126,7 @@ int snap_polys(format *fmt, int npoly, polygon *poly[/*npoly*/], int selfsnap, l
 		for (j = ((selfsnap)? i : 0); ((selfsnap)? j == i : j < npoly); j++) {
 		    snapped = snap_polyth(poly[i], poly[j], thtol, ytol, mtol);
 		    if(snapped==-1){
-		      fprintf(stderr, "snap_polys: error in snap_poly for polys %d and %d in pixel %d\n",i,j,poly[i]->pixel);
+		      fprintf(stderr, "snap_polys: error in snap_poly for polys %d and %d in pixel %lld\n",i,j,poly[i]->pixel);
 		      return(-1);
 		    }
 		    if (snapped) {
@@ -161,7 +161,7 @@ int snap_polys(format *fmt, int npoly, polygon *poly[/*npoly*/], int selfsnap, l
     } while (dnadj && stuck < 2);
     if (dnadj) {
       if(poly[0]->pixel > 0){
-	fprintf(stderr, "snap_polys stage 2: stuck in a loop in pixel %d. continuing ...\n",poly[0]->pixel);
+	fprintf(stderr, "snap_polys stage 2: stuck in a loop in pixel %lld. continuing ...\n",poly[0]->pixel);
       }
       else{
 	fprintf(stderr, "snap_polys stage 2: seem to be stuck in a loop ... exit\n");
@@ -187,10 +187,10 @@ int snap_polys(format *fmt, int npoly, polygon *poly[/*npoly*/], int selfsnap, l
   Output: adjusted caps of poly2 (i.e. poly2->rp, poly2->cm).
   Return value: number of caps adjusted.
 */
-int snap_poly(polygon *poly1, polygon *poly2, long double axtol, long double btol)
+int snap_poly(polygon *poly1, polygon *poly2, real_t axtol, real_t btol)
 {
     int adjusted, ip, ip1, ip2, nadj, sp;
-    long double cm, dl, drp, dx, dy, dz;
+    real_t cm, dl, drp, dx, dy, dz;
 
     nadj = 0;
     for (ip1 = 0; ip1 < poly1->np; ip1++) {	/* for each cap of poly1 ... */
@@ -245,6 +245,7 @@ int snap_poly(polygon *poly1, polygon *poly2, long double axtol, long double bto
 		    }
 		    if (adjusted) {
 			nadj++;
+			poly2->areaok = 0;
 			/* no need to test other direction */
 			break;
 		    }
@@ -273,15 +274,15 @@ int snap_poly(polygon *poly1, polygon *poly2, long double axtol, long double bto
   Return value: number of caps adjusted,
 		or -1 if error occurred.
 */
-int snap_polyth(polygon *poly1, polygon *poly2, long double thtol, long double ytol, long double mtol)
+int snap_polyth(polygon *poly1, polygon *poly2, real_t thtol, real_t ytol, real_t mtol)
 {
     const int per = 0;
     const int nve = 2;
 
     int adjusted, do_vcirc, i, ier, in, ip1, ip2, iv, ivp, nadj, nev, nev0, nv;
     int *ipv, *gp, *ev;
-    long double cm, cm1, dth, dthmax, sp, tol;
-    long double *angle;
+    real_t cm, cm1, dth, dthmax, sp, tol;
+    real_t *angle;
     vec *v, *ve;
 
     /* vertices and centres of edges of poly2 */
@@ -344,7 +345,10 @@ int snap_polyth(polygon *poly1, polygon *poly2, long double thtol, long double y
 		    poly2->cm[ip2] = cm;
 		    adjusted = 1;
 		}
-		if (adjusted) nadj++;
+		if (adjusted) {
+		    nadj++;
+		    poly2->areaok = 0;
+		}
 	    }
 
 	}
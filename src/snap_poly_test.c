@@ -37,7 +37,7 @@
 			 set to 0x0 on input to ignore.
   Return value: number of caps adjusted.
 */
-int snap_polys(format *fmt, int npoly, polygon *poly[/*npoly*/], int selfsnap, long double axtol, long double btol, long double thtol, long double ytol, long double mtol, int warnmax, char snapped_poly[/*npoly*/])
+int snap_polys(format *fmt, int npoly, polygon *poly[/*npoly*/], int selfsnap, real_t axtol, real_t btol, real_t thtol, real_t ytol, real_t mtol, int warnmax, char snapped_poly[/*npoly*/])
 {
     int dnadj, dnadjo, i, j, nadj, pass, snapped, stuck, warn;
 
@@ -97,7 +97,7 @@ int snap_polys(format *fmt, int npoly, polygon *poly[/*npoly*/], int selfsnap, l
 	fprintf(stderr, "snap_polys: seem to be stuck in a loop ... exit\n");
       }
       else{
-	fprintf(stderr, "snap_polys stage 1: stuck in a loop in pixel %d. continuing ...\n",poly[0]->pixel);
+	fprintf(stderr, "snap_polys stage 1: stuck in a loop in pixel %lld. continuing ...\n",poly[0]->pixel);
       }
     }
 
@@ -155,7 +155,7 @@ int snap_polys(format *fmt, int npoly, polygon *poly[/*npoly*/], int selfsnap, l
 	fprintf(stderr, "snap_polys: seem to be stuck in a loop ... exit\n");
       }
       else{
-	fprintf(stderr, "snap_polys stage 2: stuck in a loop in pixel %d. continuing ...\n",poly[0]->pixel);
+	fprintf(stderr, "snap_polys stage 2: stuck in a loop in pixel %lld. continuing ...\n",poly[0]->pixel);
       }
     }
     return(nadj);
@@ -178,10 +178,10 @@ int snap_polys(format *fmt, int npoly, polygon *poly[/*npoly*/], int selfsnap, l
   Output: adjusted caps of poly2 (i.e. poly2->rp, poly2->cm).
   Return value: number of caps adjusted.
 */
-int snap_poly(polygon *poly1, polygon *poly2, long double axtol, long double btol)
+int snap_poly(polygon *poly1, polygon *poly2, real_t axtol, real_t btol)
 {
     int adjusted, ip, ip1, ip2, nadj, sp;
-    long double cm, dl, drp, dx, dy, dz;
+    real_t cm, dl, drp, dx, dy, dz;
 
     nadj = 0;
     for (ip1 = 0; ip1 < poly1->np; ip1++) {	/* for each cap of poly1 ... */
@@ -264,15 +264,15 @@ int snap_poly(polygon *poly1, polygon *poly2, long double axtol, long double bto
   Return value: number of caps adjusted,
 		or -1 if error occurred.
 */
-int snap_polyth(polygon *poly1, polygon *poly2, long double thtol, long double ytol, long double mtol)
+int snap_polyth(polygon *poly1, polygon *poly2, real_t thtol, real_t ytol, real_t mtol)
 {
     const int per = 0;
     const int nve = 2;
 
     int adjusted, do_vcirc, i, ier, in, ip1, ip2, iv, ivp, nadj, nev, nev0, nv;
     int *ipv, *gp, *ev;
-    long double cm, cm1, dth, dthmax, sp, tol;
-    long double *angle;
+    real_t cm, cm1, dth, dthmax, sp, tol;
+    real_t *angle;
     vec *v, *ve;
         
     // vertices and centres of edges of poly2 
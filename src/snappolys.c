@@ -20,56 +20,40 @@
 	            the same polygon.
   Return value: number of caps adjusted.
 */
-int snap(int npoly, polygon *poly[/*npoly*/], long double mtol, format *fmt, long double axtol, long double btol, long double thtol, long double ytol, int selfsnap)
+int snap(int npoly, polygon *poly[/*npoly*/], real_t mtol, format *fmt, real_t axtol, real_t btol, real_t thtol, real_t ytol, int selfsnap)
 {
 #define WARNMAX		8
   int i, inull, iprune, nadj, dnadj, warnmax;
-  int *start;
-  int *total;
-  int p, max_pixel, ier;
+  int ier, p;
+  pixeldir dir;
   
   /* start by sorting polygons by pixel number*/
   poly_sort(npoly,poly,'p');
 
-  /* allocate memory for pixel info arrays start and total */ 
-  /* if only self-snapping, don't use pixelization */
-  max_pixel=(selfsnap)? 1 : poly[npoly-1]->pixel+1; 
-  start = (int *) malloc(sizeof(int) * max_pixel);
-  if (!start) {
-    fprintf(stderr, "snap_polys: failed to allocate memory for %d integers\n", max_pixel);
-    return(-1);
-  }
-  total = (int *) malloc(sizeof(int) * max_pixel);
-  if (!total) {
-    fprintf(stderr, "snap_polys: failed to allocate memory for %d integers\n", max_pixel);
-    return(-1);
-  }
-  
-  /* if we're only doing self-snapping, don't use the pixelization info */ 
+  /* if we're only doing self-snapping, don't use the pixelization info */
   if(selfsnap){
-    start[0]=0;
-    total[0]=npoly;
+    ier=pixel_dir_all(npoly, &dir);
   }
   else{
-    /* build lists of starting indices of each pixel and total number of polygons in each pixel*/
-    ier=pixel_list(npoly, poly, max_pixel, start, total);
-    if (ier == -1) {
-      fprintf(stderr, "snap: error building pixel index lists\n");
-      return(-1);
-    }
+    /* build directory of starting indices of each pixel and total number of polygons in each pixel*/
+    ier=pixel_dir(npoly, poly, &dir);
   }
-  
+  if (ier == -1) {
+    fprintf(stderr, "snap: error building pixel index lists\n");
+    return(-1);
+  }
+
   /*turn off warning messages if using more than one pixel*/
-  warnmax= (max_pixel<=1) ? WARNMAX : 0; 
+  warnmax= (dir.npix==0 || dir.pixel[dir.npix-1]==0) ? WARNMAX : 0; 
 
   /* snap edges of polygons to each other */
   nadj=0;
-  for(p=0;p<max_pixel;p++){
-    if(total[p]==0) continue;
-    dnadj=snap_polys(fmt, total[p], &poly[start[p]], selfsnap, axtol, btol, thtol, ytol, mtol,((selfsnap)? warnmax : warnmax/2),0x0);
+  for(p=0;p<dir.npix;p++){
+    dnadj=snap_polys(fmt, dir.total[p], &poly[dir.start[p]], selfsnap, axtol, btol, thtol, ytol, mtol,((selfsnap)? warnmax : warnmax/2),0x0);
     if(dnadj==-1) return(-1);
     nadj+=dnadj;
   }
+  free_pixel_dir(&dir);
   
   /* prune polygons */
   inull = 0;
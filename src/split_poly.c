@@ -27,12 +27,12 @@
 		1 = poly2 fully encloses poly1;
 		2 = poly2 splits poly1 into two.
 */
-int split_poly(polygon **poly1, polygon *poly2, polygon **poly3, long double mtol)
+int split_poly(polygon **poly1, polygon *poly2, polygon **poly3, real_t mtol)
 {
-    static polygon *poly = 0x0, *poly4 = 0x0;
+    static THREADLOCAL polygon *poly = 0x0, *poly4 = 0x0;
 
     int ier, ip, iprune, np, np1, verb;
-    long double area, area_tot, cm, tol,area1,area3,area4;
+    real_t area, area_tot, cm, tol,area1,area3,area4;
 
     /* poly2 is whole sphere, therefore contains poly1 */
     if (poly2->np == 0){
@@ -65,7 +65,7 @@ int split_poly(polygon **poly1, polygon *poly2, polygon **poly3, long double mto
     /* area of poly1 */
     tol = mtol;
     verb = 1;
-    ier = garea(*poly1, &tol, verb, &area1);
+    ier = poly_area(*poly1, &tol, verb, &area1);
     if (ier) goto error;
 
     /* number of caps of poly1 */
@@ -78,6 +78,7 @@ int split_poly(polygon **poly1, polygon *poly2, polygon **poly3, long double mto
 
 	cm = poly->cm[np1 + ip];
 	poly->cm[np1 + ip] = 2.;		/* suppress boundary to be tested */
+	poly->areaok = 0;
 	tol = mtol;
 	ier = garea(poly, &tol, verb, &area);	/* area of intersection sans boundary */
 	poly->cm[np1 + ip] = cm;		/* restore tested boundary */
@@ -189,7 +190,7 @@ int split_poly(polygon **poly1, polygon *poly2, polygon **poly3, long double mto
   Return value: npoly = number of disjoint polygons, excluding poly1,
 			or -1 if error occurred in split_poly().
 */
-int fragment_poly(polygon **poly1, polygon *poly2, int discard, int npolys, polygon *polys[/*npolys*/], long double mtol, char bmethod)
+int fragment_poly(polygon **poly1, polygon *poly2, int discard, int npolys, polygon *polys[/*npolys*/], real_t mtol, char bmethod)
 {
     int npoly, nsplit;
     polygon **poly;
@@ -13,12 +13,13 @@ int main(int argc, char *argv[])
 {
   int ifile, ipoly, nfiles, npoly;
    
-  int i, pixel, res, n, m, pixel_num;
-  long double ra, dec;
+  int i, res, n, m;
+  long long pixel, pixel_num;
+  real_t ra, dec;
   char scheme;
-  int *child_pix;
+  long long *child_pix;
   int children;
-  int *parent_pix;
+  long long *parent_pix;
    polygon **polys;
    polys=polys_global;
 
@@ -41,7 +42,7 @@ int main(int argc, char *argv[])
     scale(&dec, 'd','r');
     
     pixel = which_pixel(ra,dec,res,scheme);
-    printf("pixel=%i\n",pixel);  
+    printf("pixel=%lld\n",pixel);  
     return(0);
   }
   */
@@ -53,12 +54,12 @@ int main(int argc, char *argv[])
     exit(1);
   }
   else{
-    pixel_num=atoi(argv[1]);
+    pixel_num=atoll(argv[1]);
     scheme=argv[2][0];
 
     //allocate memory for child_pix array
     if(scheme=='d' && pixel_num==0){
-      child_pix=(int *) malloc(sizeof(int) * 117);
+      child_pix=(long long *) malloc(sizeof(long long) * 117);
       children=117;
       if(!child_pix){
 	fprintf(stderr, "get_child_pixels: failed to allocate memory for %d integers\n", 117);
@@ -66,7 +67,7 @@ int main(int argc, char *argv[])
       }
     }
     else{
-      child_pix=(int *) malloc(sizeof(int) * 4);
+      child_pix=(long long *) malloc(sizeof(long long) * 4);
       children=4;
       if(!child_pix){
 	fprintf(stderr, "get_child_pixels: failed to allocate memory for %d integers\n", 4);
@@ -75,10 +76,10 @@ int main(int argc, char *argv[])
     }
 
     get_child_pixels(pixel_num,child_pix,scheme);
-    printf("parent pixel = %d\n", pixel_num);
+    printf("parent pixel = %lld\n", pixel_num);
 
     for(i=0;i<children;i++){
-      printf("child pixel %d = %d\n", i+1, child_pix[i]);
+      printf("child pixel %d = %lld\n", i+1, child_pix[i]);
     }
     return(0);
   }
@@ -90,31 +91,31 @@ int main(int argc, char *argv[])
       exit(1);
     }
     else{
-      pixel_num=atoi(argv[1]);
+      pixel_num=atoll(argv[1]);
       scheme=argv[2][0];
       res=get_res(pixel_num, scheme);
       printf("res=%d\n",res);
       
       if(pixel_num==0 && scheme=='d'){
-        parent_pix = (int *) malloc(sizeof(int) * (168));
+        parent_pix = (long long *) malloc(sizeof(long long) * (168));
 	if (!parent_pix){
 	  fprintf(stderr, "test: failed to allocate memory for 168 integers\n");
 	  exit(1);
         }
       }
       else{
-        parent_pix = (int *) malloc(sizeof(int) * (res+1));
+        parent_pix = (long long *) malloc(sizeof(long long) * (res+1));
         if (!parent_pix) {
 	  fprintf(stderr, "test: failed to allocate memory for %d integers\n", res);
 	  exit(1);
         }
       }
       get_parent_pixels(pixel_num,parent_pix,scheme);
-      printf("child pixel = %d\nparent pixels =", pixel_num);
+      printf("child pixel = %lld\nparent pixels =", pixel_num);
       for(i=0;i<res;i++){
-	printf(" %d, ",parent_pix[i]);
+	printf(" %lld, ",parent_pix[i]);
       }
-      printf("and %d\n",parent_pix[res]);
+      printf("and %lld\n",parent_pix[res]);
       free(parent_pix);
       return(0);
     }
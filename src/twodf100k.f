@@ -1,13 +1,15 @@
 c-----------------------------------------------------------------------
 c  A J S Hamilton 2001
 c-----------------------------------------------------------------------
-      real*10 function twodf100k(ra,dec)
-      real*10 ra,dec
+      function twodf100k(ra,dec)
+#include "real.par"
+      real(KR) twodf100k
+      real(KR) ra,dec
 c
 c        parameters
       include 'pi.par'
-      real*10 RADIAN
-      parameter (RADIAN=180._10/PI)
+      real(KR) RADIAN
+      parameter (RADIAN=180._KR/PI)
 c        data variables
 C     logical init
 C     real magcut
@@ -42,11 +44,11 @@ c the 2dFGRS mask software by Peder Norberg and Shaun Cole
 
 c compl = -1. means the position is outside the main 2dF boundary
       if (compl.eq.-1.) then
-        twodf100k=0._10
+        twodf100k=0._KR
 
 c compl = -2. means the position is inside a drill hole
       elseif (compl.eq.-2.) then
-        twodf100k=0._10
+        twodf100k=0._KR
 
 c discard fields with limiting magnitude brighter than magcut
 C COMMENT THIS OUT IF YOU DON'T WANT IT
@@ -70,7 +72,7 @@ c       twodf100k=maglim
       endif
 
 c completeness: round to 8 decimal places
-      twodf100k=dble(nint(twodf100k*1.e8_10))/1.e8_10
+      twodf100k=dble(nint(twodf100k*1.e8_KR))/1.e8_KR
 
 c     print *,ra,dec,compl,maglim,twodf100k
 c
@@ -5,6 +5,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <math.h>
 #include "manglefn.h"
 #include "defaults.h"
 
@@ -14,12 +15,21 @@ const char *optstr = "dqm:s:e:v:p:Ui:o:";
 /* allocate polygons as a global array */
 polygon *polys_global[NPOLYSMAX];
 
+/* one cap of one polygon, as an entry in the adjacency index of a pixel */
+typedef struct {
+  vec rp;
+  real_t cm;
+  int ipoly;
+} capent;
+
 /* local functions */
 void	usage(void);
 int	unify_poly(polygon **, polygon *);
 #ifdef	GCC
+int	unify_pixel(polygon *[], int begin, int end, int warnmax);
 int	unify(int *npoly, polygon *[*npoly]);
 #else
+int	unify_pixel(polygon *[], int begin, int end, int warnmax);
 int	unify(int *npoly, polygon *[/**npoly*/]);
 #endif
 
@@ -58,7 +68,7 @@ int main(int argc, char *argv[])
     if (mtol != 0.) {
 	scale(&mtol, munit, 's');
 	munit = 's';
-	msg("multiple intersections closer than %Lg%c will be treated as coincident\n", mtol, munit);
+	msg("multiple intersections closer than %" RL "g%c will be treated as coincident\n", mtol, munit);
 	scale(&mtol, munit, 'r');
 	munit = 'r';
     }
@@ -140,11 +150,11 @@ int unify_poly(polygon **poly1, polygon *poly2)
 {
 /* number of extra caps to allocate to polygon, to allow for expansion */
 #define DNP		4
-    static polygon *poly = 0x0;
+    static THREADLOCAL polygon *poly = 0x0;
 
     int bnd, bndin, bndout, bnd1, bnd2, i, ier, i1, i2, np, verb;
     int np1, np2;
-    long double area, areain, tol;
+    real_t area, areain, tol;
     polygon *polyin, *polyout;
 
     bnd = 0;
@@ -202,6 +212,7 @@ int unify_poly(polygon **poly1, polygon *poly2)
 	touch_poly(poly);
 	/* suppress excluding boundary of unified poly */
 	poly->cm[bndout] = 2.;
+	poly->areaok = 0;
 	/* subarea of unified poly */
 	verb = 0;
 	ier = garea(poly, &tol, verb, &area);
@@ -214,6 +225,7 @@ int unify_poly(polygon **poly1, polygon *poly2)
 
     /* suppress dividing boundary */
     poly->cm[bndin] = 2.;
+    poly->areaok = 0;
 
     /* prune unified polygon */
     if (prune_poly(poly, mtol) == -1) return(-1);
@@ -237,6 +249,266 @@ int unify_poly(polygon **poly1, polygon *poly2)
     return(-1);
 }
 
+/*------------------------------------------------------------------------------
+  Compare cap entries by the axis and |cm| of the cap.
+*/
+static int capent_cmp_key(const capent *c1, const capent *c2)
+{
+    real_t a1, a2;
+    int k;
+
+    for (k = 0; k < 3; k++) {
+	if (c1->rp[k] < c2->rp[k]) return(-1);
+	if (c1->rp[k] > c2->rp[k]) return(1);
+    }
+    a1 = fabsl(c1->cm);
+    a2 = fabsl(c2->cm);
+    if (a1 < a2) return(-1);
+    if (a1 > a2) return(1);
+    return(0);
+}
+
+/*------------------------------------------------------------------------------
+  Order cap entries by the axis and |cm| of the cap,
+  so that the two sides of a shared boundary end up next to each other.
+*/
+static int capent_cmp(const void *v1, const void *v2)
+{
+    const capent *c1 = (const capent *)v1, *c2 = (const capent *)v2;
+    int cmp;
+
+    cmp = capent_cmp_key(c1, c2);
+    if (cmp) return(cmp);
+    if (c1->ipoly < c2->ipoly) return(-1);
+    if (c1->ipoly > c2->ipoly) return(1);
+    return(0);
+}
+
+/*------------------------------------------------------------------------------
+  Add to a heap of polygon indices the polygons after jlast that have a cap
+  complementary to a cap of polygon poly, i.e. with the same rp and opposite cm.
+
+   Input: poly = polygon.
+	  ipoly = index of poly.
+	  jlast = only polygons with index > jlast are added.
+	  ent = index of caps, sorted with capent_cmp.
+	  nent = number of entries in index.
+	  seen[j - begin] = ipoly if polygon j has already been added for ipoly.
+	  heap = min-heap of nheap polygon indices.
+  Output: seen, heap, nheap updated.
+*/
+static void push_candidates(polygon *poly, int ipoly, int jlast, capent ent[], int nent, int begin, int seen[], int heap[], int *nheap)
+{
+    int i, ih, ip, j, k, lo, hi, mid, t;
+    capent key;
+
+    for (k = 0; k < poly->np; k++) {
+	key.rp[0] = poly->rp[k][0];
+	key.rp[1] = poly->rp[k][1];
+	key.rp[2] = poly->rp[k][2];
+	key.cm = poly->cm[k];
+	/* first entry with the same axis and |cm| */
+	lo = 0;
+	hi = nent;
+	while (lo < hi) {
+	    mid = (lo + hi) / 2;
+	    if (capent_cmp_key(&ent[mid], &key) < 0) {
+		lo = mid + 1;
+	    } else {
+		hi = mid;
+	    }
+	}
+	for (i = lo; i < nent && capent_cmp_key(&ent[i], &key) == 0; i++) {
+	    j = ent[i].ipoly;
+	    if (j <= jlast || ent[i].cm != - key.cm || seen[j - begin] == ipoly) continue;
+	    seen[j - begin] = ipoly;
+	    /* sift up */
+	    ih = (*nheap)++;
+	    heap[ih] = j;
+	    while (ih > 0) {
+		ip = (ih - 1) / 2;
+		if (heap[ip] <= heap[ih]) break;
+		t = heap[ip];
+		heap[ip] = heap[ih];
+		heap[ih] = t;
+		ih = ip;
+	    }
+	}
+    }
+}
+
+/*------------------------------------------------------------------------------
+  Remove the smallest polygon index from a heap.
+*/
+static int pop_candidate(int heap[], int *nheap)
+{
+    int ic, ih, j, t;
+
+    j = heap[0];
+    (*nheap)--;
+    heap[0] = heap[*nheap];
+    /* sift down */
+    ih = 0;
+    while ((ic = 2 * ih + 1) < *nheap) {
+	if (ic + 1 < *nheap && heap[ic + 1] < heap[ic]) ic++;
+	if (heap[ih] <= heap[ic]) break;
+	t = heap[ih];
+	heap[ih] = heap[ic];
+	heap[ic] = t;
+	ih = ic;
+    }
+    return(j);
+}
+
+/*------------------------------------------------------------------------------
+  Unify polygons within a single pixel.
+
+  The result is the same as that of trying each polygon i in turn
+  against every later polygon j, as unify used to do, but only the pairs
+  that unify_poly() could possibly unify are tried.
+  Two polygons can only be unified if they share exactly one boundary,
+  i.e. if one has a cap with the same rp and the opposite cm of a cap
+  of the other.  Each pass builds an index of all the caps in the pixel
+  sorted on (rp, |cm|), and for each polygon i keeps a heap of the later
+  polygons sharing a boundary with it, tried in increasing order.
+  Whenever polygon i absorbs another, the caps it gains are looked up too,
+  so later polygons that now share a boundary with it are also tried.
+  Polygons after i are never modified before i is done with them,
+  so the index remains valid for them throughout the pass.
+
+   Input: poly = array of pointers to polygons.
+	  begin, end = polygons poly[begin] to poly[end-1] are in the pixel.
+	  warnmax = maximum number of unified pairs to report.
+  Output: poly = array of pointers to polygons, with unified polygons
+	  replaced by null pointers.
+  Return value: number of polygons unified,
+		or -1 if error occurred.
+*/
+int unify_pixel(polygon *poly[], int begin, int end, int warnmax)
+{
+    int dnadj, i, j, k, n, nadj, ncap, nent, nheap, nrep, pass, unified;
+    int *heap, *seen;
+    long long *repid;
+    capent *ent;
+
+    n = end - begin;
+    seen = (int *) malloc(sizeof(int) * 2 * n);
+    if (!seen) {
+	fprintf(stderr, "unify_pixel: failed to allocate memory for %d integers\n", 2 * n);
+	return(-1);
+    }
+    heap = &seen[n];
+    repid = 0x0;
+    if (warnmax/2 > 0) {
+	repid = (long long *) malloc(sizeof(long long) * 2 * (warnmax/2));
+	if (!repid) {
+	    fprintf(stderr, "unify_pixel: failed to allocate memory for %d integers\n", 2 * (warnmax/2));
+	    free(seen);
+	    return(-1);
+	}
+    }
+
+    nadj = 0;
+    pass = 0;
+    do {
+	pass++;
+	dnadj = 0;
+	nrep = 0;
+
+	/* count caps */
+	ncap = 0;
+	for (i = begin; i < end; i++) {
+	    if (poly[i]) ncap += poly[i]->np;
+	}
+	if (ncap < 2) break;
+
+	ent = (capent *) malloc(sizeof(capent) * ncap);
+	if (!ent) {
+	    fprintf(stderr, "unify_pixel: failed to allocate memory for %d cap entries\n", ncap);
+	    free(seen);
+	    if (repid) free(repid);
+	    return(-1);
+	}
+
+	/* index of caps, sorted on axis and |cm| */
+	nent = 0;
+	for (i = begin; i < end; i++) {
+	    if (!poly[i]) continue;
+	    for (k = 0; k < poly[i]->np; k++) {
+		ent[nent].rp[0] = poly[i]->rp[k][0];
+		ent[nent].rp[1] = poly[i]->rp[k][1];
+		ent[nent].rp[2] = poly[i]->rp[k][2];
+		ent[nent].cm = poly[i]->cm[k];
+		ent[nent].ipoly = i;
+		nent++;
+	    }
+	}
+	qsort(ent, nent, sizeof(capent), capent_cmp);
+
+	for (i = 0; i < n; i++) seen[i] = -1;
+
+	/* try unifying each polygon in turn ... */
+	for (i = begin; i < end; i++) {
+	    if (!poly[i]) continue;
+
+	    /* ... with each later polygon sharing a boundary with it, in order */
+	    nheap = 0;
+	    push_candidates(poly[i], i, i, ent, nent, begin, seen, heap, &nheap);
+	    while (nheap > 0) {
+		j = pop_candidate(heap, &nheap);
+		if (!poly[j]) continue;
+		/* only unify polygons with the same weight */
+		if (poly[i]->weight != poly[j]->weight) continue;
+		/* if applying old ids, then only unify polygons with the same id */
+		if (fmt.newid == 'o' && poly[i]->id != poly[j]->id) continue;
+
+		/* try unifying polygons */
+		unified = unify_poly(&poly[i], poly[j]);
+		if (unified == -1) {
+		    fprintf(stderr, "unify_poly: failed to unify polygons %lld & %lld; continuing\n", poly[i]->id, poly[j]->id);
+		    continue;
+		}
+		/* polygons were unified */
+		if (unified) {
+		    if (nrep < warnmax/2) {
+			repid[2 * nrep] = poly[i]->id;
+			repid[2 * nrep + 1] = poly[j]->id;
+			nrep++;
+		    }
+		    free_poly(poly[j]);
+		    poly[j] = 0x0;
+		    dnadj++;
+		    /* later polygons sharing a boundary gained by polygon i */
+		    push_candidates(poly[i], i, j, ent, nent, begin, seen, heap, &nheap);
+		}
+	    }
+	}
+	free(ent);
+
+	/* report the pass in one piece, so reports of different pixels do not interleave */
+	if (warnmax) {
+#ifdef	_OPENMP
+#pragma omp critical (unify_msg)
+#endif
+	    {
+		if (warnmax/2 > 0 && dnadj > 0) {
+		    msg("unify pass %d: the following polygons are being unified:\n", pass);
+		    for (k = 0; k < nrep; k++) msg(" (%lld %lld)", repid[2 * k], repid[2 * k + 1]);
+		    msg((dnadj > warnmax/2)? " ... more\n" : "\n");
+		}
+		msg("unify pass %d: %d polygons unified\n", pass, dnadj);
+	    }
+	}
+	nadj += dnadj;
+
+    } while (dnadj);
+
+    free(seen);
+    if (repid) free(repid);
+
+    return(nadj);
+}
+
 /*------------------------------------------------------------------------------
   Unify polygons.
 
@@ -249,41 +521,25 @@ int unify_poly(polygon **poly1, polygon *poly2)
 int unify(int *npoly, polygon *poly[/**npoly*/])
 {
 #define WARNMAX		8
-    int dnadj, i, j, unified, nadj, pass, warnmax;
-    int *start;
-    int *total;
-    int begin, end, p, max_pixel, ier;
-
-    /* allocate memory for pixel info arrays start and total */ 
-    /* if unpixelizing, don't use pixelization info */
-    max_pixel = (unpixelize)? 1: poly[*npoly-1]->pixel+1; 
-    start = (int *) malloc(sizeof(int) * max_pixel);
-    if (!start) {
-      fprintf(stderr, "unify: failed to allocate memory for %d integers\n", max_pixel);
-      return(-1);
-    }
-    total = (int *) malloc(sizeof(int) * max_pixel);
-    if (!total) {
-      fprintf(stderr, "unify: failed to allocate memory for %d integers\n", max_pixel);
-      return(-1);
-    }
+    int dnadj, i, j, nadj, warnmax;
+    int ier, p;
+    pixeldir dir;
 
     /* if we're unpixelizing, don't use the pixelization info */ 
     if(unpixelize){
-      start[0]=0;
-      total[0]=*npoly;
+      ier=pixel_dir_all(*npoly, &dir);
     }
     else{
-      /* build lists of starting indices of each pixel and total number of polygons in each pixel*/
-      ier=pixel_list(*npoly, poly, max_pixel, start, total);
-      if (ier == -1) {
-	fprintf(stderr, "unify: error building pixel index lists\n");
-	return(-1);
-      }
+      /* build directory of starting indices of each pixel and total number of polygons in each pixel*/
+      ier=pixel_dir(*npoly, poly, &dir);
+    }
+    if (ier == -1) {
+      fprintf(stderr, "unify: error building pixel index lists\n");
+      return(-1);
     }
     
     /*turn off warning messages if using more than one pixel*/
-    warnmax= (max_pixel<=1) ? WARNMAX : 0; 
+    warnmax= (dir.npix==0 || dir.pixel[dir.npix-1]==0) ? WARNMAX : 0; 
 
     nadj = 0;
 
@@ -334,63 +590,32 @@ int unify(int *npoly, polygon *poly[/**npoly*/])
     if (dnadj > 0) msg("unify: %d polygons with zero area were discarded\n", dnadj);
     nadj += dnadj;
 
-    /*unify polygons within each pixel*/
-    /* unify repeatedly, until no more unification occurs */
-    for(p=0;p<max_pixel;p++){
-      begin=start[p];
-      end=start[p]+total[p];
-      
-      pass = 0;
-      do {
-	pass++;
-	dnadj = 0;
-	/* try unifying each polygon in turn ... */
-	
-	for (i = begin; i < end; i++) {
-	  if (!poly[i]) continue;
-	  
-	  /* ... with another polygon */
-	  for (j = i+1; j < end; j++) {
-	    if (!poly[j]) continue;
-	    /* only unify polygons with the same weight */
-	    if (poly[i]->weight != poly[j]->weight) continue;
-	    
-	    /* if applying old ids, then only unify polygons with the same id */
-	    if (fmt.newid == 'o' && poly[i]->id != poly[j]->id) continue;
-	    
-	    /* try unifying polygons */
-	    unified = unify_poly(&poly[i], poly[j]);
-	    if (unified == -1) {
-	      if (warnmax/2 > 0 && dnadj > 0 && dnadj <= warnmax/2) msg("\n");
-	      fprintf(stderr, "unify_poly: failed to unify polygons %lld & %lld; continuing\n", poly[i]->id, poly[j]->id);
-	      continue;
-	    }
-	    /* polygons were unified */
-	    if (unified) {
-	      if(warnmax > 0){
-		if (warnmax/2 > 0 && dnadj == 0)
-		  msg("unify pass %d: the following polygons are being unified:\n", pass);
-		if (dnadj < warnmax/2) {
-		  msg(" (%lld %lld)", poly[i]->id, poly[j]->id);
-		} else if (dnadj == warnmax/2) {
-		  msg(" ... more\n");
-		}
-	      }
-	      free_poly(poly[j]);
-	      poly[j] = 0x0;
-	      dnadj++;
-	    }
-	  }
-	}
-	if (warnmax/2 > 0 && dnadj > 0 && dnadj <= warnmax/2) msg("\n");
-	if(warnmax) msg("unify pass %d: %d polygons unified\n", pass, dnadj);
-	nadj += dnadj;
-	
-      } while (dnadj);
+    /* unify polygons within each pixel;
+       pixels are independent of each other, so may be done in parallel */
+    ier = 0;
+    dnadj = 0;
+#ifdef	_OPENMP
+#pragma omp parallel for schedule(dynamic) reduction(+:dnadj)
+#endif
+    for (p = 0; p < dir.npix; p++) {
+      int dn;
+
+      if (dir.total[p] < 2) continue;
+      dn = unify_pixel(poly, dir.start[p], dir.start[p] + dir.total[p], warnmax);
+      if (dn == -1) {
+#ifdef	_OPENMP
+#pragma omp atomic write
+#endif
+	ier = -1;
+      } else {
+	dnadj += dn;
+      }
     }
-    
-    free(start);
-    free(total);
+    nadj += dnadj;
+
+    free_pixel_dir(&dir);
+
+    if (ier == -1) return(-1);
 
     /* copy down polygons */
     j = 0;
@@ -8,14 +8,38 @@
 
     if (strchr(optstr, 'q')) printf("  -q\t\texecute quietly\n");
 
-    if (strchr(optstr, 'w')) printf("  -w<Wlmfile>\tname of file containing spherical harmonics\n");
+    if (strchr(optstr, 'w')) {
+      if (strchr(optstr, 'C')) {
+	printf("  -w<Wlmfile>\tname of file containing spherical harmonics, to which those of the\n");
+	printf("    \t\tpolygons are added; a polygon of negative weight is subtracted\n");
+      } else {
+	printf("  -w<Wlmfile>\tname of file containing spherical harmonics\n");
+      }
+    }
+
+    if (strchr(optstr, 'C')) {
+      printf("  -C<dir>\tkeep the harmonics of each polygon in directory <dir>, and reuse them\n");
+      printf("    \t\tfor any polygon with exactly the same caps\n");
+    }
 
     if (strchr(optstr, 'z')) printf("  -z<survey>\tname of survey, or of file containing list of weights\n");
 
+    if (strchr(optstr, 'Z')) printf("  -Z<idfile>\tname of file containing table of polygon ids and weights\n");
+
     if (strchr(optstr, 'l')) printf("  -l<lmax>\tmaximum harmonic number\n");
 
+    if (strchr(optstr, 'L')) {
+      printf("  -L<n>\t\tcompute and write the harmonics <n> harmonic numbers l at a time,\n");
+      printf("    \t\tin less memory; each block of l costs a pass through the polygons\n");
+    }
+
     if (strchr(optstr, 'g')) printf("  -g<lsmooth>\tgaussian smoothing harmonic number (0 = default = no smooth)\n");
 
+    if (strchr(optstr, 'E')) {
+      printf("  -E<tol>\tinterpolate the sums over l between elevations, to relative accuracy <tol>\n");
+      printf("    \t\t(0 = default = exact, shared only by points at the same elevation)\n");
+    }
+
     if (strchr(optstr, 'c')) printf("  -c<seed>\tseed random number generator with integer <seed>\n");
 
     if (strchr(optstr, 'r')) printf("  -r<n>\t\tgenerate <n> random points\n");
@@ -62,14 +86,19 @@
 
     if (strchr(optstr, 'u')) printf("  -u<in>[,<ou>]\tr radians, d degrees, m arcmin, s arcsec, h hms(RA) & dms(Dec)\n");
 
+    if (strchr(optstr, 'I')) printf("  -I<f>\t\tread az, el data in format <f>: t text, b binary, f FITS\n");
+
+    if (strchr(optstr, 'O')) printf("  -O<f>\t\twrite az, el data in format <f>: t text, b binary, f FITS\n");
+
     if (strchr(optstr, 'p')) {
 	printf("  -p[+|-][<n>]\t<n> digits after the decimal place in output angles\n");
 	printf("            \toutput azimuths in: + [0, 2 pi) or - (-pi, pi]\n");
     
     }  
     if (strchr(optstr, 'P')) {
-      printf("  -P[scheme][<p>][,<r>]\tpixelization scheme: s simple or d sdsspix\n");
+      printf("  -P[scheme][<p>][,<r>][,<c>]\tpixelization scheme: s simple, d sdsspix or h healpix-like\n");
       printf("                       \tpixelize to max resolution of <r>, with <p> polys per pixel\n");
+      printf("                       \tand, if <c> > 0, at most <c> caps per pixel\n");
     }
     if (strchr(optstr, 'B')) {
       printf("  -B[bmethod]\tmethod for combining weights in balkanize: l=last weight in polygon list,\n");
@@ -81,6 +110,9 @@
     if(strchr(optstr, 'W')) {
       printf("  -W\t\tprint weights in polyid output file rather than id numbers\n"); 
     }
+    if(strchr(optstr, 'F')) {
+      printf("  -F\t\tflush output after every line, for interactive use\n"); 
+    }
     if (strchr(optstr, 'i')) printf("  -i<f>[<n>][u]\tread polygon_infile in format <f>, with <n> objects per line\n");
 
     if (strchr(optstr, 'o')) printf("  -o<f>[u]\twrite outfile in format <f>\n");
@@ -100,6 +132,16 @@
       printf("  -T\t\toutput the mask polygons sliced so each is in only one rasterizer polygon,rather\n");
       printf("    \t\than the rasterizer polygons themselves. (T==Trim, a common use of this feature.)\n");
     }
+    if (strchr(optstr, 'N')) {
+      if (strchr(optstr, 'H')) {
+	printf("  -N<n>\t\tgenerate HEALPix rasterizer polygons at nside <n>, in the pixels occupied\n");
+	printf("    \t\tby the mask, instead of reading them from polygon_infile1;\n");
+	printf("    \t\twith -H, write only the weights of the HEALPix pixels near the mask\n");
+      } else {
+	printf("  -N<n>\t\tfast approximate harmonics from the mask rasterized on HEALPix pixels\n");
+	printf("    \t\tat nside <n>; use nside of at least lmax/2\n");
+      }
+    }
 
     if (strchr(optstr, 'a') || strchr(optstr, 'b') || strchr(optstr, 't') || strchr(optstr, 'i') || strchr(optstr, 'o') || strchr(optstr, 'G'))
 	printf("  unit u:\tr radians, d degrees, m arcmin, s arcsec, h hms(RA) & dms(Dec)\n");
@@ -4,9 +4,11 @@
 #ifndef VERTICES_H
 #define VERTICES_H
 
+#include "real.h"
+
 typedef struct {		/* azel structure */
-    long double az;			/* azimuth */
-    long double el;			/* elevation */
+    real_t az;			/* azimuth */
+    real_t el;			/* elevation */
 } azel;
 
 typedef struct {		/* vertices structure */
@@ -45,17 +45,17 @@
   Return value: 0 if ok (even if no inside point was found);
 		-1 if failed to allocate memory.
 */
-int vmid(polygon *poly, long double mtol, int nv, int nve, vec ve[/*nv * nve*/], int ipv[/*nv*/], int ev[/*nv*/], int *nvm, vec **vm_p)
+int vmid(polygon *poly, real_t mtol, int nv, int nve, vec ve[/*nv * nve*/], int ipv[/*nv*/], int ev[/*nv*/], int *nvm, vec **vm_p)
 {
     const int do_vcirc = 1;
-    static int nvmmax = 0;
-    static vec *vm = 0x0;
+    static THREADLOCAL int nvmmax = 0;
+    static THREADLOCAL vec *vm = 0x0;
 
     int i, ier, iev, ip, iv, ivl, ivm, ivu, neva, nev0, nva, scm;
-    long double angle, cm, cmbest, s, tol;
+    real_t angle, cm, cmbest, s, tol;
     vec  rp, vc, vi;
     int *ipva, *gpa, *eva;
-    long double *cmvmin, *cmvmax, *cmpmin, *cmpmax;
+    real_t *cmvmin, *cmvmax, *cmpmin, *cmpmax;
     vec *vmin, *vmax;
 
     /* make sure nve is even and >= 2 */
@@ -215,11 +215,11 @@ int vmid(polygon *poly, long double mtol, int nv, int nve, vec ve[/*nv * nve*/],
 */
 int vmidc(polygon *poly, int nv, int nve, vec ve[/*nv * nve*/], int ipv[/*nv*/], int ev[/*nv*/], int *nvm, vec **vm_p)
 {
-    static int nvmmax = 0;
-    static vec *vm = 0x0;
+    static THREADLOCAL int nvmmax = 0;
+    static THREADLOCAL vec *vm = 0x0;
 
     int i, iev, ip, iv, ivl, ivm, ivu;
-    long double s;
+    real_t s;
 
     /* number of midpoints */
     for (ivm = 0; ev[ivm] != nv; ivm++);
@@ -9,7 +9,7 @@
 #include "defaults.h"
 
 /* getopt options */
-const char *optstr = "dqz:m:s:e:v:p:i:o:";
+const char *optstr = "dqz:Z:m:s:e:v:p:i:o:";
 
 /* allocate polygons as a global array */
 polygon *polys_global[NPOLYSMAX];
@@ -49,21 +49,27 @@ int main(int argc, char *argv[])
 	}
     }
 
-    /* survey must have been specified */
-    if (!survey) {
+    /* survey or table of weights must have been specified */
+    if (!survey && !idweight_filename) {
 	fprintf(stderr, "%s requires -z<survey> option to specify the name of a survey,\n", argv[0]);
-	fprintf(stderr, "%*s or the name of a file containing a list of weights.\n", (int)strlen(argv[0]), "");
+	fprintf(stderr, "%*s or the name of a file containing a list of weights,\n", (int)strlen(argv[0]), "");
+	fprintf(stderr, "%*s or -Z<idfile> to specify a table of polygon ids and weights.\n", (int)strlen(argv[0]), "");
 	fprintf(stderr, "Please look in weight_fn.c for the names of known surveys.\n");
 	exit(1);
     }
 
     msg("---------------- weight ----------------\n");
 
+    /* read table of polygon ids and weights */
+    if (idweight_filename) {
+	if (rdidweight(idweight_filename) == -1) exit(1);
+    }
+
     /* tolerance angle for multiple intersections */
     if (mtol != 0.) {
 	scale(&mtol, munit, 's');
 	munit = 's';
-	msg("multiple intersections closer than %Lg%c will be treated as coincident\n", mtol, munit);
+	msg("multiple intersections closer than %" RL "g%c will be treated as coincident\n", mtol, munit);
 	scale(&mtol, munit, 'r');
 	munit = 'r';
     }
@@ -106,7 +112,7 @@ int main(int argc, char *argv[])
 void usage(void)
 {
     printf("usage:\n");
-    printf("weight [-d] [-q] -z<survey> [-m<a>[u]] [-s<n>] [-e<n>] [-vo|-vn|-vp] [-p[+|-][<n>]] [-i<f>[<n>][u]] [-o<f>[u]] polygon_infile1 [polygon_infile2 ...] polygon_outfile\n");
+    printf("weight [-d] [-q] -z<survey>|-Z<idfile> [-m<a>[u]] [-s<n>] [-e<n>] [-vo|-vn|-vp] [-p[+|-][<n>]] [-i<f>[<n>][u]] [-o<f>[u]] polygon_infile1 [polygon_infile2 ...] polygon_outfile\n");
 #include "usage.h"
 }
 
@@ -117,9 +123,16 @@ void usage(void)
 /*------------------------------------------------------------------------------
   Weight polygons.
 
+  Polygons whose id appears in the table read by rdidweight() take their
+  weight from the table.  The remaining polygons are weighted by survey
+  at a point inside the polygon.  Interior points are found in parallel;
+  survey is then called serially in polygon order, so that a file of weights
+  is read in lockstep with the polygons not in the table.
+
    Input: poly = array of pointers to polygons.
 	  npoly = pointer to number of polygons.
-	  survey = name of survey, or of filename containing list of weights.
+	  survey = name of survey, or of filename containing list of weights;
+		   may be null if all weights are to come from the table.
   Output: polys = array of pointers to polygons;
   Return value: number of polygons weighted,
 		or -1 if error occurred.
@@ -129,51 +142,122 @@ int weight(int npoly, polygon *poly[/*npoly*/], char *survey)
     const int per = 0;
     const int nve = 2;
 
-    int do_vcirc, i, imid, ipoly, iverts, ivm, nev, nev0, nomid, nv, nvm, nzero;
-    int *ipv, *gp, *ev;
-    long double tol;
-    long double *angle;
-    vec *ve, *vm;
-    azel v;
+    int ier, ipoly, nomid, nnotab, ntab, nzero;
+    int *imid;
+    azel *v;
 
-    nomid = 0;
-    nzero = 0;
+    imid = (int *) malloc(sizeof(int) * npoly);
+    if (!imid) {
+	fprintf(stderr, "weight: failed to allocate memory for %d integers\n", npoly);
+	return(-1);
+    }
+    v = (azel *) malloc(sizeof(azel) * npoly);
+    if (!v) {
+	fprintf(stderr, "weight: failed to allocate memory for %d az, el pairs\n", npoly);
+	return(-1);
+    }
+
+    /* weights from table of ids */
+    ntab = 0;
+    nnotab = 0;
     for (ipoly = 0; ipoly < npoly; ipoly++) {
-	/* vertices of polygon */
-	do_vcirc = 0;
-	tol = mtol;
-	iverts = gverts(poly[ipoly], do_vcirc, &tol, per, nve, &nv, &ve, &angle, &ipv, &gp, &nev, &nev0, &ev);
-	if (iverts != 0) return(-1);
-	/* point somewhere in the middle of the polygon */
-	imid = vmid(poly[ipoly], tol, nv, nve, ve, ipv, ev, &nvm, &vm);
-	if (imid == -1) return(-1);
-	/* check found a point inside the polygon */
-	imid = 0;
-	for (ivm = 0; ivm < nvm; ivm++) {
-	    if (vm[ivm][0] != 0. || vm[ivm][1] != 0. || vm[ivm][2] != 0.) {
-		imid = 1;
-		if (ivm > 0) for (i = 0; i < 3; i++) vm[0][i] = vm[ivm][i];
-		break;
+	imid[ipoly] = 0;
+	if (idweight_filename) {
+	    if (idweight(poly[ipoly]->id, &poly[ipoly]->weight)) {
+		/* flag weight found in table */
+		imid[ipoly] = 2;
+		ntab++;
+	    } else {
+		nnotab++;
+	    }
+	}
+    }
+    if (idweight_filename) {
+	msg("weight: %d polygons weighted from table of ids\n", ntab);
+	if (!survey && nnotab > 0) msg("weight: %d polygons not in table keep their weights\n", nnotab);
+    }
+
+    /* point somewhere in the middle of each polygon still needing a weight */
+    ier = 0;
+    if (survey) {
+#ifdef	_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+	for (ipoly = 0; ipoly < npoly; ipoly++) {
+	    int do_vcirc, i, ivm, iverts, nev, nev0, nv, nvm;
+	    int *ipv, *gp, *ev;
+	    real_t tol;
+	    real_t *angle;
+	    vec *ve, *vm;
+
+	    if (imid[ipoly] == 2) continue;
+	    /* vertices of polygon */
+	    do_vcirc = 0;
+	    tol = mtol;
+	    iverts = gverts(poly[ipoly], do_vcirc, &tol, per, nve, &nv, &ve, &angle, &ipv, &gp, &nev, &nev0, &ev);
+	    if (iverts != 0) {
+#ifdef	_OPENMP
+#pragma omp atomic write
+#endif
+		ier = -1;
+		continue;
+	    }
+	    /* point somewhere in the middle of the polygon */
+	    if (vmid(poly[ipoly], tol, nv, nve, ve, ipv, ev, &nvm, &vm) == -1) {
+#ifdef	_OPENMP
+#pragma omp atomic write
+#endif
+		ier = -1;
+		continue;
+	    }
+	    /* check found a point inside the polygon */
+	    for (ivm = 0; ivm < nvm; ivm++) {
+		if (vm[ivm][0] != 0. || vm[ivm][1] != 0. || vm[ivm][2] != 0.) {
+		    imid[ipoly] = 1;
+		    if (ivm > 0) for (i = 0; i < 3; i++) vm[0][i] = vm[ivm][i];
+		    break;
+		}
+	    }
+	    /* found a point */
+	    if (imid[ipoly] == 1) {
+		/* convert unit vector to az, el */
+		rp_to_azel(*vm, &v[ipoly]);
+		/* scale angles from radians to degrees */
+		scale_azel(&v[ipoly], 'r', 'd');
+	    } else {
+		v[ipoly].az = 0.;
+		v[ipoly].el = 0.;
 	    }
 	}
+    }
+    if (ier == -1) {
+	free(imid);
+	free(v);
+	return(-1);
+    }
+
+    nomid = 0;
+    nzero = 0;
+    for (ipoly = 0; ipoly < npoly; ipoly++) {
+	/* weight from table */
+	if (imid[ipoly] == 2 || !survey) {
+	    if (poly[ipoly]->weight == 0.) nzero++;
 	/* found a point */
-        if (imid == 1) {
-	    /* convert unit vector to az, el */
-	    rp_to_azel(*vm, &v);
-	    /* scale angles from radians to degrees */
-	    scale_azel(&v, 'r', 'd');
+	} else if (imid[ipoly] == 1) {
 	    /* weight at that point */
-	    poly[ipoly]->weight = weight_fn(v.az, v.el, survey);
+	    poly[ipoly]->weight = weight_fn(v[ipoly].az, v[ipoly].el, survey);
 	    if (poly[ipoly]->weight == 0.) nzero++;
 	/* failed to find a point */
 	} else {
 	  //call weight_fn to stay in right place in weight file if reading from weights from a file
-	    weight_fn(v.az, v.el, survey);
+	    weight_fn(v[ipoly].az, v[ipoly].el, survey);
 	    if (nomid == 0) msg("weight: failed to find interior point for the following polygons:\n");
 	    msg(" %lld", (fmt.newid == 'n')? (long long)ipoly+fmt.idstart : poly[ipoly]->id);
 	    nomid++;
 	}
     }
+    free(imid);
+    free(v);
     if (nomid > 0) msg("\n");
     if (nomid > 0) {
 	msg("weight: failed to find interior point for %d polygons\n", nomid);
@@ -36,9 +36,9 @@ calling fortran routines from c):
   Output: weight at angular position az, el;
 	  if survey is null, then weight is set to 1.
 */
-long double weight_fn(long double az, long double el, char *survey)
+real_t weight_fn(real_t az, real_t el, char *survey)
 {
-    long double weight;
+    real_t weight;
 
     /* null survey */
     if (!survey) {
@@ -77,13 +77,13 @@ long double weight_fn(long double az, long double el, char *survey)
   Input: survey = name of file containing weights.
   Return value: weight.
 */
-long double rdweight(char *survey)
+real_t rdweight(char *survey)
 {
 #ifndef BUFSIZE
 #  define	BUFSIZE		64
 #endif
     static int init = 0, nweight = 0;
-    static long double weight;
+    static real_t weight;
     static inputfile file = {
 	'\0',		/* input filename */
 	0x0,		/* input file stream */
@@ -130,9 +130,197 @@ long double rdweight(char *survey)
 	    }
 	}
 	/* read contents of line into weight */
-	iscan = sscanf(file.line, "%Lg", &weight);
+	iscan = sscanf(file.line, "%" RL "g", &weight);
 	nweight++;
     } while (!iscan);
 
     return(weight);
 }
+
+/*------------------------------------------------------------------------------
+  Table of weights indexed by polygon id.
+
+  The table is an open-addressed hash on id, so that weights can be looked
+  up for polygons in any order, unlike rdweight(), which must be called
+  in lockstep with the polygons.
+*/
+static int nidw = 0, nidwmax = 0;
+static long long *idw_id = 0x0;
+static real_t *idw_weight = 0x0;
+static char *idw_used = 0x0;
+
+/* magic string at the start of a binary id, weight file */
+#define IDWEIGHT_MAGIC		"MNGLIDW1"
+
+/*------------------------------------------------------------------------------
+  Hash of polygon id.
+*/
+static unsigned long long idw_hash(long long id)
+{
+    unsigned long long h;
+
+    h = (unsigned long long)id;
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return(h);
+}
+
+/*------------------------------------------------------------------------------
+  Insert id, weight into table, replacing any previous weight for id.
+  Return value: 0 if ok;
+		-1 if failed to allocate memory.
+*/
+static int idw_put(long long id, real_t weight)
+{
+    int i, n, nold;
+    long long *oid;
+    real_t *oweight;
+    char *oused;
+
+    /* keep table at most half full */
+    if (2 * (nidw + 1) > nidwmax) {
+	nold = nidwmax;
+	oid = idw_id;
+	oweight = idw_weight;
+	oused = idw_used;
+	nidwmax = (nidwmax > 0)? 2 * nidwmax : 1024;
+	idw_id = (long long *) malloc(sizeof(long long) * nidwmax);
+	idw_weight = (real_t *) malloc(sizeof(real_t) * nidwmax);
+	idw_used = (char *) calloc(nidwmax, sizeof(char));
+	if (!idw_id || !idw_weight || !idw_used) {
+	    fprintf(stderr, "idw_put: failed to allocate memory for table of %d weights\n", nidwmax);
+	    return(-1);
+	}
+	nidw = 0;
+	for (i = 0; i < nold; i++) {
+	    if (oused[i]) idw_put(oid[i], oweight[i]);
+	}
+	free(oid);
+	free(oweight);
+	free(oused);
+    }
+
+    n = nidwmax - 1;
+    for (i = (int)(idw_hash(id) & n); idw_used[i]; i = (i + 1) & n) {
+	if (idw_id[i] == id) {
+	    idw_weight[i] = weight;
+	    return(0);
+	}
+    }
+    idw_used[i] = 1;
+    idw_id[i] = id;
+    idw_weight[i] = weight;
+    nidw++;
+    return(0);
+}
+
+/*------------------------------------------------------------------------------
+  Read table of polygon id, weight pairs.
+
+  The file is either
+  (1) text: after arbitrary header lines, each line contains an id and a weight;
+      lines that do not start with two numbers are skipped;
+  (2) binary: the 8 characters IDWEIGHT_MAGIC, followed by records each
+      consisting of an 8-byte integer id and an 8-byte double weight,
+      in native byte order.
+  If an id occurs more than once, the last weight applies.
+
+  Input: filename = name of file.
+  Return value: number of weights in table,
+		or -1 if error occurred.
+*/
+int rdidweight(char *filename)
+{
+#ifndef BUFSIZE
+#  define	BUFSIZE		64
+#endif
+    char magic[8];
+    int ird, nread;
+    long long id;
+    real_t weight;
+    double dweight;
+    inputfile file = {
+	'\0',		/* input filename */
+	0x0,		/* input file stream */
+	'\0',		/* line buffer */
+	BUFSIZE,	/* size of line buffer (will expand as necessary) */
+	0,		/* line number */
+	0		/* maximum number of characters to read (0 = no limit) */
+    };
+
+    file.file = fopen(filename, "r");
+    if (!file.file) {
+	fprintf(stderr, "rdidweight: cannot open %s for reading\n", filename);
+	return(-1);
+    }
+    file.name = filename;
+
+    nread = 0;
+    /* binary file */
+    if (fread(magic, sizeof(char), 8, file.file) == 8 && memcmp(magic, IDWEIGHT_MAGIC, 8) == 0) {
+	while (fread(&id, sizeof(long long), 1, file.file) == 1) {
+	    if (fread(&dweight, sizeof(double), 1, file.file) != 1) {
+		fprintf(stderr, "rdidweight: unexpected EOF after %d weights in %s\n", nread, filename);
+		fclose(file.file);
+		return(-1);
+	    }
+	    if (idw_put(id, (real_t)dweight) == -1) {
+		fclose(file.file);
+		return(-1);
+	    }
+	    nread++;
+	}
+	msg("%d id, weight pairs read from binary file %s\n", nread, filename);
+
+    /* text file */
+    } else {
+	rewind(file.file);
+	while (1) {
+	    ird = rdline(&file);
+	    /* serious error */
+	    if (ird == -1) {
+		fclose(file.file);
+		return(-1);
+	    }
+	    /* EOF */
+	    if (ird == 0) break;
+	    if (sscanf(file.line, "%lld %" RL "g", &id, &weight) != 2) continue;
+	    if (idw_put(id, weight) == -1) {
+		fclose(file.file);
+		return(-1);
+	    }
+	    nread++;
+	}
+	msg("%d id, weight pairs read from %s\n", nread, filename);
+    }
+
+    fclose(file.file);
+    if (file.line) free(file.line);
+
+    return(nidw);
+}
+
+/*------------------------------------------------------------------------------
+  Look up weight of polygon id in table read by rdidweight().
+
+   Input: id = polygon id.
+  Output: *weight = weight of polygon id, if found; otherwise unchanged.
+  Return value: 1 if id was found;
+		0 if not.
+*/
+int idweight(long long id, real_t *weight)
+{
+    int i, n;
+
+    if (nidwmax == 0) return(0);
+
+    n = nidwmax - 1;
+    for (i = (int)(idw_hash(id) & n); idw_used[i]; i = (i + 1) & n) {
+	if (idw_id[i] == id) {
+	    *weight = idw_weight[i];
+	    return(1);
+	}
+    }
+    return(0);
+}
@@ -16,94 +16,185 @@
    returns the number of the pixel containing the point, or -1 if error occurs
 */
 
-int which_pixel(long double az, long double el, int res, char scheme)
+long long which_pixel(real_t az, real_t el, int res, char scheme)
 {
-  int n,m,pix,base_pix,i;
-  unsigned long pixnum;
-  long double az_check, el_check;
-  int *parent_pixels;
+  long long pix=-1;
+
+  which_pixels(1, &az, &el, res, scheme, &pix, 0x0);
+  return(pix);
+}
+
+/* per-resolution tables of starting pixel numbers, and of 2^res for scheme s */
+static THREADLOCAL int tables_done = 0;
+static THREADLOCAL long long start_s[RES_LIMIT+1], start_d[RES_LIMIT+1], start_h[HEALPIX_RES_LIMIT+1];
+static THREADLOCAL real_t scale_s[RES_LIMIT+1];
 
-  if(az<0){
-    az+=TWOPI;
+static void pixel_tables(void)
+{
+  int r;
+
+  for(r=0;r<=RES_LIMIT;r++){
+    start_s[r]=pixel_start(r,'s');
+    start_d[r]=pixel_start(r,'d');
+    scale_s[r]=ldexpl(1.,r);
   }
-  if(az>TWOPI){
-    az-=TWOPI;
+  for(r=0;r<=HEALPIX_RES_LIMIT;r++){
+    start_h[r]=pixel_start(r,'h');
   }
-  
-  if(az>TWOPI || az<0){
-    fprintf(stderr, "error in which_pixel: az must lie between 0 and 2*PI.\n");
+  tables_done=1;
+}
+
+/* Function which_pixels is the batch version of which_pixel, with optionally
+   the parent pixels of each point, as get_parent_pixels would give them.
+   Pixel numbers are computed with table lookups and integer arithmetic,
+   without allocating memory.
+   inputs:
+   n: number of points
+   az[n]: azimuth angles (in radians)
+   el[n]: elevation angles (in radians)
+   res: desired resolution of the pixels to be returned
+   scheme: pixelization scheme
+   outputs:
+   pix[n]: pixel numbers of resolution res containing the points, or -1 for a bad point
+   parents[n*(res+1)]: if not null, parents[i*(res+1)+r] is the parent pixel of
+   resolution r of point i, so parents[i*(res+1)+res]=pix[i]
+   returns 0 on success, -1 if error occurs
+*/
+
+int which_pixels(int n, real_t az[/*n*/], real_t el[/*n*/], int res, char scheme, long long pix[/*n*/], long long parents[/*n*(res+1)*/])
+{
+  int i, r, ier, bad;
+  long long j, k, nx, base_pix;
+  long long *pp;
+  unsigned long pixnum;
+  real_t a, e, sine;
+  azel v;
+  vec rp;
+
+  if(res<0){
+    fprintf(stderr, "error in which_pixel: resolution must be an integer >=0.\n");
     return(-1);
   }
-  if(el>PIBYTWO || el<-PIBYTWO){
-    fprintf(stderr, "error in which_pixel: el must lie between -PI/2 and PI/2.\n");
+  if(res>RES_LIMIT){
+    fprintf(stderr, "error in which_pixel: resolution must be <= %d.\n", RES_LIMIT);
     return(-1);
   }
-  if(res<0){
-    fprintf(stderr, "error in which_pixel: resolution must be an integer >=0.\n");
+  if(scheme!='s' && scheme!='h' && scheme!='d'){
+    fprintf(stderr, "error in which_pixel: pixel scheme %c not recognized.\n", scheme);
+    return(-1);  
+  }
+  if(scheme=='h' && res>HEALPIX_RES_LIMIT){
+    fprintf(stderr, "error in which_pixel: resolution of scheme h must be <= %d.\n", HEALPIX_RES_LIMIT);
     return(-1);
   }
-  
+  if(!tables_done) pixel_tables();
+  if(scheme=='d') assign_parameters();
 
-  if(scheme=='s'){
-    // this scheme divides up the sphere by rectangles in az and el, and is numbered 
-    // such that the resolution is encoded in each pixel number.  The whole sky is pixel 0,
-    // pixels 1, 2, 3, and 4 are each 1/4 of the sky (resolution 1), pixels 5-20 are each 
-    // 1/16 of the sky (resolution 2), etc.
+  ier=0;
+  for(i=0;i<n;i++){
+    a=az[i];
+    e=el[i];
+    pp=(parents)? &parents[(long long)i*(res+1)] : 0x0;
 
+    if(a<0){
+      a+=TWOPI;
+    }
+    if(a>TWOPI){
+      a-=TWOPI;
+    }
+    bad=0;
+    if(a>TWOPI || a<0){
+      fprintf(stderr, "error in which_pixel: az must lie between 0 and 2*PI.\n");
+      bad=1;
+    }
+    if(e>PIBYTWO || e<-PIBYTWO){
+      fprintf(stderr, "error in which_pixel: el must lie between -PI/2 and PI/2.\n");
+      bad=1;
+    }
+    if(bad){
+      pix[i]=-1;
+      if(pp) for(r=0;r<=res;r++) pp[r]=-1;
+      ier=-1;
+      continue;
+    }
 
-    if(az==TWOPI) az=0;
-    n=(sinl(el)==1) ? 0 : ceill((1-sinl(el))/2*powl(2,res))-1;
-    
-    m=floorl(az/(TWOPI)*powl(2,res));
-    base_pix=powl(2,res)*n+m;
-    pix=pixel_start(res,scheme)+base_pix; 
-    return(pix);
-  }
-  else if(scheme=='d'){
-    assign_parameters();
-    if(az==TWOPI) az=0;
-    /* ang2pix_radec takes az and el in degrees */
-    az *= (180.0/PI);
-    el *= (180.0/PI);
+    if(scheme=='s'){
+      // this scheme divides up the sphere by rectangles in az and el, and is numbered 
+      // such that the resolution is encoded in each pixel number.  The whole sky is pixel 0,
+      // pixels 1, 2, 3, and 4 are each 1/4 of the sky (resolution 1), pixels 5-20 are each 
+      // 1/16 of the sky (resolution 2), etc.
+      // Row j (from the north) and column k at res give row j>>(res-r) and column k>>(res-r) at r.
 
-    if(res==0){
-      return(0);
+      if(a==TWOPI) a=0;
+      sine=sinl(e);
+      j=(sine==1) ? 0 : ceill((1-sine)/2*scale_s[res])-1;
+      k=floorl(a/(TWOPI)*scale_s[res]);
+      pix[i]=start_s[res]+(j<<res)+k;
+      if(pp){
+	for(r=res;r>=0;r--){
+	  pp[r]=start_s[r]+(j<<r)+k;
+	  j>>=1;
+	  k>>=1;
+	}
+      }
     }
-
-    else if(res==1){
-      parent_pixels = (int *) malloc(sizeof(int) * (3));
-      if(!parent_pixels){
-	fprintf(stderr, "error in which_pixel: failed to allocate memory for 3 integers\n");
-	return(-1);
+    else if(scheme=='h'){
+      // HEALPix-like NESTED scheme with nside=2^(res-1); see get_pixel.
+      // In terms of q=pix+3=4^res+hpix, the parent of q is q/4.
+      if(res==0){
+	pix[i]=0;
       }
-
-      ang2pix_radec(1, az, el, &pixnum);
-      pix = (int)pixnum;
-
-      i = get_parent_pixels(pix+pixel_start(2,scheme), parent_pixels, scheme);
-      if(i==1){
-	fprintf(stderr, "error in which_pixel: get_parent_pixels failed\n");
-	return(-1);
+      else{
+	v.az=a;
+	v.el=e;
+	azel_to_rp(&v, rp);
+	pix[i]=start_h[res]+healpix_nest_pixel(res, rp);
+      }
+      if(pp){
+	base_pix=pix[i]+3;
+	for(r=res;r>=1;r--){
+	  pp[r]=base_pix-3;
+	  base_pix>>=2;
+	}
+	pp[0]=0;
       }
-
-      return(parent_pixels[1]);
     }
-
-    else{
-      ang2pix_radec((int)powl(2,res-2), az, el, &pixnum);
-      pix = (int)pixnum;
-
-       /* check
-       pix2ang_radec((int)powl(2,res-1), pixnum, &az_check, &el_check);
-       printf("pix2ang_radec(pixnum = %d) = %Lf, %Lf\n", (int)pixnum, az_check, el_check); */
-
-      return(pix+pixel_start(res, scheme));
+    else if(scheme=='d'){
+      // SDSSPix: pixels of resolution r>=2 are rows j and columns k of a grid of
+      // 13*2^(r-2) by 36*2^(r-2) pixels, so row j>>(res-r) and column k>>(res-r) at r.
+      // Resolution 1 pixels are 2x2 blocks of resolution 2 pixels in the first 12 rows,
+      // and 1x4 blocks in the last row.
+      if(res==0){
+	pix[i]=0;
+	if(pp) pp[0]=0;
+	continue;
+      }
+      if(a==TWOPI) a=0;
+      /* ang2pix_radec takes az and el in degrees */
+      r=(res>=2)? res : 2;
+      nx=36LL<<(r-2);
+      ang2pix_radec((int)(1LL<<(r-2)), a*(180.0/PI), e*(180.0/PI), &pixnum);
+      j=(long long)pixnum/nx;
+      k=(long long)pixnum-j*nx;
+      if(res>=2) pix[i]=start_d[res]+(long long)pixnum;
+      if(pp || res==1){
+	for(;r>=2;r--){
+	  if(pp) pp[r]=start_d[r]+j*(36LL<<(r-2))+k;
+	  if(r>2){
+	    j>>=1;
+	    k>>=1;
+	  }
+	}
+	base_pix=(j<12)? (j/2)*18+k/2+1 : 109+k/4;
+	if(res==1) pix[i]=base_pix;
+	if(pp){
+	  pp[1]=base_pix;
+	  pp[0]=0;
+	}
+      }
     }
   }
-  else{
-    fprintf(stderr, "error in which_pixel: pixel scheme %c not recognized.\n", scheme);
-    return(-1);  
-  }
+  return(ier);
 }
 
 /* Function get_parent_pixels generates a list of the parent pixels for a given child pixel.
@@ -115,13 +206,14 @@ int which_pixel(long double az, long double el, int res, char scheme)
    returns 0 on success, 1 on error
 */
 
-int get_parent_pixels(int pix_c, int pix_p[], char scheme){
-  int m,n,res,base_pix,i,j;
+int get_parent_pixels(long long pix_c, long long pix_p[], char scheme){
+  int res,i,j;
+  long long m,n,base_pix;
   unsigned long pixp;
   //long double res_d;
 
   if(pix_c<0){
-    fprintf(stderr, "error in get_parent_pixels: %d is not a valid pixel number\n",pix_c);
+    fprintf(stderr, "error in get_parent_pixels: %lld is not a valid pixel number\n",pix_c);
     return(1);
   }
 
@@ -135,18 +227,28 @@ int get_parent_pixels(int pix_c, int pix_p[], char scheme){
     // 1/16 of the sky (resolution 2), etc.
     
     base_pix=pix_c-pixel_start(res,scheme);
-    m=base_pix % (int)(powl(2,res));
-    n=(base_pix-m)/powl(2,res);
+    m=base_pix & ((1LL<<res)-1);
+    n=base_pix >> res;
 
     for(i=res;i>=0;i--){
       //put pixel number into array
-      pix_p[i]=pixel_start(i,scheme)+(int)(powl(2,i))*n+m;
+      pix_p[i]=pixel_start(i,scheme)+(n<<i)+m;
       //make child pixel into next parent pixel
       n=n/2;
       m=m/2;
     }
     return(0);
   }
+  else if(scheme=='h'){
+    // in terms of q=pix+3=4^res+hpix, the parent of q is q/4
+    base_pix=pix_c+3;
+    for(i=res;i>=1;i--){
+      pix_p[i]=base_pix-3;
+      base_pix>>=2;
+    }
+    pix_p[0]=0;
+    return(0);
+  }
   else if(scheme=='d'){
     assign_parameters();
     //printf("res = %d\n", res);
@@ -161,7 +263,7 @@ int get_parent_pixels(int pix_c, int pix_p[], char scheme){
       //printf("args to superpix: %d, %d, %d\n", (int)powl(2,i-1), pix_p[i]-pixel_start(i, scheme), (int)powl(2,i-2));
       superpix((int)powl(2,i-2), (unsigned long)pix_p[i]-(unsigned long)pixel_start(i, scheme), (int)powl(2,i-3), &pixp);
       //printf("pixp = %d\n", (int)pixp);
-      pix_p[i-1] = (int)pixp + pixel_start(i-1, scheme);
+      pix_p[i-1] = (long long)pixp + pixel_start(i-1, scheme);
     }
     for(j=0;j<=5;j++){
       for(i=118+j*72;i<=152+j*72;i+=2){
@@ -190,7 +292,7 @@ int get_parent_pixels(int pix_c, int pix_p[], char scheme){
    or -1 if error occurs
 */
 
-int pixel_start(int res, char scheme){
+long long pixel_start(int res, char scheme){
 
   //int res1;
   //long double res_d;
@@ -199,9 +301,18 @@ int pixel_start(int res, char scheme){
     fprintf(stderr, "error in pixel_start: %d not a valid resolution.\n", res);
     return(-1);
   }
+  if(res>RES_LIMIT+1){
+    fprintf(stderr, "error in pixel_start: resolution %d exceeds maximum %d.\n", res, RES_LIMIT+1);
+    return(-1);
+  }
   
   if(scheme=='s'){
-    return ((int)((powl(4,res)-1)/3));
+    return (((1LL<<(2*res))-1)/3);
+  }
+  else if(scheme=='h'){
+    // 1 pixel at resolution 0, and 12*4^(res-1) NESTED pixels at resolution res>=1
+    if(res==0) return(0);
+    return ((1LL<<(2*res))-3);
   }
   else if(scheme=='d'){
     //res_d = (long double)(logl((long double)res)/logl(2.0))+1;
@@ -209,7 +320,7 @@ int pixel_start(int res, char scheme){
     //printf("pixel_start: res = %d\n", res);
     if(res==0) return(0);
     else if(res==1) return(1);
-    else return (468*(((int)powl(4,res-1)-4)/12)+118);
+    else return (468*(((1LL<<(2*(res-1)))-4)/12)+118);
   }
   else{
     fprintf(stderr, "error in pixel_start: pixel scheme %c not recognized.\n", scheme);
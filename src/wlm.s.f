@@ -1,16 +1,18 @@
 c-----------------------------------------------------------------------
 c  A J S Hamilton 2001
 c-----------------------------------------------------------------------
-      subroutine wlm(w,lmax1,im,nw,ri,phi,qphi,zi,ci,si,ph,dph,v)
-      integer lmax1,im,nw,qphi
-      real*10 w(im,nw),ri,phi,zi,ci,si,ph,dph,v(lmax1)
+      subroutine wlm(w,lmin,lmax1,im,nw,ri,phi,qphi,zi,ci,si,ph,dph,v)
+#include "real.par"
+      integer lmin,lmax1,im,nw,qphi
+      real(KR) w(im,(lmin*(lmin+1))/2+1:nw),ri,phi,zi,ci,si,ph,dph,
+     *  v(lmax1)
 c
 c        parameters
-      real*10 HALF
-      parameter (HALF=1._10/2._10)
+      real(KR) HALF
+      parameter (HALF=1._KR/2._KR)
       include 'pi.par'
-      real*10 TWOPI
-      parameter (TWOPI=2._10*PI)
+      real(KR) TWOPI
+      parameter (TWOPI=2._KR*PI)
 
 c largest non-overflowing 2^(DBL_MAX_EXP-1) for real*10 (from values.h)
       integer DBL_MAX_EXP
@@ -20,11 +22,21 @@ c        intrinsics
       intrinsic abs,max
 c        local variables
       integer l,lm,l1,m,mmax1,mmin1,mn,mn1,mq,m1,n,nmax1,n1
-      integer ed,edm,edn,ee,eem,een,ez,ezn,iez
-      real*10 al,al1,am,an,cm,cmp,cmphi,cnph,cp,
+      integer ed,edm,edn,ee,eem,een,ez,ezn,iez,k,mhi,mlo
+      real(KR) al,al1,am,an,cm,cmp,cmphi,cnph,cp,
      *  d,dim,dm,dme,dn,dpe,dre,d0,d1,d2,e,ed0,em,en,e1,e2,fn,q,qq,q1,
-     *  smphi,snph,t,z,zm,zn,zp
-      real*10 OVFLOW,UNFLOW
+     *  rq,smphi,snph,snv,cnv,t,z,zm,zn,zp
+      real(KR) OVFLOW,UNFLOW
+c        automatic work arrays:
+c        sqrt(k), 1/sqrt(k), 1/k;
+c        factors of recursion coefficients depending on l and n;
+c        cos and sin of m*phi;
+c        d(l,m,n) and e(l,m,n) for each m, at l even and odd,
+c        and the l from which the loop over m inside takes over
+      real(KR) sq(0:2*lmax1),rsq(0:2*lmax1),rl(0:2*lmax1),
+     *  qn(0:lmax1),rqn(0:lmax1),tn(0:lmax1),cmv(0:lmax1),smv(0:lmax1),
+     *  dd(0:lmax1,0:1),edd(0:lmax1,0:1)
+      integer ls(0:lmax1),ip
 c *
 c * Calculates contribution to spherical transform w(lm)
 c * by boundary segment of window function w=sum w(lm)*Y(l,m).
@@ -57,7 +69,8 @@ c *
 c * Numerical experiment indicates that underflow sets in earlier
 c * for the rotation matrix -- about l = 200, for sin(th) = 1/e.
 c *
-c  Input: lmax1 = lmax+1 where lmax is maximum desired l of transform.
+c  Input: lmin = minimum desired l of transform.
+c         lmax1 = lmax+1 where lmax is maximum desired l of transform.
 c         im = 1 means compute real part of harmonics only;
 c              2 means compute both real and imaginary parts.
 c              Note a region has pure real harmonics if it has mirror
@@ -72,20 +85,63 @@ c              zero being such that rotation from z-axis to cone axis
 c              is about cone's y-axis.
 c         dph = azimuthal angle subtended by segment.
 c Input/Output: w(i,lm) = spherical transform
-c            w(i,lm), i=1,im, lm=l*(l+1)/2+m+1, l=0,lmax, m=0,l;
+c            w(i,lm), i=1,im, lm=l*(l+1)/2+m+1, l=lmin,lmax, m=0,l;
+c            the recursions start from l=0 whatever lmin,
+c            but only harmonics with l.ge.lmin are stored;
 c            w(1,lm) is real part, w(2,lm) is imaginary part;
 c            w(i,lm) is ADDED to input w(i,lm).
 c         Note w(l,-m)=(-)^m*[Complex conjugate of w(l,m)], just as
 c              Y(l,-m)=(-)^m*[Complex conjugate of Y(l,m)].
 c Work array: v should be dimensioned at least lmax1
 c
-      if (lmax1.le.0) goto 300
-      if (dph.eq.0._10) goto 300
+c The coefficients of the recursions are products of sqrt(k) and 1/k,
+c tabulated once per call, so the loops over l need no sqrt or division.
+c Rescaling of the rotation matrix against underflow is needed only
+c for the first few l of each m, until the exponents ed and ee return
+c to zero.  Those l are done for each m in turn; the rest are done
+c with l outside and m inside, where the recursions for different m
+c are independent and w(i,lm) is contiguous in m, free of rescaling
+c and of dependence from one iteration to the next.
+c
+      if (lmax1.le.lmin) goto 300
+      if (dph.eq.0._KR) goto 300
+      sq(0)=0._KR
+      rsq(0)=0._KR
+      rl(0)=0._KR
+      do k=1,2*lmax1
+        sq(k)=sqrt(real(k,KR))
+        rsq(k)=1._KR/sq(k)
+        rl(k)=1._KR/real(k,KR)
+      enddo
+c        cos and sin of m*phi
+      do m=0,lmax1-1
+        am=m
+        cmphi=cos(am*phi)
+        smphi=sin(am*phi)
+        if (qphi.ne.0) then
+          mq=m*qphi
+          if (mod(mq/2,2).ne.0) then
+            cmphi=-cmphi
+            smphi=-smphi
+          endif
+          if (mod(mq,2).eq.1) then
+            cmp=cmphi
+            cmphi=-smphi
+            smphi=cmp
+          elseif (mod(mq,2).eq.-1) then
+            cmp=cmphi
+            cmphi=smphi
+            smphi=-cmp
+          endif
+        endif
+        cmv(m)=cmphi
+        smv(m)=smphi
+      enddo
 c        largest non-overflowing power of 2 for real*10
-      OVFLOW=2._10**(DBL_MAX_EXP-1)
-      UNFLOW=1._10/OVFLOW
-      z=OVFLOW*0._10
-      if (z.ne.0._10.or.UNFLOW.eq.0._10) then
+      OVFLOW=2._KR**(DBL_MAX_EXP-1)
+      UNFLOW=1._KR/OVFLOW
+      z=OVFLOW*0._KR
+      if (z.ne.0._KR.or.UNFLOW.eq.0._KR) then
         print *,'*** from wlm: DBL_MAX_EXP on your machine appears to be
      * <',DBL_MAX_EXP
         print *,' please modify DBL_MAX_EXP in wlm.s.f in the mangle dir
@@ -96,11 +152,11 @@ c        largest non-overflowing power of 2 for real*10
       endif
 c        cm=(zi-1)/2; cp=(zi+1)/2
 c        done this way to ensure accuracy at small ri
-      cm=-((1._10-zi)**2+ri**2)/4._10
-      cp=((1._10+zi)**2+ri**2)/4._10
+      cm=-((1._KR-zi)**2+ri**2)/4._KR
+      cp=((1._KR+zi)**2+ri**2)/4._KR
       nmax1=lmax1
       if (dph.eq.TWOPI.or.dph.eq.-TWOPI) nmax1=1
-      if (si.eq.0._10) nmax1=1
+      if (si.eq.0._KR) nmax1=1
       mmin1=1
       mmax1=lmax1
       do 280 n1=1,nmax1
@@ -115,7 +171,7 @@ c........l = n = 0
           if (n.eq.0) then
             if (l.eq.0) then
 c        zn=z(0,0)
-              zn=1._10/sqrt(2._10*TWOPI)
+              zn=1._KR/sqrt(2._KR*TWOPI)
               ezn=0
               ez=ezn
               fn=dph
@@ -132,7 +188,7 @@ c        zm=z(l-1,0); z=z(l,0); zp=z(l+1,0)
               z=zp
               zp=(qq*ci*z-al*zm)/al1
 c        v(l,0)
-              v(l1)=fn/sqrt(qq)*(zm-zp)
+              v(l1)=fn*rsq(l1+l)*(zm-zp)
             endif
 c........l = n > 0
           elseif (l.eq.n) then
@@ -147,9 +203,9 @@ c        zn may underflow
             endif
             ez=ezn
             zn=z
-            fn=2._10*sin(an*dph/2._10)/an
+            fn=2._KR*sin(an*dph/2._KR)/an
 c        z=z(l,l); zp=z(l+1,l)
-            q=sqrt(al1+al)
+            q=sq(l1+l)
             zp=q*ci*z
 c        v=v(l,l)
             v(l1)=-fn/al1*zp
@@ -158,15 +214,15 @@ c........l > n > 0
 c        zm=z(l-1,n); z=z(l,n); zp=z(l+1,n)
             qq=al1+al
             q1=q
-            q=sqrt((al1+an)*(al1-an))
+            q=sq(l1+n)*sq(l1-n)
             zm=z
             z=zp
-            zp=(qq*ci*z-q1*zm)/q
+            zp=(qq*ci*z-q1*zm)*rsq(l1+n)*rsq(l1-n)
             if (ez.gt.0) then
 c        recover from underflow
-              if (abs(zp).ge.1._10
-     *          .and.(abs(z).ge.1._10.or.z.eq.0._10)
-     *          .and.(abs(zm).ge.1._10.or.zm.eq.0._10)) then
+              if (abs(zp).ge.1._KR
+     *          .and.(abs(z).ge.1._KR.or.z.eq.0._KR)
+     *          .and.(abs(zm).ge.1._KR.or.zm.eq.0._KR)) then
                 ez=ez-1
                 zm=zm*UNFLOW
                 z=z*UNFLOW
@@ -174,7 +230,7 @@ c        recover from underflow
               endif
             endif
 c        v=v(l,n)
-            v(l1)=fn/sqrt(qq)*(q1/al*zm-q/al1*zp)
+            v(l1)=fn*rsq(l1+l)*(q1*rl(l)*zm-q*rl(l1)*zp)
           endif
 c........restore correct scaling
           if (ez.gt.0) then
@@ -185,44 +241,37 @@ c........restore correct scaling
         enddo
 c........skip rotation if harmonics in cone frame are all zero
         do l1=lmax1,n1,-1
-          if (v(l1).ne.0._10) goto 220
+          if (v(l1).ne.0._KR) goto 220
         enddo
         goto 280
   220   continue
 c--------matrix d(l,m,n) to rotate v(l,n) about cone y-axis
         cnph=cos(an*ph)
         snph=sin(an*ph)
+c        factors of the recursion coefficients that depend on l and n
+        qn(0)=0._KR
+        rqn(0)=0._KR
+        tn(0)=0._KR
+        do l=1,lmax1-1
+          qn(l)=sq(l+n)*sq(l-n)*rl(l)
+          rqn(l)=rsq(l+n)*rsq(l-n)*real(l,KR)
+          tn(l)=an*rl(l-1)*rl(l)
+        enddo
 c        cone axis is parallel to desired axis
-        if (ri.eq.0._10) then
+        if (ri.eq.0._KR) then
           mmin1=n1
           mmax1=n1
         endif
         do m1=mmin1,mmax1
           m=m1-1
           am=m
-          cmphi=cos(am*phi)
-          smphi=sin(am*phi)
-          if (qphi.ne.0) then
-            mq=m*qphi
-            if (mod(mq/2,2).ne.0) then
-              cmphi=-cmphi
-              smphi=-smphi
-            endif
-            if (mod(mq,2).eq.1) then
-              cmp=cmphi
-              cmphi=-smphi
-              smphi=cmp
-            elseif (mod(mq,2).eq.-1) then
-              cmp=cmphi
-              cmphi=smphi
-              smphi=-cmp
-            endif
-          endif
+          cmphi=cmv(m)
+          smphi=smv(m)
 c........m = n = 0
           if (m.eq.0) then
             if (n.eq.0) then
 c        d0=d(0,0,0)
-              d0=1._10
+              d0=1._KR
               ed0=0
 c        initialize dn, en
               dn=d0
@@ -250,17 +299,17 @@ c        initialize dm, em
 c........0 < m < n
           elseif (m.lt.n) then
 c        dm=d(n,m,n); em=(-)^n*d(n,m,-n)
-            t=sqrt((an-am+1._10)/(an+am))*2._10/ri
+            t=sqrt((an-am+1._KR)/(an+am))*2._KR/ri
 c        dm
             d=dm*cp*t
 c        dm may underflow ...
-            if (abs(d).le.UNFLOW.and.dm.ne.0._10) then
+            if (abs(d).le.UNFLOW.and.dm.ne.0._KR) then
               dm=dm*OVFLOW
               d=dm*cp*t
               edm=edm+1
 c        ... or may recover from underflow
             elseif (edm.gt.0) then
-              if (abs(d).ge.1._10) then
+              if (abs(d).ge.1._KR) then
                 d=d*UNFLOW
                 edm=edm-1
               endif
@@ -269,13 +318,13 @@ c        ... or may recover from underflow
 c        em
             e=em*cm*t
 c        em may underflow ...
-            if (abs(e).le.UNFLOW.and.em.ne.0._10) then
+            if (abs(e).le.UNFLOW.and.em.ne.0._KR) then
               em=em*OVFLOW
               e=em*cm*t
               eem=eem+1
 c        ... or may recover from underflow
             elseif (eem.gt.0) then
-              if (abs(e).ge.1._10) then
+              if (abs(e).ge.1._KR) then
                 e=e*UNFLOW
                 eem=eem-1
               endif
@@ -287,7 +336,7 @@ c        dn=d(n,n,n); en=(-)^n*d(n,n,-n)
 c        dn
             d=cp*dn
 c        dn may underflow
-            if (abs(d).le.UNFLOW.and.dn.ne.0._10) then
+            if (abs(d).le.UNFLOW.and.dn.ne.0._KR) then
               dn=dn*OVFLOW
               d=cp*dn
               edn=edn+1
@@ -296,7 +345,7 @@ c        dn may underflow
 c        en
             e=cm*en
 c        en may underflow
-            if (abs(e).le.UNFLOW.and.en.ne.0._10) then
+            if (abs(e).le.UNFLOW.and.en.ne.0._KR) then
               en=en*OVFLOW
               e=cm*en
               een=een+1
@@ -314,13 +363,13 @@ c        dm=d(m,m,n); em=(-)^n*d(m,m,-n)
 c        dm
             d=t*dm
 c        dm may underflow ...
-            if (abs(d).le.UNFLOW.and.dm.ne.0._10) then
+            if (abs(d).le.UNFLOW.and.dm.ne.0._KR) then
               dm=dm*OVFLOW
               d=t*dm
               edm=edm+1
 c        ... or may recover from underflow
             elseif (edm.gt.0) then
-              if (abs(d).ge.1._10) then
+              if (abs(d).ge.1._KR) then
                 d=d*UNFLOW
                 edm=edm-1
               endif
@@ -330,13 +379,13 @@ c        em
             if (n.gt.0) then
               e=t*em
 c        em may underflow ...
-              if (abs(e).le.UNFLOW.and.em.ne.0._10) then
+              if (abs(e).le.UNFLOW.and.em.ne.0._KR) then
                 em=em*OVFLOW
                 e=t*em
                 eem=eem+1
 c        ... or may recover from underflow
               elseif (eem.gt.0) then
-                if (abs(e).ge.1._10) then
+                if (abs(e).ge.1._KR) then
                   e=e*UNFLOW
                   eem=eem-1
                 endif
@@ -344,7 +393,7 @@ c        ... or may recover from underflow
               em=e
             endif
           endif
-c........l >= m, n
+c........l >= m, n, for as long as d or e is rescaled
           mn=max(m,n)
           mn1=mn+1
           do 240 l1=mn1,lmax1
@@ -353,33 +402,34 @@ c........l >= m, n
 c        d=d(l,m,n); e=(-)^n*d(l,m,-n)
             if (l.eq.mn) then
               lm=(l*l1)/2+m1
-              q=0._10
-              d1=0._10
+              q=0._KR
+              d1=0._KR
               d=dm
               ed=edm
               if (n.eq.0) then
-                e=0._10
+                e1=0._KR
+                e=0._KR
                 ee=0
               elseif (n.gt.0) then
-                e1=0._10
+                e1=0._KR
                 e=em
                 ee=eem
               endif
             elseif (l.gt.mn) then
               lm=lm+l
-              qq=2._10*al-1._10
+              qq=2._KR*al-1._KR
               q1=q
-              q=sqrt((al+am)*(al-am)*(al+an)*(al-an))/al
-              t=0._10
-              if (m*n.gt.0) t=am*an/((al-1._10)*al)
+              q=sq(l+m)*sq(l-m)*qn(l)
+              rq=rsq(l+m)*rsq(l-m)*rqn(l)
+              t=am*tn(l)
               d2=d1
               d1=d
-              d=(qq*(zi-t)*d1-q1*d2)/q
+              d=(qq*(zi-t)*d1-q1*d2)*rq
 c        recover d from underflow
               if (ed.gt.0) then
-                if (abs(d).ge.1._10
-     *            .and.(abs(d1).ge.1._10.or.e1_10.eq.0._10)
-     *            .and.(abs(d2).ge.1._10.or.e2_10.eq.0._10)) then
+                if (abs(d).ge.1._KR
+     *            .and.(abs(d1).ge.1._KR.or.d1.eq.0._KR)
+     *            .and.(abs(d2).ge.1._KR.or.d2.eq.0._KR)) then
                   d2=d2*UNFLOW
                   d1=d1*UNFLOW
                   d=d*UNFLOW
@@ -389,12 +439,12 @@ c        recover d from underflow
               if (n.gt.0) then
                 e2=e1
                 e1=e
-                e=(qq*(zi+t)*e1-q1*e2)/q
+                e=(qq*(zi+t)*e1-q1*e2)*rq
 c        recover e from underflow
                 if (ee.gt.0) then
-                  if (abs(e).ge.1._10
-     *              .and.(abs(e1).ge.1._10.or.e1.eq.0._10)
-     *              .and.(abs(e2).ge.1._10.or.e2.eq.0._10)) then
+                  if (abs(e).ge.1._KR
+     *              .and.(abs(e1).ge.1._KR.or.e1.eq.0._KR)
+     *              .and.(abs(e2).ge.1._KR.or.e2.eq.0._KR)) then
                     e2=e2*UNFLOW
                     e1=e1*UNFLOW
                     e=e*UNFLOW
@@ -427,11 +477,51 @@ c           endif
                 goto 240
               endif
             endif
-            dre=cnph*dpe*v(l1)
-            dim=snph*dme*v(l1)
-            w(1,lm)=w(1,lm)+cmphi*dre-smphi*dim
-            if (im.eq.2) w(2,lm)=w(2,lm)-cmphi*dim-smphi*dre
+            if (l.ge.lmin) then
+              dre=cnph*dpe*v(l1)
+              dim=snph*dme*v(l1)
+              w(1,lm)=w(1,lm)+cmphi*dre-smphi*dim
+              if (im.eq.2) w(2,lm)=w(2,lm)-cmphi*dim-smphi*dre
+            endif
+c        d and e at their true scale: do the rest of l below
+            if (ed.eq.0.and.ee.eq.0) goto 250
   240     continue
+          ls(m)=lmax1-1
+          goto 260
+  250     ls(m)=l
+          dd(m,mod(l,2))=d
+          dd(m,1-mod(l,2))=d1
+          edd(m,mod(l,2))=e
+          edd(m,1-mod(l,2))=e1
+  260     continue
+        enddo
+c--------rest of l, m, with l outside and m inside
+        do l=n+1,lmax1-1
+          al=l
+          qq=2._KR*al-1._KR
+          lm=(l*(l+1))/2+1
+          mlo=mmin1-1
+          mhi=min(l,mmax1)-1
+          ip=mod(l,2)
+          cnv=cnph*v(l+1)
+          snv=snph*v(l+1)
+          do m=mlo,mhi
+            if (ls(m).lt.l) then
+              q1=sq(l-1+m)*sq(l-1-m)*qn(l-1)
+              rq=rsq(l+m)*rsq(l-m)*rqn(l)
+              t=m*tn(l)
+              d=(qq*(zi-t)*dd(m,1-ip)-q1*dd(m,ip))*rq
+              e=(qq*(zi+t)*edd(m,1-ip)-q1*edd(m,ip))*rq
+              dd(m,ip)=d
+              edd(m,ip)=e
+              if (l.ge.lmin) then
+                dre=cnv*(d+e)
+                dim=snv*(d-e)
+                w(1,lm+m)=w(1,lm+m)+cmv(m)*dre-smv(m)*dim
+                if (im.eq.2) w(2,lm+m)=w(2,lm+m)-cmv(m)*dim-smv(m)*dre
+              endif
+            endif
+          enddo
         enddo
   280 continue
 c--------done
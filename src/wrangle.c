@@ -21,14 +21,14 @@
   Output: str = pointer to string containing the angle.
 	  str_len = length of string.
 */
-void wrangle(long double angle, char unit, int precision, size_t str_len, char str[/*str_len*/])
+void wrangle(real_t angle, char unit, int precision, size_t str_len, char str[/*str_len*/])
 {
 /* default number of significant digits */
 #define DIGITS		15
     char sign;
-    int hour, min;
+    int hour, i, min, n;
     int width;
-    long double a, sec;
+    real_t a, sec;
 
     if (unit == 'h') {
 	sign = (angle < 0.)? '-' : ' ';
@@ -41,7 +41,7 @@ void wrangle(long double angle, char unit, int precision, size_t str_len, char s
 	if (precision < 0) precision = DIGITS - 7;
 	width = precision + 3;
 	if (precision == 0) width--;
-	snprintf(str, str_len, "%c%02d %02d %0*.*Lf",
+	snprintf(str, str_len, "%c%02d %02d %0*.*" RL "f",
 	    sign, hour, min, width, precision, sec);
     } else {
 	switch (unit) {
@@ -69,7 +69,11 @@ void wrangle(long double angle, char unit, int precision, size_t str_len, char s
 	    break;
 	}
 	if (precision == 0) width--;
-	snprintf(str, str_len, "%*.*Lf",
-	    width, precision, angle);
+	/* right-justify in width, as "%*.*Lf" would */
+	n = wrrealf(angle, precision, str_len, str);
+	if (n < width && (size_t)width < str_len) {
+	    for (i = n; i >= 0; i--) str[i + width - n] = str[i];
+	    for (i = 0; i < width - n; i++) str[i] = ' ';
+	}
     }
 }
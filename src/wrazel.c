@@ -0,0 +1,211 @@
+/*------------------------------------------------------------------------------
+  Write binary and FITS az, el files.
+------------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include "azelfile.h"
+#include "manglefn.h"
+
+/*------------------------------------------------------------------------------
+  Write FITS primary header and table header for nrec rows.
+*/
+static int wrazel_fits_table(azelfile *file, FILE *stream, long long nrec)
+{
+    char *ttype[5], *tform[5], *tunit[5];
+    char *unit;
+    int ncol;
+
+    switch (file->unit) {
+    case 'r':	unit = "rad";		break;
+    case 'm':	unit = "arcmin";	break;
+    case 's':	unit = "arcsec";	break;
+    default:	unit = "deg";		break;
+    }
+    ttype[0] = "AZ";
+    tform[0] = "1D";
+    tunit[0] = (file->unit == 'h')? "hour" : unit;
+    ttype[1] = "EL";
+    tform[1] = "1D";
+    tunit[1] = unit;
+    ncol = 2;
+    if (file->columns & AZEL_ID) {
+	ttype[ncol] = "ID";
+	tform[ncol] = "1K";
+	tunit[ncol] = 0x0;
+	ncol++;
+    }
+    if (file->columns & AZEL_WEIGHT) {
+	ttype[ncol] = "WEIGHT";
+	tform[ncol] = "1D";
+	tunit[ncol] = 0x0;
+	ncol++;
+    }
+    if (file->columns & AZEL_POLYID) {
+	ttype[ncol] = "POLYID";
+	tform[ncol] = "1K";
+	tunit[ncol] = 0x0;
+	ncol++;
+    }
+    return(wrfits_table(stream, nrec, ncol, ttype, tform, tunit, 0, 0x0));
+}
+
+/*------------------------------------------------------------------------------
+  Write header of binary or FITS az, el file.
+
+   Input: file = pointer to azelfile structure, with name, file, fmt,
+		 columns and unit set.
+  Return value:  0 = ok;
+		-1 = error.
+*/
+int wrazel_head(azelfile *file)
+{
+    unsigned char head[AZEL_HEADSIZE];
+    int columns, version;
+
+    file->nrec = 0;
+    file->spool = 0x0;
+    if (file->fmt == 'f') {
+	/* the number of rows is not known until the end, so the table header
+	   is rewritten then, or if the file is a pipe, written only then */
+	file->headpos = ftell(file->file);
+	if (file->headpos == -1 || fseek(file->file, file->headpos, SEEK_SET) != 0) {
+	    file->spool = tmpfile();
+	    if (!file->spool) {
+		fprintf(stderr, "wrazel_head: cannot open temporary file for FITS output to %s\n", file->name);
+		return(-1);
+	    }
+	    return(0);
+	}
+	if (wrfits_primary(file->file) == -1) goto error;
+	file->headpos = ftell(file->file);
+	if (wrazel_fits_table(file, file->file, 0) == -1) goto error;
+	return(0);
+    }
+
+    memset(head, 0, AZEL_HEADSIZE);
+    memcpy(head, AZEL_MAGIC, 8);
+    version = AZEL_VERSION;
+    columns = file->columns;
+    memcpy(&head[8], &version, sizeof(int));
+    memcpy(&head[12], &columns, sizeof(int));
+    head[16] = file->unit;
+
+    if (fwrite(head, 1, AZEL_HEADSIZE, file->file) != AZEL_HEADSIZE) goto error;
+    return(0);
+
+    error:
+    fprintf(stderr, "wrazel_head: error writing to %s\n", file->name);
+    return(-1);
+}
+
+/*------------------------------------------------------------------------------
+  Write one position to binary or FITS az, el file.
+
+   Input: file = pointer to azelfile structure, whose header has been written.
+	  v = az, el, in the units file->unit of the file.
+	  id = id, written if file has an id column.
+	  weight = weight, written if file has a weight column.
+	  polyid = polygon id, written if file has a polyid column.
+  Return value:  0 = ok;
+		-1 = error.
+*/
+int wrazel(azelfile *file, azel *v, long long id, real_t weight, long long polyid)
+{
+    unsigned char rec[5 * 8];
+    double az, el, w;
+    size_t n;
+
+    FILE *stream;
+
+    az = v->az;
+    el = v->el;
+    w = weight;
+    if (file->fmt == 'f') {
+	/* FITS is big-endian */
+	fits_putd(&rec[0], az);
+	fits_putd(&rec[8], el);
+	n = 16;
+	if (file->columns & AZEL_ID) {
+	    fits_putk(&rec[n], id);
+	    n += 8;
+	}
+	if (file->columns & AZEL_WEIGHT) {
+	    fits_putd(&rec[n], w);
+	    n += 8;
+	}
+	if (file->columns & AZEL_POLYID) {
+	    fits_putk(&rec[n], polyid);
+	    n += 8;
+	}
+    } else {
+	memcpy(&rec[0], &az, 8);
+	memcpy(&rec[8], &el, 8);
+	n = 16;
+	if (file->columns & AZEL_ID) {
+	    memcpy(&rec[n], &id, 8);
+	    n += 8;
+	}
+	if (file->columns & AZEL_WEIGHT) {
+	    memcpy(&rec[n], &w, 8);
+	    n += 8;
+	}
+	if (file->columns & AZEL_POLYID) {
+	    memcpy(&rec[n], &polyid, 8);
+	    n += 8;
+	}
+    }
+
+    stream = (file->spool)? file->spool : file->file;
+    if (fwrite(rec, 1, n, stream) != n) {
+	fprintf(stderr, "wrazel: error writing to %s\n", file->name);
+	return(-1);
+    }
+    file->nrec++;
+    return(0);
+}
+
+/*------------------------------------------------------------------------------
+  Finish writing az, el file: for FITS, write the number of rows into the
+  table header, and pad the table to a whole block.
+  Must be called before the file is closed.
+
+   Input: file = pointer to azelfile structure.
+  Return value:  0 = ok;
+		-1 = error.
+*/
+int wrazel_end(azelfile *file)
+{
+    char buf[FITS_BLOCK];
+    int n, reclen;
+    size_t nread;
+
+    if (file->fmt != 'f') return(0);
+
+    reclen = 16;
+    if (file->columns & AZEL_ID) reclen += 8;
+    if (file->columns & AZEL_WEIGHT) reclen += 8;
+    if (file->columns & AZEL_POLYID) reclen += 8;
+
+    if (file->spool) {
+	/* copy spooled rows after the header */
+	if (wrfits_primary(file->file) == -1) goto error;
+	if (wrazel_fits_table(file, file->file, file->nrec) == -1) goto error;
+	rewind(file->spool);
+	while ((nread = fread(buf, 1, FITS_BLOCK, file->spool)) > 0) {
+	    if (fwrite(buf, 1, nread, file->file) != nread) goto error;
+	}
+	fclose(file->spool);
+	file->spool = 0x0;
+    } else {
+	/* rewrite table header in place */
+	if (fseek(file->file, file->headpos, SEEK_SET) != 0) goto error;
+	n = wrazel_fits_table(file, file->file, file->nrec);
+	if (fseek(file->file, 0, SEEK_END) != 0 || n == -1) goto error;
+    }
+    if (wrfits_end(file->file, file->nrec * reclen) == -1) goto error;
+    return(0);
+
+    error:
+    fprintf(stderr, "wrazel_end: error writing to %s\n", file->name);
+    return(-1);
+}
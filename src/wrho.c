@@ -1,6 +1,9 @@
 /*------------------------------------------------------------------------------
  A J S Hamilton 2001
 ------------------------------------------------------------------------------*/
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include "manglefn.h"
 
 /*------------------------------------------------------------------------------
@@ -28,10 +31,10 @@
 	     sum_lm w_lm Y_lm exp[- [l(l+1) / lsmooth(lsmooth+1)]^(esmooth/2) ]
 			  if lsmooth > 0. and general esmooth.
 */
-long double wrho(long double az, long double el, int lmax, int mmax, harmonic w[/*NW*/], long double lsmooth, long double esmooth)
+real_t wrho(real_t az, real_t el, int lmax, int mmax, harmonic w[/*NW*/], real_t lsmooth, real_t esmooth)
 {
     int im, nw;
-    long double wrho;
+    real_t wrho;
 
     im = IM;
     nw = NW;
@@ -40,3 +43,181 @@ long double wrho(long double az, long double el, int lmax, int mmax, harmonic w[
 
     return(wrho);
 }
+
+/*------------------------------------------------------------------------------
+  Values of summed harmonics at many positions.
+
+  The sums over l depend only on elevation, so points are sorted by elevation
+  and each table of sums over l, computed by fortran subroutine wrhoel,
+  is shared by all points at that elevation; what remains for each point
+  is a sum over m, costing O(mmax) rather than O(lmax mmax).
+
+  If eltol > 0, the tables are computed on a uniform grid of elevations
+  of spacing h, and interpolated to each point by 4-point Lagrange
+  interpolation.  Each sum over l is a trigonometric polynomial of degree lmax
+  in elevation, so by Bernstein's inequality the interpolation error is at most
+	(3/128) (h lmax)^4
+  times the maximum absolute value of the sum; h is chosen to make this eltol.
+  A point falls back to its own exact table if the grid tables it needs
+  would not be shared by enough of the following points to pay for them,
+  so interpolation never computes more tables than points.
+
+   Input: npt = number of points.
+	  v = array of npt az, el positions, in radians.
+	  lmax, mmax, w, lsmooth, esmooth = as for wrho.
+	  eltol = tolerance of interpolation in elevation, relative to the
+		  maximum absolute value of each sum over l;
+		= 0. to compute exact tables, one per distinct elevation.
+  Output: rho[i] = wrho(v[i].az, v[i].el, lmax, mmax, w, lsmooth, esmooth),
+	  in the same order as v.
+  Return value: number of tables of sums over l computed,
+		or -1 if error occurred.
+*/
+int wrhos(int npt, azel v[/*npt*/], int lmax, int mmax, harmonic w[/*NW*/], real_t lsmooth, real_t esmooth, real_t eltol, real_t rho[/*npt*/])
+{
+/* number of contiguous chunks of sorted points processed in parallel */
+#ifdef	_OPENMP
+#define NCHUNK		16
+#else
+#define NCHUNK		1
+#endif
+    int ic, im, ier, ma, nchunk, nt, nw;
+    int *iord;
+    real_t h;
+    real_t *el;
+
+    if (npt <= 0) return(0);
+
+    im = IM;
+    nw = NW;
+    ma = 2 * (mmax + 1);
+
+    /* order points by elevation */
+    el = (real_t *) malloc(sizeof(real_t) * npt);
+    if (!el) {
+	fprintf(stderr, "wrhos: failed to allocate memory for %d reals\n", npt);
+	return(-1);
+    }
+    iord = (int *) malloc(sizeof(int) * npt);
+    if (!iord) {
+	fprintf(stderr, "wrhos: failed to allocate memory for %d integers\n", npt);
+	free(el);
+	return(-1);
+    }
+    for (ic = 0; ic < npt; ic++) el[ic] = v[ic].el;
+    findbot(el, npt, iord, npt);
+
+    /* spacing of elevation grid */
+    h = (eltol > 0.)? pow(128. * eltol / 3., 0.25) / ((lmax > 1)? lmax : 1) : 0.;
+    /* so fine a grid would overflow the node index: compute exact tables */
+    if (h > 0. && 4. / h > MAXINT / 2) h = 0.;
+
+    nchunk = (npt < NCHUNK)? npt : NCHUNK;
+    nt = 0;
+    ier = 0;
+#ifdef	_OPENMP
+#pragma omp parallel for schedule(dynamic) reduction(+:nt)
+#endif
+    for (ic = 0; ic < nchunk; ic++) {
+	int i, ib, ie, ip, j, jp, k, kex, kp, m, nnew, s;
+	int knode[4];
+	real_t cel, c1, cm, cmp, elex, r, sm, s1, t;
+	real_t c[4];
+	real_t *a, *ax, *b;
+
+	/* 4 grid tables, in slots k mod 4, 1 exact table, and interpolated sums */
+	a = (real_t *) malloc(sizeof(real_t) * ma * 6);
+	if (!a) {
+	    fprintf(stderr, "wrhos: failed to allocate memory for %d reals\n", ma * 6);
+#ifdef	_OPENMP
+#pragma omp atomic write
+#endif
+	    ier = -1;
+	    continue;
+	}
+	ax = &a[ma * 4];
+	b = &a[ma * 5];
+	for (s = 0; s < 4; s++) knode[s] = MAXINT;
+	kex = 0;
+	elex = 0.;
+
+	ib = (int)(((long long)npt * ic) / nchunk);
+	ie = (int)(((long long)npt * (ic + 1)) / nchunk);
+	for (ip = ib; ip < ie; ip++) {
+	    i = iord[ip];
+	    cel = v[i].el;
+
+	    /* sums over l interpolated from grid tables */
+	    nnew = 0;
+	    if (h > 0.) {
+		k = (int)floor(cel / h);
+		for (j = -1; j <= 2; j++) if (knode[(k + j) & 3] != k + j) nnew++;
+		/* only if the new tables are shared by as many points */
+		if (nnew > 0) {
+		    jp = ip + nnew - 1;
+		    if (jp >= ie) {
+			nnew = -1;
+		    } else {
+			kp = (int)floor(v[iord[jp]].el / h);
+			if (kp != k) nnew = -1;
+		    }
+		}
+	    } else {
+		nnew = -1;
+	    }
+
+	    if (nnew >= 0) {
+		for (j = -1; j <= 2; j++) {
+		    s = (k + j) & 3;
+		    if (knode[s] != k + j) {
+			t = (k + j) * h;
+			wrhoel_(&t, w, &lmax, &mmax, &im, &nw, &lsmooth, &esmooth, &a[ma * s]);
+			knode[s] = k + j;
+			nt++;
+		    }
+		}
+		/* Lagrange weights at nodes k-1, k, k+1, k+2 */
+		t = cel / h - k;
+		c[0] = - t * (t - 1.) * (t - 2.) / 6.;
+		c[1] = (t + 1.) * (t - 1.) * (t - 2.) / 2.;
+		c[2] = - (t + 1.) * t * (t - 2.) / 2.;
+		c[3] = (t + 1.) * t * (t - 1.) / 6.;
+		for (m = 0; m < ma; m++) b[m] = 0.;
+		for (j = 0; j < 4; j++) {
+		    s = (k + j - 1) & 3;
+		    for (m = 0; m < ma; m++) b[m] += c[j] * a[ma * s + m];
+		}
+	    /* exact sums over l, shared with the previous point at the same elevation */
+	    } else {
+		if (!kex || cel != elex) {
+		    wrhoel_(&cel, w, &lmax, &mmax, &im, &nw, &lsmooth, &esmooth, ax);
+		    kex = 1;
+		    elex = cel;
+		    nt++;
+		}
+		for (m = 0; m < ma; m++) b[m] = ax[m];
+	    }
+
+	    /* sum over m */
+	    r = b[0];
+	    c1 = cos(v[i].az);
+	    s1 = sin(v[i].az);
+	    cm = 1.;
+	    sm = 0.;
+	    for (m = 1; m <= mmax; m++) {
+		cmp = cm;
+		cm = cmp * c1 - sm * s1;
+		sm = sm * c1 + cmp * s1;
+		r += 2. * (cm * b[2 * m] - sm * b[2 * m + 1]);
+	    }
+	    rho[i] = r;
+	}
+	free(a);
+    }
+
+    free(el);
+    free(iord);
+
+    if (ier == -1) return(-1);
+    return(nt);
+}
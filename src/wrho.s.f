@@ -1,19 +1,17 @@
 c-----------------------------------------------------------------------
 c  A J S Hamilton 2001
 c-----------------------------------------------------------------------
-      real*10 function wrho(az,el,w,lmax,mmax,im,nw,lsmooth,esmooth)
+      function wrho(az,el,w,lmax,mmax,im,nw,lsmooth,esmooth)
+#include "real.par"
+      real(KR) wrho
       integer lmax,mmax,im,nw
-      real*10 el,az,w(im,nw),lsmooth,esmooth
+      real(KR) el,az,w(im,nw),lsmooth,esmooth
 c
-c        parameters
-      real*10 HALF
-      parameter (HALF=1._10/2._10)
-      include 'pi.par'
 c        local variables
-c     integer i
-      integer l,lm,lmax1,l1,m,mmax1,m1
-      real*10 al,al1,am,cel,cm,dwrho,lsmoot1,phi,
-     *  sel,sm,smooth,t,tm,tp,y,z,zm,zn,zp
+      integer m
+      real(KR) cm,cmp,c1,sm,s1
+c        automatic work array
+      real(KR) a(2,0:mmax)
 c *
 c * Given window harmonics w_lm, returns value of window function
 c *    sum w_lm Y_lm exp{-[l(l+1)/lsmooth(lsmooth+1)]**(esmooth/2)]}
@@ -36,54 +34,124 @@ c                 = 2 for Gaussian smoothing.
 c Output: wrho = sum w_lm Y_lm
 c                    * exp{-[l(l+1)/lsmooth(lsmooth+1)]**(esmooth/2)]}
 c
-      lmax1=lmax+1
-      mmax1=mmax+1
-      lsmoot1=lsmooth+1._10
+c The sums over l, which depend only on elevation, are done by wrhoel;
+c what is left is the sum over m, which depends on azimuth,
+c with cos and sin of m*az by rotation from those of (m-1)*az.
+c
+      call wrhoel(el,w,lmax,mmax,im,nw,lsmooth,esmooth,a)
+      wrho=a(1,0)
+      c1=cos(az)
+      s1=sin(az)
+      cm=1._KR
+      sm=0._KR
+      do m=1,mmax
+        cmp=cm
+        cm=cmp*c1-sm*s1
+        sm=sm*c1+cmp*s1
+        wrho=wrho+2._KR*(cm*a(1,m)-sm*a(2,m))
+      enddo
+      return
+      end
+c
+c-----------------------------------------------------------------------
+      subroutine wrhoel(el,w,lmax,mmax,im,nw,lsmooth,esmooth,a)
+#include "real.par"
+      integer lmax,mmax,im,nw
+      real(KR) el,w(im,nw),lsmooth,esmooth,a(2,0:mmax)
+c
+c        parameters
+      real(KR) HALF
+      parameter (HALF=1._KR/2._KR)
+      include 'pi.par'
+c        local variables
+      integer k,l,lm,l1,m,mtop
+      real(KR) al,al1,cel,lsmoot1,sel,t,zp
+c        automatic work arrays
+      real(KR) sq(0:2*lmax+1),rsq(0:2*lmax+1),smooth(0:lmax),
+     *  z(0:mmax),zm(0:mmax),zn(0:mmax)
+c *
+c * Given window harmonics w_lm, returns the sums over l
+c *    a_m = sum_l w_lm z_lm sqrt(2l+1)
+c *            * exp{-[l(l+1)/lsmooth(lsmooth+1)]**(esmooth/2)]}
+c * at elevation el radians, where Y_lm = z_lm sqrt(2l+1) exp(i m az),
+c * so that the window function at azimuth az is
+c *    a_0 + sum_{m>0} 2 Re[a_m exp(i m az)] .
+c * These depend only on elevation, so can be shared by all points
+c * at the same elevation, or interpolated between elevations:
+c * as a function of el, a_m is a trigonometric polynomial of degree lmax.
+c *
+c  Input: el = elevation (= latitude = pi/2 - polar angle) in radians.
+c         w, lmax, mmax, im, nw, lsmooth, esmooth = as for wrho.
+c Output: a(i,m), i=1,2, m=0,mmax = sums over l;
+c            a(1,m) is real part, a(2,m) is imaginary part,
+c            zero if im=1; a(i,m) is zero for m > lmax.
+c
+c The sum runs over l outside, over m inside.
+c For each l, the recursions of z(l,m) for different m are independent,
+c and the harmonics w(i,lm) are contiguous in m,
+c so the inner loops are free of branches, and vectorize if KR=8.
+c The coefficients of the recursion are products of sqrt(k),
+c and the smoothing factor depends only on l,
+c so sqrt and exp are tabulated once, not evaluated for each l and m.
+c
       cel=cos(el)
       sel=sin(el)
-      phi=az
-      wrho=0._10
-      do 180 m1=1,mmax1
-        m=m1-1
-        am=m
-        if (m.eq.0) then
-c        zn=z(0,0)
-          zn=1._10/sqrt(4._10*PI)
-          cm=1._10
-          sm=0._10
-        elseif (m.gt.0) then
-c        zn=z(m,m)
-          zn=-sqrt((am-HALF)/am)*cel*zn
-          cm=2._10*cos(am*phi)
-          if (im.eq.2) sm=2._10*sin(am*phi)
+      do m=0,mmax
+        a(1,m)=0._KR
+        a(2,m)=0._KR
+      enddo
+      if (lmax.lt.0) return
+c        sqrt(k) and 1/sqrt(k)
+      sq(0)=0._KR
+      rsq(0)=0._KR
+      do k=1,2*lmax+1
+        sq(k)=sqrt(real(k,KR))
+        rsq(k)=1._KR/sq(k)
+      enddo
+c        smoothing, and sqrt(2l+1) of Y(l,m)
+      lsmoot1=lsmooth+1._KR
+      do l=0,lmax
+        al=l
+        al1=l+1
+        smooth(l)=sq(2*l+1)
+        if (lsmooth.gt.0._KR) smooth(l)=smooth(l)
+     *    *exp(-(al/lsmooth*al1/lsmoot1)**(esmooth/2._KR))
+      enddo
+c        zn(m)=z(m,m)
+      zn(0)=1._KR/sqrt(4._KR*PI)
+      do m=1,mmax
+        zn(m)=-sqrt((m-HALF)/m)*cel*zn(m-1)
+      enddo
+c        z(m)=z(l,m), zm(m)=z(l-1,m)
+      do 180 l=0,lmax
+        l1=l+1
+        mtop=min(l,mmax)
+        if (l.le.mmax) then
+          z(l)=zn(l)
+          zm(l)=0._KR
+        endif
+c        accumulate w(l,m)*z(l,m)
+        lm=(l*l1)/2+1
+        if (im.eq.2) then
+          do m=0,mtop
+            a(1,m)=a(1,m)+w(1,lm+m)*z(m)*smooth(l)
+            a(2,m)=a(2,m)+w(2,lm+m)*z(m)*smooth(l)
+          enddo
+        else
+          do m=0,mtop
+            a(1,m)=a(1,m)+w(1,lm+m)*z(m)*smooth(l)
+          enddo
+        endif
+c        zp=z(l+1,m)
+        if (l.lt.lmax) then
+          t=l1+l
+          do m=0,mtop
+            zp=(t*sel*z(m)-sq(l+m)*sq(l-m)*zm(m))
+     *        *rsq(l1+m)*rsq(l1-m)
+            zm(m)=z(m)
+            z(m)=zp
+          enddo
         endif
-        z=0._10
-        zp=zn
-        lm=(m*m1)/2+1
-        do 160 l1=m1,lmax1
-          al1=l1
-          l=l1-1
-          al=l
-c        zm=z(l-1,m); z=z(l,m); zp=z(l+1,m)
-          zm=z
-          z=zp
-          t=al1+al
-          tm=sqrt((al+am)*(al-am))
-          tp=sqrt((al1+am)*(al1-am))
-          zp=(t*sel*z-tm*zm)/tp
-          y=z*sqrt(t)
-c        dwrho=w(l,m)*Y(l,m)+w(l,-m)*Y(l,-m)
-          lm=lm+l
-          dwrho=cm*w(1,lm)
-          if (im.eq.2) dwrho=dwrho-sm*w(2,lm)
-          dwrho=dwrho*y
-          if (lsmooth.gt.0._10) then
-            smooth=exp(-(al/lsmooth*al1/lsmoot1)**(esmooth/2._10))
-            dwrho=dwrho*smooth
-          endif
-          wrho=wrho+dwrho
-c         write (*,'(2i4,i6,5g12.4)') l,m,lm,sm,cm,y,(w(i,lm),i=1,im)
-  160   continue
   180 continue
       return
       end
@@ -4,6 +4,7 @@
 #include <math.h>
 #include <stdio.h>
 #include <string.h>
+#include "fits.h"
 #include "manglefn.h"
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -17,15 +18,15 @@
 const int verb = 0;
 
 /* initial angular tolerance within which to merge multiple intersections */
-extern long double mtol;
+extern real_t mtol;
 
 /* min, max weights to keep */
 extern int is_weight_min, is_weight_max;
-extern long double weight_min, weight_max;
+extern real_t weight_min, weight_max;
 
 /* min, max areas to keep */
 extern int is_area_min, is_area_max;
-extern long double area_min, area_max;
+extern real_t area_min, area_max;
 
 /* min, max ids to keep */
 extern int is_id_min, is_id_max;
@@ -33,7 +34,7 @@ extern long long id_min, id_max;
 
 /* min, max pixels to keep */
 extern int is_pixel_min, is_pixel_max;
-extern int pixel_min, pixel_max;
+extern long long pixel_min, pixel_max;
 
 /*pixelization info*/
 extern int res_max;                  /*maximum resolution allowed for pixelization*/
@@ -47,6 +48,41 @@ extern int balkanized;                /*switch indicating whether input has been
 
 extern int real;             /*equal to either '8' or '10' depending on whether doubles (real*8) or long doubles (real*10) are used*/
 
+/*------------------------------------------------------------------------------
+  Write one cap of a polygon, as
+  fprintf(file, " %.19Lg %.19Lg %.19Lg %.19Lg\n", rp[0], rp[1], rp[2], cm)
+  would, only faster.
+*/
+static void wr_cap(FILE *file, vec rp, real_t cm)
+{
+    char line[4 * (AZEL_STR_LEN + 1) + 1];
+    int i, n;
+
+    n = 0;
+    for (i = 0; i < 4; i++) {
+	line[n++] = ' ';
+	n += wrrealg((i < 3)? rp[i] : cm, 19, 0, AZEL_STR_LEN, &line[n]);
+    }
+    line[n++] = '\n';
+    fwrite(line, 1, n, file);
+}
+
+/*------------------------------------------------------------------------------
+  Write real number, as fprintf(file, "% *.*Lf", width, precision, x) would,
+  only faster.
+*/
+static void wr_fixed(FILE *file, int width, int precision, real_t x)
+{
+    char str[AZEL_STR_LEN + 1];
+    int n;
+
+    str[0] = ' ';
+    n = wrrealf(x, precision, AZEL_STR_LEN, (signbit(x))? str : &str[1]);
+    if (!signbit(x)) n++;
+    for (; n < width; n++) putc(' ', file);
+    fputs(str, file);
+}
+
 /*------------------------------------------------------------------------------
   Write mask data.
 
@@ -139,9 +175,9 @@ int wr_circ(char *filename, format *fmt, int npolys, polygon *polys[/*npolys*/],
     char unit;
     char az_str[AZEL_STR_LEN], el_str[AZEL_STR_LEN], th_str[AZEL_STR_LEN];
     int i, ier, ip, ipoly, nbadarea, npoly;
-    long double area, angle[3], tol;
+    real_t area, angle[3], tol;
     FILE *file;
-    char *circle_fmt = "circle %lld ( %d caps, %.18Lg weight, %.18Lf str):\n";
+    char *circle_fmt = "circle %lld ( %d caps, %.18" RL "g weight, %.18" RL "f str):\n";
 
     /* open filename for writing */
     if (!filename || strcmp(filename, "-") == 0) {
@@ -152,6 +188,7 @@ int wr_circ(char *filename, format *fmt, int npolys, polygon *polys[/*npolys*/],
 	    fprintf(stderr, "wr_circ: cannot open %s for writing\n", filename);
 	    return(-1);
 	}
+	wrbuf(file);
     }
 
     /* write number of polygons */
@@ -220,7 +257,7 @@ int wr_circ(char *filename, format *fmt, int npolys, polygon *polys[/*npolys*/],
 	npoly, (file == stdout)? "output": filename);
 
     /* close file */
-    if (file != stdout) fclose(file);
+    if (file != stdout) wrclose(file);
 
     return(npoly);
 }
@@ -241,14 +278,14 @@ int wr_edge(char *filename, format *fmt, int npolys, polygon *polys[/*npolys*/],
 {
     const int per = 0;
     const int nve = 2;
-    const char *edges_fmt = "edges %lld ( %d points/edge, %d edges, %.18Lg weight, %s %s mid):\n";
-    const char *graphics_fmt = "graphics %lld ( %d points, %d edges, %.18Lg weight, %s %s mid):\n";
-    const char *vertices_fmt = "vertices %lld ( %d vertices, %.18Lg weight, %s %s mid):\n";
+    const char *edges_fmt = "edges %lld ( %d points/edge, %d edges, %.18" RL "g weight, %s %s mid):\n";
+    const char *graphics_fmt = "graphics %lld ( %d points, %d edges, %.18" RL "g weight, %s %s mid):\n";
+    const char *vertices_fmt = "vertices %lld ( %d vertices, %.18" RL "g weight, %s %s mid):\n";
     char az_str[AZEL_STR_LEN], el_str[AZEL_STR_LEN];
     int do_vcirc, i, ier, imid, ipoly, iv, ive, ivm, jv, manybounds, nbadverts, nev, nev0, npoly, npt, nv, nvm;
     int *ipv, *gp, *ev;
-    long double azo, tol;
-    long double *angle;
+    real_t azo, tol;
+    real_t *angle;
     vec *ve, *vm;
     azel v;
     FILE *file;
@@ -262,6 +299,7 @@ int wr_edge(char *filename, format *fmt, int npolys, polygon *polys[/*npolys*/],
 	    fprintf(stderr, "wr_edge: cannot open %s for writing\n", filename);
 	    return(-1);
 	}
+	wrbuf(file);
     }
 
     /* whether to write vertices also for circles with no intersections */
@@ -402,7 +440,7 @@ int wr_edge(char *filename, format *fmt, int npolys, polygon *polys[/*npolys*/],
 	npoly, (file == stdout)? "output": filename);
 
     /* close file */
-    if (file != stdout) fclose(file);
+    if (file != stdout) wrclose(file);
 
     return(npoly);
 }
@@ -427,8 +465,8 @@ int wr_list(char *filename, format *fmt, int npolys, polygon *polys[/*npolys*/],
     char az_str_mid[AZEL_STR_LEN], el_str_mid[AZEL_STR_LEN];
     int do_vcirc, i, ier, imid, ipoly, iv, ive, ivm, jv, manybounds, nbadverts, nev, nev0, npoly, npt, nv, nvm,firstpoint;
     int *ipv, *gp, *ev;
-    long double azo, tol,az1,el1;
-    long double *angle;
+    real_t azo, tol,az1,el1;
+    real_t *angle;
     vec *ve, *vm;
     azel v;
     FILE *file;
@@ -445,6 +483,7 @@ int wr_list(char *filename, format *fmt, int npolys, polygon *polys[/*npolys*/],
 	    fprintf(stderr, "wr_list: cannot open %s for writing\n", filename);
 	    return(-1);
 	}
+	wrbuf(file);
     }
     if(filename){
       sprintf(weightfilename,"%s.weight",filename);
@@ -458,6 +497,7 @@ int wr_list(char *filename, format *fmt, int npolys, polygon *polys[/*npolys*/],
 	    fprintf(stderr, "wr_list: cannot open %s for writing\n", weightfilename);
 	    return(-1);
 	}
+	wrbuf(weightfile);
     }
 
 
@@ -589,7 +629,7 @@ int wr_list(char *filename, format *fmt, int npolys, polygon *polys[/*npolys*/],
 	    wrangle(v.el, fmt->outunitp, fmt->outprecision, AZEL_STR_LEN, el_str);
 	    fprintf(file, " %s %s\n", az_str, el_str);
 	    fprintf(file, "NaN NaN\n");
-	    fprintf(weightfile,"%lld %.18Lg %s %s\n", polys[ipoly]->id,polys[ipoly]->weight,az_str_mid,el_str_mid); 
+	    fprintf(weightfile,"%lld %.18" RL "g %s %s\n", polys[ipoly]->id,polys[ipoly]->weight,az_str_mid,el_str_mid); 
 	}
 	//fprintf(file, "NaN NaN\n");
 
@@ -613,8 +653,8 @@ int wr_list(char *filename, format *fmt, int npolys, polygon *polys[/*npolys*/],
 	(weightfile == stdout)? "output": weightfilename);
 
     /* close file */
-    if (file != stdout) fclose(file);
-    if (weightfile != stdout) fclose(weightfile);
+    if (file != stdout) wrclose(file);
+    if (weightfile != stdout) wrclose(weightfile);
 
     return(npoly);
 }
@@ -638,9 +678,9 @@ int wr_rect(char *filename, format *fmt, int npolys, polygon *polys[/*npolys*/],
     char unit;
     char azmin_str[AZEL_STR_LEN], azmax_str[AZEL_STR_LEN], elmin_str[AZEL_STR_LEN], elmax_str[AZEL_STR_LEN];
     int ier, ipoly, isrect, nbadarea, nrect;
-    long double area, azmin, azmax, elmin, elmax, tol;
+    real_t area, azmin, azmax, elmin, elmax, tol;
     FILE *file;
-    char *rect_fmt = "rectangle %lld ( %d caps, %.18Lg weight, %.18Lf str):\n";
+    char *rect_fmt = "rectangle %lld ( %d caps, %.18" RL "g weight, %.18" RL "f str):\n";
 
     /* count how many polygons are rectangles */
     nrect = 0;
@@ -669,6 +709,7 @@ int wr_rect(char *filename, format *fmt, int npolys, polygon *polys[/*npolys*/],
 	    fprintf(stderr, "wr_rect: cannot open %s for writing\n", filename);
 	    return(-1);
 	}
+	wrbuf(file);
     }
 
     /* write number of rectangles */
@@ -738,7 +779,7 @@ int wr_rect(char *filename, format *fmt, int npolys, polygon *polys[/*npolys*/],
 	nrect, (file == stdout)? "output": filename);
 
     /* close file */
-    if (file != stdout) fclose(file);
+    if (file != stdout) wrclose(file);
 
     return(nrect);
 }
@@ -757,12 +798,13 @@ int wr_rect(char *filename, format *fmt, int npolys, polygon *polys[/*npolys*/],
 */
 int wr_poly(char *filename, format *fmt, int npolys, polygon *polys[/*npolys*/], int npolyw)
 {
+    char weight_str[AZEL_STR_LEN], area_str[AZEL_STR_LEN];
     int ier, ip, ipoly, nbadarea, npoly;
-    long double area, tol;
+    real_t area, tol;
     FILE *file;
     char *poly_fmt;
-    char *polygon_fmt = "polygon %lld ( %d caps, %.19Lg weight, %d pixel, %.19Lg str):\n";
-    char *spolygon_fmt = "%lld %d %.19Lg %d %.19Lg\n";
+    char *polygon_fmt = "polygon %lld ( %d caps, %s weight, %lld pixel, %s str):\n";
+    char *spolygon_fmt = "%lld %d %s %lld %s\n";
 
     /* open filename for writing */
     if (!filename || strcmp(filename, "-") == 0) {
@@ -773,6 +815,7 @@ int wr_poly(char *filename, format *fmt, int npolys, polygon *polys[/*npolys*/],
 	    fprintf(stderr, "wr_poly: cannot open %s for writing\n", filename);
 	    return(-1);
 	}
+	wrbuf(file);
     }
 
     /* format */
@@ -813,13 +856,14 @@ int wr_poly(char *filename, format *fmt, int npolys, polygon *polys[/*npolys*/],
 	}
 
 	/* number of caps, weight, and area of polygon */
+	wrrealg(polys[ipoly]->weight, 19, 0, AZEL_STR_LEN, weight_str);
+	wrrealg(area, 19, 0, AZEL_STR_LEN, area_str);
 	fprintf(file, poly_fmt,
-	    polys[ipoly]->id, polys[ipoly]->np, polys[ipoly]->weight, polys[ipoly]->pixel, area);
+	    polys[ipoly]->id, polys[ipoly]->np, weight_str, polys[ipoly]->pixel, area_str);
 
 	/* write boundaries of polygon */
 	for (ip = 0; ip < polys[ipoly]->np; ip++) {
-	    fprintf(file, " %.19Lg %.19Lg %.19Lg %.19Lg\n",
-		polys[ipoly]->rp[ip][0], polys[ipoly]->rp[ip][1], polys[ipoly]->rp[ip][2], polys[ipoly]->cm[ip]);
+	    wr_cap(file, polys[ipoly]->rp[ip], polys[ipoly]->cm[ip]);
 	}
 
 	/* increment polygon count */
@@ -836,7 +880,7 @@ int wr_poly(char *filename, format *fmt, int npolys, polygon *polys[/*npolys*/],
 	npoly, (file == stdout)? "output": filename);
 
     /* close file */
-    if (file != stdout) fclose(file);
+    if (file != stdout) wrclose(file);
 
     return(npoly);
 }
@@ -857,8 +901,9 @@ int wr_poly(char *filename, format *fmt, int npolys, polygon *polys[/*npolys*/],
 */
 int wr_dpoly(char *filename, format *fmt, int npolys, polygon *polys[/*npolys*/], int npolyw, long long raster_ids[/*npolys*/])
 {
+  char weight_str[AZEL_STR_LEN], area_str[AZEL_STR_LEN];
   int ier, ip, ipoly, jpoly,nbadarea, npoly,npolysub;
-  long double area, tol;
+  real_t area, tol;
   FILE *file;
   FILE *file_exists;
   char subfilename[1000];
@@ -866,8 +911,8 @@ int wr_dpoly(char *filename, format *fmt, int npolys, polygon *polys[/*npolys*/]
   char *stringbegin;
   char *stringend;
   char *poly_fmt;
-  char *polygon_fmt = "polygon %lld ( %d caps, %.19Lg weight, %d pixel, %.19Lg str):\n";
-  char *spolygon_fmt = "%lld %d %.19Lg %d %.19Lg\n";
+  char *polygon_fmt = "polygon %lld ( %d caps, %s weight, %lld pixel, %s str):\n";
+  char *spolygon_fmt = "%lld %d %s %lld %s\n";
 
   //if using raster ids, make sure raster_id array exists
   if(fmt->dmethod=='r' && (!raster_ids)){
@@ -914,7 +959,7 @@ int wr_dpoly(char *filename, format *fmt, int npolys, polygon *polys[/*npolys*/]
     if (fmt->dmethod=='i') {
       sprintf(subfilename, "%s/%.*s.%lld.pol",filename,nchars,stringbegin,polys[ipoly]->id);
     } else if (fmt->dmethod=='p') {
-      sprintf(subfilename, "%s/%.*s.%d.pol",filename,nchars,stringbegin,polys[ipoly]->pixel);
+      sprintf(subfilename, "%s/%.*s.%lld.pol",filename,nchars,stringbegin,polys[ipoly]->pixel);
     } else if (fmt->dmethod=='r') {
       sprintf(subfilename, "%s/%.*s.%lld.pol",filename,nchars,stringbegin,raster_ids[ipoly]);
     } else {
@@ -983,13 +1028,14 @@ int wr_dpoly(char *filename, format *fmt, int npolys, polygon *polys[/*npolys*/]
     }
     
     /* number of caps, weight, and area of polygon */
+    wrrealg(polys[ipoly]->weight, 19, 0, AZEL_STR_LEN, weight_str);
+    wrrealg(area, 19, 0, AZEL_STR_LEN, area_str);
     fprintf(file, poly_fmt,
-	    polys[ipoly]->id, polys[ipoly]->np, polys[ipoly]->weight, polys[ipoly]->pixel, area);
+	    polys[ipoly]->id, polys[ipoly]->np, weight_str, polys[ipoly]->pixel, area_str);
     
     /* write boundaries of polygon */
     for (ip = 0; ip < polys[ipoly]->np; ip++) {
-      fprintf(file, " %.19Lg %.19Lg %.19Lg %.19Lg\n",
-	      polys[ipoly]->rp[ip][0], polys[ipoly]->rp[ip][1], polys[ipoly]->rp[ip][2], polys[ipoly]->cm[ip]);
+      wr_cap(file, polys[ipoly]->rp[ip], polys[ipoly]->cm[ip]);
     }
     
     /* increment polygon count */
@@ -1039,6 +1085,7 @@ int wr_Reg(char *filename, format *fmt, int npolys, polygon *polys[/*npolys*/],
 	    fprintf(stderr, "wr_Reg: cannot open %s for writing\n", filename);
 	    return(-1);
 	}
+	wrbuf(file);
     }
 
     /* write number of polygons */
@@ -1073,7 +1120,7 @@ int wr_Reg(char *filename, format *fmt, int npolys, polygon *polys[/*npolys*/],
 
 	/* write boundaries of polygon */
 	for (ip = 0; ip < polys[ipoly]->np; ip++) {
-	    fprintf(file, " %21.19Lf %21.19Lf %21.19Lf %21.19Lf\n",
+	    fprintf(file, " %21.19" RL "f %21.19" RL "f %21.19" RL "f %21.19" RL "f\n",
 		polys[ipoly]->rp[ip][0], polys[ipoly]->rp[ip][1], polys[ipoly]->rp[ip][2], polys[ipoly]->cm[ip]);
 	}
 
@@ -1086,7 +1133,7 @@ int wr_Reg(char *filename, format *fmt, int npolys, polygon *polys[/*npolys*/],
 	npoly, (file == stdout)? "output": filename);
 
     /* close file */
-    if (file != stdout) fclose(file);
+    if (file != stdout) wrclose(file);
 
     return(npoly);
 }
@@ -1109,7 +1156,7 @@ int wr_area(char *filename, format *fmt, int npolys, polygon *polys[/*npolys*/],
 #define	PRECISION	18
     int idwidth, ier, ipoly, nbadarea, npoly, precision, width;
     long long idmin,idmax;
-    long double area, tol;
+    real_t area, tol;
     FILE *file;
 
     /* open filename for writing */
@@ -1121,6 +1168,7 @@ int wr_area(char *filename, format *fmt, int npolys, polygon *polys[/*npolys*/],
 	    fprintf(stderr, "wr_area: cannot open %s for writing\n", filename);
 	    return(-1);
 	}
+	wrbuf(file);
     }
 
     /* largest width of polygon id number */
@@ -1131,8 +1179,8 @@ int wr_area(char *filename, format *fmt, int npolys, polygon *polys[/*npolys*/],
 	if (polys[ipoly]->id < idmin) idmin = polys[ipoly]->id;
 	if (polys[ipoly]->id > idmax) idmax = polys[ipoly]->id;
     }
-    idmin = ((idmin < 0)? floorl(log10l((long double)-idmin)) + 2 : 1);
-    idmax = ((idmax > 0)? floorl(log10l((long double)idmax)) + 1 : 1);
+    idmin = ((idmin < 0)? floorl(log10l((real_t)-idmin)) + 2 : 1);
+    idmax = ((idmax > 0)? floorl(log10l((real_t)idmax)) + 1 : 1);
     idwidth = ((idmin > idmax)? idmin : idmax);
 
     /* width of area in steradians */
@@ -1160,7 +1208,8 @@ int wr_area(char *filename, format *fmt, int npolys, polygon *polys[/*npolys*/],
 	}
 
 	/* write area */
-	fprintf(file, "% *.*Lf %*lld\n", width, precision, area, idwidth, polys[ipoly]->id);
+	wr_fixed(file, width, precision, area);
+	fprintf(file, " %*lld\n", idwidth, polys[ipoly]->id);
 
 	/* increment polygon count */
 	npoly++;
@@ -1176,7 +1225,7 @@ int wr_area(char *filename, format *fmt, int npolys, polygon *polys[/*npolys*/],
 	npoly, (file == stdout)? "output": filename);
 
     /* close file */
-    if (file != stdout) fclose(file);
+    if (file != stdout) wrclose(file);
 
     return(npoly);
 }
@@ -1207,6 +1256,7 @@ int wr_id(char *filename, int npolys, polygon *polys[/*npolys*/], int npolyw)
 	    fprintf(stderr, "wr_id: cannot open %s for writing\n", filename);
 	    return(-1);
 	}
+	wrbuf(file);
     }
 
     /* largest width of polygon id number */
@@ -1217,8 +1267,8 @@ int wr_id(char *filename, int npolys, polygon *polys[/*npolys*/], int npolyw)
 	if (polys[ipoly]->id < idmin) idmin = polys[ipoly]->id;
 	if (polys[ipoly]->id > idmax) idmax = polys[ipoly]->id;
     }
-    idmin = ((idmin < 0)? floorl(log10l((long double)-idmin)) + 2 : 1);
-    idmax = ((idmax > 0)? floorl(log10l((long double)idmax)) + 1 : 1);
+    idmin = ((idmin < 0)? floorl(log10l((real_t)-idmin)) + 2 : 1);
+    idmax = ((idmax > 0)? floorl(log10l((real_t)idmax)) + 1 : 1);
     idwidth = ((idmin > idmax)? idmin : idmax);
 
     /* write header */
@@ -1242,7 +1292,7 @@ int wr_id(char *filename, int npolys, polygon *polys[/*npolys*/], int npolyw)
 	npoly, (file == stdout)? "output": filename);
 
     /* close file */
-    if (file != stdout) fclose(file);
+    if (file != stdout) wrclose(file);
 
     return(npoly);
 }
@@ -1268,8 +1318,8 @@ int wr_midpoint(char *filename, format *fmt, int npolys, polygon *polys[/*npolys
     int i, idwidth, ier, imid, ipoly, ivm, nev, nev0, npoly, nv, nvm, width;
     long long idmin,idmax;
     int *ipv, *gp, *ev;
-    long double tol;
-    long double *angle;
+    real_t tol;
+    real_t *angle;
     vec *ve, *vm;
     azel v;
     FILE *file;
@@ -1283,6 +1333,7 @@ int wr_midpoint(char *filename, format *fmt, int npolys, polygon *polys[/*npolys
 	    fprintf(stderr, "wr_midpoint: cannot open %s for writing\n", filename);
 	    return(-1);
 	}
+	wrbuf(file);
     }
 
     /* largest width of polygon id number */
@@ -1293,8 +1344,8 @@ int wr_midpoint(char *filename, format *fmt, int npolys, polygon *polys[/*npolys
 	if (polys[ipoly]->id < idmin) idmin = polys[ipoly]->id;
 	if (polys[ipoly]->id > idmax) idmax = polys[ipoly]->id;
     }
-    idmin = ((idmin < 0)? floorl(log10l((long double)-idmin)) + 2 : 1);
-    idmax = ((idmax > 0)? floorl(log10l((long double)idmax)) + 1 : 1);
+    idmin = ((idmin < 0)? floorl(log10l((real_t)-idmin)) + 2 : 1);
+    idmax = ((idmax > 0)? floorl(log10l((real_t)idmax)) + 1 : 1);
     idwidth = ((idmin > idmax)? idmin : idmax);
 
     /* write header */
@@ -1354,7 +1405,7 @@ int wr_midpoint(char *filename, format *fmt, int npolys, polygon *polys[/*npolys
 	npoly, (file == stdout)? "output": filename);
 
     /* close file */
-    if (file != stdout) fclose(file);
+    if (file != stdout) wrclose(file);
 
     return(npoly);
 }
@@ -1377,7 +1428,7 @@ int wr_weight(char *filename, format *fmt, int npolys, polygon *polys[/*npolys*/
 #define	PRECISION	10
     int idwidth, ipoly, npoly, precision, width;
     long long idmin,idmax;
-    long double weightmax;
+    real_t weightmax;
     FILE *file;
 
     /* open filename for writing */
@@ -1389,6 +1440,7 @@ int wr_weight(char *filename, format *fmt, int npolys, polygon *polys[/*npolys*/
 	    fprintf(stderr, "wr_weight: cannot open %s for writing\n", filename);
 	    return(-1);
 	}
+	wrbuf(file);
     }
 
     /* largest width of polygon id number */
@@ -1399,8 +1451,8 @@ int wr_weight(char *filename, format *fmt, int npolys, polygon *polys[/*npolys*/
 	if (polys[ipoly]->id < idmin) idmin = polys[ipoly]->id;
 	if (polys[ipoly]->id > idmax) idmax = polys[ipoly]->id;
     }
-    idmin = ((idmin < 0)? floorl(log10l((long double)-idmin)) + 2 : 1);
-    idmax = ((idmax > 0)? floorl(log10l((long double)idmax)) + 1 : 1);
+    idmin = ((idmin < 0)? floorl(log10l((real_t)-idmin)) + 2 : 1);
+    idmax = ((idmax > 0)? floorl(log10l((real_t)idmax)) + 1 : 1);
     idwidth = ((idmin > idmax)? idmin : idmax);
 
     /* largest width of weight */
@@ -1424,7 +1476,7 @@ int wr_weight(char *filename, format *fmt, int npolys, polygon *polys[/*npolys*/
 	if (!polys[ipoly]) continue;
 
 	/* write weight */
-	fprintf(file, "% *.*Lg %*lld\n", width, precision, polys[ipoly]->weight, idwidth, polys[ipoly]->id);
+	fprintf(file, "% *.*" RL "g %*lld\n", width, precision, polys[ipoly]->weight, idwidth, polys[ipoly]->id);
 
 	/* increment polygon count */
 	npoly++;
@@ -1435,28 +1487,93 @@ int wr_weight(char *filename, format *fmt, int npolys, polygon *polys[/*npolys*/
 	npoly, (file == stdout)? "output": filename);
 
     /* close file */
-    if (file != stdout) fclose(file);
+    if (file != stdout) wrclose(file);
 
     return(npoly);
 }
 
 /*------------------------------------------------------------------------------
-  Write HEALPix weights.
+  Write HEALPix weights as a FITS binary table, in the layout HEALPix
+  software reads: one WEIGHT column, a row for each pixel in NESTED order,
+  or, for a partial sky map, PIXEL and WEIGHT columns.
+
+   Input: file = file to write to.
+	  numweight = number of weights in array.
+	  weights = weights to write.
+	  pixel = HEALPix pixel of each weight, or null for all pixels.
+	  nside = HEALPix nside of partial sky map.
+   Return value: number of weights written,
+		or -1 if error occurred.
+*/
+static int wr_healpix_fits(FILE *file, int numweight, real_t weights[/*numweight*/], long long pixel[/*numweight*/], int nside)
+{
+    static char *ttype[] = {"WEIGHT"}, *tform[] = {"1D"};
+    static char *ttypep[] = {"PIXEL", "WEIGHT"}, *tformp[] = {"1K", "1D"};
+    char card[7][FITS_CARD + 1], value[FITS_STRLEN];
+    unsigned char rec[16];
+    int iweight, n, reclen;
+
+    if (!pixel) nside = (int)(sqrt(numweight / 12.) + .5);
+
+    n = 0;
+    fits_card(card[n++], "PIXTYPE", "'HEALPIX '", "HEALPix pixelisation");
+    fits_card(card[n++], "ORDERING", "'NESTED  '", "pixel ordering scheme");
+    sprintf(value, "%d", nside);
+    fits_card(card[n++], "NSIDE", value, "resolution parameter");
+    if (pixel) {
+	fits_card(card[n++], "OBJECT", "'PARTIAL '", "sky coverage");
+	fits_card(card[n++], "INDXSCHM", "'EXPLICIT'", "indexing scheme");
+    } else {
+	fits_card(card[n++], "FIRSTPIX", "0", "first pixel number");
+	sprintf(value, "%d", numweight - 1);
+	fits_card(card[n++], "LASTPIX", value, "last pixel number");
+	fits_card(card[n++], "INDXSCHM", "'IMPLICIT'", "indexing scheme");
+    }
+
+    if (wrfits_primary(file) == -1) return(-1);
+    if (pixel) {
+	if (wrfits_table(file, numweight, 2, ttypep, tformp, 0x0, n, card) == -1) return(-1);
+	reclen = 16;
+    } else {
+	if (wrfits_table(file, numweight, 1, ttype, tform, 0x0, n, card) == -1) return(-1);
+	reclen = 8;
+    }
+    for (iweight = 0; iweight < numweight; iweight++) {
+	if (pixel) {
+	    fits_putk(rec, pixel[iweight]);
+	    fits_putd(&rec[8], weights[iweight]);
+	} else {
+	    fits_putd(rec, weights[iweight]);
+	}
+	if (fwrite(rec, 1, reclen, file) != reclen) return(-1);
+    }
+    if (wrfits_end(file, (long long)numweight * reclen) == -1) return(-1);
+
+    return(numweight);
+}
+
+/*------------------------------------------------------------------------------
+  Write HEALPix weights, of all the pixels at some nside, in NESTED order,
+  or, as a sparse map, of some pixels only, each line giving the weight
+  followed by the pixel.
 
    Input: filename = name of file to write to;
 		     "" or "-" means write to standard output.
 	  fmt = pointer to format structure.
 	  numweight = number of weights in array.
 	  weights = weights to write.
+	  pixel = HEALPix pixel of each weight, in NESTED order,
+		  or null if the weights are of all pixels.
+	  nside = HEALPix nside of sparse map.
    Return value: number of weights written,
 		or -1 if error occurred.
 */
-int wr_healpix_weight(char *filename, format *fmt, int numweight, long double weights[/*numweight*/])
+int wr_healpix_weight(char *filename, format *fmt, int numweight, real_t weights[/*numweight*/], long long pixel[/*numweight*/], int nside)
 {
 #undef	PRECISION
 #define	PRECISION	6
     int iweight, nweight, precision, width;
-    long double weightmax;
+    real_t weightmax;
     FILE *file;
 
     /* open filename for writing */
@@ -1468,6 +1585,17 @@ int wr_healpix_weight(char *filename, format *fmt, int numweight, long double we
 	    fprintf(stderr, "wr_healpix_weight: cannot open %s for writing\n", filename);
 	    return(-1);
 	}
+	wrbuf(file);
+    }
+
+    /* FITS table, if az, el data are to be written as FITS */
+    if (fmt->outazel == 'f') {
+	nweight = wr_healpix_fits(file, numweight, weights, pixel, nside);
+	if (nweight == -1) {
+	    fprintf(stderr, "wr_healpix_weight: error writing to %s\n", (file == stdout)? "output": filename);
+	    return(-1);
+	}
+	goto done;
     }
 
     /* largest width of weight */
@@ -1481,7 +1609,11 @@ int wr_healpix_weight(char *filename, format *fmt, int numweight, long double we
     if (precision == 0) width--;
 
     /* write header */
-    fprintf(file, "healpix_weight %d\n", numweight);
+    if (pixel) {
+	fprintf(file, "healpix_weight %d %d\n", numweight, nside);
+    } else {
+	fprintf(file, "healpix_weight %d\n", numweight);
+    }
 
     nweight = 0;
     for (iweight = 0; iweight < numweight; iweight++) {
@@ -1489,18 +1621,21 @@ int wr_healpix_weight(char *filename, format *fmt, int numweight, long double we
 	   if (!weights[iweight]) continue; */
 
 	/* write weight */
-	fprintf(file, "% *.*Lf\n", width, precision, weights[iweight]);
+	wr_fixed(file, width, precision, weights[iweight]);
+	if (pixel) fprintf(file, " %lld", pixel[iweight]);
+	putc('\n', file);
 
 	/* increment polygon count */
 	nweight++;
     }
 
+    done:
     /* advise */
     msg("%d HEALPix weights written to %s\n",
 	nweight, (file == stdout)? "output": filename);
 
     /* close file */
-    if (file != stdout) fclose(file);
+    if (file != stdout) wrclose(file);
 
     return(nweight);
 }
@@ -1516,7 +1651,7 @@ int wr_healpix_weight(char *filename, format *fmt, int numweight, long double we
 int discard_poly(int npolys, polygon *polys[/*npolys*/])
 {
     int discard, ier, ipoly, nbadarea, noutarea, noutweight, noutid, noutpixel, npoly;
-    long double area, tol;
+    real_t area, tol;
 
     if (is_weight_min || is_weight_max || is_area_min || is_area_max || is_id_min || is_id_max || is_pixel_min || is_pixel_max) {
 	noutweight = 0;
@@ -1665,34 +1800,34 @@ int discard_poly(int npolys, polygon *polys[/*npolys*/])
 	if (noutweight > 0) {
 	    if (is_weight_min && is_weight_max) {
 		if (weight_min < weight_max) {
-		    msg("%d polygons with weights outside [%Lg, %Lg] discarded\n",
+		    msg("%d polygons with weights outside [%" RL "g, %" RL "g] discarded\n",
 			noutweight, weight_min, weight_max);
 		} else {
-		    msg("%d polygons with weights inside (%Lg, %Lg) discarded\n",
+		    msg("%d polygons with weights inside (%" RL "g, %" RL "g) discarded\n",
 			noutweight, weight_max, weight_min);
 		}
 	    } else if (is_weight_min) {
-		msg("%d polygons with weights < %Lg discarded\n",
+		msg("%d polygons with weights < %" RL "g discarded\n",
 		    noutweight, weight_min);
 	    } else if (is_weight_max) {
-		msg("%d polygons with weights > %Lg discarded\n",
+		msg("%d polygons with weights > %" RL "g discarded\n",
 		    noutweight, weight_max);
 	    }
 	}
 	if (noutarea > 0) {
 	    if (is_area_min && is_area_max) {
 		if (area_min < area_max) {
-		    msg("%d polygons with areas outside [%Lg, %Lg] discarded\n",
+		    msg("%d polygons with areas outside [%" RL "g, %" RL "g] discarded\n",
 			noutarea, area_min, area_max);
 		} else {
-		    msg("%d polygons with areas inside (%Lg, %Lg) discarded\n",
+		    msg("%d polygons with areas inside (%" RL "g, %" RL "g) discarded\n",
 			noutarea, area_max, area_min);
 		}
 	    } else if (is_area_min) {
-		msg("%d polygons with areas < %Lg discarded\n",
+		msg("%d polygons with areas < %" RL "g discarded\n",
 		    noutarea, area_min);
 	    } else if (is_area_max) {
-		msg("%d polygons with areas > %Lg discarded\n",
+		msg("%d polygons with areas > %" RL "g discarded\n",
 		    noutarea, area_max);
 	    }
 	}
@@ -1716,17 +1851,17 @@ int discard_poly(int npolys, polygon *polys[/*npolys*/])
 	if (noutpixel > 0) {
 	    if (is_pixel_min && is_pixel_max) {
 		if (pixel_min < pixel_max) {
-		    msg("%d polygons with pixel numbers outside [%d, %d] discarded\n",
+		    msg("%d polygons with pixel numbers outside [%lld, %lld] discarded\n",
 			noutpixel, pixel_min, pixel_max);
 		} else {
-		    msg("%d polygons with pixel numbers inside (%d, %d) discarded\n",
+		    msg("%d polygons with pixel numbers inside (%lld, %lld) discarded\n",
 			noutpixel, pixel_max, pixel_min);
 		}
 	    } else if (is_pixel_min) {
-		msg("%d polygons with pixel numbers < %d discarded\n",
+		msg("%d polygons with pixel numbers < %lld discarded\n",
 		    noutpixel, pixel_min);
 	    } else if (is_pixel_max) {
-		msg("%d polygons with pixel numbers > %d discarded\n",
+		msg("%d polygons with pixel numbers > %lld discarded\n",
 		    noutpixel, pixel_max);
 	    }
 	}
@@ -0,0 +1,289 @@
+/*------------------------------------------------------------------------------
+  Fast writing of numbers to text, and buffering of output files.
+------------------------------------------------------------------------------*/
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "manglefn.h"
+
+/* size of output file buffers */
+#define OUTBUFSIZE	(1 << 20)
+/* maximum number of output files with buffers at once */
+#define MAXOUTBUF	16
+
+/* buffers given to output files by wrbuf, to be freed by wrclose */
+static struct {
+    FILE *file;
+    char *buf;
+} outbuf[MAXOUTBUF];
+
+/*
+  A finite real is M 2^E with M an integer of at most MANT_DIG bits,
+  so x 10^p = M 5^p 2^(E+p) is an exact 128-bit integer for p <= MAXPREC,
+  which can be rounded to nearest, ties to even, as printf does.
+  Anything that does not fit (large or tiny numbers, inf, nan) goes to snprintf.
+*/
+#ifdef REAL8
+#define MANT_DIG	DBL_MANT_DIG
+#else
+#define MANT_DIG	LDBL_MANT_DIG
+#endif
+#if defined(__SIZEOF_INT128__) && MANT_DIG <= 64
+#define FAST
+#define MAXPREC		27
+typedef unsigned __int128 uint128;
+#endif
+
+#ifdef FAST
+static const unsigned long long pow5[MAXPREC + 1] = {
+    1ULL, 5ULL, 25ULL, 125ULL, 625ULL, 3125ULL, 15625ULL, 78125ULL, 390625ULL,
+    1953125ULL, 9765625ULL, 48828125ULL, 244140625ULL, 1220703125ULL,
+    6103515625ULL, 30517578125ULL, 152587890625ULL, 762939453125ULL,
+    3814697265625ULL, 19073486328125ULL, 95367431640625ULL,
+    476837158203125ULL, 2384185791015625ULL, 11920928955078125ULL,
+    59604644775390625ULL, 298023223876953125ULL, 1490116119384765625ULL,
+    7450580596923828125ULL
+};
+
+/*------------------------------------------------------------------------------
+  Round |x| 10^p to the nearest integer, ties to even.
+
+   Input: x = finite number.
+	  p = power of 10, 0 <= p <= MAXPREC.
+  Output: q = rounded integer.
+  Return value: 1 = ok;
+		0 = result does not fit in 64 bits.
+*/
+static int round10(real_t x, int p, unsigned long long *q)
+{
+    int e, s;
+    unsigned long long m;
+    uint128 n, r, half;
+
+    if (x == 0.) {
+	*q = 0;
+	return(1);
+    }
+    m = (unsigned long long)ldexpl(frexpl(fabsl(x), &e), MANT_DIG);
+    n = (uint128)m * pow5[p];
+    s = -(e - MANT_DIG + p);
+    if (s <= 0) {
+	if (-s >= 64 || (n >> (64 + s)) != 0) return(0);
+	*q = (unsigned long long)(n << -s);
+	return(1);
+    }
+    if (s >= 128) {
+	/* n < 2^127 <= 2^(s-1), so x 10^p < 1/2 */
+	*q = 0;
+	return(1);
+    }
+    if ((n >> s) >> 64) return(0);
+    *q = (unsigned long long)(n >> s);
+    r = n - ((uint128)*q << s);
+    half = (uint128)1 << (s - 1);
+    if (r > half || (r == half && (*q & 1))) (*q)++;
+    return(1);
+}
+
+/*------------------------------------------------------------------------------
+  Write the decimal digits of q into str, most significant first,
+  zero-padded on the left to at least nd digits.
+  Return value: number of digits written.
+*/
+static int wrdigits(unsigned long long q, int nd, char *str)
+{
+    char tmp[32];
+    int i, n;
+
+    n = 0;
+    do {
+	tmp[n++] = '0' + q % 10;
+	q /= 10;
+    } while (q > 0);
+    while (n < nd) tmp[n++] = '0';
+    for (i = 0; i < n; i++) str[i] = tmp[n - 1 - i];
+    return(n);
+}
+#endif
+
+/*------------------------------------------------------------------------------
+  Write real number into string, as snprintf(str, str_len, "%.*Lf", precision, x)
+  would, only faster.
+
+   Input: x = number.
+	  precision = number of digits after decimal point.
+  Output: str = pointer to string containing the number.
+	  str_len = length of string.
+  Return value: number of characters written, excluding terminating null.
+*/
+int wrrealf(real_t x, int precision, size_t str_len, char str[/*str_len*/])
+{
+#ifdef FAST
+    char buf[64];
+    int i, n, nd;
+    unsigned long long q;
+
+    if (!isfinite(x) || precision < 0 || precision > MAXPREC || !round10(x, precision, &q)) goto slow;
+
+    n = 0;
+    if (signbit(x)) buf[n++] = '-';
+    nd = wrdigits(q, precision + 1, &buf[n]);
+    if (precision > 0) {
+	/* open a gap for the decimal point */
+	for (i = n + nd; i > n + nd - precision; i--) buf[i] = buf[i - 1];
+	buf[n + nd - precision] = '.';
+	nd++;
+    }
+    n += nd;
+    if ((size_t)n >= str_len) goto slow;
+    for (i = 0; i < n; i++) str[i] = buf[i];
+    str[n] = '\0';
+    return(n);
+
+    slow:
+#endif
+    return(snprintf(str, str_len, "%.*" RL "f", precision, x));
+}
+
+/*------------------------------------------------------------------------------
+  Write real number into string, as snprintf(str, str_len, "%.*Lg", precision, x)
+  would, or "%#.*Lg" if alt is true, only faster.
+
+   Input: x = number.
+	  precision = number of significant digits.
+	  alt = 1 to keep trailing zeros, as the # flag does.
+  Output: str = pointer to string containing the number.
+	  str_len = length of string.
+  Return value: number of characters written, excluding terminating null.
+*/
+int wrrealg(real_t x, int precision, int alt, size_t str_len, char str[/*str_len*/])
+{
+#ifdef FAST
+    char buf[64];
+    int d, i, n, nd, p;
+    unsigned long long q, qlo;
+
+    if (precision == 0) precision = 1;
+    if (!isfinite(x) || precision > 19) goto slow;
+
+    /* decimal exponent d of x, once rounded to precision digits */
+    qlo = 1;
+    for (i = 1; i < precision; i++) qlo *= 10;
+    if (x == 0.) {
+	d = 0;
+	q = 0;
+    } else {
+	d = (int)floorl(log10l(fabsl(x)));
+	for (i = 0; i < 3; i++) {
+	    p = precision - 1 - d;
+	    if (p < 0 || p > MAXPREC || !round10(x, p, &q)) goto slow;
+	    if (q < qlo) {
+		d--;
+	    } else if (q / 10 >= qlo) {
+		d++;
+	    } else {
+		break;
+	    }
+	}
+	if (i == 3) goto slow;
+    }
+    /* %g switches to exponential notation */
+    if (d < -4 || d >= precision) goto slow;
+
+    n = 0;
+    if (signbit(x)) buf[n++] = '-';
+    p = precision - 1 - d;
+    nd = wrdigits(q, p + 1, &buf[n]);
+    if (p > 0) {
+	for (i = n + nd; i > n + nd - p; i--) buf[i] = buf[i - 1];
+	buf[n + nd - p] = '.';
+	nd++;
+	if (!alt) {
+	    /* strip trailing zeros, and the decimal point if nothing follows it */
+	    while (buf[n + nd - 1] == '0') nd--;
+	    if (buf[n + nd - 1] == '.') nd--;
+	}
+    } else if (alt) {
+	buf[n + nd] = '.';
+	nd++;
+    }
+    n += nd;
+    if ((size_t)n >= str_len) goto slow;
+    for (i = 0; i < n; i++) str[i] = buf[i];
+    str[n] = '\0';
+    return(n);
+
+    slow:
+#endif
+    if (alt) {
+	return(snprintf(str, str_len, "%#.*" RL "g", precision, x));
+    } else {
+	return(snprintf(str, str_len, "%.*" RL "g", precision, x));
+    }
+}
+
+/*------------------------------------------------------------------------------
+  Give an output file a large buffer, so that writing is not limited by
+  system calls; output to a terminal is left line buffered.
+  Must be called before anything is written to the file.
+  The buffer is freed when the file is closed with wrclose.
+
+   Input: file = output file.
+  Return value: 0 = ok;
+		-1 = could not allocate buffer, file is left as it was.
+*/
+int wrbuf(FILE *file)
+{
+    int i, ier;
+    char *buf;
+
+    if (isatty(fileno(file))) return(0);
+
+    buf = (char *) malloc(sizeof(char) * OUTBUFSIZE);
+    if (!buf) return(-1);
+
+    ier = -1;
+#ifdef	_OPENMP
+#pragma omp critical (wrbuf)
+#endif
+    for (i = 0; i < MAXOUTBUF; i++) {
+	if (outbuf[i].file) continue;
+	if (setvbuf(file, buf, _IOFBF, OUTBUFSIZE) == 0) {
+	    outbuf[i].file = file;
+	    outbuf[i].buf = buf;
+	    ier = 0;
+	}
+	break;
+    }
+    if (ier == -1) free(buf);
+    return(ier);
+}
+
+/*------------------------------------------------------------------------------
+  Close an output file, and free any buffer wrbuf gave it.
+
+   Input: file = output file.
+  Return value: as fclose.
+*/
+int wrclose(FILE *file)
+{
+    int i, ier;
+    char *buf;
+
+    ier = fclose(file);
+
+    buf = 0x0;
+#ifdef	_OPENMP
+#pragma omp critical (wrbuf)
+#endif
+    for (i = 0; i < MAXOUTBUF; i++) {
+	if (outbuf[i].file != file) continue;
+	buf = outbuf[i].buf;
+	outbuf[i].file = 0x0;
+	outbuf[i].buf = 0x0;
+	break;
+    }
+    if (buf) free(buf);
+    return(ier);
+}
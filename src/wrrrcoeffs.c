@@ -26,14 +26,14 @@
   Return value: number of coefficients written,
 		or -1 if error occurred.
 */
-int wrrrcoeffs(char *filename, long double area, long double bound[2], long double vert[2])
+int wrrrcoeffs(char *filename, real_t area, real_t bound[2], real_t vert[2])
 {
 /* precision with which harmonics are written */
 #define PRECISION	16
 /* number of coefficients */
 #define NCOEFF		4
     int icoeff, width;
-    long double rrcoeff[NCOEFF];
+    real_t rrcoeff[NCOEFF];
     FILE *file;
 
     /* first 4 coefficients of power series expansion of <RR> */
@@ -59,7 +59,7 @@ int wrrrcoeffs(char *filename, long double area, long double bound[2], long doub
     /* write */
     fprintf(file, "%*s\n", PRECISION, "WWcoeffs");
     for (icoeff = 0; icoeff < NCOEFF; icoeff++) {
-	fprintf(file, "%- #*.*Lg\n", width, PRECISION, rrcoeff[icoeff]);
+	fprintf(file, "%- #*.*" RL "g\n", width, PRECISION, rrcoeff[icoeff]);
     }
 
     /* advise */
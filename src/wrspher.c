@@ -18,9 +18,6 @@
 */
 int wrspher(char *filename, int lmax, harmonic w[/*NW*/])
 {
-/* precision with which harmonics are written */
-#define PRECISION	16
-    int i, iw, width;
     FILE *file;
 
     /* open filename for writing */
@@ -34,17 +31,8 @@ int wrspher(char *filename, int lmax, harmonic w[/*NW*/])
 	}
     }
 
-    /* width of each number */
-    width = PRECISION + 7;
-
     /* write */
-    fprintf(file, "%12d %12d %12d\n", lmax, IM, NW);
-    for (iw = 0; iw < NW; iw++) {
-	for (i = 0; i < IM; i++) {
-	    fprintf(file, " %- #*.*Lg", width, PRECISION, w[iw][i]);
-	}
-	fprintf(file, "\n");
-    }
+    wrspher_band(file, lmax, 0, lmax, w);
 
     /* advise */
     msg("%d x %d harmonics up to lmax = %d written to %s\n",
@@ -55,3 +43,43 @@ int wrspher(char *filename, int lmax, harmonic w[/*NW*/])
 
     return(NW);
 }
+
+/*------------------------------------------------------------------------------
+  Write a band of spherical harmonics, from lmin to lmax.
+  Successive bands, starting from lmin = 0, written to the same file
+  make up the same file as wrspher, without all the harmonics
+  having to be held at once.
+
+   Input: file = file to write to.
+	  lmaxw = maximum harmonic number of all the bands;
+		  the header is written along with the band starting at lmin = 0.
+	  lmin, lmax = minimum, maximum harmonic number of the band.
+	  w = array containing harmonics from lmin to lmax;
+	      NW - NW0 = ((lmax + 1)(lmax + 2) - lmin (lmin + 1))/ 2
+	      is defined in harmonics.h.
+  Return value: number of (complex) harmonics written.
+*/
+int wrspher_band(FILE *file, int lmaxw, int lmin, int lmax, harmonic w[/*NW - NW0*/])
+{
+/* precision with which harmonics are written */
+#define PRECISION	16
+    int i, iw, width;
+
+    /* width of each number */
+    width = PRECISION + 7;
+
+    /* header */
+    if (lmin == 0) {
+	fprintf(file, "%12d %12d %12d\n", lmaxw, IM, ((lmaxw + 1) * (lmaxw + 2)) / 2);
+    }
+
+    /* write */
+    for (iw = 0; iw < NW - NW0; iw++) {
+	for (i = 0; i < IM; i++) {
+	    fprintf(file, " %- #*.*" RL "g", width, PRECISION, w[iw][i]);
+	}
+	fprintf(file, "\n");
+    }
+
+    return(NW - NW0);
+}